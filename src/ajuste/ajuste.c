@@ -0,0 +1,374 @@
+#include "ajuste.h"
+#include "../util/util.h"
+#include "../es/es.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define REGISTROS_BLOCO_AJUSTE 1024 // Registros lidos por vez ao montar a amostra
+
+#define DECLARAR_VARIANTE_ARVORE_B(bytes) void descreverVarianteArvoreB_##bytes(VarianteArvoreB *variante);
+#define DECLARAR_VARIANTE_ARVORE_BSTAR(bytes) void descreverVarianteArvoreBStar_##bytes(VarianteArvoreBStar *variante);
+TAMANHOS_ARVORE_B(DECLARAR_VARIANTE_ARVORE_B)
+TAMANHOS_ARVORE_BSTAR(DECLARAR_VARIANTE_ARVORE_BSTAR)
+
+/**
+ * Monta o caminho do arquivo auxiliar com a escolha do ajuste para um arquivo de registros.
+ */
+static void caminhoAjuste(const char *nomeArquivo, char *caminho, size_t tamanho) {
+    snprintf(caminho, tamanho, "%s.ajuste", nomeArquivo);
+}
+
+static double segundosDesde(const struct timespec *inicio) {
+    struct timespec fim;
+    clock_gettime(CLOCK_MONOTONIC, &fim);
+    return (fim.tv_sec - inicio->tv_sec) + (fim.tv_nsec - inicio->tv_nsec) / 1e9;
+}
+
+/**
+ * Devolve as variantes da Árvore B compiladas no executável, a começar pela ordem padrão.
+ *
+ * @param variantes Onde o endereço da tabela de variantes será gravado.
+ * @return Número de variantes.
+ */
+int variantesArvoreB(const VarianteArvoreB **variantes) {
+#define CONTAR_VARIANTE(bytes) + 1
+    static VarianteArvoreB tabela[1 TAMANHOS_ARVORE_B(CONTAR_VARIANTE)];
+    static int quantidade = 0;
+    if (quantidade == 0) {
+        descreverVarianteArvoreB(&tabela[quantidade++]);
+#define DESCREVER_VARIANTE_ARVORE_B(bytes) descreverVarianteArvoreB_##bytes(&tabela[quantidade++]);
+        TAMANHOS_ARVORE_B(DESCREVER_VARIANTE_ARVORE_B)
+    }
+    *variantes = tabela;
+    return quantidade;
+}
+
+/**
+ * Devolve as variantes da árvore B* compiladas no executável, a começar pela ordem padrão.
+ *
+ * @param variantes Onde o endereço da tabela de variantes será gravado.
+ * @return Número de variantes.
+ */
+int variantesArvoreBStar(const VarianteArvoreBStar **variantes) {
+    static VarianteArvoreBStar tabela[1 TAMANHOS_ARVORE_BSTAR(CONTAR_VARIANTE)];
+    static int quantidade = 0;
+    if (quantidade == 0) {
+        descreverVarianteArvoreBStar(&tabela[quantidade++]);
+#define DESCREVER_VARIANTE_ARVORE_BSTAR(bytes) descreverVarianteArvoreBStar_##bytes(&tabela[quantidade++]);
+        TAMANHOS_ARVORE_BSTAR(DESCREVER_VARIANTE_ARVORE_BSTAR)
+    }
+    *variantes = tabela;
+    return quantidade;
+}
+
+/**
+ * Lê, do arquivo auxiliar do ajuste, o nome da variante escolhida para uma árvore.
+ *
+ * @return Retorna true se o arquivo auxiliar está atualizado e tem a escolha.
+ */
+static bool lerEscolhaAjuste(const char *nomeArquivo, const char *arvore, char *nome, size_t tamanho) {
+    char caminho[300];
+    caminhoAjuste(nomeArquivo, caminho, sizeof(caminho));
+    if (!auxiliarAtualizado(nomeArquivo, caminho)) {
+        fprintf(stderr, "Nenhum ajuste atualizado para %s; execute \"pesquisa ajuste %s\".\n", nomeArquivo, nomeArquivo);
+        return false;
+    }
+
+    FILE *arquivo = fopen(caminho, "r");
+    if (!arquivo) {
+        perror("Erro ao abrir o ajuste");
+        return false;
+    }
+    char linha[128], lida[32], escolha[32];
+    bool encontrada = false;
+    while (!encontrada && fgets(linha, sizeof(linha), arquivo) != NULL) {
+        encontrada = sscanf(linha, "%31s %31s", lida, escolha) == 2 && strcmp(lida, arvore) == 0;
+    }
+    fclose(arquivo);
+
+    if (!encontrada) {
+        fprintf(stderr, "O ajuste de %s não tem escolha para %s.\n", nomeArquivo, arvore);
+        return false;
+    }
+    snprintf(nome, tamanho, "%s", escolha);
+    return true;
+}
+
+/**
+ * Escolhe uma variante da Árvore B pelo nome ou, com "auto", pela escolha gravada pelo ajuste.
+ *
+ * @param nomeArquivo Caminho do arquivo de registros.
+ * @param nome Tamanho do nó em bytes, "padrao" ou "auto".
+ * @return Variante escolhida ou NULL (com a mensagem de erro já impressa).
+ */
+const VarianteArvoreB* escolherVarianteArvoreB(const char *nomeArquivo, const char *nome) {
+    char escolha[32];
+    if (strcmp(nome, "auto") == 0) {
+        if (!lerEscolhaAjuste(nomeArquivo, "arvore_b", escolha, sizeof(escolha))) {
+            return NULL;
+        }
+        nome = escolha;
+    }
+
+    const VarianteArvoreB *variantes;
+    int quantidade = variantesArvoreB(&variantes);
+    for (int i = 0; i < quantidade; i++) {
+        if (strcmp(variantes[i].nome, nome) == 0) {
+            return &variantes[i];
+        }
+    }
+    fprintf(stderr, "Variante da Árvore B desconhecida: %s. Disponíveis:", nome);
+    for (int i = 0; i < quantidade; i++) {
+        fprintf(stderr, " %s", variantes[i].nome);
+    }
+    fprintf(stderr, ".\n");
+    return NULL;
+}
+
+/**
+ * Escolhe uma variante da árvore B* pelo nome ou, com "auto", pela escolha gravada pelo ajuste.
+ *
+ * @param nomeArquivo Caminho do arquivo de registros.
+ * @param nome Tamanho do nó em bytes, "padrao" ou "auto".
+ * @return Variante escolhida ou NULL (com a mensagem de erro já impressa).
+ */
+const VarianteArvoreBStar* escolherVarianteArvoreBStar(const char *nomeArquivo, const char *nome) {
+    char escolha[32];
+    if (strcmp(nome, "auto") == 0) {
+        if (!lerEscolhaAjuste(nomeArquivo, "arvore_bstar", escolha, sizeof(escolha))) {
+            return NULL;
+        }
+        nome = escolha;
+    }
+
+    const VarianteArvoreBStar *variantes;
+    int quantidade = variantesArvoreBStar(&variantes);
+    for (int i = 0; i < quantidade; i++) {
+        if (strcmp(variantes[i].nome, nome) == 0) {
+            return &variantes[i];
+        }
+    }
+    fprintf(stderr, "Variante da árvore B* desconhecida: %s. Disponíveis:", nome);
+    for (int i = 0; i < quantidade; i++) {
+        fprintf(stderr, " %s", variantes[i].nome);
+    }
+    fprintf(stderr, ".\n");
+    return NULL;
+}
+
+/**
+ * Monta a amostra: um registro válido a cada total/amostra posições, lidos em blocos
+ * sequenciais, de modo que a amostra conserva a ordem das chaves no arquivo. O arquivo é
+ * aberto com abrirArquivoDados, como nos métodos de pesquisa, para que -D valha também aqui.
+ */
+static Registro* montarAmostra(const char *nomeArquivo, long amostra, long **posicoes, long *tamanho) {
+    FILE *arquivo = abrirArquivoDados(nomeArquivo, "rb");
+    if (!arquivo) {
+        perror("Erro ao abrir o arquivo");
+        return NULL;
+    }
+    fseeko(arquivo, 0, SEEK_END);
+    long totalRegistros = ftello(arquivo) / sizeof(Registro);
+    fseeko(arquivo, 0, SEEK_SET);
+    long passo = totalRegistros > amostra ? totalRegistros / amostra : 1;
+
+    Registro *bloco = malloc(REGISTROS_BLOCO_AJUSTE * sizeof(Registro));
+    Registro *registros = malloc(amostra * sizeof(Registro));
+    *posicoes = malloc(amostra * sizeof(long));
+    if (!bloco || !registros || !*posicoes) {
+        perror("Erro ao alocar a amostra");
+        free(bloco);
+        free(registros);
+        free(*posicoes);
+        fclose(arquivo);
+        return NULL;
+    }
+
+    *tamanho = 0;
+    long posicao = 0;
+    size_t lidos;
+    while (*tamanho < amostra && (lidos = fread(bloco, sizeof(Registro), REGISTROS_BLOCO_AJUSTE, arquivo)) > 0) {
+        for (size_t i = 0; i < lidos && *tamanho < amostra; i++, posicao++) {
+            if (posicao % passo == 0 && registroValido(&bloco[i])) {
+                registros[*tamanho] = bloco[i];
+                (*posicoes)[(*tamanho)++] = posicao;
+            }
+        }
+    }
+    free(bloco);
+    fclose(arquivo);
+    return registros;
+}
+
+/**
+ * Imprime uma linha da tabela do ajuste.
+ */
+static void imprimirMedidaAjuste(
+    const char *nome,
+    int ordem,
+    size_t bytesNo,
+    const Metricas *metricas,
+    double construcao,
+    double busca,
+    long consultas
+) {
+    printf(
+        "  %-8s %6d %8zu %9" PRIu64 " %6" PRIu64 " %10.1f %12.1f %14.1f %12.1f\n",
+        nome,
+        ordem,
+        bytesNo,
+        metricas->numNos,
+        metricas->altura,
+        (double)metricas->numNos * bytesNo / (1 << 20),
+        construcao * 1e3,
+        busca * 1e9 / consultas,
+        (construcao + busca) * 1e3
+    );
+}
+
+/**
+ * Mede a construção e as buscas de cada variante das árvores B e B* sobre uma amostra do
+ * arquivo e grava, no arquivo auxiliar "<arquivo>.ajuste", a variante de menor tempo total
+ * (construção por inserções mais uma busca por chave da amostra) de cada árvore. A opção
+ * -N auto dos métodos 3 e 4 usa essa escolha.
+ *
+ * @param nomeArquivo Caminho do arquivo de registros.
+ * @param amostra Número máximo de registros da amostra.
+ * @return 0 em caso de sucesso ou 1 em caso de falha.
+ */
+int ajustarVariantes(const char *nomeArquivo, long amostra) {
+    long tamanho = 0;
+    long *posicoes = NULL;
+    Registro *registros = montarAmostra(nomeArquivo, amostra, &posicoes, &tamanho);
+    if (!registros) {
+        return 1;
+    }
+    Chave *consultas = malloc((tamanho > 0 ? tamanho : 1) * sizeof(Chave));
+    if (tamanho == 0 || !consultas) {
+        fprintf(stderr, "A amostra de %s não tem registros válidos.\n", nomeArquivo);
+        free(registros);
+        free(posicoes);
+        free(consultas);
+        return 1;
+    }
+    for (long i = 0; i < tamanho; i++) {
+        consultas[i] = registros[i].chave;
+    }
+    for (long i = tamanho - 1; i > 0; i--) {
+        long j = rand() % (i + 1);
+        Chave troca = consultas[i];
+        consultas[i] = consultas[j];
+        consultas[j] = troca;
+    }
+
+    printf("Ajuste de %s: amostra de %ld registros, melhor de %d repetições.\n", nomeArquivo, tamanho, REPETICOES_AJUSTE);
+    printf("  %-8s %6s %8s %9s %6s %10s %12s %14s %12s\n", "variante", "ordem", "bytes/nó", "nós", "altura", "MiB", "construção ms", "busca ns/cons.", "total ms");
+
+    const VarianteArvoreB *variantesB;
+    int numB = variantesArvoreB(&variantesB);
+    int escolhidaB = 0;
+    double melhorB = -1.0;
+    printf("Árvore B:\n");
+    for (int v = 0; v < numB; v++) {
+        double construcao = -1.0, busca = -1.0;
+        Metricas metricas;
+        for (int r = 0; r < REPETICOES_AJUSTE; r++) {
+            struct timespec inicio;
+            void *raiz = NULL;
+            memset(&metricas, 0, sizeof(metricas));
+            clock_gettime(CLOCK_MONOTONIC, &inicio);
+            for (long i = 0; i < tamanho; i++) {
+                raiz = variantesB[v].inserir(raiz, registros[i].chave, posicoes[i], &metricas);
+            }
+            double tempo = segundosDesde(&inicio);
+            construcao = construcao < 0.0 || tempo < construcao ? tempo : construcao;
+
+            long encontradas = 0;
+            clock_gettime(CLOCK_MONOTONIC, &inicio);
+            for (long i = 0; i < tamanho; i++) {
+                encontradas += variantesB[v].buscar(raiz, consultas[i], &metricas) != NULL;
+            }
+            tempo = segundosDesde(&inicio);
+            busca = busca < 0.0 || tempo < busca ? tempo : busca;
+            if (encontradas != tamanho) {
+                fprintf(stderr, "A variante %s achou %ld de %ld chaves.\n", variantesB[v].nome, encontradas, tamanho);
+            }
+            variantesB[v].medir(raiz, &metricas);
+            variantesB[v].destruir(raiz);
+        }
+        if (melhorB < 0.0 || construcao + busca < melhorB) {
+            melhorB = construcao + busca;
+            escolhidaB = v;
+        }
+        imprimirMedidaAjuste(variantesB[v].nome, variantesB[v].ordem, variantesB[v].bytesNo, &metricas, construcao, busca, tamanho);
+    }
+
+    const VarianteArvoreBStar *variantesBStar;
+    int numBStar = variantesArvoreBStar(&variantesBStar);
+    int escolhidaBStar = 0;
+    double melhorBStar = -1.0;
+    printf("Árvore B*:\n");
+    for (int v = 0; v < numBStar; v++) {
+        double construcao = -1.0, busca = -1.0;
+        Metricas metricas;
+        for (int r = 0; r < REPETICOES_AJUSTE; r++) {
+            struct timespec inicio;
+            void *raiz = NULL;
+            memset(&metricas, 0, sizeof(metricas));
+            clock_gettime(CLOCK_MONOTONIC, &inicio);
+            for (long i = 0; i < tamanho; i++) {
+                raiz = variantesBStar[v].inserir(raiz, registros[i], posicoes[i], &metricas);
+            }
+            double tempo = segundosDesde(&inicio);
+            construcao = construcao < 0.0 || tempo < construcao ? tempo : construcao;
+
+            long encontradas = 0;
+            clock_gettime(CLOCK_MONOTONIC, &inicio);
+            for (long i = 0; i < tamanho; i++) {
+                encontradas += variantesBStar[v].buscar(raiz, consultas[i], NULL, &metricas) != NULL;
+            }
+            tempo = segundosDesde(&inicio);
+            busca = busca < 0.0 || tempo < busca ? tempo : busca;
+            if (encontradas != tamanho) {
+                fprintf(stderr, "A variante %s achou %ld de %ld chaves.\n", variantesBStar[v].nome, encontradas, tamanho);
+            }
+            variantesBStar[v].medir(raiz, &metricas);
+            variantesBStar[v].destruir(raiz);
+        }
+        if (melhorBStar < 0.0 || construcao + busca < melhorBStar) {
+            melhorBStar = construcao + busca;
+            escolhidaBStar = v;
+        }
+        imprimirMedidaAjuste(variantesBStar[v].nome, variantesBStar[v].ordem, variantesBStar[v].bytesNo, &metricas, construcao, busca, tamanho);
+    }
+
+    free(registros);
+    free(posicoes);
+    free(consultas);
+
+    char caminho[300];
+    caminhoAjuste(nomeArquivo, caminho, sizeof(caminho));
+    FILE *arquivo = fopen(caminho, "w");
+    if (!arquivo) {
+        perror("Erro ao gravar o ajuste");
+        return 1;
+    }
+    fprintf(arquivo, "# Ajuste de %s com amostra de %ld registros\n", nomeArquivo, tamanho);
+    fprintf(arquivo, "arvore_b %s\n", variantesB[escolhidaB].nome);
+    fprintf(arquivo, "arvore_bstar %s\n", variantesBStar[escolhidaBStar].nome);
+    if (fclose(arquivo) != 0) {
+        perror("Erro ao gravar o ajuste");
+        return 1;
+    }
+
+    printf(
+        "Escolhas gravadas em %s: Árvore B %s e árvore B* %s (use -N auto nos métodos 3 e 4).\n",
+        caminho,
+        variantesB[escolhidaB].nome,
+        variantesBStar[escolhidaBStar].nome
+    );
+    return 0;
+}
@@ -0,0 +1,28 @@
+#ifndef AJUSTE_H
+#define AJUSTE_H
+
+#include "../arvoreb/arvoreb.h"
+#include "../arvorebstar/arvorebstar.h"
+
+#define AMOSTRA_AJUSTE 200000 // Registros da amostra medida pelo ajuste, se outra não for pedida
+#define REPETICOES_AJUSTE 3 // Repetições de cada medida; vale a mais rápida
+
+/*
+ * Tamanhos de nó compilados como variantes das árvores B e B*, na forma X(bytes). O Makefile
+ * os define a partir de BYTES_ARVORE_B e BYTES_ARVORE_BSTAR, as mesmas listas que compilam os
+ * objetos das variantes; sem eles, só a ordem padrão fica disponível.
+ */
+#ifndef TAMANHOS_ARVORE_B
+#define TAMANHOS_ARVORE_B(X)
+#endif
+#ifndef TAMANHOS_ARVORE_BSTAR
+#define TAMANHOS_ARVORE_BSTAR(X)
+#endif
+
+int variantesArvoreB(const VarianteArvoreB **variantes);
+int variantesArvoreBStar(const VarianteArvoreBStar **variantes);
+const VarianteArvoreB* escolherVarianteArvoreB(const char *nomeArquivo, const char *nome);
+const VarianteArvoreBStar* escolherVarianteArvoreBStar(const char *nomeArquivo, const char *nome);
+int ajustarVariantes(const char *nomeArquivo, long amostra);
+
+#endif // AJUSTE_H
@@ -1,11 +1,13 @@
 #include "arvore.h"
+#include "../es/es.h"
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
 #include <time.h>
 
-int lerNoArquivo(FILE *arquivo, long posicao, NoArvore *no, int *transferencias) {
-    if (fseek(arquivo, posicao * sizeof(NoArvore), SEEK_SET) != 0) {
+int lerNoArquivo(FILE *arquivo, long posicao, NoArvore *no, Metricas *metricas) {
+    registrarPosicionamento(metricas);
+    if (fseeko(arquivo, (off_t)posicao * (off_t)sizeof(NoArvore), SEEK_SET) != 0) {
         perror("Erro ao posicionar o ponteiro do arquivo para leitura");
         return -1;
     }
@@ -13,12 +15,13 @@ int lerNoArquivo(FILE *arquivo, long posicao, NoArvore *no, int *transferencias)
         perror("Erro ao ler nó do arquivo");
         return -1;
     }
-    (*transferencias)++;
+    registrarLeitura(metricas, sizeof(NoArvore));
     return 0;
 }
 
-int escreverNoArquivo(FILE *arquivo, long posicao, NoArvore *no) {
-    if (fseek(arquivo, posicao * sizeof(NoArvore), SEEK_SET) != 0) {
+int escreverNoArquivo(FILE *arquivo, long posicao, NoArvore *no, Metricas *metricas) {
+    registrarPosicionamento(metricas);
+    if (fseeko(arquivo, (off_t)posicao * (off_t)sizeof(NoArvore), SEEK_SET) != 0) {
         perror("Erro ao posicionar o ponteiro do arquivo para escrita");
         return -1;
     }
@@ -26,6 +29,7 @@ int escreverNoArquivo(FILE *arquivo, long posicao, NoArvore *no) {
         perror("Erro ao escrever nó no arquivo");
         return -1;
     }
+    registrarEscrita(metricas, sizeof(NoArvore));
     return 0;
 }
 
@@ -35,8 +39,8 @@ void exibirArvoreInOrder(FILE *arquivo, long posicaoRaiz, int nivel) {
     }
 
     NoArvore no;
-    int transferencias = 0;
-    if (lerNoArquivo(arquivo, posicaoRaiz, &no, &transferencias) == -1) {
+    Metricas metricas = {0};
+    if (lerNoArquivo(arquivo, posicaoRaiz, &no, &metricas) == -1) {
         printf("Erro ao ler nó na posição %ld.\n", posicaoRaiz);
         return;
     }
@@ -48,7 +52,7 @@ void exibirArvoreInOrder(FILE *arquivo, long posicaoRaiz, int nivel) {
     for (int i = 0; i < nivel; i++) {
         printf("   "); // Indentação para visualizar a estrutura da árvore
     }
-    printf("%d\n", no.chave);
+    printf("%" FORMATO_CHAVE "\n", no.chave);
 
     // Exibe o filho direito
     exibirArvoreInOrder(arquivo, no.direita, nivel + 1);
@@ -58,13 +62,13 @@ void exibirArvore(FILE *arquivo, long posicaoRaiz) {
     exibirArvoreInOrder(arquivo, posicaoRaiz, 0);
 }
 
-void construirArvoreBinaria(FILE *arquivoEntrada, int *transferencias, int *comparacoes, long *posicaoRaiz) {
+void construirArvoreBinaria(FILE *arquivoEntrada, Metricas *metricas, long *posicaoRaiz) {
     if (!arquivoEntrada) {
         perror("Arquivo de entrada inválido");
         return;
     }
 
-    FILE *arquivoArvore = fopen("src/arvore/arvore.bin", "wb+");
+    FILE *arquivoArvore = abrirArquivoDados("src/arvore/arvore.bin", "wb+");
     if (!arquivoArvore) {
         perror("Erro ao criar o arquivo da árvore");
         return;
@@ -74,12 +78,22 @@ void construirArvoreBinaria(FILE *arquivoEntrada, int *transferencias, int *comp
     *posicaoRaiz = -1;
     long contadorNos = 0;
 
-    while (lerRegistro(arquivoEntrada, contadorNos, &reg, transferencias)) {
-        *posicaoRaiz = inserirNoArvore(arquivoArvore, *posicaoRaiz, reg.chave, contadorNos, transferencias, comparacoes);
+    while (lerRegistro(arquivoEntrada, contadorNos, &reg, metricas)) {
+        if (!registroValido(&reg)) {
+            contadorNos++;
+            continue; // Posição removida, não entra na árvore
+        }
+        // A profundidade do novo nó é o número de comparações feitas na descida mais um
+        uint64_t comparacoesAntes = metricas->comparacoes;
+        *posicaoRaiz = inserirNoArvore(arquivoArvore, *posicaoRaiz, reg.chave, contadorNos, metricas);
         if (*posicaoRaiz == -1) {
-            printf("Erro ao inserir chave %d na árvore.\n", reg.chave);
+            printf("Erro ao inserir chave %" FORMATO_CHAVE " na árvore.\n", reg.chave);
             break;
         }
+        if (metricas->comparacoes - comparacoesAntes + 1 > metricas->altura) {
+            metricas->altura = metricas->comparacoes - comparacoesAntes + 1;
+        }
+        metricas->numNos++;
         contadorNos++;
     }
 
@@ -87,7 +101,7 @@ void construirArvoreBinaria(FILE *arquivoEntrada, int *transferencias, int *comp
 }
 
 
-long inserirNoArvore(FILE *arquivo, long posicaoRaiz, int chave, long contadorNos, int *transferencias, int *comparacoes) {
+long inserirNoArvore(FILE *arquivo, long posicaoRaiz, Chave chave, long contadorNos, Metricas *metricas) {
     NoArvore no;
 
     if (posicaoRaiz == -1) {
@@ -97,54 +111,93 @@ long inserirNoArvore(FILE *arquivo, long posicaoRaiz, int chave, long contadorNo
         no.direita = -1;
 
         long novaPosicao = contadorNos * sizeof(NoArvore);
-        if (escreverNoArquivo(arquivo, novaPosicao, &no) == -1) return -1;
+        if (escreverNoArquivo(arquivo, novaPosicao, &no, metricas) == -1) return -1;
         return novaPosicao;
     }
 
-    if (lerNoArquivo(arquivo, posicaoRaiz, &no, transferencias) == -1) {
+    if (lerNoArquivo(arquivo, posicaoRaiz, &no, metricas) == -1) {
         printf("Erro ao ler nó na posição %ld.\n", posicaoRaiz);
         return -1;
     }
 
-    (*comparacoes)++;
+    metricas->comparacoes++;
     if (chave < no.chave) {
-        long novaPosicaoEsquerda = inserirNoArvore(arquivo, no.esquerda, chave, contadorNos, transferencias, comparacoes);
+        long novaPosicaoEsquerda = inserirNoArvore(arquivo, no.esquerda, chave, contadorNos, metricas);
         if (novaPosicaoEsquerda == -1) return -1;
         if (no.esquerda != novaPosicaoEsquerda) {
             no.esquerda = novaPosicaoEsquerda;
-            if (escreverNoArquivo(arquivo, posicaoRaiz, &no) == -1) return -1;
+            if (escreverNoArquivo(arquivo, posicaoRaiz, &no, metricas) == -1) return -1;
         }
-    } else if (chave > no.chave) {
-        long novaPosicaoDireita = inserirNoArvore(arquivo, no.direita, chave, contadorNos, transferencias, comparacoes);
+    } else {
+        // Chaves repetidas seguem pela direita, depois das ocorrências já inseridas
+        long novaPosicaoDireita = inserirNoArvore(arquivo, no.direita, chave, contadorNos, metricas);
         if (novaPosicaoDireita == -1) return -1;
         if (no.direita != novaPosicaoDireita) {
             no.direita = novaPosicaoDireita;
-            if (escreverNoArquivo(arquivo, posicaoRaiz, &no) == -1) return -1;
+            if (escreverNoArquivo(arquivo, posicaoRaiz, &no, metricas) == -1) return -1;
         }
     }
 
     return posicaoRaiz;
 }
 
-long buscarNoArvore(FILE *arquivo, long posicaoRaiz, int chave, int *transferencias, int *comparacoes) {
+long buscarNoArvore(FILE *arquivo, long posicaoRaiz, Chave chave, Metricas *metricas) {
     NoArvore no;
 
     if (posicaoRaiz == -1) {
         return -1;
     }
 
-    if (lerNoArquivo(arquivo, posicaoRaiz, &no, transferencias) == -1) {
+    if (lerNoArquivo(arquivo, posicaoRaiz, &no, metricas) == -1) {
         printf("Erro ao ler nó na posição %ld durante a busca.\n", posicaoRaiz);
         return -1;
     }
 
-    (*comparacoes)++;
+    metricas->comparacoes++;
     if (chave == no.chave) {
         return no.posicao; 
     } else if (chave < no.chave) {
-        return buscarNoArvore(arquivo, no.esquerda, chave, transferencias, comparacoes);
+        return buscarNoArvore(arquivo, no.esquerda, chave, metricas);
     } else {
-        return buscarNoArvore(arquivo, no.direita, chave, transferencias, comparacoes);
+        return buscarNoArvore(arquivo, no.direita, chave, metricas);
     }
 }
 
+/**
+ * Busca todas as ocorrências de uma chave na árvore binária em uma única descida. Como as
+ * chaves repetidas são inseridas pela direita, a próxima ocorrência está sempre na subárvore
+ * direita da anterior, no caminho da mesma busca.
+ *
+ * @param arquivo Ponteiro para o arquivo da árvore.
+ * @param posicaoRaiz Posição da raiz no arquivo da árvore.
+ * @param chave Chave a ser buscada.
+ * @param posicoes Vetor onde as posições dos registros serão armazenadas, até o limite.
+ * @param limite Tamanho do vetor de posições.
+ * @param metricas Ponteiro para as métricas da fase em andamento.
+ * @return Número de ocorrências da chave, que pode passar do limite (-1 em caso de erro).
+ */
+int buscarTodosArvore(FILE *arquivo, long posicaoRaiz, Chave chave, long *posicoes, int limite, Metricas *metricas) {
+    NoArvore no;
+    int encontradas = 0;
+
+    while (posicaoRaiz != -1) {
+        if (lerNoArquivo(arquivo, posicaoRaiz, &no, metricas) == -1) {
+            printf("Erro ao ler nó na posição %ld durante a busca.\n", posicaoRaiz);
+            return -1;
+        }
+
+        metricas->comparacoes++;
+        if (chave == no.chave) {
+            if (encontradas < limite) {
+                posicoes[encontradas] = no.posicao;
+            }
+            encontradas++;
+            posicaoRaiz = no.direita;
+        } else if (chave < no.chave) {
+            posicaoRaiz = no.esquerda;
+        } else {
+            posicaoRaiz = no.direita;
+        }
+    }
+    return encontradas;
+}
@@ -5,15 +5,16 @@
 #include <stdio.h>
 
 typedef struct NoArvore {
-    int chave; // Chave do registro
+    Chave chave; // Chave do registro
     long posicao; // Posição do registro no armazenamento externo
     long esquerda; // Posição do filho esquerdo no arquivo
     long direita; // Posição do filho direito no arquivo
 } NoArvore;
 
-long inserirNoArvore(FILE *arquivo, long posicaoRaiz, int chave, long contadorNos, int *transferencias, int *comparacoes);
-long buscarNoArvore(FILE *arquivo, long posicaoRaiz, int chave, int *transferencias, int *comparacoes);
-void construirArvoreBinaria(FILE *arquivoEntrada, int *transferencias, int *comparacoes, long *posicaoRaiz);
+long inserirNoArvore(FILE *arquivo, long posicaoRaiz, Chave chave, long contadorNos, Metricas *metricas);
+long buscarNoArvore(FILE *arquivo, long posicaoRaiz, Chave chave, Metricas *metricas);
+int buscarTodosArvore(FILE *arquivo, long posicaoRaiz, Chave chave, long *posicoes, int limite, Metricas *metricas);
+void construirArvoreBinaria(FILE *arquivoEntrada, Metricas *metricas, long *posicaoRaiz);
 void exibirArvore(FILE *arquivo, long posicaoRaiz);
 
 #endif // ARVORE_H
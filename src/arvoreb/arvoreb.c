@@ -1,6 +1,7 @@
 #include "arvoreb.h"
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 /**
  * Cria um novo nó para uma Árvore B.
@@ -31,9 +32,11 @@ NoArvoreB* criarNoArvoreB() {
  * @param i Índice no nó pai onde o novo nó será inserido.
  * @param no Ponteiro para o nó pai onde a divisão ocorrerá.
  * @param noFilho Ponteiro para o nó que será dividido.
+ * @param metricas Ponteiro para as métricas da fase em andamento.
  */
-void dividirNo(int i, NoArvoreB *no, NoArvoreB *noFilho) {
+void dividirNo(int i, NoArvoreB *no, NoArvoreB *noFilho, Metricas *metricas) {
     NoArvoreB *novoNo = criarNoArvoreB();
+    metricas->divisoes++;
     novoNo->folha = noFilho->folha;
     const int pontoMedio = ORDEM_ARVORE_B / 2;
 
@@ -75,6 +78,16 @@ void dividirNo(int i, NoArvoreB *no, NoArvoreB *noFilho) {
     no->numChaves++;
 }
 
+/**
+ * Ordena as entradas pela chave e, entre chaves repetidas, pela posição do registro, de modo
+ * que todas as ocorrências de uma chave fiquem juntas e na ordem do arquivo.
+ *
+ * @return Retorna true se a entrada (chave, posicao) vem antes da entrada dada.
+ */
+static inline bool antesDaEntrada(Chave chave, long posicao, const Entrada *entrada) {
+    return chave < entrada->chave || (chave == entrada->chave && posicao < entrada->posicao);
+}
+
 /**
  * Insere uma chave em um nó da Árvore B que não está cheio.
  *
@@ -86,48 +99,46 @@ void dividirNo(int i, NoArvoreB *no, NoArvoreB *noFilho) {
  * @param no Ponteiro para o nó onde a chave será inserida.
  * @param chave Chave a ser inserida.
  * @param posicao Posição do registro no armazenamento externo.
- * @param transferencias Ponteiro para contagem de transferências na árvore.
- * @param comparacoes Ponteiro para contagem de comparações realizadas.
+ * @param metricas Ponteiro para as métricas da fase em andamento.
  */
-void inserirNoNaoCheio(NoArvoreB *no, int chave, long posicao, int *transferencias, int *comparacoes) {
+void inserirNoNaoCheio(NoArvoreB *no, Chave chave, long posicao, Metricas *metricas) {
     int i = no->numChaves - 1;
 
     // Verifica se o nó é uma folha
     if (no->folha) {
         // Enquanto houver chaves maiores e estamos dentro dos limites do nó atual
-        while (i >= 0 && chave < no->entradas[i].chave) {
+        while (i >= 0 && antesDaEntrada(chave, posicao, &no->entradas[i])) {
             // Desloca as chaves maiores para a direita para abrir espaço
             no->entradas[i + 1] = no->entradas[i];
             i--;
-            (*comparacoes)++;  // Incrementa a contagem de comparações
+            metricas->comparacoes++;  // Incrementa a contagem de comparações
         }
 
         // Insere a chave na posição correta
         no->entradas[i + 1].chave = chave;
         no->entradas[i + 1].posicao = posicao;
         no->numChaves++;  // Incrementa o número de chaves no nó
-        (*transferencias)++;  // Incrementa a contagem de transferências de dados
     } else {
         // Se o nó não for uma folha, determina o filho apropriado para inserção
-        while (i >= 0 && chave < no->entradas[i].chave) {
+        while (i >= 0 && antesDaEntrada(chave, posicao, &no->entradas[i])) {
             i--;
-            (*comparacoes)++;  // Incrementa a contagem de comparações
+            metricas->comparacoes++;  // Incrementa a contagem de comparações
         }
         i++;
 
         // Verifica se o filho onde a chave será inserida está cheio
         if (no->filhos[i]->numChaves == ORDEM_ARVORE_B - 1) {
             // Se o filho estiver cheio, divide o filho
-            dividirNo(i, no, no->filhos[i]);
+            dividirNo(i, no, no->filhos[i], metricas);
 
             // Após a divisão, a chave deve ser inserida no filho certo
-            if (chave > no->entradas[i].chave) {
+            if (!antesDaEntrada(chave, posicao, &no->entradas[i])) {
                 i++;
             }
         }
 
         // Chama recursivamente a função para inserir a chave no filho apropriado
-        inserirNoNaoCheio(no->filhos[i], chave, posicao, transferencias, comparacoes);
+        inserirNoNaoCheio(no->filhos[i], chave, posicao, metricas);
     }
 }
 
@@ -141,11 +152,10 @@ void inserirNoNaoCheio(NoArvoreB *no, int chave, long posicao, int *transferenci
  * @param raiz Ponteiro para a raiz da Árvore B.
  * @param chave Chave a ser inserida.
  * @param posicao Posição do registro no armazenamento externo.
- * @param transferencias Ponteiro para contagem de transferências na árvore.
- * @param comparacoes Ponteiro para contagem de comparações realizadas.
+ * @param metricas Ponteiro para as métricas da fase em andamento.
  * @return Ponteiro para a raiz atualizada da Árvore B.
  */
-NoArvoreB* inserirNoArvoreB(NoArvoreB *raiz, int chave, long posicao, int *transferencias, int *comparacoes) {
+NoArvoreB* inserirNoArvoreB(NoArvoreB *raiz, Chave chave, long posicao, Metricas *metricas) {
     // Verifica se a raiz é nula (árvore vazia)
     if (raiz == NULL) {
         // Cria uma nova raiz e insere a chave nela
@@ -162,20 +172,20 @@ NoArvoreB* inserirNoArvoreB(NoArvoreB *raiz, int chave, long posicao, int *trans
             novaRaiz->filhos[0] = raiz;
 
             // Divide a raiz antiga e atualiza a raiz global
-            dividirNo(0, novaRaiz, raiz);
-            (*comparacoes)++;  // Incrementa a contagem de comparações
+            dividirNo(0, novaRaiz, raiz, metricas);
+            metricas->comparacoes++;  // Incrementa a contagem de comparações
 
             // Determina em qual filho inserir a chave
-            if (chave > novaRaiz->entradas[0].chave) {
-                inserirNoNaoCheio(novaRaiz->filhos[1], chave, posicao, transferencias, comparacoes);
+            if (!antesDaEntrada(chave, posicao, &novaRaiz->entradas[0])) {
+                inserirNoNaoCheio(novaRaiz->filhos[1], chave, posicao, metricas);
             } else {
-                inserirNoNaoCheio(novaRaiz->filhos[0], chave, posicao, transferencias, comparacoes);
+                inserirNoNaoCheio(novaRaiz->filhos[0], chave, posicao, metricas);
             }
 
             raiz = novaRaiz;  // Atualize a raiz global para a nova raiz
         } else {
             // Se a raiz não estiver cheia, chama a função para inserir no nó não cheio
-            inserirNoNaoCheio(raiz, chave, posicao, transferencias, comparacoes);
+            inserirNoNaoCheio(raiz, chave, posicao, metricas);
         }
     }
 
@@ -192,11 +202,10 @@ NoArvoreB* inserirNoArvoreB(NoArvoreB *raiz, int chave, long posicao, int *trans
  *
  * @param raiz Ponteiro para a raiz da Árvore B onde a busca será realizada.
  * @param chave Chave a ser buscada.
- * @param transferencias Ponteiro para contagem de transferências na árvore.
- * @param comparacoes Ponteiro para contagem de comparações realizadas.
+ * @param metricas Ponteiro para as métricas da fase em andamento.
  * @return Ponteiro para a entrada encontrada ou NULL se a chave não for encontrada.
  */
-Entrada* buscarNoArvoreB(NoArvoreB *raiz, int chave, int *transferencias, int *comparacoes) {
+Entrada* buscarNoArvoreB(NoArvoreB *raiz, Chave chave, Metricas *metricas) {
     // Verifica se a árvore está vazia (raiz == NULL)
     if (raiz == NULL) {
         return NULL;
@@ -206,12 +215,12 @@ Entrada* buscarNoArvoreB(NoArvoreB *raiz, int chave, int *transferencias, int *c
     // Encontra a posição onde a chave deve estar no nó
     while (i < raiz->numChaves && chave > raiz->entradas[i].chave) {
         i++;
-        (*comparacoes)++;  // Incrementa a contagem de comparações
+        metricas->comparacoes++;  // Incrementa a contagem de comparações
     }
 
     // Verifica se a chave foi encontrada no nó atual
     if (i < raiz->numChaves && chave == raiz->entradas[i].chave) {
-        (*comparacoes)++;  // Incrementa a contagem de comparações
+        metricas->comparacoes++;  // Incrementa a contagem de comparações
         return &raiz->entradas[i];  // Retorna um ponteiro para a entrada encontrada
     }
 
@@ -220,7 +229,482 @@ Entrada* buscarNoArvoreB(NoArvoreB *raiz, int chave, int *transferencias, int *c
         return NULL;
     }
 
-    return buscarNoArvoreB(raiz->filhos[i], chave, transferencias, comparacoes);  // Recursivamente busca nos filhos
+    return buscarNoArvoreB(raiz->filhos[i], chave, metricas);  // Recursivamente busca nos filhos
+}
+
+/**
+ * Busca todas as ocorrências de uma chave na Árvore B em uma única descida.
+ *
+ * As ocorrências ficam juntas na ordem das entradas: em cada nó, a busca desce só pelos
+ * filhos vizinhos das entradas com a chave (e pelo filho antes da primeira delas), que são
+ * as únicas subárvores onde outras ocorrências podem estar.
+ *
+ * @param raiz Ponteiro para a raiz da Árvore B.
+ * @param chave Chave a ser buscada.
+ * @param posicoes Vetor onde as posições das ocorrências serão armazenadas, até o limite.
+ * @param limite Tamanho do vetor de posições.
+ * @param metricas Ponteiro para as métricas da fase em andamento.
+ * @return Número de ocorrências da chave, que pode passar do limite.
+ */
+int buscarTodosArvoreB(NoArvoreB *raiz, Chave chave, long *posicoes, int limite, Metricas *metricas) {
+    if (raiz == NULL) {
+        return 0;
+    }
+
+    int i = 0;
+    while (i < raiz->numChaves && chave > raiz->entradas[i].chave) {
+        i++;
+        metricas->comparacoes++;
+    }
+
+    int encontradas = 0;
+    while (true) {
+        if (!raiz->folha) {
+            encontradas += buscarTodosArvoreB(raiz->filhos[i], chave, posicoes + encontradas, limite > encontradas ? limite - encontradas : 0, metricas);
+        }
+        if (i == raiz->numChaves) {
+            break;
+        }
+        metricas->comparacoes++;
+        if (raiz->entradas[i].chave != chave) {
+            break;
+        }
+        if (encontradas < limite) {
+            posicoes[encontradas] = raiz->entradas[i].posicao;
+        }
+        encontradas++;
+        i++;
+    }
+    return encontradas;
+}
+
+/**
+ * Pede ao processador as linhas de cache do nó que a busca lê primeiro: o contador e o início
+ * das entradas, que são percorridas em ordem. O número de linhas vem do tamanho do nó, até
+ * LINHAS_ANTECIPADAS_ARVORE_B; em nós maiores, a leitura sequencial das entradas aciona a
+ * antecipação do próprio processador para o restante.
+ */
+static void anteciparNoArvoreB(const NoArvoreB *no) {
+    size_t bytes = offsetof(NoArvoreB, entradas) + sizeof(no->entradas);
+    if (bytes > LINHAS_ANTECIPADAS_ARVORE_B * LINHA_CACHE_ARVORE_B) {
+        bytes = LINHAS_ANTECIPADAS_ARVORE_B * LINHA_CACHE_ARVORE_B;
+    }
+    for (size_t deslocamento = 0; deslocamento < bytes; deslocamento += LINHA_CACHE_ARVORE_B) {
+        __builtin_prefetch((const char *)no + deslocamento);
+    }
+}
+
+/**
+ * Busca um lote de chaves na Árvore B, descendo um grupo de consultas por vez em conjunto.
+ *
+ * Cada consulta do grupo avança um nível e pede ao processador o próximo nó com
+ * __builtin_prefetch antes de a função passar à consulta seguinte. Quando o grupo volta à
+ * primeira consulta, seu nó já está a caminho do cache, e a espera pela memória de uma
+ * consulta se sobrepõe ao trabalho das outras. O resultado e as comparações contadas são
+ * os mesmos de chamar buscarNoArvoreB para cada chave.
+ *
+ * @param raiz Ponteiro para a raiz da Árvore B.
+ * @param chaves Chaves a serem buscadas.
+ * @param quantidade Número de chaves do lote.
+ * @param resultados Vetor onde a entrada de cada chave (ou NULL) será armazenada.
+ * @param metricas Ponteiro para as métricas da fase em andamento.
+ */
+void buscarLoteArvoreB(NoArvoreB *raiz, const Chave *chaves, int quantidade, Entrada **resultados, Metricas *metricas) {
+    NoArvoreB *nos[GRUPO_LOTE_ARVORE_B]; // Próximo nó de cada consulta do grupo, ou NULL se terminou
+
+    for (int inicio = 0; inicio < quantidade; inicio += GRUPO_LOTE_ARVORE_B) {
+        int tamanho = quantidade - inicio < GRUPO_LOTE_ARVORE_B ? quantidade - inicio : GRUPO_LOTE_ARVORE_B;
+        int ativas = raiz != NULL ? tamanho : 0;
+        for (int j = 0; j < tamanho; j++) {
+            resultados[inicio + j] = NULL;
+            nos[j] = raiz;
+        }
+
+        while (ativas > 0) {
+            for (int j = 0; j < tamanho; j++) {
+                NoArvoreB *no = nos[j];
+                if (no == NULL) {
+                    continue;
+                }
+
+                Chave chave = chaves[inicio + j];
+                int i = 0;
+                while (i < no->numChaves && chave > no->entradas[i].chave) {
+                    i++;
+                    metricas->comparacoes++;
+                }
+
+                if (i < no->numChaves && chave == no->entradas[i].chave) {
+                    metricas->comparacoes++;
+                    resultados[inicio + j] = &no->entradas[i];
+                    nos[j] = NULL;
+                    ativas--;
+                } else if (no->folha) {
+                    nos[j] = NULL;
+                    ativas--;
+                } else {
+                    nos[j] = no->filhos[i];
+                    anteciparNoArvoreB(nos[j]);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Junta dois filhos adjacentes de um nó da Árvore B.
+ *
+ * A entrada separadora do nó pai desce para o filho da esquerda, que recebe também todas
+ * as entradas e filhos do irmão da direita. O irmão da direita é liberado e o nó pai perde
+ * uma entrada.
+ *
+ * @param no Ponteiro para o nó pai.
+ * @param i Índice do filho da esquerda no nó pai.
+ */
+static void juntarFilhos(NoArvoreB *no, int i) {
+    NoArvoreB *esquerdo = no->filhos[i];
+    NoArvoreB *direito = no->filhos[i + 1];
+
+    // A entrada separadora desce para o final do filho da esquerda
+    esquerdo->entradas[esquerdo->numChaves] = no->entradas[i];
+
+    for (int j = 0; j < direito->numChaves; j++) {
+        esquerdo->entradas[esquerdo->numChaves + 1 + j] = direito->entradas[j];
+    }
+    if (!esquerdo->folha) {
+        for (int j = 0; j <= direito->numChaves; j++) {
+            esquerdo->filhos[esquerdo->numChaves + 1 + j] = direito->filhos[j];
+        }
+    }
+    esquerdo->numChaves += direito->numChaves + 1;
+
+    // Fecha o espaço deixado no nó pai
+    for (int j = i; j < no->numChaves - 1; j++) {
+        no->entradas[j] = no->entradas[j + 1];
+        no->filhos[j + 1] = no->filhos[j + 2];
+    }
+    no->numChaves--;
+
+    free(direito);
+}
+
+/**
+ * Move uma entrada do irmão da esquerda para o filho i, passando pelo nó pai.
+ *
+ * @param no Ponteiro para o nó pai.
+ * @param i Índice do filho que receberá a entrada.
+ */
+static void emprestarDoIrmaoEsquerdo(NoArvoreB *no, int i) {
+    NoArvoreB *filho = no->filhos[i];
+    NoArvoreB *irmao = no->filhos[i - 1];
+
+    for (int j = filho->numChaves - 1; j >= 0; j--) {
+        filho->entradas[j + 1] = filho->entradas[j];
+    }
+    if (!filho->folha) {
+        for (int j = filho->numChaves; j >= 0; j--) {
+            filho->filhos[j + 1] = filho->filhos[j];
+        }
+        filho->filhos[0] = irmao->filhos[irmao->numChaves];
+    }
+
+    filho->entradas[0] = no->entradas[i - 1];
+    no->entradas[i - 1] = irmao->entradas[irmao->numChaves - 1];
+
+    filho->numChaves++;
+    irmao->numChaves--;
+}
+
+/**
+ * Move uma entrada do irmão da direita para o filho i, passando pelo nó pai.
+ *
+ * @param no Ponteiro para o nó pai.
+ * @param i Índice do filho que receberá a entrada.
+ */
+static void emprestarDoIrmaoDireito(NoArvoreB *no, int i) {
+    NoArvoreB *filho = no->filhos[i];
+    NoArvoreB *irmao = no->filhos[i + 1];
+
+    filho->entradas[filho->numChaves] = no->entradas[i];
+    if (!filho->folha) {
+        filho->filhos[filho->numChaves + 1] = irmao->filhos[0];
+    }
+    no->entradas[i] = irmao->entradas[0];
+
+    for (int j = 0; j < irmao->numChaves - 1; j++) {
+        irmao->entradas[j] = irmao->entradas[j + 1];
+    }
+    if (!irmao->folha) {
+        for (int j = 0; j < irmao->numChaves; j++) {
+            irmao->filhos[j] = irmao->filhos[j + 1];
+        }
+    }
+
+    filho->numChaves++;
+    irmao->numChaves--;
+}
+
+/**
+ * Garante que o filho i de um nó tenha mais que o número mínimo de chaves antes da descida.
+ *
+ * Se o filho estiver no mínimo, tenta emprestar uma entrada de um irmão adjacente. Se nenhum
+ * irmão puder emprestar, o filho é juntado a um deles.
+ *
+ * @param no Ponteiro para o nó pai.
+ * @param i Índice do filho por onde a remoção vai descer.
+ * @return Índice do filho por onde a remoção deve continuar após o ajuste.
+ */
+static int garantirFolga(NoArvoreB *no, int i) {
+    if (no->filhos[i]->numChaves > MINIMO_CHAVES_ARVORE_B) {
+        return i;
+    }
+
+    if (i > 0 && no->filhos[i - 1]->numChaves > MINIMO_CHAVES_ARVORE_B) {
+        emprestarDoIrmaoEsquerdo(no, i);
+    } else if (i < no->numChaves && no->filhos[i + 1]->numChaves > MINIMO_CHAVES_ARVORE_B) {
+        emprestarDoIrmaoDireito(no, i);
+    } else if (i < no->numChaves) {
+        juntarFilhos(no, i);
+    } else {
+        juntarFilhos(no, i - 1);
+        i--;
+    }
+    return i;
+}
+
+/**
+ * Remove a maior ou a menor entrada de uma subárvore.
+ *
+ * Usada para obter o antecessor ou o sucessor de uma entrada de um nó interno, que então
+ * ocupa o lugar da entrada removida.
+ *
+ * @param no Ponteiro para a raiz da subárvore, que deve ter mais que o mínimo de chaves.
+ * @param maior Indica se a maior (true) ou a menor (false) entrada deve ser removida.
+ * @param removida Ponteiro onde a entrada removida será armazenada.
+ */
+static void removerExtremo(NoArvoreB *no, bool maior, Entrada *removida) {
+    if (no->folha) {
+        if (maior) {
+            *removida = no->entradas[no->numChaves - 1];
+        } else {
+            *removida = no->entradas[0];
+            for (int j = 0; j < no->numChaves - 1; j++) {
+                no->entradas[j] = no->entradas[j + 1];
+            }
+        }
+        no->numChaves--;
+        return;
+    }
+
+    int i = garantirFolga(no, maior ? no->numChaves : 0);
+    removerExtremo(no->filhos[i], maior, removida);
+}
+
+/**
+ * Remove uma entrada com a chave informada da subárvore enraizada em um nó.
+ *
+ * A remoção desce a árvore uma única vez, garantindo que cada nó visitado (exceto a raiz)
+ * tenha mais que o mínimo de chaves, de modo que a retirada de uma entrada nunca deixe
+ * um nó abaixo do mínimo.
+ *
+ * @param no Ponteiro para o nó atual.
+ * @param chave Chave a ser removida.
+ * @param removida Ponteiro onde a entrada removida será armazenada.
+ * @param metricas Ponteiro para as métricas da fase em andamento.
+ * @return Retorna true se alguma entrada com a chave foi removida.
+ */
+static bool removerRecursivo(NoArvoreB *no, Chave chave, Entrada *removida, Metricas *metricas) {
+    int i = 0;
+    while (i < no->numChaves && chave > no->entradas[i].chave) {
+        i++;
+        metricas->comparacoes++;
+    }
+
+    if (i < no->numChaves && chave == no->entradas[i].chave) {
+        metricas->comparacoes++;
+
+        if (no->folha) {
+            // Caso 1: a chave está em uma folha e pode ser retirada diretamente
+            *removida = no->entradas[i];
+            for (int j = i; j < no->numChaves - 1; j++) {
+                no->entradas[j] = no->entradas[j + 1];
+            }
+            no->numChaves--;
+            return true;
+        }
+
+        // Caso 2: a chave está em um nó interno e é substituída pelo antecessor ou sucessor
+        if (no->filhos[i]->numChaves > MINIMO_CHAVES_ARVORE_B) {
+            *removida = no->entradas[i];
+            removerExtremo(no->filhos[i], true, &no->entradas[i]);
+            return true;
+        }
+        if (no->filhos[i + 1]->numChaves > MINIMO_CHAVES_ARVORE_B) {
+            *removida = no->entradas[i];
+            removerExtremo(no->filhos[i + 1], false, &no->entradas[i]);
+            return true;
+        }
+
+        // Nenhum dos filhos pode ceder uma entrada: junta os dois e continua no filho resultante
+        juntarFilhos(no, i);
+        return removerRecursivo(no->filhos[i], chave, removida, metricas);
+    }
+
+    if (no->folha) {
+        return false;
+    }
+
+    // Caso 3: a chave está em uma subárvore; garante folga no filho antes de descer
+    i = garantirFolga(no, i);
+    return removerRecursivo(no->filhos[i], chave, removida, metricas);
+}
+
+/**
+ * Remove uma chave da Árvore B.
+ *
+ * Esta função remove uma entrada com a chave informada, redistribuindo entradas entre irmãos
+ * ou juntando nós quando necessário para manter o número mínimo de chaves. Se a raiz ficar
+ * sem chaves, a árvore diminui de altura. Quando a chave aparece mais de uma vez, apenas
+ * uma das entradas é removida, e sua posição é devolvida em posicaoRemovida.
+ *
+ * @param raiz Ponteiro para a raiz da Árvore B.
+ * @param chave Chave a ser removida.
+ * @param posicaoRemovida Ponteiro onde será armazenada a posição do registro removido, ou -1 se a chave não existir.
+ * @param metricas Ponteiro para as métricas da fase em andamento.
+ * @return Ponteiro para a raiz atualizada da Árvore B.
+ */
+NoArvoreB* removerDaArvoreB(NoArvoreB *raiz, Chave chave, long *posicaoRemovida, Metricas *metricas) {
+    *posicaoRemovida = -1;
+    if (raiz == NULL) {
+        return NULL;
+    }
+
+    Entrada removida;
+    if (removerRecursivo(raiz, chave, &removida, metricas)) {
+        *posicaoRemovida = removida.posicao;
+    }
+
+    // Se a raiz ficou sem chaves, a árvore perde um nível
+    if (raiz->numChaves == 0) {
+        NoArvoreB *novaRaiz = raiz->folha ? NULL : raiz->filhos[0];
+        free(raiz);
+        raiz = novaRaiz;
+    }
+
+    return raiz;
+}
+
+/**
+ * Calcula quantas entradas cabem, no máximo, em uma subárvore da Árvore B com a altura dada.
+ */
+static long capacidadeSubarvoreB(int altura) {
+    long capacidade = 0;
+    for (int i = 0; i < altura; i++) {
+        capacidade = capacidade * ORDEM_ARVORE_B + (ORDEM_ARVORE_B - 1);
+    }
+    return capacidade;
+}
+
+/**
+ * Monta uma subárvore da Árvore B com a altura dada a partir de entradas já ordenadas.
+ *
+ * O nó recebe o menor número de filhos capaz de guardar todas as entradas e as distribui
+ * igualmente entre eles, separadas por uma entrada que fica no próprio nó. Assim todos os
+ * filhos ficam com pelo menos o mínimo de chaves e todas as folhas na mesma profundidade.
+ *
+ * @param entradas Entradas ordenadas por chave.
+ * @param quantidade Número de entradas.
+ * @param altura Altura da subárvore (1 para uma folha).
+ * @return Ponteiro para a raiz da subárvore.
+ */
+static NoArvoreB* montarSubarvoreB(const Entrada *entradas, long quantidade, int altura) {
+    NoArvoreB *no = criarNoArvoreB();
+
+    if (altura == 1) {
+        for (long i = 0; i < quantidade; i++) {
+            no->entradas[i] = entradas[i];
+        }
+        no->numChaves = quantidade;
+        return no;
+    }
+
+    no->folha = false;
+    long capacidadeFilho = capacidadeSubarvoreB(altura - 1);
+    int numFilhos = (quantidade + 1 + capacidadeFilho) / (capacidadeFilho + 1);
+    if (numFilhos < 2) {
+        numFilhos = 2;
+    }
+
+    long restante = quantidade - (numFilhos - 1);
+    long inicio = 0;
+    for (int i = 0; i < numFilhos; i++) {
+        long tamanho = restante / numFilhos + (i < restante % numFilhos ? 1 : 0);
+        no->filhos[i] = montarSubarvoreB(entradas + inicio, tamanho, altura - 1);
+        inicio += tamanho;
+
+        // A entrada seguinte separa este filho do próximo
+        if (i < numFilhos - 1) {
+            no->entradas[i] = entradas[inicio++];
+        }
+    }
+    no->numChaves = numFilhos - 1;
+    return no;
+}
+
+/**
+ * Monta uma Árvore B de uma só vez a partir de entradas ordenadas por chave e, entre chaves
+ * repetidas, por posição.
+ *
+ * É a alternativa às inserções uma a uma quando todas as entradas já são conhecidas: nenhuma
+ * chave é comparada e nenhum nó é dividido. A árvore resultante tem a menor altura possível.
+ *
+ * @param entradas Entradas ordenadas por chave.
+ * @param quantidade Número de entradas.
+ * @return Ponteiro para a raiz da Árvore B ou NULL se não houver entradas.
+ */
+NoArvoreB* montarArvoreB(const Entrada *entradas, long quantidade) {
+    if (quantidade == 0) {
+        return NULL;
+    }
+
+    int altura = 1;
+    while (capacidadeSubarvoreB(altura) < quantidade) {
+        altura++;
+    }
+    return montarSubarvoreB(entradas, quantidade, altura);
+}
+
+/**
+ * Conta os nós de uma subárvore da Árvore B.
+ */
+static uint64_t contarNosArvoreB(NoArvoreB *no) {
+    uint64_t total = 1;
+    if (!no->folha) {
+        for (int i = 0; i <= no->numChaves; i++) {
+            total += contarNosArvoreB(no->filhos[i]);
+        }
+    }
+    return total;
+}
+
+/**
+ * Percorre a Árvore B registrando sua altura e número de nós nas métricas.
+ *
+ * @param raiz Ponteiro para a raiz da Árvore B.
+ * @param metricas Ponteiro para as métricas onde altura e número de nós serão registrados.
+ */
+void medirArvoreB(NoArvoreB *raiz, Metricas *metricas) {
+    metricas->altura = 0;
+    metricas->numNos = 0;
+    if (raiz == NULL) {
+        return;
+    }
+
+    // Todas as folhas estão no mesmo nível: a altura é o comprimento do caminho mais à esquerda
+    for (NoArvoreB *no = raiz; no != NULL; no = no->folha ? NULL : no->filhos[0]) {
+        metricas->altura++;
+    }
+    metricas->numNos = contarNosArvoreB(raiz);
 }
 
 /**
@@ -244,3 +728,46 @@ void destruirArvoreB(NoArvoreB *raiz) {
     // Libera a memória alocada para o nó atual
     free(raiz);
 }
+
+static void* inserirVarianteArvoreB(void *raiz, Chave chave, long posicao, Metricas *metricas) {
+    return inserirNoArvoreB(raiz, chave, posicao, metricas);
+}
+
+static Entrada* buscarVarianteArvoreB(void *raiz, Chave chave, Metricas *metricas) {
+    return buscarNoArvoreB(raiz, chave, metricas);
+}
+
+static void buscarLoteVarianteArvoreB(void *raiz, const Chave *chaves, int quantidade, Entrada **resultados, Metricas *metricas) {
+    buscarLoteArvoreB(raiz, chaves, quantidade, resultados, metricas);
+}
+
+static void medirVarianteArvoreB(void *raiz, Metricas *metricas) {
+    medirArvoreB(raiz, metricas);
+}
+
+static void destruirVarianteArvoreB(void *raiz) {
+    destruirArvoreB(raiz);
+}
+
+/**
+ * Descreve a variante compilada neste objeto (a ordem padrão ou um tamanho de nó).
+ *
+ * @param variante Estrutura onde o nome, a ordem e as operações da variante serão gravados.
+ */
+void descreverVarianteArvoreB(VarianteArvoreB *variante) {
+#ifdef BYTES_NO_ARVORE_B
+    _Static_assert(sizeof(NoArvoreB) <= BYTES_NO_ARVORE_B, "O nó da variante não cabe no tamanho pedido");
+#define TEXTO_ARVORE_B(bytes) #bytes
+#define NOME_TEXTO_ARVORE_B(bytes) TEXTO_ARVORE_B(bytes)
+    variante->nome = NOME_TEXTO_ARVORE_B(BYTES_NO_ARVORE_B);
+#else
+    variante->nome = "padrao";
+#endif
+    variante->ordem = ORDEM_ARVORE_B;
+    variante->bytesNo = sizeof(NoArvoreB);
+    variante->inserir = inserirVarianteArvoreB;
+    variante->buscar = buscarVarianteArvoreB;
+    variante->buscarLote = buscarLoteVarianteArvoreB;
+    variante->medir = medirVarianteArvoreB;
+    variante->destruir = destruirVarianteArvoreB;
+}
@@ -2,15 +2,61 @@
 #define ARVOREB_H
 
 #include "../registro/registro.h"
+#include "../metricas/metricas.h"
 #include <stdbool.h>
 
+/*
+ * Variantes por tamanho de nó: o Makefile compila este módulo de novo para cada tamanho em
+ * BYTES_ARVORE_B, com -DBYTES_NO_ARVORE_B=<bytes>. A ordem passa a ser a maior ordem par
+ * cujo nó cabe nesse tamanho (os laços continuam limitados por uma constante) e os símbolos
+ * externos ganham o sufixo _<bytes>, para que as variantes convivam no mesmo executável.
+ */
+#ifdef BYTES_NO_ARVORE_B
+#define JUNTAR_NOME_ARVORE_B(nome, bytes) nome##_##bytes
+#define NOME_VARIANTE_ARVORE_B(nome, bytes) JUNTAR_NOME_ARVORE_B(nome, bytes)
+#define criarNoArvoreB NOME_VARIANTE_ARVORE_B(criarNoArvoreB, BYTES_NO_ARVORE_B)
+#define dividirNo NOME_VARIANTE_ARVORE_B(dividirNo, BYTES_NO_ARVORE_B)
+#define inserirNoNaoCheio NOME_VARIANTE_ARVORE_B(inserirNoNaoCheio, BYTES_NO_ARVORE_B)
+#define inserirNoArvoreB NOME_VARIANTE_ARVORE_B(inserirNoArvoreB, BYTES_NO_ARVORE_B)
+#define buscarNoArvoreB NOME_VARIANTE_ARVORE_B(buscarNoArvoreB, BYTES_NO_ARVORE_B)
+#define buscarTodosArvoreB NOME_VARIANTE_ARVORE_B(buscarTodosArvoreB, BYTES_NO_ARVORE_B)
+#define buscarLoteArvoreB NOME_VARIANTE_ARVORE_B(buscarLoteArvoreB, BYTES_NO_ARVORE_B)
+#define montarArvoreB NOME_VARIANTE_ARVORE_B(montarArvoreB, BYTES_NO_ARVORE_B)
+#define removerDaArvoreB NOME_VARIANTE_ARVORE_B(removerDaArvoreB, BYTES_NO_ARVORE_B)
+#define medirArvoreB NOME_VARIANTE_ARVORE_B(medirArvoreB, BYTES_NO_ARVORE_B)
+#define destruirArvoreB NOME_VARIANTE_ARVORE_B(destruirArvoreB, BYTES_NO_ARVORE_B)
+#define descreverVarianteArvoreB NOME_VARIANTE_ARVORE_B(descreverVarianteArvoreB, BYTES_NO_ARVORE_B)
+#define ORDEM_ARVORE_B ((BYTES_NO_ARVORE_B / (int)(sizeof(Entrada) + sizeof(void *))) & ~1)
+#endif
+
+#ifndef ORDEM_ARVORE_B // Os microbenchmarks compilam a árvore com outras ordens
 #define ORDEM_ARVORE_B 4 // Definindo a ordem da árvore B
+#endif
+#define MINIMO_CHAVES_ARVORE_B (ORDEM_ARVORE_B / 2 - 1) // Número mínimo de chaves em um nó não raiz
+#define GRUPO_LOTE_ARVORE_B 16 // Consultas de um lote que descem a árvore juntas
+#define LINHA_CACHE_ARVORE_B 64 // Bytes de uma linha de cache
+#define LINHAS_ANTECIPADAS_ARVORE_B 4 // Máximo de linhas de um nó pedidas por antecipação na busca em lote
 
 typedef struct Entrada {
-    int chave; // Chave do registro
+    Chave chave; // Chave do registro
     long posicao; // Posição do registro no armazenamento externo
 } Entrada;
 
+/*
+ * Operações de uma variante, sobre a raiz vista como ponteiro opaco: é assim que o código
+ * compilado com a ordem padrão escolhe uma variante em tempo de execução.
+ */
+typedef struct {
+    const char *nome; // Tamanho do nó em bytes, ou "padrao" para a ordem padrão
+    int ordem;
+    size_t bytesNo; // Tamanho real de um nó
+    void* (*inserir)(void *raiz, Chave chave, long posicao, Metricas *metricas);
+    Entrada* (*buscar)(void *raiz, Chave chave, Metricas *metricas);
+    void (*buscarLote)(void *raiz, const Chave *chaves, int quantidade, Entrada **resultados, Metricas *metricas);
+    void (*medir)(void *raiz, Metricas *metricas);
+    void (*destruir)(void *raiz);
+} VarianteArvoreB;
+
 typedef struct NoArvoreB {
     int numChaves; // Número de chaves no nó
     Entrada entradas[ORDEM_ARVORE_B - 1]; // Array de entradas (chaves e posições)
@@ -19,8 +65,16 @@ typedef struct NoArvoreB {
 } NoArvoreB;
 
 NoArvoreB* criarNoArvoreB();
-NoArvoreB* inserirNoArvoreB(NoArvoreB *raiz, int chave, long referencia, int *transferencias, int *comparacoes);
-Entrada* buscarNoArvoreB(NoArvoreB *raiz, int chave, int *transferencias, int *comparacoes);
+void dividirNo(int i, NoArvoreB *no, NoArvoreB *noFilho, Metricas *metricas);
+void inserirNoNaoCheio(NoArvoreB *no, Chave chave, long posicao, Metricas *metricas);
+NoArvoreB* inserirNoArvoreB(NoArvoreB *raiz, Chave chave, long referencia, Metricas *metricas);
+Entrada* buscarNoArvoreB(NoArvoreB *raiz, Chave chave, Metricas *metricas);
+int buscarTodosArvoreB(NoArvoreB *raiz, Chave chave, long *posicoes, int limite, Metricas *metricas);
+void buscarLoteArvoreB(NoArvoreB *raiz, const Chave *chaves, int quantidade, Entrada **resultados, Metricas *metricas);
+NoArvoreB* montarArvoreB(const Entrada *entradas, long quantidade);
+NoArvoreB* removerDaArvoreB(NoArvoreB *raiz, Chave chave, long *posicaoRemovida, Metricas *metricas);
+void medirArvoreB(NoArvoreB *raiz, Metricas *metricas);
 void destruirArvoreB(NoArvoreB *raiz);
+void descreverVarianteArvoreB(VarianteArvoreB *variante);
 
 #endif // ARVOREB_H
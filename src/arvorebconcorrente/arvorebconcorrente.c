@@ -0,0 +1,496 @@
+#include "arvorebconcorrente.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>
+
+/*
+ * Árvore B com acoplamento otimista de travas.
+ *
+ * Cada nó tem um contador de versão. Quem lê não trava nada: anota a versão do nó, lê seu
+ * conteúdo e confere, antes de usar o que leu, que a versão não mudou; se mudou, recomeça
+ * a operação da raiz. Quem escreve trava apenas os nós que altera (a folha que recebe a
+ * chave, ou o nó dividido e seu pai), trocando a versão anotada pela versão travada.
+ *
+ * Os nós nunca são liberados enquanto a árvore existe (não há remoção), então um leitor
+ * atrasado pode sempre seguir um ponteiro antigo: no pior caso a validação falha e ele
+ * recomeça.
+ */
+
+/**
+ * Cria um novo nó vazio, destravado.
+ */
+static NoArvoreBConcorrente* criarNoConcorrente(bool folha) {
+    NoArvoreBConcorrente *no = calloc(1, sizeof(NoArvoreBConcorrente));
+    atomic_init(&no->versao, 0);
+    no->folha = folha;
+    return no;
+}
+
+/**
+ * Anota a versão de um nó para uma leitura otimista, esperando se ele estiver travado.
+ */
+static uint64_t lerVersao(NoArvoreBConcorrente *no) {
+    uint64_t versao = atomic_load_explicit(&no->versao, memory_order_acquire);
+    while (versao & 1) {
+        sched_yield();
+        versao = atomic_load_explicit(&no->versao, memory_order_acquire);
+    }
+    return versao;
+}
+
+/**
+ * Confere se o nó continua na versão anotada, isto é, se o que foi lido dele é consistente.
+ */
+static bool validarVersao(NoArvoreBConcorrente *no, uint64_t versao) {
+    atomic_thread_fence(memory_order_acquire);
+    return atomic_load_explicit(&no->versao, memory_order_relaxed) == versao;
+}
+
+/**
+ * Trava um nó para escrita, desde que ele ainda esteja na versão anotada.
+ *
+ * @return Retorna true se o nó foi travado; false se outra thread o alterou ou travou antes.
+ */
+static bool travarNo(NoArvoreBConcorrente *no, uint64_t versao) {
+    if (!atomic_compare_exchange_strong_explicit(&no->versao, &versao, versao | 1, memory_order_acquire, memory_order_relaxed)) {
+        return false;
+    }
+    // A trava precisa ser visível antes de qualquer escrita no nó
+    atomic_thread_fence(memory_order_release);
+    return true;
+}
+
+/**
+ * Destrava um nó, avançando sua versão e invalidando as leituras feitas antes da escrita.
+ */
+static void destravarNo(NoArvoreBConcorrente *no) {
+    atomic_fetch_add_explicit(&no->versao, 1, memory_order_release);
+}
+
+/**
+ * Divide um filho cheio, com o filho e o pai já travados.
+ *
+ * A segunda metade das entradas vai para um nó novo e a entrada do meio sobe para o pai,
+ * como em dividirNo. O nó novo só fica visível quando o pai é alterado.
+ *
+ * @param pai Nó pai, travado e com espaço para mais uma entrada.
+ * @param filho Nó cheio a ser dividido, travado.
+ * @param metricas Ponteiro para as métricas da thread.
+ */
+static void dividirNoConcorrente(NoArvoreBConcorrente *pai, NoArvoreBConcorrente *filho, Metricas *metricas) {
+    const int pontoMedio = ORDEM_ARVORE_B / 2;
+    NoArvoreBConcorrente *novo = criarNoConcorrente(filho->folha);
+    metricas->divisoes++;
+
+    novo->numChaves = pontoMedio - 1;
+    for (int j = 0; j < pontoMedio - 1; j++) {
+        novo->entradas[j] = filho->entradas[j + pontoMedio];
+    }
+    if (!filho->folha) {
+        for (int j = 0; j < pontoMedio; j++) {
+            novo->filhos[j] = filho->filhos[j + pontoMedio];
+        }
+    }
+    filho->numChaves = pontoMedio - 1;
+
+    // Posição do filho no pai
+    int i = 0;
+    while (pai->filhos[i] != filho) {
+        i++;
+    }
+
+    for (int j = pai->numChaves; j >= i + 1; j--) {
+        pai->filhos[j + 1] = pai->filhos[j];
+    }
+    pai->filhos[i + 1] = novo;
+    for (int j = pai->numChaves - 1; j >= i; j--) {
+        pai->entradas[j + 1] = pai->entradas[j];
+    }
+    pai->entradas[i] = filho->entradas[pontoMedio - 1];
+    pai->numChaves++;
+}
+
+/**
+ * Inicializa uma Árvore B concorrente vazia, cuja raiz é uma folha sem chaves.
+ *
+ * @param arvore Ponteiro para a árvore.
+ */
+void iniciarArvoreBConcorrente(ArvoreBConcorrente *arvore) {
+    atomic_init(&arvore->raiz, criarNoConcorrente(true));
+}
+
+/**
+ * Faz uma tentativa de inserção descendo da raiz com leituras otimistas.
+ *
+ * Um nó cheio encontrado no caminho é dividido antes da descida, como em inserirNoNaoCheio;
+ * depois da divisão a tentativa termina sem inserir, para recomeçar sobre a árvore nova.
+ *
+ * @return Retorna true se a chave foi inserida; false se a operação deve recomeçar.
+ */
+static bool tentarInserir(ArvoreBConcorrente *arvore, Chave chave, long posicao, Metricas *metricas) {
+    NoArvoreBConcorrente *no = atomic_load_explicit(&arvore->raiz, memory_order_acquire);
+    uint64_t versao = lerVersao(no);
+    if (no != atomic_load_explicit(&arvore->raiz, memory_order_acquire)) {
+        return false;
+    }
+
+    NoArvoreBConcorrente *pai = NULL;
+    uint64_t versaoPai = 0;
+
+    while (true) {
+        if (no->numChaves == ORDEM_ARVORE_B - 1) {
+            // Nó cheio: trava o pai e o nó, nessa ordem, e divide
+            if (pai != NULL && !travarNo(pai, versaoPai)) {
+                return false;
+            }
+            if (!travarNo(no, versao)) {
+                if (pai != NULL) {
+                    destravarNo(pai);
+                }
+                return false;
+            }
+
+            if (pai == NULL) {
+                // A raiz só é trocada por quem segura a raiz antiga travada
+                if (no != atomic_load_explicit(&arvore->raiz, memory_order_acquire)) {
+                    destravarNo(no);
+                    return false;
+                }
+                NoArvoreBConcorrente *novaRaiz = criarNoConcorrente(false);
+                novaRaiz->filhos[0] = no;
+                dividirNoConcorrente(novaRaiz, no, metricas);
+                atomic_store_explicit(&arvore->raiz, novaRaiz, memory_order_release);
+            } else {
+                dividirNoConcorrente(pai, no, metricas);
+                destravarNo(pai);
+            }
+            destravarNo(no);
+            return false;
+        }
+
+        // O pai não pode ter mudado desde que o caminho passou por ele
+        if (pai != NULL && !validarVersao(pai, versaoPai)) {
+            return false;
+        }
+
+        if (no->folha) {
+            if (!travarNo(no, versao)) {
+                return false;
+            }
+            int i = no->numChaves - 1;
+            while (i >= 0 && chave < no->entradas[i].chave) {
+                no->entradas[i + 1] = no->entradas[i];
+                i--;
+                metricas->comparacoes++;
+            }
+            no->entradas[i + 1].chave = chave;
+            no->entradas[i + 1].posicao = posicao;
+            no->numChaves++;
+            destravarNo(no);
+            return true;
+        }
+
+        int i = no->numChaves - 1;
+        while (i >= 0 && chave < no->entradas[i].chave) {
+            i--;
+            metricas->comparacoes++;
+        }
+        NoArvoreBConcorrente *filho = no->filhos[i + 1];
+        if (!validarVersao(no, versao) || filho == NULL) {
+            return false;
+        }
+
+        pai = no;
+        versaoPai = versao;
+        no = filho;
+        versao = lerVersao(no);
+        if (!validarVersao(pai, versaoPai)) {
+            return false;
+        }
+    }
+}
+
+/**
+ * Insere uma chave na Árvore B concorrente.
+ *
+ * Pode ser chamada por várias threads ao mesmo tempo, junto com buscarArvoreBConcorrente.
+ * Chaves repetidas são inseridas novamente, como em inserirNoArvoreB.
+ *
+ * @param arvore Ponteiro para a árvore.
+ * @param chave Chave a ser inserida.
+ * @param posicao Posição do registro no armazenamento externo.
+ * @param metricas Ponteiro para as métricas da thread que insere.
+ */
+void inserirArvoreBConcorrente(ArvoreBConcorrente *arvore, Chave chave, long posicao, Metricas *metricas) {
+    while (!tentarInserir(arvore, chave, posicao, metricas)) {
+        // Outra thread alterou o caminho: recomeça da raiz
+    }
+}
+
+/**
+ * Faz uma tentativa de busca sem travar nenhum nó.
+ *
+ * @return 1 se a chave foi encontrada, 0 se não existe e -1 se a busca deve recomeçar.
+ */
+static int tentarBuscar(ArvoreBConcorrente *arvore, Chave chave, long *posicao, Metricas *metricas) {
+    NoArvoreBConcorrente *no = atomic_load_explicit(&arvore->raiz, memory_order_acquire);
+    uint64_t versao = lerVersao(no);
+    if (no != atomic_load_explicit(&arvore->raiz, memory_order_acquire)) {
+        return -1;
+    }
+
+    while (true) {
+        int numChaves = no->numChaves;
+        if (numChaves > ORDEM_ARVORE_B - 1) {
+            return -1;
+        }
+
+        int i = 0;
+        while (i < numChaves && chave > no->entradas[i].chave) {
+            i++;
+            metricas->comparacoes++;
+        }
+
+        if (i < numChaves && chave == no->entradas[i].chave) {
+            long encontrada = no->entradas[i].posicao;
+            metricas->comparacoes++;
+            if (!validarVersao(no, versao)) {
+                return -1;
+            }
+            *posicao = encontrada;
+            return 1;
+        }
+
+        bool folha = no->folha;
+        NoArvoreBConcorrente *filho = no->filhos[i];
+        if (!validarVersao(no, versao)) {
+            return -1;
+        }
+        if (folha) {
+            return 0;
+        }
+        if (filho == NULL) {
+            return -1;
+        }
+
+        // O filho só é confiável se o pai não mudou depois de anotada a versão do filho
+        NoArvoreBConcorrente *pai = no;
+        uint64_t versaoPai = versao;
+        no = filho;
+        versao = lerVersao(no);
+        if (!validarVersao(pai, versaoPai)) {
+            return -1;
+        }
+    }
+}
+
+/**
+ * Busca uma chave na Árvore B concorrente sem travar nenhum nó.
+ *
+ * @param arvore Ponteiro para a árvore.
+ * @param chave Chave a ser buscada.
+ * @param posicao Ponteiro onde será armazenada a posição do registro encontrado.
+ * @param metricas Ponteiro para as métricas da thread que busca.
+ * @return Retorna true se a chave foi encontrada.
+ */
+bool buscarArvoreBConcorrente(ArvoreBConcorrente *arvore, Chave chave, long *posicao, Metricas *metricas) {
+    int resultado;
+    while ((resultado = tentarBuscar(arvore, chave, posicao, metricas)) < 0) {
+        // Um escritor alterou o caminho durante a leitura: recomeça da raiz
+    }
+    return resultado == 1;
+}
+
+/**
+ * Libera uma subárvore da Árvore B concorrente.
+ */
+static void destruirNoConcorrente(NoArvoreBConcorrente *no) {
+    if (!no->folha) {
+        for (int i = 0; i <= no->numChaves; i++) {
+            destruirNoConcorrente(no->filhos[i]);
+        }
+    }
+    free(no);
+}
+
+/**
+ * Destrói uma Árvore B concorrente. Nenhuma outra thread pode estar usando a árvore.
+ *
+ * @param arvore Ponteiro para a árvore.
+ */
+void destruirArvoreBConcorrente(ArvoreBConcorrente *arvore) {
+    destruirNoConcorrente(atomic_load(&arvore->raiz));
+    atomic_store(&arvore->raiz, NULL);
+}
+
+/* ---------- Rodadas concorrentes ---------- */
+
+typedef struct {
+    ArvoreBConcorrente *arvore;
+    const Chave *chaves; // Chave de cada posição do arquivo
+    const long *posicoes; // Posições válidas do arquivo
+    long inicio; // Primeira posição inserida pelo escritor
+    long fim;
+    long passo; // Distância entre as posições inseridas pelo mesmo escritor
+    long numPreenchidas; // Posições inseridas antes da rodada, consultadas pelos leitores
+    atomic_int *escritoresAtivos;
+    uint64_t semente;
+    uint64_t operacoes;
+    uint64_t falhas;
+    Metricas metricas;
+} TarefaConcorrente;
+
+/**
+ * Gera o próximo número pseudoaleatório de uma thread (xorshift).
+ */
+static uint64_t proximoAleatorio(uint64_t *estado) {
+    *estado ^= *estado << 13;
+    *estado ^= *estado >> 7;
+    *estado ^= *estado << 17;
+    return *estado;
+}
+
+/**
+ * Insere as posições atribuídas a um escritor.
+ */
+static void* escreverConcorrente(void *argumento) {
+    TarefaConcorrente *tarefa = argumento;
+    for (long i = tarefa->inicio; i < tarefa->fim; i += tarefa->passo) {
+        long posicao = tarefa->posicoes[i];
+        inserirArvoreBConcorrente(tarefa->arvore, tarefa->chaves[posicao], posicao, &tarefa->metricas);
+        tarefa->operacoes++;
+    }
+    atomic_fetch_sub(tarefa->escritoresAtivos, 1);
+    return NULL;
+}
+
+/**
+ * Busca chaves já inseridas, sorteadas, enquanto houver escritores trabalhando. Uma busca
+ * falha se não encontra a chave ou devolve uma posição com outra chave.
+ */
+static void* lerConcorrente(void *argumento) {
+    TarefaConcorrente *tarefa = argumento;
+    while (atomic_load(tarefa->escritoresAtivos) > 0) {
+        long posicao = tarefa->posicoes[proximoAleatorio(&tarefa->semente) % tarefa->numPreenchidas];
+        long encontrada;
+        Chave chave = tarefa->chaves[posicao];
+        if (!buscarArvoreBConcorrente(tarefa->arvore, chave, &encontrada, &tarefa->metricas) || tarefa->chaves[encontrada] != chave) {
+            tarefa->falhas++;
+        }
+        tarefa->operacoes++;
+    }
+    return NULL;
+}
+
+/**
+ * Executa uma rodada de inserções e buscas simultâneas sobre uma Árvore B concorrente.
+ *
+ * A primeira metade das posições válidas é inserida antes da rodada. Durante a rodada, os
+ * escritores inserem a segunda metade e os leitores buscam chaves da primeira metade até os
+ * escritores terminarem. Ao final, todas as chaves são conferidas.
+ *
+ * @param chaves Chave de cada posição do arquivo (CHAVE_REMOVIDA nas posições removidas).
+ * @param totalPosicoes Número de posições do arquivo.
+ * @param leitores Número de threads leitoras.
+ * @param escritores Número de threads escritoras (pelo menos uma).
+ * @param metricas Ponteiro para as métricas da rodada (consultas dos leitores e tempos).
+ * @param insercoes Ponteiro onde será armazenado o número de inserções da rodada.
+ * @param falhas Ponteiro onde será armazenado o número de buscas que falharam.
+ * @return Retorna true se nenhuma busca falhou, durante ou depois da rodada.
+ */
+bool executarRodadaConcorrente(
+    const Chave *chaves,
+    long totalPosicoes,
+    int leitores,
+    int escritores,
+    Metricas *metricas,
+    uint64_t *insercoes,
+    uint64_t *falhas
+) {
+    long *posicoes = malloc((totalPosicoes > 0 ? totalPosicoes : 1) * sizeof(long));
+    long numValidas = 0;
+    for (long posicao = 0; posicao < totalPosicoes; posicao++) {
+        if (chaves[posicao] != CHAVE_REMOVIDA) {
+            posicoes[numValidas++] = posicao;
+        }
+    }
+
+    if (escritores < 1) {
+        escritores = 1;
+    }
+    if (leitores + escritores > MAXIMO_THREADS_CONCORRENTES) {
+        leitores = MAXIMO_THREADS_CONCORRENTES - escritores;
+    }
+
+    // A primeira metade (ao menos uma chave, para os leitores) entra antes da rodada
+    ArvoreBConcorrente arvore;
+    Metricas preenchimento;
+    iniciarArvoreBConcorrente(&arvore);
+    iniciarMetricas(&preenchimento);
+    long numPreenchidas = numValidas > 1 ? numValidas / 2 : numValidas;
+    for (long i = 0; i < numPreenchidas; i++) {
+        inserirArvoreBConcorrente(&arvore, chaves[posicoes[i]], posicoes[i], &preenchimento);
+    }
+    if (numPreenchidas == 0) {
+        leitores = 0;
+    }
+
+    TarefaConcorrente tarefas[MAXIMO_THREADS_CONCORRENTES] = {0};
+    pthread_t threads[MAXIMO_THREADS_CONCORRENTES];
+    bool criada[MAXIMO_THREADS_CONCORRENTES];
+    atomic_int escritoresAtivos;
+    atomic_init(&escritoresAtivos, escritores);
+    int numThreads = escritores + leitores;
+
+    iniciarMetricas(metricas);
+    for (int t = 0; t < numThreads; t++) {
+        TarefaConcorrente *tarefa = &tarefas[t];
+        tarefa->arvore = &arvore;
+        tarefa->chaves = chaves;
+        tarefa->posicoes = posicoes;
+        tarefa->inicio = numPreenchidas + t;
+        tarefa->fim = numValidas;
+        tarefa->passo = escritores;
+        tarefa->numPreenchidas = numPreenchidas;
+        tarefa->escritoresAtivos = &escritoresAtivos;
+        tarefa->semente = 0x9E3779B97F4A7C15ULL * (t + 1);
+
+        void *(*funcao)(void *) = t < escritores ? escreverConcorrente : lerConcorrente;
+        criada[t] = pthread_create(&threads[t], NULL, funcao, tarefa) == 0;
+        if (!criada[t] && t < escritores) {
+            funcao(tarefa); // Um escritor precisa terminar seu trabalho mesmo sem thread
+        }
+    }
+
+    *insercoes = 0;
+    *falhas = 0;
+    for (int t = 0; t < numThreads; t++) {
+        if (criada[t]) {
+            pthread_join(threads[t], NULL);
+        }
+        acumularMetricas(metricas, &tarefas[t].metricas);
+        if (t < escritores) {
+            *insercoes += tarefas[t].operacoes;
+        } else {
+            metricas->consultas += tarefas[t].operacoes;
+            *falhas += tarefas[t].falhas;
+        }
+    }
+    finalizarMetricas(metricas);
+
+    // Conferência final: todas as chaves, das duas metades, precisam ser encontradas
+    Metricas conferencia;
+    iniciarMetricas(&conferencia);
+    for (long i = 0; i < numValidas; i++) {
+        long encontrada;
+        Chave chave = chaves[posicoes[i]];
+        if (!buscarArvoreBConcorrente(&arvore, chave, &encontrada, &conferencia) || chaves[encontrada] != chave) {
+            (*falhas)++;
+        }
+    }
+
+    destruirArvoreBConcorrente(&arvore);
+    free(posicoes);
+    return *falhas == 0;
+}
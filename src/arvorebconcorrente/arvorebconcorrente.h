@@ -0,0 +1,39 @@
+#ifndef ARVOREBCONCORRENTE_H
+#define ARVOREBCONCORRENTE_H
+
+#include "../arvoreb/arvoreb.h"
+#include "../metricas/metricas.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#define MAXIMO_THREADS_CONCORRENTES 64 // Limite de threads das rodadas concorrentes
+
+// Nó da Árvore B concorrente: igual ao NoArvoreB, acrescido de um contador de versão
+typedef struct NoArvoreBConcorrente {
+    _Atomic uint64_t versao; // Bit 0 indica nó travado; cada destravamento avança a versão
+    int numChaves; // Número de chaves no nó
+    bool folha; // Indica se o nó é uma folha
+    Entrada entradas[ORDEM_ARVORE_B - 1]; // Array de entradas (chaves e posições)
+    struct NoArvoreBConcorrente *filhos[ORDEM_ARVORE_B]; // Ponteiros para os filhos
+} NoArvoreBConcorrente;
+
+typedef struct {
+    _Atomic(NoArvoreBConcorrente *) raiz; // Raiz atual, trocada apenas com a raiz antiga travada
+} ArvoreBConcorrente;
+
+void iniciarArvoreBConcorrente(ArvoreBConcorrente *arvore);
+void inserirArvoreBConcorrente(ArvoreBConcorrente *arvore, Chave chave, long posicao, Metricas *metricas);
+bool buscarArvoreBConcorrente(ArvoreBConcorrente *arvore, Chave chave, long *posicao, Metricas *metricas);
+void destruirArvoreBConcorrente(ArvoreBConcorrente *arvore);
+bool executarRodadaConcorrente(
+    const Chave *chaves,
+    long totalPosicoes,
+    int leitores,
+    int escritores,
+    Metricas *metricas,
+    uint64_t *insercoes,
+    uint64_t *falhas
+);
+
+#endif // ARVOREBCONCORRENTE_H
@@ -1,5 +1,6 @@
 #include "arvorebstar.h"
 #include <stdlib.h>
+#include <stddef.h>
 
 /**
  * Cria um novo nó para a árvore B*.
@@ -38,7 +39,7 @@ NoArvoreBStar* criarNoArvoreBStar(bool ehFolha) {
  * @param chave Chave a ser inserida.
  * @return Índice no array de chaves onde a nova chave deve ser inserida.
  */
-int encontrarPosicaoInsercao(int chaves[], int numChaves, int chave) {
+int encontrarPosicaoInsercao(Chave chaves[], int numChaves, Chave chave) {
     int pos = 0;
     while (pos < numChaves && chaves[pos] < chave) {
         pos++;
@@ -47,52 +48,940 @@ int encontrarPosicaoInsercao(int chaves[], int numChaves, int chave) {
 }
 
 
-bool inserirRegistroNoNóFolha(NoFolhaArvoreBStar *no, Registro reg, int *transferencias, int *comparacoes) {
+/**
+ * Insere um registro em um nó folha da árvore B* que ainda tem espaço.
+ *
+ * As chaves do nó são mantidas ordenadas. Uma chave repetida é inserida depois das
+ * ocorrências de posição menor, de modo que as ocorrências fiquem na ordem do arquivo.
+ *
+ * @param no Ponteiro para o nó folha.
+ * @param reg Registro a ser inserido.
+ * @param posicao Posição do registro no armazenamento externo.
+ * @param metricas Ponteiro para as métricas da fase em andamento.
+ * @return Retorna true se o registro foi inserido (false se o nó estiver cheio).
+ */
+bool inserirRegistroNoNóFolha(NoFolhaArvoreBStar *no, Registro reg, long posicao, Metricas *metricas) {
     if (no == NULL || no->numChaves >= ORDEM_ARVORE_BSTAR - 1) {
         // Nó é nulo ou já está cheio
         return false;
     }
 
     int posicaoInsercao = 0;
-    while (posicaoInsercao < no->numChaves && no->chaves[posicaoInsercao] < reg.chave) {
-        (*comparacoes)++;
+    while (posicaoInsercao < no->numChaves &&
+           (no->chaves[posicaoInsercao] < reg.chave ||
+            (no->chaves[posicaoInsercao] == reg.chave && no->posicoes[posicaoInsercao] < posicao))) {
+        metricas->comparacoes++;
         posicaoInsercao++;
     }
 
-    // Se a chave já existe, não insere
-    if (posicaoInsercao < no->numChaves && no->chaves[posicaoInsercao] == reg.chave) {
-        (*comparacoes)++;
-        return false;
-    }
-
     // Desloca as chaves e registros para abrir espaço para o novo registro
     for (int i = no->numChaves; i > posicaoInsercao; i--) {
         no->chaves[i] = no->chaves[i - 1];
         no->registros[i] = no->registros[i - 1];
-        (*transferencias) += 2;
+        no->posicoes[i] = no->posicoes[i - 1];
     }
 
     // Insere o novo registro
     no->chaves[posicaoInsercao] = reg.chave;
     no->registros[posicaoInsercao] = reg;
+    no->posicoes[posicaoInsercao] = posicao;
     no->numChaves++;
-    (*transferencias) += 2;
 
     return true;
 }
 
-void dividirNó(NoArvoreBStar *pai, int index, NoArvoreBStar *nó, int *transferencias, int *comparacoes) {
-    return;
+/**
+ * Retorna o número de chaves de um nó da árvore B*, seja ele folha ou interno.
+ */
+static int numChavesNo(const NoArvoreBStar *no) {
+    return no->folha ? no->tipo.folha.numChaves : no->tipo.interno.numChaves;
+}
+
+/**
+ * Retorna o número mínimo de chaves que um nó não raiz da árvore B* deve manter.
+ */
+static int minimoChavesNo(const NoArvoreBStar *no) {
+    return no->folha ? MINIMO_CHAVES_FOLHA_BSTAR : MINIMO_CHAVES_INTERNO_BSTAR;
 }
 
-NoArvoreBStar* inserirArvoreBStar(NoArvoreBStar *raiz, Registro reg, int *transferencias, int *comparacoes) {
-    return NULL;
+/**
+ * Encontra o filho de um nó interno por onde a busca de uma chave deve descer.
+ *
+ * Cada chave de um nó interno é a menor chave da subárvore à sua direita, então a descida
+ * segue pelo filho que fica após todas as chaves menores ou iguais à chave procurada.
+ *
+ * @param no Ponteiro para o nó interno.
+ * @param chave Chave procurada.
+ * @param metricas Ponteiro para as métricas da fase em andamento.
+ * @return Índice do filho por onde a busca deve continuar.
+ */
+static int encontrarFilho(const NoInternoArvoreBStar *no, Chave chave, Metricas *metricas) {
+    int i = 0;
+    while (i < no->numChaves && chave >= no->chaves[i]) {
+        metricas->comparacoes++;
+        i++;
+    }
+    if (i < no->numChaves) {
+        metricas->comparacoes++;
+    }
+    return i;
+}
+
+/**
+ * Encontra o filho de um nó interno onde está a primeira ocorrência possível de uma chave.
+ *
+ * Uma sequência de chaves repetidas pode ter sido dividida entre duas folhas, e a chave
+ * separadora é então igual à chave; a descida segue pelo filho que fica após as chaves
+ * estritamente menores, à esquerda de encontrarFilho.
+ *
+ * @param no Ponteiro para o nó interno.
+ * @param chave Chave procurada.
+ * @param metricas Ponteiro para as métricas da fase em andamento.
+ * @return Índice do filho por onde a busca deve continuar.
+ */
+static int encontrarFilhoInferior(const NoInternoArvoreBStar *no, Chave chave, Metricas *metricas) {
+    int i = 0;
+    while (i < no->numChaves && chave > no->chaves[i]) {
+        metricas->comparacoes++;
+        i++;
+    }
+    if (i < no->numChaves) {
+        metricas->comparacoes++;
+    }
+    return i;
 }
 
-Registro* buscarArvoreBStar(NoArvoreBStar *raiz, int chave, int *transferencias, int *comparacoes) {
+/**
+ * Desce até a folha da primeira ocorrência de uma chave (ou da primeira chave maior).
+ */
+static NoFolhaArvoreBStar* descerFolhaInferior(NoArvoreBStar *raiz, Chave chave, Metricas *metricas) {
+    NoArvoreBStar *no = raiz;
+    while (!no->folha) {
+        no = no->tipo.interno.filhos[encontrarFilhoInferior(&no->tipo.interno, chave, metricas)];
+    }
+    return &no->tipo.folha;
+}
+
+/**
+ * Procura a primeira ocorrência de uma chave: a descida pelo limite inferior chega à folha
+ * em que ela está ou à anterior, quando todas as chaves dessa folha são menores, e então a
+ * busca passa à folha seguinte da lista.
+ *
+ * @param raiz Ponteiro para a raiz da árvore B* (não nula).
+ * @param chave Chave procurada.
+ * @param indice Onde será armazenado o índice da ocorrência na folha.
+ * @param metricas Ponteiro para as métricas da fase em andamento.
+ * @return Folha da primeira ocorrência ou NULL se a chave não existe.
+ */
+static NoFolhaArvoreBStar* localizarPrimeiraOcorrencia(NoArvoreBStar *raiz, Chave chave, int *indice, Metricas *metricas) {
+    NoFolhaArvoreBStar *folha = descerFolhaInferior(raiz, chave, metricas);
+    int i = encontrarPosicaoInsercao(folha->chaves, folha->numChaves, chave);
+    metricas->comparacoes += i + 1;
+    if (i == folha->numChaves && folha->proximo != NULL) {
+        folha = folha->proximo;
+        i = 0;
+        metricas->comparacoes++;
+    }
+    if (i < folha->numChaves && folha->chaves[i] == chave) {
+        *indice = i;
+        return folha;
+    }
     return NULL;
 }
 
+/**
+ * Encontra o filho de um nó interno que contém a primeira ocorrência de uma chave. É o filho
+ * de encontrarFilhoInferior, a menos que a chave separadora seja igual à chave e a subárvore
+ * desse filho só tenha chaves menores (as ocorrências que ela tinha foram removidas); nesse
+ * caso a primeira ocorrência está no filho seguinte.
+ */
+static int encontrarFilhoPrimeiraOcorrencia(const NoInternoArvoreBStar *no, Chave chave, Metricas *metricas) {
+    int i = encontrarFilhoInferior(no, chave, metricas);
+    if (i < no->numChaves && no->chaves[i] == chave) {
+        // A maior chave da subárvore está no fim da sua folha mais à direita
+        const NoArvoreBStar *ultimo = no->filhos[i];
+        while (!ultimo->folha) {
+            ultimo = ultimo->tipo.interno.filhos[ultimo->tipo.interno.numChaves];
+        }
+        const NoFolhaArvoreBStar *folha = &ultimo->tipo.folha;
+        metricas->comparacoes++;
+        if (folha->numChaves == 0 || folha->chaves[folha->numChaves - 1] < chave) {
+            i++;
+        }
+    }
+    return i;
+}
+
+/**
+ * Move a primeira entrada do filho i para o final do irmão da esquerda.
+ *
+ * Em folhas, a chave e o registro mudam de nó e a chave separadora do pai passa a ser a nova
+ * menor chave do filho i. Em nós internos, a chave separadora desce para o irmão e a primeira
+ * chave do filho i sobe para o pai.
+ *
+ * @param pai Ponteiro para o nó interno pai.
+ * @param i Índice do filho que cede a entrada (deve ser maior que zero).
+ */
+static void redistribuirParaEsquerda(NoArvoreBStar *pai, int i) {
+    NoInternoArvoreBStar *interno = &pai->tipo.interno;
+    NoArvoreBStar *origem = interno->filhos[i];
+    NoArvoreBStar *destino = interno->filhos[i - 1];
+
+    if (origem->folha) {
+        NoFolhaArvoreBStar *de = &origem->tipo.folha;
+        NoFolhaArvoreBStar *para = &destino->tipo.folha;
+
+        para->chaves[para->numChaves] = de->chaves[0];
+        para->registros[para->numChaves] = de->registros[0];
+        para->posicoes[para->numChaves] = de->posicoes[0];
+        para->numChaves++;
+
+        for (int j = 0; j < de->numChaves - 1; j++) {
+            de->chaves[j] = de->chaves[j + 1];
+            de->registros[j] = de->registros[j + 1];
+            de->posicoes[j] = de->posicoes[j + 1];
+        }
+        de->numChaves--;
+
+        interno->chaves[i - 1] = de->chaves[0];
+    } else {
+        NoInternoArvoreBStar *de = &origem->tipo.interno;
+        NoInternoArvoreBStar *para = &destino->tipo.interno;
+
+        para->chaves[para->numChaves] = interno->chaves[i - 1];
+        para->filhos[para->numChaves + 1] = de->filhos[0];
+        para->numChaves++;
+
+        interno->chaves[i - 1] = de->chaves[0];
+
+        for (int j = 0; j < de->numChaves - 1; j++) {
+            de->chaves[j] = de->chaves[j + 1];
+        }
+        for (int j = 0; j < de->numChaves; j++) {
+            de->filhos[j] = de->filhos[j + 1];
+        }
+        de->numChaves--;
+    }
+}
+
+/**
+ * Move a última entrada do filho i para o início do irmão da direita.
+ *
+ * É a operação simétrica de redistribuirParaEsquerda.
+ *
+ * @param pai Ponteiro para o nó interno pai.
+ * @param i Índice do filho que cede a entrada (deve ser menor que o número de chaves do pai).
+ */
+static void redistribuirParaDireita(NoArvoreBStar *pai, int i) {
+    NoInternoArvoreBStar *interno = &pai->tipo.interno;
+    NoArvoreBStar *origem = interno->filhos[i];
+    NoArvoreBStar *destino = interno->filhos[i + 1];
+
+    if (origem->folha) {
+        NoFolhaArvoreBStar *de = &origem->tipo.folha;
+        NoFolhaArvoreBStar *para = &destino->tipo.folha;
+
+        for (int j = para->numChaves; j > 0; j--) {
+            para->chaves[j] = para->chaves[j - 1];
+            para->registros[j] = para->registros[j - 1];
+            para->posicoes[j] = para->posicoes[j - 1];
+        }
+        de->numChaves--;
+        para->chaves[0] = de->chaves[de->numChaves];
+        para->registros[0] = de->registros[de->numChaves];
+        para->posicoes[0] = de->posicoes[de->numChaves];
+        para->numChaves++;
+
+        interno->chaves[i] = para->chaves[0];
+    } else {
+        NoInternoArvoreBStar *de = &origem->tipo.interno;
+        NoInternoArvoreBStar *para = &destino->tipo.interno;
+
+        for (int j = para->numChaves; j > 0; j--) {
+            para->chaves[j] = para->chaves[j - 1];
+        }
+        for (int j = para->numChaves + 1; j > 0; j--) {
+            para->filhos[j] = para->filhos[j - 1];
+        }
+        para->chaves[0] = interno->chaves[i];
+        para->filhos[0] = de->filhos[de->numChaves];
+        para->numChaves++;
+
+        interno->chaves[i] = de->chaves[de->numChaves - 1];
+        de->numChaves--;
+    }
+}
+
+/**
+ * Divide um nó cheio da árvore B* em dois.
+ *
+ * Em folhas, metade dos registros passa para uma nova folha, que é encadeada logo após o nó
+ * dividido, e a menor chave da nova folha é copiada para o pai. Em nós internos, a chave do
+ * meio sobe para o pai. O pai deve ter espaço para receber a nova chave.
+ *
+ * @param pai Ponteiro para o nó interno pai.
+ * @param index Índice do nó dividido entre os filhos do pai.
+ * @param nó Ponteiro para o nó cheio a ser dividido.
+ * @param metricas Ponteiro para as métricas da fase em andamento.
+ */
+static void dividirNó(NoArvoreBStar *pai, int index, NoArvoreBStar *nó, Metricas *metricas) {
+    NoArvoreBStar *novo = criarNoArvoreBStar(nó->folha);
+    Chave chaveSeparadora;
+    metricas->divisoes++;
+
+    if (nó->folha) {
+        NoFolhaArvoreBStar *esquerda = &nó->tipo.folha;
+        NoFolhaArvoreBStar *direita = &novo->tipo.folha;
+        int manter = esquerda->numChaves / 2;
+
+        for (int j = manter; j < esquerda->numChaves; j++) {
+            direita->chaves[j - manter] = esquerda->chaves[j];
+            direita->registros[j - manter] = esquerda->registros[j];
+            direita->posicoes[j - manter] = esquerda->posicoes[j];
+        }
+        direita->numChaves = esquerda->numChaves - manter;
+        esquerda->numChaves = manter;
+
+        // Mantém o encadeamento das folhas em ordem de chave
+        direita->proximo = esquerda->proximo;
+        esquerda->proximo = direita;
+
+        chaveSeparadora = direita->chaves[0];
+    } else {
+        NoInternoArvoreBStar *esquerda = &nó->tipo.interno;
+        NoInternoArvoreBStar *direita = &novo->tipo.interno;
+        int meio = esquerda->numChaves / 2;
+
+        for (int j = meio + 1; j < esquerda->numChaves; j++) {
+            direita->chaves[j - meio - 1] = esquerda->chaves[j];
+        }
+        for (int j = meio + 1; j <= esquerda->numChaves; j++) {
+            direita->filhos[j - meio - 1] = esquerda->filhos[j];
+        }
+        direita->numChaves = esquerda->numChaves - meio - 1;
+        esquerda->numChaves = meio;
+
+        chaveSeparadora = esquerda->chaves[meio];
+    }
+
+    // Abre espaço no pai para a chave separadora e o novo filho
+    NoInternoArvoreBStar *interno = &pai->tipo.interno;
+    for (int j = interno->numChaves; j > index; j--) {
+        interno->chaves[j] = interno->chaves[j - 1];
+        interno->filhos[j + 1] = interno->filhos[j];
+    }
+    interno->chaves[index] = chaveSeparadora;
+    interno->filhos[index + 1] = novo;
+    interno->numChaves++;
+}
+
+/**
+ * Insere um registro na árvore B*.
+ *
+ * A inserção desce a árvore uma única vez. Sempre que o filho por onde a descida continua
+ * está cheio, a função primeiro tenta passar uma entrada para um irmão adjacente com folga,
+ * como é próprio da árvore B*, e só divide o filho quando nenhum irmão pode recebê-la. Se a
+ * raiz estiver cheia, ela é dividida e a árvore cresce em altura.
+ *
+ * @param raiz Ponteiro para a raiz da árvore B*.
+ * @param reg Registro a ser inserido.
+ * @param posicao Posição do registro no armazenamento externo.
+ * @param metricas Ponteiro para as métricas da fase em andamento.
+ * @return Ponteiro para a raiz atualizada da árvore B*.
+ */
+NoArvoreBStar* inserirArvoreBStar(NoArvoreBStar *raiz, Registro reg, long posicao, Metricas *metricas) {
+    if (raiz == NULL) {
+        raiz = criarNoArvoreBStar(true);
+    }
+
+    if (numChavesNo(raiz) == ORDEM_ARVORE_BSTAR - 1) {
+        NoArvoreBStar *novaRaiz = criarNoArvoreBStar(false);
+        novaRaiz->tipo.interno.filhos[0] = raiz;
+        dividirNó(novaRaiz, 0, raiz, metricas);
+        raiz = novaRaiz;
+    }
+
+    NoArvoreBStar *no = raiz;
+    while (!no->folha) {
+        NoInternoArvoreBStar *interno = &no->tipo.interno;
+        int i = encontrarFilho(interno, reg.chave, metricas);
+
+        if (numChavesNo(interno->filhos[i]) == ORDEM_ARVORE_BSTAR - 1) {
+            // Um irmão só recebe a entrada se continuar com espaço livre depois disso
+            if (i > 0 && numChavesNo(interno->filhos[i - 1]) < ORDEM_ARVORE_BSTAR - 2) {
+                redistribuirParaEsquerda(no, i);
+            } else if (i < interno->numChaves && numChavesNo(interno->filhos[i + 1]) < ORDEM_ARVORE_BSTAR - 2) {
+                redistribuirParaDireita(no, i);
+            } else {
+                dividirNó(no, i, interno->filhos[i], metricas);
+            }
+            i = encontrarFilho(interno, reg.chave, metricas);
+        }
+
+        no = interno->filhos[i];
+    }
+
+    inserirRegistroNoNóFolha(&no->tipo.folha, reg, posicao, metricas);
+    return raiz;
+}
+
+/**
+ * Busca um registro na árvore B*.
+ *
+ * A busca desce pelo limite inferior até a folha da primeira ocorrência da chave, ou até a
+ * anterior a ela, e devolve a primeira ocorrência.
+ *
+ * @param raiz Ponteiro para a raiz da árvore B*.
+ * @param chave Chave a ser buscada.
+ * @param posicao Ponteiro onde será armazenada a posição do registro no arquivo (pode ser NULL).
+ * @param metricas Ponteiro para as métricas da fase em andamento.
+ * @return Ponteiro para o registro encontrado ou NULL se a chave não for encontrada.
+ */
+Registro* buscarArvoreBStar(NoArvoreBStar *raiz, Chave chave, long *posicao, Metricas *metricas) {
+    if (raiz == NULL) {
+        return NULL;
+    }
+
+    int i;
+    NoFolhaArvoreBStar *folha = localizarPrimeiraOcorrencia(raiz, chave, &i, metricas);
+    if (folha == NULL) {
+        return NULL;
+    }
+    if (posicao != NULL) {
+        *posicao = folha->posicoes[i];
+    }
+    return &folha->registros[i];
+}
+
+/**
+ * Pede ao processador as linhas de cache do nó que a busca lê primeiro: o indicador de folha,
+ * o contador e o início das chaves, que ficam no mesmo lugar em nós internos e folhas e são
+ * percorridas em ordem. O número de linhas vem do tamanho do nó, até
+ * LINHAS_ANTECIPADAS_ARVORE_BSTAR; em nós maiores, a leitura sequencial das chaves aciona a
+ * antecipação do próprio processador para o restante.
+ */
+static void anteciparNoArvoreBStar(const NoArvoreBStar *no) {
+    size_t bytes = offsetof(NoArvoreBStar, tipo.interno.chaves) + sizeof(no->tipo.interno.chaves);
+    if (bytes > LINHAS_ANTECIPADAS_ARVORE_BSTAR * LINHA_CACHE_ARVORE_BSTAR) {
+        bytes = LINHAS_ANTECIPADAS_ARVORE_BSTAR * LINHA_CACHE_ARVORE_BSTAR;
+    }
+    for (size_t deslocamento = 0; deslocamento < bytes; deslocamento += LINHA_CACHE_ARVORE_BSTAR) {
+        __builtin_prefetch((const char *)no + deslocamento);
+    }
+}
+
+/**
+ * Busca um lote de chaves na árvore B*, descendo um grupo de consultas por vez em conjunto.
+ *
+ * Como em buscarLoteArvoreB, cada consulta do grupo desce um nível e pede o próximo nó ao
+ * processador antes de a função passar à consulta seguinte, sobrepondo as esperas pela
+ * memória. O resultado e as comparações contadas são os mesmos de buscarArvoreBStar.
+ *
+ * @param raiz Ponteiro para a raiz da árvore B*.
+ * @param chaves Chaves a serem buscadas.
+ * @param quantidade Número de chaves do lote.
+ * @param resultados Vetor onde o registro de cada chave (ou NULL) será armazenado.
+ * @param posicoes Vetor onde a posição de cada registro encontrado será armazenada (pode ser NULL).
+ * @param metricas Ponteiro para as métricas da fase em andamento.
+ */
+void buscarLoteArvoreBStar(NoArvoreBStar *raiz, const Chave *chaves, int quantidade, Registro **resultados, long *posicoes, Metricas *metricas) {
+    NoArvoreBStar *nos[GRUPO_LOTE_ARVORE_BSTAR]; // Próximo nó de cada consulta do grupo, ou NULL se terminou
+
+    for (int inicio = 0; inicio < quantidade; inicio += GRUPO_LOTE_ARVORE_BSTAR) {
+        int tamanho = quantidade - inicio < GRUPO_LOTE_ARVORE_BSTAR ? quantidade - inicio : GRUPO_LOTE_ARVORE_BSTAR;
+        int ativas = raiz != NULL ? tamanho : 0;
+        for (int j = 0; j < tamanho; j++) {
+            resultados[inicio + j] = NULL;
+            nos[j] = raiz;
+        }
+
+        while (ativas > 0) {
+            for (int j = 0; j < tamanho; j++) {
+                NoArvoreBStar *no = nos[j];
+                if (no == NULL) {
+                    continue;
+                }
+
+                Chave chave = chaves[inicio + j];
+                if (!no->folha) {
+                    nos[j] = no->tipo.interno.filhos[encontrarFilhoInferior(&no->tipo.interno, chave, metricas)];
+                    anteciparNoArvoreBStar(nos[j]);
+                    continue;
+                }
+
+                NoFolhaArvoreBStar *folha = &no->tipo.folha;
+                int i = encontrarPosicaoInsercao(folha->chaves, folha->numChaves, chave);
+                metricas->comparacoes += i + 1;
+                if (i == folha->numChaves && folha->proximo != NULL) {
+                    // A primeira ocorrência pode estar no início da folha seguinte
+                    folha = folha->proximo;
+                    i = 0;
+                    metricas->comparacoes++;
+                }
+                if (i < folha->numChaves && folha->chaves[i] == chave) {
+                    resultados[inicio + j] = &folha->registros[i];
+                    if (posicoes != NULL) {
+                        posicoes[inicio + j] = folha->posicoes[i];
+                    }
+                }
+                nos[j] = NULL;
+                ativas--;
+            }
+        }
+    }
+}
+
+/**
+ * Busca as chaves de um intervalo na árvore B*.
+ *
+ * A busca desce até a folha que pode conter a menor chave do intervalo e segue pela lista
+ * encadeada de folhas até passar da maior chave ou atingir o limite de resultados.
+ *
+ * @param raiz Ponteiro para a raiz da árvore B*.
+ * @param minimo Menor chave do intervalo.
+ * @param maximo Maior chave do intervalo.
+ * @param chaves Vetor onde as chaves encontradas serão armazenadas, em ordem crescente.
+ * @param posicoes Vetor onde as posições dos registros encontrados serão armazenadas.
+ * @param limite Número máximo de resultados.
+ * @param metricas Ponteiro para as métricas da fase em andamento.
+ * @return Número de chaves encontradas.
+ */
+int buscarIntervaloArvoreBStar(NoArvoreBStar *raiz, Chave minimo, Chave maximo, Chave *chaves, long *posicoes, int limite, Metricas *metricas) {
+    if (raiz == NULL || minimo > maximo) {
+        return 0;
+    }
+
+    NoArvoreBStar *no = raiz;
+    while (!no->folha) {
+        no = no->tipo.interno.filhos[encontrarFilhoInferior(&no->tipo.interno, minimo, metricas)];
+    }
+
+    NoFolhaArvoreBStar *folha = &no->tipo.folha;
+    int i = encontrarPosicaoInsercao(folha->chaves, folha->numChaves, minimo);
+    metricas->comparacoes += i;
+
+    int encontradas = 0;
+    while (folha != NULL && encontradas < limite) {
+        if (i == folha->numChaves) {
+            folha = folha->proximo;
+            i = 0;
+            continue;
+        }
+        metricas->comparacoes++;
+        if (folha->chaves[i] > maximo) {
+            break;
+        }
+        chaves[encontradas] = folha->chaves[i];
+        posicoes[encontradas] = folha->posicoes[i];
+        encontradas++;
+        i++;
+    }
+    return encontradas;
+}
+
+/**
+ * Resolve um lote de chaves em ordem crescente por junção com a lista de folhas: uma descida
+ * leva à folha da menor chave do lote e, daí em diante, a folha e o lote avançam juntos, sem
+ * percorrer de novo os níveis internos, e cada folha é visitada no máximo uma vez. Quando a
+ * próxima chave está além da folha seguinte, um trecho sem chaves do lote é saltado com uma
+ * nova descida, que também segue sempre para a frente; assim um lote esparso não paga a
+ * lista de folhas inteira.
+ *
+ * @param raiz Ponteiro para a raiz da árvore B*.
+ * @param chaves Chaves do lote, em ordem crescente (repetições permitidas).
+ * @param quantidade Número de chaves do lote.
+ * @param resultados Vetor onde o registro de cada chave (ou NULL) será armazenado.
+ * @param posicoes Vetor onde a posição de cada registro encontrado será armazenada (pode ser NULL).
+ * @param metricas Ponteiro para as métricas da fase em andamento.
+ */
+void juntarLoteArvoreBStar(NoArvoreBStar *raiz, const Chave *chaves, int quantidade, Registro **resultados, long *posicoes, Metricas *metricas) {
+    for (int q = 0; q < quantidade; q++) {
+        resultados[q] = NULL;
+    }
+    if (raiz == NULL || quantidade == 0) {
+        return;
+    }
+
+    NoFolhaArvoreBStar *folha = descerFolhaInferior(raiz, chaves[0], metricas);
+    int i = 0;
+    for (int q = 0; q < quantidade && folha != NULL; q++) {
+        Chave chave = chaves[q];
+        bool saltou = false;
+        // Avança até a primeira chave >= chave, pela folha atual e pelas seguintes
+        while (folha != NULL) {
+            if (i == folha->numChaves || folha->chaves[folha->numChaves - 1] < chave) {
+                NoFolhaArvoreBStar *proxima = folha->proximo;
+                metricas->comparacoes++;
+                if (!saltou && proxima != NULL && proxima->chaves[proxima->numChaves - 1] < chave) {
+                    folha = descerFolhaInferior(raiz, chave, metricas);
+                    saltou = true;
+                } else {
+                    folha = proxima;
+                }
+                i = 0;
+                continue;
+            }
+            metricas->comparacoes++;
+            if (folha->chaves[i] >= chave) {
+                break;
+            }
+            i++;
+        }
+        if (folha != NULL && folha->chaves[i] == chave) {
+            resultados[q] = &folha->registros[i];
+            if (posicoes != NULL) {
+                posicoes[q] = folha->posicoes[i];
+            }
+        }
+    }
+}
+
+/**
+ * Busca todas as ocorrências de uma chave na árvore B* em uma única descida: a busca chega à
+ * folha da primeira ocorrência e segue pela lista encadeada de folhas enquanto a chave se
+ * repete.
+ *
+ * @param raiz Ponteiro para a raiz da árvore B*.
+ * @param chave Chave a ser buscada.
+ * @param registros Vetor onde os registros das ocorrências serão armazenados, até o limite.
+ * @param posicoes Vetor onde as posições das ocorrências serão armazenadas (pode ser NULL).
+ * @param limite Tamanho dos vetores.
+ * @param metricas Ponteiro para as métricas da fase em andamento.
+ * @return Número de ocorrências da chave, que pode passar do limite.
+ */
+int buscarTodosArvoreBStar(NoArvoreBStar *raiz, Chave chave, Registro **registros, long *posicoes, int limite, Metricas *metricas) {
+    if (raiz == NULL) {
+        return 0;
+    }
+
+    NoFolhaArvoreBStar *folha = descerFolhaInferior(raiz, chave, metricas);
+    int i = encontrarPosicaoInsercao(folha->chaves, folha->numChaves, chave);
+    metricas->comparacoes += i;
+
+    int encontradas = 0;
+    while (folha != NULL) {
+        if (i == folha->numChaves) {
+            folha = folha->proximo;
+            i = 0;
+            continue;
+        }
+        metricas->comparacoes++;
+        if (folha->chaves[i] != chave) {
+            break;
+        }
+        if (encontradas < limite) {
+            registros[encontradas] = &folha->registros[i];
+            if (posicoes != NULL) {
+                posicoes[encontradas] = folha->posicoes[i];
+            }
+        }
+        encontradas++;
+        i++;
+    }
+    return encontradas;
+}
+
+/**
+ * Junta o filho i com o irmão da direita, liberando o irmão.
+ *
+ * @param pai Ponteiro para o nó interno pai.
+ * @param i Índice do filho da esquerda.
+ */
+static void juntarFilhosBStar(NoArvoreBStar *pai, int i) {
+    NoInternoArvoreBStar *interno = &pai->tipo.interno;
+    NoArvoreBStar *esquerdo = interno->filhos[i];
+    NoArvoreBStar *direito = interno->filhos[i + 1];
+
+    if (esquerdo->folha) {
+        NoFolhaArvoreBStar *para = &esquerdo->tipo.folha;
+        NoFolhaArvoreBStar *de = &direito->tipo.folha;
+
+        for (int j = 0; j < de->numChaves; j++) {
+            para->chaves[para->numChaves + j] = de->chaves[j];
+            para->registros[para->numChaves + j] = de->registros[j];
+            para->posicoes[para->numChaves + j] = de->posicoes[j];
+        }
+        para->numChaves += de->numChaves;
+        para->proximo = de->proximo;
+    } else {
+        NoInternoArvoreBStar *para = &esquerdo->tipo.interno;
+        NoInternoArvoreBStar *de = &direito->tipo.interno;
+
+        // A chave separadora desce entre as chaves dos dois nós
+        para->chaves[para->numChaves] = interno->chaves[i];
+        for (int j = 0; j < de->numChaves; j++) {
+            para->chaves[para->numChaves + 1 + j] = de->chaves[j];
+        }
+        for (int j = 0; j <= de->numChaves; j++) {
+            para->filhos[para->numChaves + 1 + j] = de->filhos[j];
+        }
+        para->numChaves += de->numChaves + 1;
+    }
+
+    for (int j = i; j < interno->numChaves - 1; j++) {
+        interno->chaves[j] = interno->chaves[j + 1];
+        interno->filhos[j + 1] = interno->filhos[j + 2];
+    }
+    interno->numChaves--;
+
+    free(direito);
+}
+
+/**
+ * Garante que o filho i tenha mais que o mínimo de chaves antes de a remoção descer por ele.
+ *
+ * O filho recebe uma entrada de um irmão adjacente quando algum deles está acima do mínimo;
+ * caso contrário, é juntado a um dos irmãos.
+ *
+ * @param pai Ponteiro para o nó interno pai.
+ * @param i Índice do filho por onde a remoção vai descer.
+ * @return Índice do filho por onde a remoção deve continuar após o ajuste.
+ */
+static int garantirFolgaBStar(NoArvoreBStar *pai, int i) {
+    NoInternoArvoreBStar *interno = &pai->tipo.interno;
+    NoArvoreBStar *filho = interno->filhos[i];
+
+    if (numChavesNo(filho) > minimoChavesNo(filho)) {
+        return i;
+    }
+
+    if (i > 0 && numChavesNo(interno->filhos[i - 1]) > minimoChavesNo(filho)) {
+        redistribuirParaDireita(pai, i - 1);
+    } else if (i < interno->numChaves && numChavesNo(interno->filhos[i + 1]) > minimoChavesNo(filho)) {
+        redistribuirParaEsquerda(pai, i + 1);
+    } else if (i < interno->numChaves) {
+        juntarFilhosBStar(pai, i);
+    } else {
+        juntarFilhosBStar(pai, i - 1);
+        i--;
+    }
+    return i;
+}
+
+/**
+ * Remove um registro da árvore B*.
+ *
+ * A remoção desce a árvore uma única vez, redistribuindo entradas entre irmãos ou juntando
+ * nós para que a folha de onde o registro sai nunca fique abaixo do mínimo. Entre chaves
+ * repetidas sai a primeira ocorrência, cuja subárvore é escolhida em cada nível por
+ * encontrarFilhoPrimeiraOcorrencia. Se a raiz ficar sem chaves, a árvore diminui de altura.
+ *
+ * @param raiz Ponteiro para a raiz da árvore B*.
+ * @param chave Chave do registro a ser removido.
+ * @param posicaoRemovida Ponteiro onde será armazenada a posição do registro removido, ou -1 se a chave não existir.
+ * @param metricas Ponteiro para as métricas da fase em andamento.
+ * @return Ponteiro para a raiz atualizada da árvore B*.
+ */
+NoArvoreBStar* removerArvoreBStar(NoArvoreBStar *raiz, Chave chave, long *posicaoRemovida, Metricas *metricas) {
+    *posicaoRemovida = -1;
+    if (raiz == NULL) {
+        return NULL;
+    }
+
+    NoArvoreBStar *no = raiz;
+    while (!no->folha) {
+        int i = encontrarFilhoPrimeiraOcorrencia(&no->tipo.interno, chave, metricas);
+        i = garantirFolgaBStar(no, i);
+        no = no->tipo.interno.filhos[i];
+    }
+
+    NoFolhaArvoreBStar *folha = &no->tipo.folha;
+    int i = encontrarPosicaoInsercao(folha->chaves, folha->numChaves, chave);
+    metricas->comparacoes += i + 1;
+
+    if (i < folha->numChaves && folha->chaves[i] == chave) {
+        *posicaoRemovida = folha->posicoes[i];
+        for (int j = i; j < folha->numChaves - 1; j++) {
+            folha->chaves[j] = folha->chaves[j + 1];
+            folha->registros[j] = folha->registros[j + 1];
+            folha->posicoes[j] = folha->posicoes[j + 1];
+        }
+        folha->numChaves--;
+    }
+
+    // Se a raiz ficou sem chaves, a árvore perde um nível
+    if (numChavesNo(raiz) == 0) {
+        NoArvoreBStar *novaRaiz = raiz->folha ? NULL : raiz->tipo.interno.filhos[0];
+        free(raiz);
+        raiz = novaRaiz;
+    }
+
+    return raiz;
+}
+
+/**
+ * Monta uma árvore B* de uma só vez a partir de registros ordenados por chave e, entre
+ * chaves repetidas, por posição.
+ *
+ * As folhas são preenchidas por igual, ligadas em sequência, e cada nível de nós internos é
+ * montado sobre o anterior, usando como chave separadora a menor chave de cada filho. Como
+ * os nós de um nível recebem quantidades iguais, nenhum fica abaixo do mínimo de chaves.
+ *
+ * @param registros Registros ordenados por chave.
+ * @param posicoes Posição de cada registro no armazenamento externo.
+ * @param quantidade Número de registros.
+ * @return Ponteiro para a raiz da árvore B* ou NULL se não houver registros.
+ */
+NoArvoreBStar* montarArvoreBStar(const Registro *registros, const long *posicoes, long quantidade) {
+    if (quantidade == 0) {
+        return NULL;
+    }
+
+    long numNos = (quantidade + ORDEM_ARVORE_BSTAR - 2) / (ORDEM_ARVORE_BSTAR - 1);
+    NoArvoreBStar **nivel = malloc(numNos * sizeof(NoArvoreBStar *));
+    Chave *menores = malloc(numNos * sizeof(Chave)); // Menor chave de cada subárvore do nível
+
+    // Folhas
+    NoFolhaArvoreBStar *anterior = NULL;
+    long inicio = 0;
+    for (long i = 0; i < numNos; i++) {
+        long tamanho = quantidade / numNos + (i < quantidade % numNos ? 1 : 0);
+        NoArvoreBStar *no = criarNoArvoreBStar(true);
+        NoFolhaArvoreBStar *folha = &no->tipo.folha;
+
+        for (long j = 0; j < tamanho; j++) {
+            folha->chaves[j] = registros[inicio + j].chave;
+            folha->registros[j] = registros[inicio + j];
+            folha->posicoes[j] = posicoes[inicio + j];
+        }
+        folha->numChaves = tamanho;
+
+        if (anterior != NULL) {
+            anterior->proximo = folha;
+        }
+        anterior = folha;
+
+        nivel[i] = no;
+        menores[i] = registros[inicio].chave;
+        inicio += tamanho;
+    }
+
+    // Níveis internos, até sobrar apenas a raiz
+    while (numNos > 1) {
+        long numPais = (numNos + ORDEM_ARVORE_BSTAR - 1) / ORDEM_ARVORE_BSTAR;
+        long proximo = 0;
+        for (long i = 0; i < numPais; i++) {
+            long tamanho = numNos / numPais + (i < numNos % numPais ? 1 : 0);
+            NoArvoreBStar *pai = criarNoArvoreBStar(false);
+            NoInternoArvoreBStar *interno = &pai->tipo.interno;
+
+            for (long j = 0; j < tamanho; j++) {
+                interno->filhos[j] = nivel[proximo + j];
+                if (j > 0) {
+                    interno->chaves[j - 1] = menores[proximo + j];
+                }
+            }
+            interno->numChaves = tamanho - 1;
+
+            // O nível é reescrito no próprio vetor: i nunca passa de proximo
+            menores[i] = menores[proximo];
+            nivel[i] = pai;
+            proximo += tamanho;
+        }
+        numNos = numPais;
+    }
+
+    NoArvoreBStar *raiz = nivel[0];
+    free(nivel);
+    free(menores);
+    return raiz;
+}
+
+/**
+ * Conta os nós de uma subárvore da árvore B*.
+ */
+static uint64_t contarNosArvoreBStar(NoArvoreBStar *no) {
+    uint64_t total = 1;
+    if (!no->folha) {
+        for (int i = 0; i <= no->tipo.interno.numChaves; i++) {
+            total += contarNosArvoreBStar(no->tipo.interno.filhos[i]);
+        }
+    }
+    return total;
+}
+
+/**
+ * Percorre a árvore B* registrando sua altura e número de nós nas métricas.
+ *
+ * @param raiz Ponteiro para a raiz da árvore B*.
+ * @param metricas Ponteiro para as métricas onde altura e número de nós serão registrados.
+ */
+void medirArvoreBStar(NoArvoreBStar *raiz, Metricas *metricas) {
+    metricas->altura = 0;
+    metricas->numNos = 0;
+    if (raiz == NULL) {
+        return;
+    }
+
+    for (NoArvoreBStar *no = raiz; no != NULL; no = no->folha ? NULL : no->tipo.interno.filhos[0]) {
+        metricas->altura++;
+    }
+    metricas->numNos = contarNosArvoreBStar(raiz);
+}
+
+/**
+ * Destrói uma árvore B* e libera a memória alocada.
+ *
+ * @param raiz Ponteiro para a raiz da árvore B* a ser destruída.
+ */
 void destruirArvoreBStar(NoArvoreBStar *raiz) {
-    return;
-}
\ No newline at end of file
+    if (raiz == NULL) {
+        return;
+    }
+
+    if (!raiz->folha) {
+        for (int i = 0; i <= raiz->tipo.interno.numChaves; i++) {
+            destruirArvoreBStar(raiz->tipo.interno.filhos[i]);
+        }
+    }
+
+    free(raiz);
+}
+
+static void* inserirVarianteArvoreBStar(void *raiz, Registro reg, long posicao, Metricas *metricas) {
+    return inserirArvoreBStar(raiz, reg, posicao, metricas);
+}
+
+static Registro* buscarVarianteArvoreBStar(void *raiz, Chave chave, long *posicao, Metricas *metricas) {
+    return buscarArvoreBStar(raiz, chave, posicao, metricas);
+}
+
+static void buscarLoteVarianteArvoreBStar(void *raiz, const Chave *chaves, int quantidade, Registro **resultados, long *posicoes, Metricas *metricas) {
+    buscarLoteArvoreBStar(raiz, chaves, quantidade, resultados, posicoes, metricas);
+}
+
+static void juntarLoteVarianteArvoreBStar(void *raiz, const Chave *chaves, int quantidade, Registro **resultados, long *posicoes, Metricas *metricas) {
+    juntarLoteArvoreBStar(raiz, chaves, quantidade, resultados, posicoes, metricas);
+}
+
+static void medirVarianteArvoreBStar(void *raiz, Metricas *metricas) {
+    medirArvoreBStar(raiz, metricas);
+}
+
+static void destruirVarianteArvoreBStar(void *raiz) {
+    destruirArvoreBStar(raiz);
+}
+
+/**
+ * Descreve a variante compilada neste objeto (a ordem padrão ou um tamanho de nó).
+ *
+ * @param variante Estrutura onde o nome, a ordem e as operações da variante serão gravados.
+ */
+void descreverVarianteArvoreBStar(VarianteArvoreBStar *variante) {
+#ifdef BYTES_NO_ARVORE_BSTAR
+    _Static_assert(sizeof(NoArvoreBStar) <= BYTES_NO_ARVORE_BSTAR, "O nó da variante não cabe no tamanho pedido");
+#define TEXTO_ARVORE_BSTAR(bytes) #bytes
+#define NOME_TEXTO_ARVORE_BSTAR(bytes) TEXTO_ARVORE_BSTAR(bytes)
+    variante->nome = NOME_TEXTO_ARVORE_BSTAR(BYTES_NO_ARVORE_BSTAR);
+#else
+    variante->nome = "padrao";
+#endif
+    variante->ordem = ORDEM_ARVORE_BSTAR;
+    variante->bytesNo = sizeof(NoArvoreBStar);
+    variante->inserir = inserirVarianteArvoreBStar;
+    variante->buscar = buscarVarianteArvoreBStar;
+    variante->buscarLote = buscarLoteVarianteArvoreBStar;
+    variante->juntarLote = juntarLoteVarianteArvoreBStar;
+    variante->medir = medirVarianteArvoreBStar;
+    variante->destruir = destruirVarianteArvoreBStar;
+}
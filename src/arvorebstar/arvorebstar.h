@@ -2,22 +2,71 @@
 #define ARVOREBSTAR_H
 
 #include "../registro/registro.h"
+#include "../metricas/metricas.h"
 #include <stdbool.h>
 
+/*
+ * Variantes por tamanho de nó, como na Árvore B: com -DBYTES_NO_ARVORE_BSTAR=<bytes>, a ordem
+ * passa a ser a maior cuja folha (que guarda os registros inteiros) cabe nesse tamanho e os
+ * símbolos externos ganham o sufixo _<bytes>.
+ */
+#ifdef BYTES_NO_ARVORE_BSTAR
+#define JUNTAR_NOME_ARVORE_BSTAR(nome, bytes) nome##_##bytes
+#define NOME_VARIANTE_ARVORE_BSTAR(nome, bytes) JUNTAR_NOME_ARVORE_BSTAR(nome, bytes)
+#define criarNoArvoreBStar NOME_VARIANTE_ARVORE_BSTAR(criarNoArvoreBStar, BYTES_NO_ARVORE_BSTAR)
+#define encontrarPosicaoInsercao NOME_VARIANTE_ARVORE_BSTAR(encontrarPosicaoInsercao, BYTES_NO_ARVORE_BSTAR)
+#define inserirRegistroNoNóFolha NOME_VARIANTE_ARVORE_BSTAR(inserirRegistroNoNóFolha, BYTES_NO_ARVORE_BSTAR)
+#define inserirArvoreBStar NOME_VARIANTE_ARVORE_BSTAR(inserirArvoreBStar, BYTES_NO_ARVORE_BSTAR)
+#define buscarArvoreBStar NOME_VARIANTE_ARVORE_BSTAR(buscarArvoreBStar, BYTES_NO_ARVORE_BSTAR)
+#define buscarLoteArvoreBStar NOME_VARIANTE_ARVORE_BSTAR(buscarLoteArvoreBStar, BYTES_NO_ARVORE_BSTAR)
+#define juntarLoteArvoreBStar NOME_VARIANTE_ARVORE_BSTAR(juntarLoteArvoreBStar, BYTES_NO_ARVORE_BSTAR)
+#define buscarTodosArvoreBStar NOME_VARIANTE_ARVORE_BSTAR(buscarTodosArvoreBStar, BYTES_NO_ARVORE_BSTAR)
+#define buscarIntervaloArvoreBStar NOME_VARIANTE_ARVORE_BSTAR(buscarIntervaloArvoreBStar, BYTES_NO_ARVORE_BSTAR)
+#define montarArvoreBStar NOME_VARIANTE_ARVORE_BSTAR(montarArvoreBStar, BYTES_NO_ARVORE_BSTAR)
+#define removerArvoreBStar NOME_VARIANTE_ARVORE_BSTAR(removerArvoreBStar, BYTES_NO_ARVORE_BSTAR)
+#define medirArvoreBStar NOME_VARIANTE_ARVORE_BSTAR(medirArvoreBStar, BYTES_NO_ARVORE_BSTAR)
+#define destruirArvoreBStar NOME_VARIANTE_ARVORE_BSTAR(destruirArvoreBStar, BYTES_NO_ARVORE_BSTAR)
+#define descreverVarianteArvoreBStar NOME_VARIANTE_ARVORE_BSTAR(descreverVarianteArvoreBStar, BYTES_NO_ARVORE_BSTAR)
+#define ORDEM_ARVORE_BSTAR ((BYTES_NO_ARVORE_BSTAR - 32) / (int)(sizeof(Chave) + sizeof(Registro) + sizeof(long)) + 1)
+#endif
+
+#ifndef ORDEM_ARVORE_BSTAR // Os microbenchmarks compilam a árvore com outras ordens
 #define ORDEM_ARVORE_BSTAR 5 // Definindo a ordem da árvore B*
+#endif
+#define MINIMO_CHAVES_FOLHA_BSTAR ((ORDEM_ARVORE_BSTAR - 1) / 2) // Mínimo de chaves em uma folha não raiz
+#define MINIMO_CHAVES_INTERNO_BSTAR ((ORDEM_ARVORE_BSTAR - 2) / 2) // Mínimo de chaves em um nó interno não raiz
+#define GRUPO_LOTE_ARVORE_BSTAR 16 // Consultas de um lote que descem a árvore juntas
+#define LINHA_CACHE_ARVORE_BSTAR 64 // Bytes de uma linha de cache
+#define LINHAS_ANTECIPADAS_ARVORE_BSTAR 4 // Máximo de linhas de um nó pedidas por antecipação na busca em lote
+
+/*
+ * Operações de uma variante da árvore B*, sobre a raiz vista como ponteiro opaco.
+ */
+typedef struct {
+    const char *nome; // Tamanho do nó em bytes, ou "padrao" para a ordem padrão
+    int ordem;
+    size_t bytesNo; // Tamanho real de um nó
+    void* (*inserir)(void *raiz, Registro reg, long posicao, Metricas *metricas);
+    Registro* (*buscar)(void *raiz, Chave chave, long *posicao, Metricas *metricas);
+    void (*buscarLote)(void *raiz, const Chave *chaves, int quantidade, Registro **resultados, long *posicoes, Metricas *metricas);
+    void (*juntarLote)(void *raiz, const Chave *chaves, int quantidade, Registro **resultados, long *posicoes, Metricas *metricas); // Lote em ordem crescente
+    void (*medir)(void *raiz, Metricas *metricas);
+    void (*destruir)(void *raiz);
+} VarianteArvoreBStar;
 
 // Estrutura para nós internos
 typedef struct NoInternoArvoreBStar {
     int numChaves; // Número de chaves no nó
-    int chaves[ORDEM_ARVORE_BSTAR - 1]; // Array de chaves
+    Chave chaves[ORDEM_ARVORE_BSTAR - 1]; // Array de chaves
     struct NoArvoreBStar *filhos[ORDEM_ARVORE_BSTAR]; // Ponteiros para os filhos
 } NoInternoArvoreBStar;
 
 // Estrutura para nós folha
 typedef struct NoFolhaArvoreBStar {
     int numChaves; // Número de chaves no nó
-    int chaves[ORDEM_ARVORE_BSTAR - 1]; // Array de chaves
+    Chave chaves[ORDEM_ARVORE_BSTAR - 1]; // Array de chaves
     Registro registros[ORDEM_ARVORE_BSTAR - 1]; // Array de registros
+    long posicoes[ORDEM_ARVORE_BSTAR - 1]; // Posição de cada registro no armazenamento externo
     struct NoFolhaArvoreBStar *proximo; // Ponteiro para o próximo nó folha
 } NoFolhaArvoreBStar;
 
@@ -31,8 +80,18 @@ typedef struct NoArvoreBStar {
 } NoArvoreBStar;
 
 NoArvoreBStar* criarNoArvoreBStar(bool ehFolha);
-NoArvoreBStar* inserirArvoreBStar(NoArvoreBStar *raiz, Registro reg, int *transferencias, int *comparacoes);
-Registro* buscarArvoreBStar(NoArvoreBStar *raiz, int chave, int *transferencias, int *comparacoes);
+int encontrarPosicaoInsercao(Chave chaves[], int numChaves, Chave chave);
+bool inserirRegistroNoNóFolha(NoFolhaArvoreBStar *no, Registro reg, long posicao, Metricas *metricas);
+NoArvoreBStar* inserirArvoreBStar(NoArvoreBStar *raiz, Registro reg, long posicao, Metricas *metricas);
+Registro* buscarArvoreBStar(NoArvoreBStar *raiz, Chave chave, long *posicao, Metricas *metricas);
+void buscarLoteArvoreBStar(NoArvoreBStar *raiz, const Chave *chaves, int quantidade, Registro **resultados, long *posicoes, Metricas *metricas);
+void juntarLoteArvoreBStar(NoArvoreBStar *raiz, const Chave *chaves, int quantidade, Registro **resultados, long *posicoes, Metricas *metricas);
+int buscarTodosArvoreBStar(NoArvoreBStar *raiz, Chave chave, Registro **registros, long *posicoes, int limite, Metricas *metricas);
+int buscarIntervaloArvoreBStar(NoArvoreBStar *raiz, Chave minimo, Chave maximo, Chave *chaves, long *posicoes, int limite, Metricas *metricas);
+NoArvoreBStar* montarArvoreBStar(const Registro *registros, const long *posicoes, long quantidade);
+NoArvoreBStar* removerArvoreBStar(NoArvoreBStar *raiz, Chave chave, long *posicaoRemovida, Metricas *metricas);
+void medirArvoreBStar(NoArvoreBStar *raiz, Metricas *metricas);
 void destruirArvoreBStar(NoArvoreBStar *raiz);
+void descreverVarianteArvoreBStar(VarianteArvoreBStar *variante);
 
 #endif // ARVOREBSTAR_H
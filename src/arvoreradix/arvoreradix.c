@@ -0,0 +1,451 @@
+#include "arvoreradix.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Devolve o byte da chave usado no nível dado, com o bit de sinal invertido para que a
+ * ordem dos bytes sem sinal siga a ordem das chaves com sinal.
+ */
+static uint8_t byteChave(Chave chave, int nivel) {
+    uint64_t ordenada = (uint64_t)chave ^ ((uint64_t)1 << (8 * BYTES_CHAVE_RADIX - 1));
+    return (uint8_t)(ordenada >> (8 * (BYTES_CHAVE_RADIX - 1 - nivel)));
+}
+
+/**
+ * Aloca um nó interno vazio do tipo dado.
+ */
+static NoArvoreRadix* criarNoRadix(TipoNoRadix tipo) {
+    size_t tamanho = tipo == RADIX_NO4 ? sizeof(NoRadix4)
+        : tipo == RADIX_NO16 ? sizeof(NoRadix16)
+        : tipo == RADIX_NO48 ? sizeof(NoRadix48)
+        : sizeof(NoRadix256);
+    NoArvoreRadix *no = calloc(1, tamanho);
+    no->tipo = tipo;
+    return no;
+}
+
+/**
+ * Aloca uma folha com a chave e a posição do registro.
+ */
+static NoArvoreRadix* criarFolhaRadix(Chave chave, long posicao) {
+    FolhaArvoreRadix *folha = calloc(1, sizeof(FolhaArvoreRadix));
+    folha->cabecalho.tipo = RADIX_FOLHA;
+    folha->chave = chave;
+    folha->posicao = posicao;
+    return &folha->cabecalho;
+}
+
+/**
+ * Acrescenta a posição de mais uma ocorrência da chave de uma folha, dobrando a lista quando
+ * ela está cheia.
+ */
+static void acrescentarOcorrenciaRadix(FolhaArvoreRadix *folha, long posicao) {
+    ListaPosicoesRadix *lista = folha->repetidas;
+    if (lista == NULL || lista->quantidade == lista->capacidade) {
+        int capacidade = lista == NULL ? 2 : 2 * lista->capacidade;
+        lista = realloc(lista, sizeof(ListaPosicoesRadix) + capacidade * sizeof(long));
+        if (lista == NULL) {
+            perror("Erro ao alocar as ocorrências da chave");
+            return;
+        }
+        if (folha->repetidas == NULL) {
+            lista->quantidade = 0;
+        }
+        lista->capacidade = capacidade;
+        folha->repetidas = lista;
+    }
+    lista->posicoes[lista->quantidade++] = posicao;
+}
+
+/**
+ * Localiza o ponteiro para o filho de um nó interno que corresponde ao byte dado.
+ *
+ * @return Endereço do ponteiro para o filho, ou NULL se o nó não tem filho para o byte.
+ */
+static NoArvoreRadix** encontrarFilhoRadix(NoArvoreRadix *no, uint8_t byte, Metricas *metricas) {
+    switch (no->tipo) {
+        case RADIX_NO4: {
+            NoRadix4 *no4 = (NoRadix4 *)no;
+            for (int i = 0; i < no->numFilhos; i++) {
+                metricas->comparacoes++;
+                if (no4->bytes[i] == byte) {
+                    return &no4->filhos[i];
+                }
+            }
+            return NULL;
+        }
+        case RADIX_NO16: {
+            NoRadix16 *no16 = (NoRadix16 *)no;
+            for (int i = 0; i < no->numFilhos; i++) {
+                metricas->comparacoes++;
+                if (no16->bytes[i] == byte) {
+                    return &no16->filhos[i];
+                }
+            }
+            return NULL;
+        }
+        case RADIX_NO48: {
+            NoRadix48 *no48 = (NoRadix48 *)no;
+            metricas->comparacoes++;
+            return no48->indices[byte] ? &no48->filhos[no48->indices[byte] - 1] : NULL;
+        }
+        case RADIX_NO256: {
+            NoRadix256 *no256 = (NoRadix256 *)no;
+            metricas->comparacoes++;
+            return no256->filhos[byte] ? &no256->filhos[byte] : NULL;
+        }
+        default:
+            return NULL;
+    }
+}
+
+/**
+ * Insere um filho em um nó interno de 4 ou 16 filhos, mantendo os bytes em ordem crescente.
+ */
+static void inserirFilhoOrdenado(uint8_t *bytes, NoArvoreRadix **filhos, int numFilhos, uint8_t byte, NoArvoreRadix *filho) {
+    int i = numFilhos;
+    while (i > 0 && bytes[i - 1] > byte) {
+        bytes[i] = bytes[i - 1];
+        filhos[i] = filhos[i - 1];
+        i--;
+    }
+    bytes[i] = byte;
+    filhos[i] = filho;
+}
+
+/**
+ * Copia o cabeçalho de um nó para o nó que o substitui ao crescer, e libera o antigo.
+ */
+static void substituirNoRadix(NoArvoreRadix **referencia, NoArvoreRadix *antigo, NoArvoreRadix *novo) {
+    novo->tamanhoPrefixo = antigo->tamanhoPrefixo;
+    novo->numFilhos = antigo->numFilhos;
+    memcpy(novo->prefixo, antigo->prefixo, sizeof(antigo->prefixo));
+    *referencia = novo;
+    free(antigo);
+}
+
+/**
+ * Acrescenta um filho a um nó interno, trocando o nó por um tipo maior se ele estiver cheio.
+ *
+ * @param referencia Ponteiro que aponta para o nó (na raiz ou no pai), atualizado na troca.
+ * @param byte Byte que leva ao novo filho.
+ * @param filho Novo filho.
+ * @param metricas Ponteiro para as métricas; cada troca de tipo conta como uma divisão.
+ */
+static void adicionarFilhoRadix(NoArvoreRadix **referencia, uint8_t byte, NoArvoreRadix *filho, Metricas *metricas) {
+    NoArvoreRadix *no = *referencia;
+
+    switch (no->tipo) {
+        case RADIX_NO4: {
+            NoRadix4 *no4 = (NoRadix4 *)no;
+            if (no->numFilhos < 4) {
+                inserirFilhoOrdenado(no4->bytes, no4->filhos, no->numFilhos, byte, filho);
+                no->numFilhos++;
+                return;
+            }
+            NoRadix16 *no16 = (NoRadix16 *)criarNoRadix(RADIX_NO16);
+            memcpy(no16->bytes, no4->bytes, sizeof(no4->bytes));
+            memcpy(no16->filhos, no4->filhos, sizeof(no4->filhos));
+            substituirNoRadix(referencia, no, &no16->cabecalho);
+            metricas->divisoes++;
+            adicionarFilhoRadix(referencia, byte, filho, metricas);
+            return;
+        }
+        case RADIX_NO16: {
+            NoRadix16 *no16 = (NoRadix16 *)no;
+            if (no->numFilhos < 16) {
+                inserirFilhoOrdenado(no16->bytes, no16->filhos, no->numFilhos, byte, filho);
+                no->numFilhos++;
+                return;
+            }
+            NoRadix48 *no48 = (NoRadix48 *)criarNoRadix(RADIX_NO48);
+            for (int i = 0; i < 16; i++) {
+                no48->indices[no16->bytes[i]] = i + 1;
+                no48->filhos[i] = no16->filhos[i];
+            }
+            substituirNoRadix(referencia, no, &no48->cabecalho);
+            metricas->divisoes++;
+            adicionarFilhoRadix(referencia, byte, filho, metricas);
+            return;
+        }
+        case RADIX_NO48: {
+            NoRadix48 *no48 = (NoRadix48 *)no;
+            if (no->numFilhos < 48) {
+                // Sem remoções, as vagas ocupadas são sempre as primeiras
+                no48->filhos[no->numFilhos] = filho;
+                no48->indices[byte] = no->numFilhos + 1;
+                no->numFilhos++;
+                return;
+            }
+            NoRadix256 *no256 = (NoRadix256 *)criarNoRadix(RADIX_NO256);
+            for (int b = 0; b < 256; b++) {
+                if (no48->indices[b]) {
+                    no256->filhos[b] = no48->filhos[no48->indices[b] - 1];
+                }
+            }
+            substituirNoRadix(referencia, no, &no256->cabecalho);
+            metricas->divisoes++;
+            adicionarFilhoRadix(referencia, byte, filho, metricas);
+            return;
+        }
+        case RADIX_NO256: {
+            ((NoRadix256 *)no)->filhos[byte] = filho;
+            no->numFilhos++;
+            return;
+        }
+        default:
+            return;
+    }
+}
+
+/**
+ * Insere uma chave na árvore radix adaptativa.
+ *
+ * A descida compara o prefixo comprimido de cada nó com a chave. Se o prefixo diverge, um
+ * nó de 4 filhos é criado no ponto da divergência; se a descida chega a uma folha de outra
+ * chave, um nó de 4 filhos com o prefixo comum das duas chaves passa a separá-las. Uma chave
+ * repetida acrescenta a sua posição à lista de ocorrências da folha.
+ *
+ * @param raiz Ponteiro para a raiz da árvore (NULL para a árvore vazia).
+ * @param chave Chave a ser inserida.
+ * @param posicao Posição do registro no arquivo.
+ * @param metricas Ponteiro para as métricas da fase em andamento.
+ * @return Ponteiro para a raiz da árvore, que muda quando a raiz é substituída.
+ */
+NoArvoreRadix* inserirArvoreRadix(NoArvoreRadix *raiz, Chave chave, long posicao, Metricas *metricas) {
+    NoArvoreRadix **referencia = &raiz;
+    int nivel = 0;
+
+    while (*referencia != NULL) {
+        NoArvoreRadix *no = *referencia;
+
+        if (no->tipo == RADIX_FOLHA) {
+            FolhaArvoreRadix *folha = (FolhaArvoreRadix *)no;
+            metricas->comparacoes++;
+            if (folha->chave == chave) {
+                acrescentarOcorrenciaRadix(folha, posicao);
+                return raiz;
+            }
+
+            // Separa as duas chaves no primeiro byte em que diferem
+            NoArvoreRadix *novo = criarNoRadix(RADIX_NO4);
+            while (byteChave(folha->chave, nivel + novo->tamanhoPrefixo) == byteChave(chave, nivel + novo->tamanhoPrefixo)) {
+                novo->prefixo[novo->tamanhoPrefixo] = byteChave(chave, nivel + novo->tamanhoPrefixo);
+                novo->tamanhoPrefixo++;
+            }
+            int divergente = nivel + novo->tamanhoPrefixo;
+            *referencia = novo;
+            adicionarFilhoRadix(referencia, byteChave(folha->chave, divergente), no, metricas);
+            adicionarFilhoRadix(referencia, byteChave(chave, divergente), criarFolhaRadix(chave, posicao), metricas);
+            return raiz;
+        }
+
+        // Compara o prefixo comprimido com os bytes seguintes da chave
+        int comum = 0;
+        while (comum < no->tamanhoPrefixo && no->prefixo[comum] == byteChave(chave, nivel + comum)) {
+            metricas->comparacoes++;
+            comum++;
+        }
+        if (comum < no->tamanhoPrefixo) {
+            metricas->comparacoes++;
+
+            // O prefixo diverge: um novo nó assume a parte comum e o antigo fica com o restante
+            NoArvoreRadix *novo = criarNoRadix(RADIX_NO4);
+            novo->tamanhoPrefixo = comum;
+            memcpy(novo->prefixo, no->prefixo, comum);
+            uint8_t byteAntigo = no->prefixo[comum];
+            no->tamanhoPrefixo -= comum + 1;
+            memmove(no->prefixo, no->prefixo + comum + 1, no->tamanhoPrefixo);
+
+            *referencia = novo;
+            adicionarFilhoRadix(referencia, byteAntigo, no, metricas);
+            adicionarFilhoRadix(referencia, byteChave(chave, nivel + comum), criarFolhaRadix(chave, posicao), metricas);
+            return raiz;
+        }
+        nivel += no->tamanhoPrefixo;
+
+        uint8_t byte = byteChave(chave, nivel);
+        NoArvoreRadix **filho = encontrarFilhoRadix(no, byte, metricas);
+        if (filho == NULL) {
+            adicionarFilhoRadix(referencia, byte, criarFolhaRadix(chave, posicao), metricas);
+            return raiz;
+        }
+        referencia = filho;
+        nivel++;
+    }
+
+    *referencia = criarFolhaRadix(chave, posicao);
+    return raiz;
+}
+
+/**
+ * Busca uma chave na árvore radix adaptativa.
+ *
+ * Cada nó interno consome seu prefixo comprimido e um byte da chave; a folha alcançada
+ * guarda a chave inteira, que é comparada no fim para confirmar o resultado.
+ *
+ * @param raiz Ponteiro para a raiz da árvore.
+ * @param chave Chave a ser buscada.
+ * @param metricas Ponteiro para as métricas da fase em andamento.
+ * @return Ponteiro para a folha encontrada ou NULL se a chave não estiver na árvore.
+ */
+FolhaArvoreRadix* buscarArvoreRadix(NoArvoreRadix *raiz, Chave chave, Metricas *metricas) {
+    NoArvoreRadix *no = raiz;
+    int nivel = 0;
+
+    while (no != NULL) {
+        if (no->tipo == RADIX_FOLHA) {
+            FolhaArvoreRadix *folha = (FolhaArvoreRadix *)no;
+            metricas->comparacoes++;
+            return folha->chave == chave ? folha : NULL;
+        }
+
+        for (int i = 0; i < no->tamanhoPrefixo; i++) {
+            metricas->comparacoes++;
+            if (no->prefixo[i] != byteChave(chave, nivel + i)) {
+                return NULL;
+            }
+        }
+        nivel += no->tamanhoPrefixo;
+
+        NoArvoreRadix **filho = encontrarFilhoRadix(no, byteChave(chave, nivel), metricas);
+        no = filho != NULL ? *filho : NULL;
+        nivel++;
+    }
+    return NULL;
+}
+
+/**
+ * Busca todas as ocorrências de uma chave na árvore radix: a descida é a de
+ * buscarArvoreRadix e a folha guarda a posição da primeira ocorrência e a lista das demais.
+ *
+ * @param raiz Ponteiro para a raiz da árvore.
+ * @param chave Chave a ser buscada.
+ * @param posicoes Vetor onde as posições das ocorrências serão armazenadas, até o limite.
+ * @param limite Tamanho do vetor de posições.
+ * @param metricas Ponteiro para as métricas da fase em andamento.
+ * @return Número de ocorrências da chave, que pode passar do limite.
+ */
+int buscarTodosArvoreRadix(NoArvoreRadix *raiz, Chave chave, long *posicoes, int limite, Metricas *metricas) {
+    FolhaArvoreRadix *folha = buscarArvoreRadix(raiz, chave, metricas);
+    if (folha == NULL) {
+        return 0;
+    }
+    int encontradas = 1 + (folha->repetidas != NULL ? folha->repetidas->quantidade : 0);
+    for (int i = 0; i < encontradas && i < limite; i++) {
+        posicoes[i] = i == 0 ? folha->posicao : folha->repetidas->posicoes[i - 1];
+    }
+    return encontradas;
+}
+
+/**
+ * Percorre a subárvore contando seus nós e acumulando sua altura e memória ocupada.
+ */
+static void percorrerArvoreRadix(NoArvoreRadix *no, uint64_t profundidade, uint64_t *altura, uint64_t *numNos, size_t *memoria) {
+    (*numNos)++;
+    if (profundidade > *altura) {
+        *altura = profundidade;
+    }
+
+    NoArvoreRadix **filhos;
+    int capacidade;
+    switch (no->tipo) {
+        case RADIX_NO4:
+            *memoria += sizeof(NoRadix4);
+            filhos = ((NoRadix4 *)no)->filhos;
+            capacidade = no->numFilhos;
+            break;
+        case RADIX_NO16:
+            *memoria += sizeof(NoRadix16);
+            filhos = ((NoRadix16 *)no)->filhos;
+            capacidade = no->numFilhos;
+            break;
+        case RADIX_NO48:
+            *memoria += sizeof(NoRadix48);
+            filhos = ((NoRadix48 *)no)->filhos;
+            capacidade = no->numFilhos;
+            break;
+        case RADIX_NO256:
+            *memoria += sizeof(NoRadix256);
+            filhos = ((NoRadix256 *)no)->filhos;
+            capacidade = 256;
+            break;
+        default:
+            *memoria += sizeof(FolhaArvoreRadix);
+            if (((FolhaArvoreRadix *)no)->repetidas != NULL) {
+                *memoria += sizeof(ListaPosicoesRadix) + ((FolhaArvoreRadix *)no)->repetidas->capacidade * sizeof(long);
+            }
+            return;
+    }
+
+    for (int i = 0; i < capacidade; i++) {
+        if (filhos[i] != NULL) {
+            percorrerArvoreRadix(filhos[i], profundidade + 1, altura, numNos, memoria);
+        }
+    }
+}
+
+/**
+ * Percorre a árvore radix registrando sua altura e número de nós (folhas incluídas).
+ *
+ * @param raiz Ponteiro para a raiz da árvore.
+ * @param metricas Ponteiro para as métricas onde altura e número de nós serão registrados.
+ */
+void medirArvoreRadix(NoArvoreRadix *raiz, Metricas *metricas) {
+    size_t memoria = 0;
+    metricas->altura = 0;
+    metricas->numNos = 0;
+    if (raiz != NULL) {
+        percorrerArvoreRadix(raiz, 1, &metricas->altura, &metricas->numNos, &memoria);
+    }
+}
+
+/**
+ * Calcula os bytes ocupados pelos nós e folhas da árvore, sem o custo do alocador.
+ */
+size_t memoriaArvoreRadix(NoArvoreRadix *raiz) {
+    uint64_t altura = 0, numNos = 0;
+    size_t memoria = 0;
+    if (raiz != NULL) {
+        percorrerArvoreRadix(raiz, 1, &altura, &numNos, &memoria);
+    }
+    return memoria;
+}
+
+/**
+ * Libera todos os nós e folhas da árvore radix.
+ *
+ * @param raiz Ponteiro para a raiz da árvore.
+ */
+void destruirArvoreRadix(NoArvoreRadix *raiz) {
+    if (raiz == NULL) {
+        return;
+    }
+
+    switch (raiz->tipo) {
+        case RADIX_NO4:
+            for (int i = 0; i < raiz->numFilhos; i++) {
+                destruirArvoreRadix(((NoRadix4 *)raiz)->filhos[i]);
+            }
+            break;
+        case RADIX_NO16:
+            for (int i = 0; i < raiz->numFilhos; i++) {
+                destruirArvoreRadix(((NoRadix16 *)raiz)->filhos[i]);
+            }
+            break;
+        case RADIX_NO48:
+            for (int i = 0; i < raiz->numFilhos; i++) {
+                destruirArvoreRadix(((NoRadix48 *)raiz)->filhos[i]);
+            }
+            break;
+        case RADIX_NO256:
+            for (int i = 0; i < 256; i++) {
+                destruirArvoreRadix(((NoRadix256 *)raiz)->filhos[i]);
+            }
+            break;
+        default:
+            free(((FolhaArvoreRadix *)raiz)->repetidas);
+            break;
+    }
+    free(raiz);
+}
@@ -0,0 +1,82 @@
+#ifndef ARVORERADIX_H
+#define ARVORERADIX_H
+
+#include "../registro/registro.h"
+#include "../metricas/metricas.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define BYTES_CHAVE_RADIX ((int)sizeof(Chave)) // A chave é consumida um byte por nível
+
+/*
+ * Árvore radix adaptativa (ART) sobre a chave (32 ou 64 bits, conforme a compilação).
+ *
+ * A chave é percorrida do byte mais significativo para o menos significativo, com o bit de
+ * sinal invertido para que a ordem dos bytes siga a ordem das chaves. Os nós internos mudam
+ * de tipo conforme o número de filhos (4, 16, 48 ou 256) e guardam os bytes que todos os
+ * seus descendentes têm em comum (compressão de caminho). Uma folha guarda a chave inteira
+ * e pode ficar acima do último nível quando não há outra chave com o mesmo início.
+ */
+typedef enum {
+    RADIX_FOLHA,
+    RADIX_NO4,
+    RADIX_NO16,
+    RADIX_NO48,
+    RADIX_NO256
+} TipoNoRadix;
+
+typedef struct NoArvoreRadix {
+    uint8_t tipo; // TipoNoRadix
+    uint8_t tamanhoPrefixo; // Bytes comprimidos antes do byte que escolhe o filho
+    uint16_t numFilhos; // Filhos ocupados (não usado nas folhas)
+    uint8_t prefixo[BYTES_CHAVE_RADIX - 1]; // Bytes comprimidos
+} NoArvoreRadix;
+
+/*
+ * Lista compacta das posições das ocorrências repetidas de uma chave, além da primeira.
+ */
+typedef struct {
+    int quantidade;
+    int capacidade;
+    long posicoes[]; // Em ordem de inserção
+} ListaPosicoesRadix;
+
+typedef struct {
+    NoArvoreRadix cabecalho;
+    Chave chave; // Chave do registro
+    long posicao; // Posição da primeira ocorrência no armazenamento externo
+    ListaPosicoesRadix *repetidas; // Demais ocorrências (NULL para chave única)
+} FolhaArvoreRadix;
+
+typedef struct {
+    NoArvoreRadix cabecalho;
+    uint8_t bytes[4]; // Byte de cada filho, em ordem crescente
+    NoArvoreRadix *filhos[4];
+} NoRadix4;
+
+typedef struct {
+    NoArvoreRadix cabecalho;
+    uint8_t bytes[16]; // Byte de cada filho, em ordem crescente
+    NoArvoreRadix *filhos[16];
+} NoRadix16;
+
+typedef struct {
+    NoArvoreRadix cabecalho;
+    uint8_t indices[256]; // Índice + 1 do filho de cada byte, ou 0 se não há filho
+    NoArvoreRadix *filhos[48];
+} NoRadix48;
+
+typedef struct {
+    NoArvoreRadix cabecalho;
+    NoArvoreRadix *filhos[256]; // Filho de cada byte, ou NULL
+} NoRadix256;
+
+NoArvoreRadix* inserirArvoreRadix(NoArvoreRadix *raiz, Chave chave, long posicao, Metricas *metricas);
+FolhaArvoreRadix* buscarArvoreRadix(NoArvoreRadix *raiz, Chave chave, Metricas *metricas);
+int buscarTodosArvoreRadix(NoArvoreRadix *raiz, Chave chave, long *posicoes, int limite, Metricas *metricas);
+void medirArvoreRadix(NoArvoreRadix *raiz, Metricas *metricas);
+size_t memoriaArvoreRadix(NoArvoreRadix *raiz);
+void destruirArvoreRadix(NoArvoreRadix *raiz);
+
+#endif // ARVORERADIX_H
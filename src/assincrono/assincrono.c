@@ -0,0 +1,528 @@
+#include "assincrono.h"
+#include "../arvore/arvore.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <linux/io_uring.h>
+
+#define MAXIMO_THREADS_ES 16 // Limite de threads do motor de leitura com pread
+
+/*
+ * Motor de E/S: recebe pedidos de leitura identificados por um número e devolve suas
+ * conclusões em qualquer ordem. Há duas implementações, uma sobre o io_uring e outra
+ * sobre um conjunto de threads que chamam pread.
+ */
+typedef struct MotorES {
+    TipoMotorES tipo;
+    void (*submeter)(struct MotorES *motor, int descritor, struct iovec *vetor, off_t deslocamento, uint64_t id);
+    int (*aguardar)(struct MotorES *motor, uint64_t *ids, int *resultados, int maximo, Metricas *metricas);
+    void (*liberar)(struct MotorES *motor);
+} MotorES;
+
+/* ---------- Motor io_uring ---------- */
+
+typedef struct {
+    MotorES base;
+    int descritor;
+    unsigned *sqCabeca, *sqCauda, *sqMascara, *sqVetor;
+    unsigned *cqCabeca, *cqCauda, *cqMascara;
+    struct io_uring_sqe *sqes;
+    struct io_uring_cqe *cqes;
+    void *anelSQ, *anelCQ;
+    size_t tamanhoSQ, tamanhoCQ, tamanhoSQEs;
+    unsigned pendentes; // Pedidos colocados no anel e ainda não entregues ao núcleo
+} MotorIoUring;
+
+static void submeterIoUring(MotorES *motor, int descritor, struct iovec *vetor, off_t deslocamento, uint64_t id) {
+    MotorIoUring *anel = (MotorIoUring *)motor;
+    unsigned cauda = *anel->sqCauda;
+    unsigned indice = cauda & *anel->sqMascara;
+    struct io_uring_sqe *sqe = &anel->sqes[indice];
+
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_READV;
+    sqe->fd = descritor;
+    sqe->addr = (uint64_t)(uintptr_t)vetor;
+    sqe->len = 1;
+    sqe->off = deslocamento;
+    sqe->user_data = id;
+
+    anel->sqVetor[indice] = indice;
+    __atomic_store_n(anel->sqCauda, cauda + 1, __ATOMIC_RELEASE);
+    anel->pendentes++;
+}
+
+static int aguardarIoUring(MotorES *motor, uint64_t *ids, int *resultados, int maximo, Metricas *metricas) {
+    MotorIoUring *anel = (MotorIoUring *)motor;
+
+    // Entrega os pedidos pendentes e espera pelo menos uma conclusão em uma única chamada
+    int retorno = (int)syscall(__NR_io_uring_enter, anel->descritor, anel->pendentes, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+    metricas->chamadasSistema++;
+    if (retorno < 0) {
+        perror("Erro em io_uring_enter");
+        return -1;
+    }
+    anel->pendentes = 0;
+
+    unsigned cabeca = *anel->cqCabeca;
+    unsigned cauda = __atomic_load_n(anel->cqCauda, __ATOMIC_ACQUIRE);
+    int concluidos = 0;
+
+    while (cabeca != cauda && concluidos < maximo) {
+        struct io_uring_cqe *cqe = &anel->cqes[cabeca & *anel->cqMascara];
+        ids[concluidos] = cqe->user_data;
+        resultados[concluidos] = cqe->res;
+        concluidos++;
+        cabeca++;
+    }
+
+    __atomic_store_n(anel->cqCabeca, cabeca, __ATOMIC_RELEASE);
+    return concluidos;
+}
+
+static void liberarIoUring(MotorES *motor) {
+    MotorIoUring *anel = (MotorIoUring *)motor;
+    munmap(anel->sqes, anel->tamanhoSQEs);
+    if (anel->anelCQ != anel->anelSQ) {
+        munmap(anel->anelCQ, anel->tamanhoCQ);
+    }
+    munmap(anel->anelSQ, anel->tamanhoSQ);
+    close(anel->descritor);
+    free(anel);
+}
+
+/**
+ * Cria um motor de E/S sobre o io_uring, usando as chamadas de sistema diretamente.
+ *
+ * @param entradas Número máximo de leituras em andamento.
+ * @return Ponteiro para o motor ou NULL se o io_uring não estiver disponível.
+ */
+static MotorES* criarMotorIoUring(unsigned entradas) {
+    struct io_uring_params parametros;
+    memset(&parametros, 0, sizeof(parametros));
+
+    int descritor = (int)syscall(__NR_io_uring_setup, entradas, &parametros);
+    if (descritor < 0) {
+        return NULL;
+    }
+
+    MotorIoUring *anel = calloc(1, sizeof(MotorIoUring));
+    anel->descritor = descritor;
+    anel->tamanhoSQ = parametros.sq_off.array + parametros.sq_entries * sizeof(unsigned);
+    anel->tamanhoCQ = parametros.cq_off.cqes + parametros.cq_entries * sizeof(struct io_uring_cqe);
+    anel->tamanhoSQEs = parametros.sq_entries * sizeof(struct io_uring_sqe);
+
+    // Núcleos recentes permitem mapear os dois anéis de uma só vez
+    bool mapaUnico = (parametros.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (mapaUnico) {
+        if (anel->tamanhoCQ > anel->tamanhoSQ) {
+            anel->tamanhoSQ = anel->tamanhoCQ;
+        }
+        anel->tamanhoCQ = anel->tamanhoSQ;
+    }
+
+    anel->anelSQ = mmap(NULL, anel->tamanhoSQ, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, descritor, IORING_OFF_SQ_RING);
+    if (anel->anelSQ == MAP_FAILED) {
+        close(descritor);
+        free(anel);
+        return NULL;
+    }
+
+    anel->anelCQ = mapaUnico
+        ? anel->anelSQ
+        : mmap(NULL, anel->tamanhoCQ, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, descritor, IORING_OFF_CQ_RING);
+    anel->sqes = mmap(NULL, anel->tamanhoSQEs, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, descritor, IORING_OFF_SQES);
+    if (anel->anelCQ == MAP_FAILED || anel->sqes == MAP_FAILED) {
+        if (anel->sqes != MAP_FAILED) {
+            munmap(anel->sqes, anel->tamanhoSQEs);
+        }
+        if (anel->anelCQ != MAP_FAILED && anel->anelCQ != anel->anelSQ) {
+            munmap(anel->anelCQ, anel->tamanhoCQ);
+        }
+        munmap(anel->anelSQ, anel->tamanhoSQ);
+        close(descritor);
+        free(anel);
+        return NULL;
+    }
+
+    char *sq = anel->anelSQ;
+    char *cq = anel->anelCQ;
+    anel->sqCabeca = (unsigned *)(sq + parametros.sq_off.head);
+    anel->sqCauda = (unsigned *)(sq + parametros.sq_off.tail);
+    anel->sqMascara = (unsigned *)(sq + parametros.sq_off.ring_mask);
+    anel->sqVetor = (unsigned *)(sq + parametros.sq_off.array);
+    anel->cqCabeca = (unsigned *)(cq + parametros.cq_off.head);
+    anel->cqCauda = (unsigned *)(cq + parametros.cq_off.tail);
+    anel->cqMascara = (unsigned *)(cq + parametros.cq_off.ring_mask);
+    anel->cqes = (struct io_uring_cqe *)(cq + parametros.cq_off.cqes);
+
+    anel->base.tipo = MOTOR_IO_URING;
+    anel->base.submeter = submeterIoUring;
+    anel->base.aguardar = aguardarIoUring;
+    anel->base.liberar = liberarIoUring;
+    return &anel->base;
+}
+
+/* ---------- Motor de threads com pread ---------- */
+
+typedef struct {
+    int descritor;
+    struct iovec *vetor;
+    off_t deslocamento;
+    uint64_t id;
+    int resultado;
+} PedidoES;
+
+typedef struct {
+    MotorES base;
+    pthread_t threads[MAXIMO_THREADS_ES];
+    int numThreads;
+    pthread_mutex_t trava;
+    pthread_cond_t temPedido;
+    pthread_cond_t temConclusao;
+    PedidoES *pedidos; // Fila circular de pedidos aguardando uma thread
+    PedidoES *concluidos; // Fila circular de pedidos já atendidos
+    int capacidade;
+    int inicioPedidos, numPedidos;
+    int inicioConcluidos, numConcluidos;
+    bool encerrar;
+} MotorThreads;
+
+static void* executarThreadES(void *argumento) {
+    MotorThreads *motor = argumento;
+
+    pthread_mutex_lock(&motor->trava);
+    while (true) {
+        while (motor->numPedidos == 0 && !motor->encerrar) {
+            pthread_cond_wait(&motor->temPedido, &motor->trava);
+        }
+        if (motor->numPedidos == 0) {
+            break;
+        }
+
+        PedidoES pedido = motor->pedidos[motor->inicioPedidos];
+        motor->inicioPedidos = (motor->inicioPedidos + 1) % motor->capacidade;
+        motor->numPedidos--;
+        pthread_mutex_unlock(&motor->trava);
+
+        ssize_t lidos = pread(pedido.descritor, pedido.vetor->iov_base, pedido.vetor->iov_len, pedido.deslocamento);
+        pedido.resultado = lidos < 0 ? -1 : (int)lidos;
+
+        pthread_mutex_lock(&motor->trava);
+        motor->concluidos[(motor->inicioConcluidos + motor->numConcluidos) % motor->capacidade] = pedido;
+        motor->numConcluidos++;
+        pthread_cond_signal(&motor->temConclusao);
+    }
+    pthread_mutex_unlock(&motor->trava);
+    return NULL;
+}
+
+static void submeterThreads(MotorES *base, int descritor, struct iovec *vetor, off_t deslocamento, uint64_t id) {
+    MotorThreads *motor = (MotorThreads *)base;
+
+    pthread_mutex_lock(&motor->trava);
+    PedidoES *pedido = &motor->pedidos[(motor->inicioPedidos + motor->numPedidos) % motor->capacidade];
+    pedido->descritor = descritor;
+    pedido->vetor = vetor;
+    pedido->deslocamento = deslocamento;
+    pedido->id = id;
+    motor->numPedidos++;
+    pthread_cond_signal(&motor->temPedido);
+    pthread_mutex_unlock(&motor->trava);
+}
+
+static int aguardarThreads(MotorES *base, uint64_t *ids, int *resultados, int maximo, Metricas *metricas) {
+    MotorThreads *motor = (MotorThreads *)base;
+    int concluidos = 0;
+
+    pthread_mutex_lock(&motor->trava);
+    while (motor->numConcluidos == 0) {
+        pthread_cond_wait(&motor->temConclusao, &motor->trava);
+    }
+    while (motor->numConcluidos > 0 && concluidos < maximo) {
+        PedidoES *pedido = &motor->concluidos[motor->inicioConcluidos];
+        ids[concluidos] = pedido->id;
+        resultados[concluidos] = pedido->resultado;
+        motor->inicioConcluidos = (motor->inicioConcluidos + 1) % motor->capacidade;
+        motor->numConcluidos--;
+        concluidos++;
+    }
+    pthread_mutex_unlock(&motor->trava);
+
+    // Cada leitura atendida corresponde a uma chamada pread feita por uma das threads
+    metricas->chamadasSistema += concluidos;
+    return concluidos;
+}
+
+static void liberarThreads(MotorES *base) {
+    MotorThreads *motor = (MotorThreads *)base;
+
+    pthread_mutex_lock(&motor->trava);
+    motor->encerrar = true;
+    pthread_cond_broadcast(&motor->temPedido);
+    pthread_mutex_unlock(&motor->trava);
+
+    for (int i = 0; i < motor->numThreads; i++) {
+        pthread_join(motor->threads[i], NULL);
+    }
+
+    pthread_mutex_destroy(&motor->trava);
+    pthread_cond_destroy(&motor->temPedido);
+    pthread_cond_destroy(&motor->temConclusao);
+    free(motor->pedidos);
+    free(motor->concluidos);
+    free(motor);
+}
+
+/**
+ * Cria um motor de E/S em que um conjunto de threads atende as leituras com pread.
+ *
+ * @param capacidade Número máximo de leituras em andamento.
+ * @return Ponteiro para o motor criado.
+ */
+static MotorES* criarMotorThreads(int capacidade) {
+    MotorThreads *motor = calloc(1, sizeof(MotorThreads));
+    motor->capacidade = capacidade;
+    motor->pedidos = malloc(capacidade * sizeof(PedidoES));
+    motor->concluidos = malloc(capacidade * sizeof(PedidoES));
+    pthread_mutex_init(&motor->trava, NULL);
+    pthread_cond_init(&motor->temPedido, NULL);
+    pthread_cond_init(&motor->temConclusao, NULL);
+
+    motor->numThreads = capacidade < MAXIMO_THREADS_ES ? capacidade : MAXIMO_THREADS_ES;
+    for (int i = 0; i < motor->numThreads; i++) {
+        pthread_create(&motor->threads[i], NULL, executarThreadES, motor);
+    }
+
+    motor->base.tipo = MOTOR_THREADS;
+    motor->base.submeter = submeterThreads;
+    motor->base.aguardar = aguardarThreads;
+    motor->base.liberar = liberarThreads;
+    return &motor->base;
+}
+
+/* ---------- Executor de consultas ---------- */
+
+typedef enum {
+    LENDO_NO, // Aguardando a leitura de um nó da árvore
+    LENDO_REGISTRO // Aguardando a leitura do registro encontrado
+} EstadoConsulta;
+
+typedef struct {
+    EstadoConsulta estado;
+    NoArvore no;
+    struct iovec vetor;
+    void *destino; // Onde os bytes pedidos devem terminar
+    size_t tamanho; // Quantidade de bytes pedidos
+    off_t deslocamento; // Deslocamento pedido no arquivo
+    char *bloco; // Buffer alinhado, usado apenas quando os descritores exigem alinhamento
+} Consulta;
+
+/**
+ * Pede a leitura de um trecho de arquivo para uma consulta.
+ *
+ * Quando o descritor exige alinhamento (O_DIRECT), a leitura cobre os blocos alinhados que
+ * contêm o trecho e é feita no buffer alinhado da consulta; concluirLeitura copia depois
+ * o trecho pedido para o destino.
+ */
+static void pedirLeitura(
+    MotorES *motor,
+    int descritor,
+    Consulta *consulta,
+    void *destino,
+    size_t tamanho,
+    off_t deslocamento,
+    size_t alinhamento,
+    uint64_t id
+) {
+    consulta->destino = destino;
+    consulta->tamanho = tamanho;
+    consulta->deslocamento = deslocamento;
+
+    if (alinhamento == 0) {
+        consulta->vetor.iov_base = destino;
+        consulta->vetor.iov_len = tamanho;
+        motor->submeter(motor, descritor, &consulta->vetor, deslocamento, id);
+        return;
+    }
+
+    off_t inicio = deslocamento - (deslocamento % alinhamento);
+    off_t fim = deslocamento + tamanho;
+    fim += (alinhamento - fim % alinhamento) % alinhamento;
+    consulta->vetor.iov_base = consulta->bloco;
+    consulta->vetor.iov_len = fim - inicio;
+    motor->submeter(motor, descritor, &consulta->vetor, inicio, id);
+}
+
+/**
+ * Confere uma leitura concluída e, se ela foi feita em blocos alinhados, copia o trecho pedido.
+ *
+ * @return Retorna true se todos os bytes pedidos foram lidos.
+ */
+static bool concluirLeitura(Consulta *consulta, int lidos, size_t alinhamento) {
+    if (alinhamento == 0) {
+        return lidos == (int)consulta->tamanho;
+    }
+
+    size_t antes = consulta->deslocamento % alinhamento;
+    if (lidos < (int)(antes + consulta->tamanho)) {
+        return false;
+    }
+    memcpy(consulta->destino, consulta->bloco + antes, consulta->tamanho);
+    return true;
+}
+
+/**
+ * Pede a leitura de um nó da árvore binária para uma consulta.
+ */
+static void lerNoAssincrono(MotorES *motor, int descritorArvore, Consulta *consulta, long posicaoNo, size_t alinhamento, uint64_t id) {
+    consulta->estado = LENDO_NO;
+    pedirLeitura(motor, descritorArvore, consulta, &consulta->no, sizeof(NoArvore), (off_t)posicaoNo * sizeof(NoArvore), alinhamento, id);
+}
+
+/**
+ * Busca um lote de chaves na árvore binária em disco mantendo várias consultas em andamento.
+ *
+ * Cada consulta percorre a árvore do arquivo src/arvore/arvore.bin como em buscarNoArvore,
+ * mas as leituras não bloqueiam: até 'profundidade' consultas ficam com uma leitura pendente
+ * ao mesmo tempo, e cada uma avança um nível (ou lê seu registro) assim que sua leitura é
+ * concluída. As leituras são feitas pelo io_uring; se ele não estiver disponível, um conjunto
+ * de threads com pread é usado no lugar.
+ *
+ * @param descritorArvore Descritor do arquivo da árvore binária.
+ * @param descritorRegistros Descritor do arquivo de registros.
+ * @param alinhamento Alinhamento exigido pelas leituras nos descritores (0 se não houver).
+ * @param posicaoRaiz Posição da raiz da árvore no arquivo.
+ * @param chaves Chaves a serem buscadas.
+ * @param quantidade Número de chaves do lote.
+ * @param profundidade Número máximo de consultas com leitura pendente.
+ * @param resultados Vetor com uma posição por chave, onde os resultados serão armazenados.
+ * @param metricas Ponteiro para as métricas da pesquisa.
+ * @return Motor de E/S efetivamente usado.
+ */
+TipoMotorES buscarLoteArvoreAssincrono(
+    int descritorArvore,
+    int descritorRegistros,
+    size_t alinhamento,
+    long posicaoRaiz,
+    const Chave *chaves,
+    int quantidade,
+    int profundidade,
+    ResultadoConsulta *resultados,
+    Metricas *metricas
+) {
+    if (profundidade < 1) {
+        profundidade = 1;
+    }
+
+    MotorES *motor = criarMotorIoUring(profundidade);
+    if (motor == NULL) {
+        motor = criarMotorThreads(profundidade);
+    }
+    TipoMotorES tipo = motor->tipo;
+
+    Consulta *consultas = calloc(quantidade, sizeof(Consulta));
+    uint64_t *ids = malloc(profundidade * sizeof(uint64_t));
+    int *lidos = malloc(profundidade * sizeof(int));
+    int proxima = 0, emAndamento = 0, concluidas = 0;
+
+    while (concluidas < quantidade) {
+        // Inicia novas consultas enquanto houver espaço na fila
+        while (emAndamento < profundidade && proxima < quantidade) {
+            ResultadoConsulta *resultado = &resultados[proxima];
+            resultado->chave = chaves[proxima];
+            resultado->encontrado = false;
+            resultado->posicao = -1;
+
+            if (posicaoRaiz == -1) {
+                concluidas++;
+            } else {
+                // Um registro pode atravessar a fronteira entre dois blocos alinhados
+                if (alinhamento > 0 && posix_memalign((void **)&consultas[proxima].bloco, alinhamento, 2 * alinhamento) != 0) {
+                    concluidas++;
+                    proxima++;
+                    continue;
+                }
+                lerNoAssincrono(motor, descritorArvore, &consultas[proxima], posicaoRaiz, alinhamento, proxima);
+                emAndamento++;
+            }
+            proxima++;
+        }
+
+        if (emAndamento == 0) {
+            continue;
+        }
+
+        int numConcluidos = motor->aguardar(motor, ids, lidos, profundidade, metricas);
+        if (numConcluidos < 0) {
+            break;
+        }
+
+        // Avança cada consulta cuja leitura terminou
+        for (int i = 0; i < numConcluidos; i++) {
+            int id = (int)ids[i];
+            Consulta *consulta = &consultas[id];
+            ResultadoConsulta *resultado = &resultados[id];
+
+            bool completa = concluirLeitura(consulta, lidos[i], alinhamento);
+
+            if (consulta->estado == LENDO_REGISTRO) {
+                emAndamento--;
+                concluidas++;
+                free(consulta->bloco);
+                if (completa) {
+                    registrarLeitura(metricas, sizeof(Registro));
+                    resultado->encontrado = true;
+                }
+                continue;
+            }
+
+            if (!completa) {
+                emAndamento--;
+                concluidas++;
+                free(consulta->bloco);
+                continue; // Falha de leitura encerra a consulta sem resultado
+            }
+
+            registrarLeitura(metricas, sizeof(NoArvore));
+            metricas->comparacoes++;
+
+            if (resultado->chave == consulta->no.chave) {
+                resultado->posicao = consulta->no.posicao;
+                consulta->estado = LENDO_REGISTRO;
+                pedirLeitura(
+                    motor,
+                    descritorRegistros,
+                    consulta,
+                    &resultado->registro,
+                    sizeof(Registro),
+                    (off_t)resultado->posicao * sizeof(Registro),
+                    alinhamento,
+                    id
+                );
+                continue;
+            }
+
+            long proximoNo = resultado->chave < consulta->no.chave ? consulta->no.esquerda : consulta->no.direita;
+            if (proximoNo == -1) {
+                emAndamento--;
+                concluidas++;
+                free(consulta->bloco);
+            } else {
+                lerNoAssincrono(motor, descritorArvore, consulta, proximoNo, alinhamento, id);
+            }
+        }
+    }
+
+    free(lidos);
+    free(ids);
+    free(consultas);
+    motor->liberar(motor);
+    return tipo;
+}
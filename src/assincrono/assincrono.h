@@ -0,0 +1,34 @@
+#ifndef ASSINCRONO_H
+#define ASSINCRONO_H
+
+#include "../registro/registro.h"
+#include "../metricas/metricas.h"
+#include <stdbool.h>
+
+#define PROFUNDIDADE_FILA_PADRAO 64 // Consultas mantidas em andamento ao mesmo tempo
+
+typedef enum {
+    MOTOR_IO_URING, // Leituras submetidas pelo io_uring do Linux
+    MOTOR_THREADS // Leituras feitas com pread por um conjunto de threads
+} TipoMotorES;
+
+typedef struct {
+    Chave chave; // Chave consultada
+    bool encontrado; // Indica se a chave foi encontrada
+    long posicao; // Posição do registro no arquivo de registros
+    Registro registro; // Registro encontrado
+} ResultadoConsulta;
+
+TipoMotorES buscarLoteArvoreAssincrono(
+    int descritorArvore,
+    int descritorRegistros,
+    size_t alinhamento,
+    long posicaoRaiz,
+    const Chave *chaves,
+    int quantidade,
+    int profundidade,
+    ResultadoConsulta *resultados,
+    Metricas *metricas
+);
+
+#endif // ASSINCRONO_H
@@ -0,0 +1,160 @@
+#include "atualizacao.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/**
+ * Monta o caminho do arquivo que guarda a lista de posições livres de um arquivo de registros.
+ *
+ * A lista de posições livres é mantida em um arquivo auxiliar com o mesmo nome do arquivo
+ * de registros acrescido da extensão ".livres". Cada posição é gravada como um long, e o
+ * arquivo funciona como uma pilha: a última posição liberada é a primeira reaproveitada.
+ *
+ * @param nomeArquivo Caminho do arquivo de registros.
+ * @param caminho Buffer onde o caminho do arquivo auxiliar será escrito.
+ * @param tamanho Tamanho do buffer.
+ */
+static void caminhoListaLivres(const char *nomeArquivo, char *caminho, size_t tamanho) {
+    snprintf(caminho, tamanho, "%s.livres", nomeArquivo);
+}
+
+/**
+ * Retira uma posição livre da lista de posições livres do arquivo.
+ *
+ * @param nomeArquivo Caminho do arquivo de registros.
+ * @return Posição livre reaproveitável ou -1 se a lista estiver vazia.
+ */
+static long retirarPosicaoLivre(const char *nomeArquivo) {
+    char caminho[300];
+    caminhoListaLivres(nomeArquivo, caminho, sizeof(caminho));
+
+    FILE *lista = fopen(caminho, "r+b");
+    if (!lista) {
+        return -1; // Nenhuma posição foi liberada até agora
+    }
+
+    long posicao = -1;
+    if (fseeko(lista, 0, SEEK_END) == 0) {
+        off_t tamanho = ftello(lista);
+        if (tamanho >= (long)sizeof(long)) {
+            fseeko(lista, tamanho - (off_t)sizeof(long), SEEK_SET);
+            if (fread(&posicao, sizeof(long), 1, lista) != 1) {
+                posicao = -1;
+            } else {
+                fflush(lista);
+                ftruncate(fileno(lista), tamanho - sizeof(long));
+            }
+        }
+    }
+
+    fclose(lista);
+    return posicao;
+}
+
+/**
+ * Acrescenta uma posição à lista de posições livres do arquivo.
+ *
+ * @param nomeArquivo Caminho do arquivo de registros.
+ * @param posicao Posição liberada.
+ * @return Retorna true se a posição foi gravada na lista.
+ */
+static bool devolverPosicaoLivre(const char *nomeArquivo, long posicao) {
+    char caminho[300];
+    caminhoListaLivres(nomeArquivo, caminho, sizeof(caminho));
+
+    FILE *lista = fopen(caminho, "ab");
+    if (!lista) {
+        perror("Erro ao abrir a lista de posições livres");
+        return false;
+    }
+
+    bool sucesso = fwrite(&posicao, sizeof(long), 1, lista) == 1;
+    if (!sucesso) {
+        perror("Erro ao gravar a lista de posições livres");
+    }
+
+    fclose(lista);
+    return sucesso;
+}
+
+/**
+ * Inclui um novo registro no arquivo de registros.
+ *
+ * Esta função reaproveita a posição de um registro removido, quando houver alguma na lista
+ * de posições livres, ou acrescenta o registro ao final do arquivo. A escrita conta como
+ * uma transferência de dados da memória interna para o armazenamento externo. A posição
+ * não depende da chave, então um arquivo ordenado pode deixar de estar em ordem; o acesso
+ * sequencial indexado confere a ordem ao criar o índice e, sem ela, lê o arquivo inteiro.
+ *
+ * @param arquivo Ponteiro para o arquivo de registros, aberto para leitura e escrita.
+ * @param nomeArquivo Caminho do arquivo de registros, usado para localizar a lista de posições livres.
+ * @param reg Ponteiro para o registro a ser incluído.
+ * @param metricas Ponteiro para as métricas da fase em andamento.
+ * @return Posição em que o registro foi gravado ou -1 em caso de erro.
+ */
+long incluirRegistro(FILE *arquivo, const char *nomeArquivo, const Registro *reg, Metricas *metricas) {
+    long posicao = retirarPosicaoLivre(nomeArquivo);
+
+    if (posicao == -1) {
+        registrarPosicionamento(metricas);
+        if (fseeko(arquivo, 0, SEEK_END) != 0) {
+            perror("Erro ao buscar o final do arquivo");
+            return -1;
+        }
+        posicao = ftello(arquivo) / sizeof(Registro);
+    }
+
+    if (!atualizarRegistro(arquivo, posicao, reg, metricas)) {
+        return -1;
+    }
+    return posicao;
+}
+
+/**
+ * Regrava um registro em uma posição já existente do arquivo.
+ *
+ * @param arquivo Ponteiro para o arquivo de registros, aberto para leitura e escrita.
+ * @param posicao Posição do registro no arquivo.
+ * @param reg Ponteiro para o registro com os novos dados.
+ * @param metricas Ponteiro para as métricas da fase em andamento.
+ * @return Retorna true se o registro foi gravado.
+ */
+bool atualizarRegistro(FILE *arquivo, long posicao, const Registro *reg, Metricas *metricas) {
+    registrarPosicionamento(metricas);
+    if (fseeko(arquivo, DESLOCAMENTO_REGISTRO(posicao), SEEK_SET) != 0) {
+        perror("Erro ao buscar posição no arquivo");
+        return false;
+    }
+
+    if (fwrite(reg, sizeof(Registro), 1, arquivo) != 1) {
+        perror("Erro ao escrever registro no arquivo");
+        return false;
+    }
+
+    fflush(arquivo);
+    registrarEscrita(metricas, sizeof(Registro));
+    return true;
+}
+
+/**
+ * Remove um registro do arquivo de registros.
+ *
+ * O registro não é apagado fisicamente: sua posição recebe uma lápide (chave igual a
+ * CHAVE_REMOVIDA) e é acrescentada à lista de posições livres, para ser reaproveitada
+ * pela próxima inclusão.
+ *
+ * @param arquivo Ponteiro para o arquivo de registros, aberto para leitura e escrita.
+ * @param nomeArquivo Caminho do arquivo de registros, usado para localizar a lista de posições livres.
+ * @param posicao Posição do registro a ser removido.
+ * @param metricas Ponteiro para as métricas da fase em andamento.
+ * @return Retorna true se o registro foi removido.
+ */
+bool removerRegistro(FILE *arquivo, const char *nomeArquivo, long posicao, Metricas *metricas) {
+    Registro lapide = {0};
+    lapide.chave = CHAVE_REMOVIDA;
+
+    if (!atualizarRegistro(arquivo, posicao, &lapide, metricas)) {
+        return false;
+    }
+    return devolverPosicaoLivre(nomeArquivo, posicao);
+}
@@ -0,0 +1,23 @@
+#ifndef ATUALIZACAO_H
+#define ATUALIZACAO_H
+
+#include "../registro/registro.h"
+#include <stdio.h>
+#include <stdbool.h>
+
+typedef enum {
+    OPERACAO_INCLUIR = 'I', // Inclui um novo registro
+    OPERACAO_ATUALIZAR = 'A', // Regrava os dados de um registro existente
+    OPERACAO_REMOVER = 'R' // Remove um registro existente
+} TipoOperacao;
+
+typedef struct {
+    TipoOperacao tipo; // Operação a ser aplicada
+    Chave chave; // Chave do registro afetado
+} Operacao;
+
+long incluirRegistro(FILE *arquivo, const char *nomeArquivo, const Registro *reg, Metricas *metricas);
+bool atualizarRegistro(FILE *arquivo, long posicao, const Registro *reg, Metricas *metricas);
+bool removerRegistro(FILE *arquivo, const char *nomeArquivo, long posicao, Metricas *metricas);
+
+#endif // ATUALIZACAO_H
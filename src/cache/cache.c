@@ -0,0 +1,237 @@
+#include "cache.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Balde da tabela de espalhamento de uma chave (espalhamento multiplicativo).
+ */
+static unsigned baldeCache(const Cache *cache, Chave chave) {
+    return (unsigned)(((uint64_t)chave * 0x9E3779B97F4A7C15ULL) >> 32) & cache->mascaraBaldes;
+}
+
+/**
+ * Localiza o nó de uma chave em qualquer lista.
+ *
+ * @return Índice do nó ou -1 se a chave não está na cache.
+ */
+static int localizarCache(const Cache *cache, Chave chave) {
+    int no = cache->baldes[baldeCache(cache, chave)];
+    while (no >= 0 && cache->nos[no].chave != chave) {
+        no = cache->nos[no].proximoBalde;
+    }
+    return no;
+}
+
+/**
+ * Retira um nó da lista em que está, sem tirá-lo da tabela.
+ */
+static void desligarNo(Cache *cache, int no) {
+    NoCache *atual = &cache->nos[no];
+    FilaCache *fila = &cache->filas[atual->lista];
+    if (atual->anterior >= 0) {
+        cache->nos[atual->anterior].proximo = atual->proximo;
+    } else {
+        fila->inicio = atual->proximo;
+    }
+    if (atual->proximo >= 0) {
+        cache->nos[atual->proximo].anterior = atual->anterior;
+    } else {
+        fila->fim = atual->anterior;
+    }
+    fila->tamanho--;
+    atual->lista = LISTA_LIVRE_CACHE;
+}
+
+/**
+ * Coloca um nó no início (lado mais recente) de uma lista.
+ */
+static void ligarNo(Cache *cache, int no, ListaCache lista) {
+    NoCache *atual = &cache->nos[no];
+    FilaCache *fila = &cache->filas[lista];
+    atual->lista = lista;
+    atual->anterior = -1;
+    atual->proximo = fila->inicio;
+    if (fila->inicio >= 0) {
+        cache->nos[fila->inicio].anterior = no;
+    } else {
+        fila->fim = no;
+    }
+    fila->inicio = no;
+    fila->tamanho++;
+}
+
+/**
+ * Descarta um nó: tira-o da lista e da tabela, devolve a vaga do registro e o próprio nó.
+ */
+static void descartarNo(Cache *cache, int no) {
+    NoCache *atual = &cache->nos[no];
+    int *elo = &cache->baldes[baldeCache(cache, atual->chave)];
+    while (*elo != no) {
+        elo = &cache->nos[*elo].proximoBalde;
+    }
+    *elo = atual->proximoBalde;
+
+    desligarNo(cache, no);
+    if (atual->vaga >= 0) {
+        cache->vagas[cache->numVagas++] = atual->vaga;
+        atual->vaga = -1;
+    }
+    atual->proximo = cache->livres;
+    cache->livres = no;
+}
+
+/**
+ * Abre uma vaga de registro. A fila de entrada cede a mais antiga quando passou do seu
+ * limite (a chave continua lembrada na fila fantasma); senão, sai a menos usada da lista
+ * principal.
+ */
+static int obterVaga(Cache *cache) {
+    if (cache->numVagas == 0) {
+        FilaCache *entrada = &cache->filas[LISTA_ENTRADA_CACHE];
+        if (entrada->tamanho > cache->limiteEntrada || cache->filas[LISTA_PRINCIPAL_CACHE].tamanho == 0) {
+            int no = entrada->fim;
+            desligarNo(cache, no);
+            cache->vagas[cache->numVagas++] = cache->nos[no].vaga;
+            cache->nos[no].vaga = -1;
+            ligarNo(cache, no, LISTA_FANTASMA_CACHE);
+            if (cache->filas[LISTA_FANTASMA_CACHE].tamanho > cache->limiteFantasma) {
+                descartarNo(cache, cache->filas[LISTA_FANTASMA_CACHE].fim);
+            }
+        } else {
+            descartarNo(cache, cache->filas[LISTA_PRINCIPAL_CACHE].fim);
+        }
+        cache->expulsoes++;
+    }
+    return cache->vagas[--cache->numVagas];
+}
+
+/**
+ * Cria uma cache vazia que ocupa no máximo o orçamento dado, contando os registros, os nós
+ * (inclusive os da fila fantasma) e a tabela de espalhamento.
+ *
+ * @param cache Estrutura da cache a ser inicializada.
+ * @param orcamento Memória disponível, em bytes.
+ * @return Retorna true se a cache foi criada (o orçamento precisa caber ao menos um registro).
+ */
+bool criarCache(Cache *cache, size_t orcamento) {
+    memset(cache, 0, sizeof(Cache));
+
+    // Custo por registro guardado: o registro, a vaga, o seu nó e a parte dos nós fantasmas,
+    // com até dois baldes por nó
+    size_t custoNo = sizeof(NoCache) + 2 * sizeof(int);
+    size_t custo = sizeof(Registro) + sizeof(int) + custoNo + custoNo / FRACAO_FANTASMA_CACHE;
+    size_t capacidade = orcamento / custo;
+    if (capacidade < 1) {
+        return false;
+    }
+    if (capacidade > (size_t)(INT32_MAX / 4)) {
+        capacidade = INT32_MAX / 4;
+    }
+
+    cache->capacidade = (int)capacidade;
+    cache->limiteEntrada = cache->capacidade / FRACAO_ENTRADA_CACHE > 0 ? cache->capacidade / FRACAO_ENTRADA_CACHE : 1;
+    cache->limiteFantasma = cache->capacidade / FRACAO_FANTASMA_CACHE > 0 ? cache->capacidade / FRACAO_FANTASMA_CACHE : 1;
+    int numNos = cache->capacidade + cache->limiteFantasma + 1;
+    unsigned numBaldes = 1;
+    while (numBaldes < (unsigned)numNos) {
+        numBaldes <<= 1;
+    }
+    cache->mascaraBaldes = numBaldes - 1;
+
+    cache->nos = malloc(numNos * sizeof(NoCache));
+    cache->registros = malloc(capacidade * sizeof(Registro));
+    cache->baldes = malloc(numBaldes * sizeof(int));
+    cache->vagas = malloc(capacidade * sizeof(int));
+    if (!cache->nos || !cache->registros || !cache->baldes || !cache->vagas) {
+        destruirCache(cache);
+        return false;
+    }
+    cache->bytes = numNos * sizeof(NoCache) + capacidade * (sizeof(Registro) + sizeof(int)) + numBaldes * sizeof(int);
+
+    memset(cache->baldes, -1, numBaldes * sizeof(int));
+    for (int i = 0; i < numNos; i++) {
+        cache->nos[i].lista = LISTA_LIVRE_CACHE;
+        cache->nos[i].vaga = -1;
+        cache->nos[i].proximo = i + 1 < numNos ? i + 1 : -1;
+    }
+    cache->livres = 0;
+    for (int i = 0; i < cache->capacidade; i++) {
+        cache->vagas[i] = cache->capacidade - 1 - i;
+    }
+    cache->numVagas = cache->capacidade;
+    for (int i = 0; i < 4; i++) {
+        cache->filas[i].inicio = cache->filas[i].fim = -1;
+    }
+    return true;
+}
+
+/**
+ * Consulta uma chave na cache. Um acerto na lista principal a move para o início; um
+ * acerto na fila de entrada não altera a ordem, como na política 2Q.
+ *
+ * @param cache Ponteiro para a cache.
+ * @param chave Chave consultada.
+ * @param reg Onde o registro guardado será copiado em caso de acerto.
+ * @return Retorna true em caso de acerto.
+ */
+bool consultarCache(Cache *cache, Chave chave, Registro *reg) {
+    int no = localizarCache(cache, chave);
+    if (no < 0 || cache->nos[no].lista == LISTA_FANTASMA_CACHE) {
+        cache->faltas++;
+        return false;
+    }
+
+    if (cache->nos[no].lista == LISTA_PRINCIPAL_CACHE) {
+        desligarNo(cache, no);
+        ligarNo(cache, no, LISTA_PRINCIPAL_CACHE);
+    }
+    *reg = cache->registros[cache->nos[no].vaga];
+    cache->acertos++;
+    return true;
+}
+
+/**
+ * Guarda o registro de uma chave depois de uma falta. A chave entra na fila de entrada ou,
+ * se ainda estava lembrada na fila fantasma, na lista principal.
+ *
+ * @param cache Ponteiro para a cache.
+ * @param chave Chave do registro.
+ * @param reg Registro lido do arquivo.
+ */
+void guardarCache(Cache *cache, Chave chave, const Registro *reg) {
+    int no = localizarCache(cache, chave);
+    if (no >= 0 && cache->nos[no].lista != LISTA_FANTASMA_CACHE) {
+        cache->registros[cache->nos[no].vaga] = *reg;
+        return;
+    }
+
+    if (no >= 0) {
+        desligarNo(cache, no);
+        cache->nos[no].vaga = obterVaga(cache);
+        ligarNo(cache, no, LISTA_PRINCIPAL_CACHE);
+        cache->promocoes++;
+    } else {
+        int vaga = obterVaga(cache);
+        no = cache->livres;
+        cache->livres = cache->nos[no].proximo;
+        unsigned balde = baldeCache(cache, chave);
+        cache->nos[no].chave = chave;
+        cache->nos[no].vaga = vaga;
+        cache->nos[no].proximoBalde = cache->baldes[balde];
+        cache->baldes[balde] = no;
+        ligarNo(cache, no, LISTA_ENTRADA_CACHE);
+    }
+    cache->registros[cache->nos[no].vaga] = *reg;
+}
+
+/**
+ * Libera a memória da cache.
+ */
+void destruirCache(Cache *cache) {
+    free(cache->nos);
+    free(cache->registros);
+    free(cache->baldes);
+    free(cache->vagas);
+    memset(cache, 0, sizeof(Cache));
+}
@@ -0,0 +1,68 @@
+#ifndef CACHE_H
+#define CACHE_H
+
+#include "../registro/registro.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+#define FRACAO_ENTRADA_CACHE 4 // A fila de entrada fica com 1/4 dos registros guardados
+#define FRACAO_FANTASMA_CACHE 2 // A fila fantasma lembra as chaves de 1/2 dos registros guardados
+
+/*
+ * Cache de resultados com a política 2Q: uma chave consultada pela primeira vez entra na
+ * fila de entrada (FIFO); ao sair dela, só a chave fica lembrada na fila fantasma. Uma chave
+ * que volta enquanto está na fila fantasma é considerada frequente e passa à lista principal,
+ * mantida em ordem LRU. Assim, uma varredura de chaves vistas uma única vez passa só pela
+ * fila de entrada e não expulsa as chaves frequentes.
+ *
+ * Os nós das três listas ficam em um vetor e se encadeiam por índices; os registros ficam
+ * em um vetor à parte, só para os nós guardados.
+ */
+typedef enum {
+    LISTA_LIVRE_CACHE,
+    LISTA_ENTRADA_CACHE, // A1in: chaves vistas uma vez, com o registro
+    LISTA_FANTASMA_CACHE, // A1out: chaves que saíram da entrada, sem o registro
+    LISTA_PRINCIPAL_CACHE // Am: chaves frequentes, com o registro
+} ListaCache;
+
+typedef struct {
+    Chave chave;
+    int lista; // ListaCache em que o nó está
+    int anterior; // Vizinho mais recente na lista (-1 no início)
+    int proximo; // Vizinho mais antigo na lista (-1 no fim)
+    int proximoBalde; // Próximo nó do mesmo balde da tabela de espalhamento
+    int vaga; // Posição do registro no vetor de registros (-1 na fila fantasma)
+} NoCache;
+
+typedef struct {
+    int inicio; // Nó mais recente
+    int fim; // Nó mais antigo
+    int tamanho;
+} FilaCache;
+
+typedef struct {
+    NoCache *nos;
+    Registro *registros;
+    int *baldes; // Primeiro nó de cada balde (-1 se vazio)
+    int *vagas; // Pilha de vagas livres no vetor de registros
+    int numVagas;
+    int livres; // Primeiro nó livre, encadeado por "proximo"
+    unsigned mascaraBaldes;
+    int capacidade; // Registros guardados ao mesmo tempo
+    int limiteEntrada; // Tamanho máximo da fila de entrada
+    int limiteFantasma; // Tamanho máximo da fila fantasma
+    FilaCache filas[4]; // Indexadas por ListaCache
+    size_t bytes; // Memória ocupada pela cache
+
+    long acertos;
+    long faltas;
+    long promocoes; // Chaves que passaram da fila fantasma à lista principal
+    long expulsoes; // Registros descartados para abrir espaço
+} Cache;
+
+bool criarCache(Cache *cache, size_t orcamento);
+bool consultarCache(Cache *cache, Chave chave, Registro *reg);
+void guardarCache(Cache *cache, Chave chave, const Registro *reg);
+void destruirCache(Cache *cache);
+
+#endif // CACHE_H
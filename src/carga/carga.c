@@ -0,0 +1,245 @@
+#define _POSIX_C_SOURCE 200809L
+#include "carga.h"
+#include "../servidor/servidor.h"
+#include "../metricas/metricas.h"
+#include "../util/util.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+/*
+ * Gerador de carga do servidor de consultas.
+ *
+ * Cada conexão é atendida por uma thread que envia um pedido, espera a resposta e só então
+ * envia o próximo (laço fechado), medindo a latência de cada pedido. As chaves são sorteadas
+ * antes da rodada, para que a leitura do arquivo não entre nas medidas.
+ */
+
+typedef struct {
+    const char *caminhoSocket;
+    int indiceArquivo;
+    int tamanhoIntervalo; // 0 para buscas de uma chave
+    const Chave *chaves; // Chaves desta conexão
+    int numPedidos;
+    double *latencias; // Latência de cada pedido, em microssegundos
+    int respondidos;
+    int encontrados;
+    int naoEncontrados;
+    int erros;
+} ConexaoCarga;
+
+static double diferencaMicrossegundos(const struct timespec *inicio, const struct timespec *fim) {
+    return (fim->tv_sec - inicio->tv_sec) * 1e6 + (fim->tv_nsec - inicio->tv_nsec) / 1e3;
+}
+
+static int compararLatencias(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Conecta ao socket Unix do servidor.
+ *
+ * @return Descritor da conexão ou -1 em caso de erro.
+ */
+static int conectarServidor(const char *caminhoSocket) {
+    struct sockaddr_un endereco;
+    memset(&endereco, 0, sizeof(endereco));
+    endereco.sun_family = AF_UNIX;
+    strncpy(endereco.sun_path, caminhoSocket, sizeof(endereco.sun_path) - 1);
+
+    int conexao = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (conexao < 0) {
+        return -1;
+    }
+    if (connect(conexao, (struct sockaddr *)&endereco, sizeof(endereco)) != 0) {
+        close(conexao);
+        return -1;
+    }
+    return conexao;
+}
+
+/**
+ * Lê e descarta o corpo de uma resposta, depois de seu cabeçalho.
+ *
+ * @return Retorna true se o corpo inteiro foi lido.
+ */
+static bool lerCorpoResposta(int conexao, const CabecalhoResposta *cabecalho, bool intervalo) {
+    if (cabecalho->status != RESPOSTA_ENCONTRADO) {
+        return true;
+    }
+    if (!intervalo) {
+        RegistroResposta registro;
+        return lerCompleto(conexao, &registro, sizeof(registro));
+    }
+    for (int i = 0; i < cabecalho->quantidade; i++) {
+        EntradaResposta entrada;
+        if (!lerCompleto(conexao, &entrada, sizeof(entrada))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Laço de uma conexão: envia os pedidos um a um e mede o tempo até cada resposta.
+ */
+static void* executarConexaoCarga(void *argumento) {
+    ConexaoCarga *dados = argumento;
+    int conexao = conectarServidor(dados->caminhoSocket);
+    if (conexao < 0) {
+        dados->erros = dados->numPedidos;
+        return NULL;
+    }
+
+    bool intervalo = dados->tamanhoIntervalo > 0;
+    for (int i = 0; i < dados->numPedidos; i++) {
+        PedidoServidor pedido;
+        memset(&pedido, 0, sizeof(pedido));
+        pedido.tipo = intervalo ? PEDIDO_INTERVALO : PEDIDO_BUSCA;
+        pedido.arquivo = dados->indiceArquivo;
+        pedido.chave = dados->chaves[i];
+        pedido.maximo = dados->chaves[i] + dados->tamanhoIntervalo - 1;
+        pedido.limite = LIMITE_INTERVALO_SERVIDOR;
+
+        struct timespec inicio, fim;
+        clock_gettime(CLOCK_MONOTONIC, &inicio);
+        CabecalhoResposta cabecalho;
+        if (!escreverCompleto(conexao, &pedido, sizeof(pedido)) ||
+            !lerCompleto(conexao, &cabecalho, sizeof(cabecalho)) ||
+            !lerCorpoResposta(conexao, &cabecalho, intervalo)) {
+            dados->erros += dados->numPedidos - i;
+            break;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &fim);
+
+        dados->latencias[dados->respondidos++] = diferencaMicrossegundos(&inicio, &fim);
+        if (cabecalho.status == RESPOSTA_ENCONTRADO) {
+            dados->encontrados++;
+        } else if (cabecalho.status == RESPOSTA_NAO_ENCONTRADO) {
+            dados->naoEncontrados++;
+        } else {
+            dados->erros++;
+        }
+    }
+
+    close(conexao);
+    return NULL;
+}
+
+/**
+ * Executa uma rodada de carga contra o servidor e relata vazão e latências.
+ *
+ * @param caminhoSocket Caminho do socket Unix do servidor.
+ * @param nomeArquivo Arquivo de registros de onde as chaves são sorteadas.
+ * @param indiceArquivo Índice do mesmo arquivo na lista do servidor.
+ * @param conexoes Número de conexões simultâneas, cada uma em uma thread.
+ * @param pedidosPorConexao Pedidos enviados em sequência por conexão.
+ * @param tamanhoIntervalo Largura dos intervalos pedidos, ou 0 para buscas de uma chave.
+ * @return 0 se todos os pedidos foram respondidos ou 1 caso contrário.
+ */
+int executarCarga(
+    const char *caminhoSocket,
+    const char *nomeArquivo,
+    int indiceArquivo,
+    int conexoes,
+    int pedidosPorConexao,
+    int tamanhoIntervalo
+) {
+    if (conexoes < 1 || conexoes > MAXIMO_CONEXOES_CARGA || pedidosPorConexao < 1) {
+        fprintf(stderr, "Use de 1 a %d conexões e ao menos um pedido por conexão.\n", MAXIMO_CONEXOES_CARGA);
+        return 1;
+    }
+
+    FILE *arquivo = fopen(nomeArquivo, "rb");
+    if (!arquivo) {
+        perror("Erro ao abrir o arquivo");
+        return 1;
+    }
+
+    long totalPedidos = (long)conexoes * pedidosPorConexao;
+    Chave *chaves = malloc(totalPedidos * sizeof(Chave));
+    double *latencias = malloc(totalPedidos * sizeof(double));
+    ConexaoCarga *dados = calloc(conexoes, sizeof(ConexaoCarga));
+    pthread_t *threads = malloc(conexoes * sizeof(pthread_t));
+    if (!chaves || !latencias || !dados || !threads) {
+        perror("Erro ao alocar a carga");
+        fclose(arquivo);
+        free(chaves);
+        free(latencias);
+        free(dados);
+        free(threads);
+        return 1;
+    }
+
+    srand(time(NULL));
+    sortearChaves(arquivo, chaves, (int)totalPedidos);
+    fclose(arquivo);
+
+    Metricas metricas;
+    iniciarMetricas(&metricas);
+
+    int iniciadas = 0;
+    for (int i = 0; i < conexoes; i++) {
+        dados[i].caminhoSocket = caminhoSocket;
+        dados[i].indiceArquivo = indiceArquivo;
+        dados[i].tamanhoIntervalo = tamanhoIntervalo;
+        dados[i].chaves = chaves + (long)i * pedidosPorConexao;
+        dados[i].numPedidos = pedidosPorConexao;
+        dados[i].latencias = latencias + (long)i * pedidosPorConexao;
+        if (pthread_create(&threads[i], NULL, executarConexaoCarga, &dados[i]) != 0) {
+            dados[i].erros = pedidosPorConexao;
+            break;
+        }
+        iniciadas++;
+    }
+    for (int i = 0; i < iniciadas; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    finalizarMetricas(&metricas);
+
+    // Junta as latências das conexões no início do vetor para ordená-las
+    long respondidos = 0, encontrados = 0, naoEncontrados = 0, erros = 0;
+    for (int i = 0; i < conexoes; i++) {
+        memmove(latencias + respondidos, dados[i].latencias, dados[i].respondidos * sizeof(double));
+        respondidos += dados[i].respondidos;
+        encontrados += dados[i].encontrados;
+        naoEncontrados += dados[i].naoEncontrados;
+        erros += dados[i].erros;
+    }
+    metricas.consultas = respondidos;
+    qsort(latencias, respondidos, sizeof(double), compararLatencias);
+
+    printf(
+        "Carga de %s: %d conexão(ões) x %d pedido(s) de %s.\n",
+        caminhoSocket,
+        conexoes,
+        pedidosPorConexao,
+        tamanhoIntervalo > 0 ? "intervalo" : "busca"
+    );
+    printf("Respostas: %ld encontradas, %ld não encontradas, %ld erros.\n", encontrados, naoEncontrados, erros);
+    if (respondidos > 0) {
+        printf(
+            "Vazão: %.0f pedidos/s. Latência (µs): p50 %.1f, p90 %.1f, p99 %.1f, máxima %.1f.\n",
+            metricas.tempoReal > 0 ? respondidos / metricas.tempoReal : 0.0,
+            latencias[(respondidos - 1) * 50 / 100],
+            latencias[(respondidos - 1) * 90 / 100],
+            latencias[(respondidos - 1) * 99 / 100],
+            latencias[respondidos - 1]
+        );
+    }
+    imprimirMetricas(stdout, FORMATO_TEXTO, "carga", nomeArquivo, "carga", "Carga do Servidor", &metricas);
+
+    free(chaves);
+    free(latencias);
+    free(dados);
+    free(threads);
+    return erros == 0 ? 0 : 1;
+}
@@ -0,0 +1,15 @@
+#ifndef CARGA_H
+#define CARGA_H
+
+#define MAXIMO_CONEXOES_CARGA 256 // Conexões simultâneas abertas pelo gerador de carga
+
+int executarCarga(
+    const char *caminhoSocket,
+    const char *nomeArquivo,
+    int indiceArquivo,
+    int conexoes,
+    int pedidosPorConexao,
+    int tamanhoIntervalo
+);
+
+#endif // CARGA_H
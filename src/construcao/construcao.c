@@ -0,0 +1,774 @@
+#include "construcao.h"
+#include "../es/es.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+
+/*
+ * Construção paralela por partição de chaves.
+ *
+ * Chaves sorteadas do arquivo definem divisores que repartem o intervalo de chaves em uma
+ * partição por thread. Na primeira etapa, cada thread lê uma faixa contígua do arquivo e
+ * distribui seus registros pelas partições; na segunda, cada thread junta e ordena uma
+ * partição. Como as partições não se sobrepõem, as sequências ordenadas, uma após a outra,
+ * formam a sequência completa, e a estrutura é montada sobre ela de uma só vez.
+ */
+
+typedef struct {
+    Registro registro;
+    long posicao; // Posição do registro no arquivo
+} ItemParticao;
+
+typedef struct {
+    ItemParticao *itens;
+    long quantidade;
+    long capacidade;
+} Balde;
+
+typedef struct {
+    const char *nomeArquivo;
+    long inicio; // Primeira posição da faixa lida pela thread
+    long fim; // Posição seguinte à última da faixa
+    const Chave *divisores; // Menor chave de cada partição, a partir da segunda
+    int numParticoes;
+    Balde *baldes; // Um balde por partição
+    Metricas metricas;
+    bool falhou;
+} TarefaLeitura;
+
+typedef struct {
+    TarefaLeitura *leituras; // Faixas lidas, na ordem do arquivo
+    int numLeituras;
+    int particao;
+    ItemParticao *itens; // Trecho do vetor final reservado para a partição
+    long quantidade;
+    Metricas metricas;
+    bool falhou;
+} TarefaOrdenacao;
+
+typedef struct {
+    const char *nomeArquivo;
+    long inicio;
+    long fim;
+    int intervaloIndex;
+    Indice *entradas;
+    long quantidade;
+    long capacidade;
+    bool ordenada; // Indica se as chaves válidas da faixa estão em ordem crescente
+    bool temValidas;
+    Chave primeira; // Primeira e última chaves válidas da faixa
+    Chave ultima;
+    Metricas metricas;
+    bool falhou;
+} TarefaIndice;
+
+/**
+ * Executa uma função sobre cada tarefa de um vetor, uma thread por tarefa.
+ *
+ * Se uma thread não puder ser criada, a tarefa correspondente é executada pela própria
+ * thread chamadora, de modo que todas as tarefas são sempre concluídas.
+ *
+ * @param funcao Função executada por thread.
+ * @param tarefas Vetor de tarefas.
+ * @param tamanhoTarefa Tamanho de cada tarefa, em bytes.
+ * @param quantidade Número de tarefas.
+ */
+static void executarEmThreads(void *(*funcao)(void *), void *tarefas, size_t tamanhoTarefa, int quantidade) {
+    pthread_t threads[MAXIMO_THREADS_CONSTRUCAO];
+    bool criada[MAXIMO_THREADS_CONSTRUCAO];
+
+    for (int i = 0; i < quantidade; i++) {
+        void *tarefa = (char *)tarefas + i * tamanhoTarefa;
+        criada[i] = pthread_create(&threads[i], NULL, funcao, tarefa) == 0;
+        if (!criada[i]) {
+            funcao(tarefa);
+        }
+    }
+
+    for (int i = 0; i < quantidade; i++) {
+        if (criada[i]) {
+            pthread_join(threads[i], NULL);
+        }
+    }
+}
+
+/**
+ * Compara dois itens pela chave e, em caso de empate, pela posição no arquivo.
+ *
+ * @return Retorna true se o item a vem antes do item b.
+ */
+static bool precede(const ItemParticao *a, const ItemParticao *b, Metricas *metricas) {
+    metricas->comparacoes++;
+    if (a->registro.chave != b->registro.chave) {
+        return a->registro.chave < b->registro.chave;
+    }
+    return a->posicao < b->posicao;
+}
+
+/**
+ * Ordena itens por intercalação, da menor sequência para a maior.
+ *
+ * @param itens Vetor a ser ordenado.
+ * @param auxiliar Vetor de trabalho com o mesmo tamanho.
+ * @param quantidade Número de itens.
+ * @param metricas Ponteiro para as métricas onde as comparações são contadas.
+ */
+static void ordenarItens(ItemParticao *itens, ItemParticao *auxiliar, long quantidade, Metricas *metricas) {
+    ItemParticao *origem = itens;
+    ItemParticao *destino = auxiliar;
+
+    for (long largura = 1; largura < quantidade; largura *= 2) {
+        for (long inicio = 0; inicio < quantidade; inicio += 2 * largura) {
+            long meio = inicio + largura < quantidade ? inicio + largura : quantidade;
+            long fim = inicio + 2 * largura < quantidade ? inicio + 2 * largura : quantidade;
+            long i = inicio, j = meio, k = inicio;
+
+            while (i < meio && j < fim) {
+                destino[k++] = precede(&origem[j], &origem[i], metricas) ? origem[j++] : origem[i++];
+            }
+            while (i < meio) {
+                destino[k++] = origem[i++];
+            }
+            while (j < fim) {
+                destino[k++] = origem[j++];
+            }
+        }
+
+        ItemParticao *troca = origem;
+        origem = destino;
+        destino = troca;
+    }
+
+    if (origem != itens) {
+        memcpy(itens, origem, quantidade * sizeof(ItemParticao));
+    }
+}
+
+/**
+ * Encontra a partição de uma chave por busca binária nos divisores.
+ */
+static int escolherParticao(const Chave *divisores, int numDivisores, Chave chave, Metricas *metricas) {
+    int inicio = 0, fim = numDivisores;
+    while (inicio < fim) {
+        int meio = (inicio + fim) / 2;
+        metricas->comparacoes++;
+        if (chave < divisores[meio]) {
+            fim = meio;
+        } else {
+            inicio = meio + 1;
+        }
+    }
+    return inicio;
+}
+
+/**
+ * Acrescenta um registro a um balde, ampliando-o quando necessário.
+ *
+ * @return Retorna true se houve memória para o registro.
+ */
+static bool acrescentarItem(Balde *balde, const Registro *reg, long posicao) {
+    if (balde->quantidade == balde->capacidade) {
+        long capacidade = balde->capacidade > 0 ? balde->capacidade * 2 : 64;
+        ItemParticao *itens = realloc(balde->itens, capacidade * sizeof(ItemParticao));
+        if (!itens) {
+            return false;
+        }
+        balde->itens = itens;
+        balde->capacidade = capacidade;
+    }
+
+    balde->itens[balde->quantidade].registro = *reg;
+    balde->itens[balde->quantidade].posicao = posicao;
+    balde->quantidade++;
+    return true;
+}
+
+/**
+ * Primeira etapa: lê uma faixa do arquivo e distribui os registros válidos pelas partições.
+ * Cada thread abre o arquivo por conta própria para ter sua própria posição de leitura.
+ */
+static void* lerFaixa(void *argumento) {
+    TarefaLeitura *tarefa = argumento;
+    FILE *arquivo = abrirArquivoDados(tarefa->nomeArquivo, "rb");
+    if (!arquivo) {
+        tarefa->falhou = true;
+        return NULL;
+    }
+
+    Registro reg;
+    for (long posicao = tarefa->inicio; posicao < tarefa->fim; posicao++) {
+        if (!lerRegistro(arquivo, posicao, &reg, &tarefa->metricas)) {
+            tarefa->falhou = true;
+            break;
+        }
+        if (!registroValido(&reg)) {
+            continue;
+        }
+
+        int particao = escolherParticao(tarefa->divisores, tarefa->numParticoes - 1, reg.chave, &tarefa->metricas);
+        if (!acrescentarItem(&tarefa->baldes[particao], &reg, posicao)) {
+            tarefa->falhou = true;
+            break;
+        }
+    }
+
+    fclose(arquivo);
+    return NULL;
+}
+
+/**
+ * Segunda etapa: junta os baldes de uma partição, na ordem do arquivo, e os ordena.
+ */
+static void* ordenarParticao(void *argumento) {
+    TarefaOrdenacao *tarefa = argumento;
+    long quantidade = 0;
+
+    for (int i = 0; i < tarefa->numLeituras; i++) {
+        Balde *balde = &tarefa->leituras[i].baldes[tarefa->particao];
+        if (balde->quantidade > 0) {
+            memcpy(tarefa->itens + quantidade, balde->itens, balde->quantidade * sizeof(ItemParticao));
+            quantidade += balde->quantidade;
+        }
+        free(balde->itens);
+        balde->itens = NULL;
+    }
+
+    ItemParticao *auxiliar = malloc((quantidade > 0 ? quantidade : 1) * sizeof(ItemParticao));
+    if (!auxiliar) {
+        tarefa->falhou = true;
+        return NULL;
+    }
+    ordenarItens(tarefa->itens, auxiliar, quantidade, &tarefa->metricas);
+    free(auxiliar);
+
+    tarefa->quantidade = quantidade;
+    return NULL;
+}
+
+/**
+ * Sorteia chaves do arquivo, em posições igualmente espaçadas, e escolhe os divisores que
+ * repartem as chaves em partições de tamanhos próximos.
+ *
+ * @param arquivo Ponteiro para o arquivo de registros.
+ * @param totalRegistros Número de registros do arquivo.
+ * @param numParticoes Número de partições desejado.
+ * @param divisores Vetor onde os divisores serão armazenados.
+ * @param metricas Ponteiro para as métricas da construção.
+ * @return Número de divisores escolhidos (zero se não houver registros válidos na amostra).
+ */
+static int escolherDivisores(FILE *arquivo, long totalRegistros, int numParticoes, Chave *divisores, Metricas *metricas) {
+    long numAmostras = (long)numParticoes * AMOSTRAS_POR_PARTICAO;
+    if (numAmostras > totalRegistros) {
+        numAmostras = totalRegistros;
+    }
+
+    ItemParticao *amostras = malloc(2 * (numAmostras > 0 ? numAmostras : 1) * sizeof(ItemParticao));
+    if (!amostras) {
+        return 0;
+    }
+
+    long validas = 0;
+    for (long i = 0; i < numAmostras; i++) {
+        long posicao = i * totalRegistros / numAmostras;
+        if (lerRegistro(arquivo, posicao, &amostras[validas].registro, metricas) && registroValido(&amostras[validas].registro)) {
+            amostras[validas].posicao = posicao;
+            validas++;
+        }
+    }
+
+    int numDivisores = 0;
+    if (validas > 0) {
+        ordenarItens(amostras, amostras + numAmostras, validas, metricas);
+        for (int k = 1; k < numParticoes; k++) {
+            divisores[numDivisores++] = amostras[k * validas / numParticoes].registro.chave;
+        }
+    }
+
+    free(amostras);
+    return numDivisores;
+}
+
+/**
+ * Lê o arquivo em paralelo e devolve seus registros válidos ordenados por chave e, entre
+ * chaves repetidas, por posição.
+ *
+ * @param nomeArquivo Caminho do arquivo de registros.
+ * @param numThreads Número de threads usadas na leitura e na ordenação.
+ * @param quantidade Ponteiro onde será armazenado o número de itens devolvidos.
+ * @param metricas Ponteiro para as métricas da construção.
+ * @return Vetor de itens ordenados (liberado por quem chama) ou NULL em caso de erro.
+ */
+static ItemParticao* ordenarPorParticoes(const char *nomeArquivo, int numThreads, long *quantidade, Metricas *metricas) {
+    *quantidade = 0;
+
+    FILE *arquivo = abrirArquivoDados(nomeArquivo, "rb");
+    if (!arquivo) {
+        perror("Erro ao abrir o arquivo");
+        return NULL;
+    }
+
+    registrarPosicionamento(metricas);
+    fseeko(arquivo, 0, SEEK_END);
+    long totalRegistros = ftello(arquivo) / sizeof(Registro);
+
+    if (numThreads > MAXIMO_THREADS_CONSTRUCAO) {
+        numThreads = MAXIMO_THREADS_CONSTRUCAO;
+    }
+    if (numThreads > totalRegistros) {
+        numThreads = totalRegistros > 0 ? totalRegistros : 1;
+    }
+
+    Chave divisores[MAXIMO_THREADS_CONSTRUCAO];
+    int numParticoes = escolherDivisores(arquivo, totalRegistros, numThreads, divisores, metricas) + 1;
+    fclose(arquivo);
+
+    // Primeira etapa: cada thread lê uma faixa contígua do arquivo
+    TarefaLeitura leituras[MAXIMO_THREADS_CONSTRUCAO];
+    memset(leituras, 0, sizeof(leituras));
+    for (int i = 0; i < numThreads; i++) {
+        leituras[i].nomeArquivo = nomeArquivo;
+        leituras[i].inicio = i * totalRegistros / numThreads;
+        leituras[i].fim = (i + 1) * totalRegistros / numThreads;
+        leituras[i].divisores = divisores;
+        leituras[i].numParticoes = numParticoes;
+        leituras[i].baldes = calloc(numParticoes, sizeof(Balde));
+        leituras[i].falhou = leituras[i].baldes == NULL;
+    }
+
+    executarEmThreads(lerFaixa, leituras, sizeof(TarefaLeitura), numThreads);
+
+    bool falhou = false;
+    long total = 0;
+    for (int i = 0; i < numThreads; i++) {
+        acumularMetricas(metricas, &leituras[i].metricas);
+        falhou = falhou || leituras[i].falhou;
+        for (int p = 0; !leituras[i].falhou && p < numParticoes; p++) {
+            total += leituras[i].baldes[p].quantidade;
+        }
+    }
+
+    ItemParticao *itens = falhou ? NULL : malloc((total > 0 ? total : 1) * sizeof(ItemParticao));
+
+    // Segunda etapa: cada thread ordena uma partição no trecho reservado a ela
+    if (itens != NULL) {
+        TarefaOrdenacao ordenacoes[MAXIMO_THREADS_CONSTRUCAO];
+        memset(ordenacoes, 0, sizeof(ordenacoes));
+        long deslocamento = 0;
+        for (int p = 0; p < numParticoes; p++) {
+            ordenacoes[p].leituras = leituras;
+            ordenacoes[p].numLeituras = numThreads;
+            ordenacoes[p].particao = p;
+            ordenacoes[p].itens = itens + deslocamento;
+            for (int i = 0; i < numThreads; i++) {
+                deslocamento += leituras[i].baldes[p].quantidade;
+            }
+        }
+
+        executarEmThreads(ordenarParticao, ordenacoes, sizeof(TarefaOrdenacao), numParticoes);
+
+        // As partições ordenadas, uma após a outra, formam a sequência completa
+        for (int p = 0; p < numParticoes; p++) {
+            acumularMetricas(metricas, &ordenacoes[p].metricas);
+            falhou = falhou || ordenacoes[p].falhou;
+            memmove(itens + *quantidade, ordenacoes[p].itens, ordenacoes[p].quantidade * sizeof(ItemParticao));
+            *quantidade += ordenacoes[p].quantidade;
+        }
+    }
+
+    for (int i = 0; i < numThreads; i++) {
+        for (int p = 0; leituras[i].baldes != NULL && p < numParticoes; p++) {
+            free(leituras[i].baldes[p].itens);
+        }
+        free(leituras[i].baldes);
+    }
+
+    if (falhou || itens == NULL) {
+        fprintf(stderr, "Erro na construção paralela.\n");
+        free(itens);
+        *quantidade = 0;
+        return NULL;
+    }
+    return itens;
+}
+
+/**
+ * Constrói uma Árvore B com várias threads a partir de um arquivo de registros.
+ *
+ * Os registros são lidos e ordenados por partição de chaves e a árvore é montada de uma só
+ * vez sobre a sequência ordenada. Cada ocorrência de uma chave repetida tem a sua entrada,
+ * como na construção sequencial.
+ *
+ * @param nomeArquivo Caminho do arquivo de registros.
+ * @param numThreads Número de threads.
+ * @param metricas Ponteiro para as métricas da construção.
+ * @return Ponteiro para a raiz da Árvore B ou NULL se não houver registros ou em caso de erro.
+ */
+NoArvoreB* construirArvoreBParalela(const char *nomeArquivo, int numThreads, Metricas *metricas) {
+    long quantidade;
+    ItemParticao *itens = ordenarPorParticoes(nomeArquivo, numThreads, &quantidade, metricas);
+    if (!itens) {
+        return NULL;
+    }
+
+    Entrada *entradas = malloc((quantidade > 0 ? quantidade : 1) * sizeof(Entrada));
+    if (!entradas) {
+        perror("Erro ao alocar as entradas da Árvore B");
+        free(itens);
+        return NULL;
+    }
+    for (long i = 0; i < quantidade; i++) {
+        entradas[i].chave = itens[i].registro.chave;
+        entradas[i].posicao = itens[i].posicao;
+    }
+    free(itens);
+
+    NoArvoreB *raiz = montarArvoreB(entradas, quantidade);
+    free(entradas);
+    return raiz;
+}
+
+/**
+ * Constrói uma árvore B* com várias threads a partir de um arquivo de registros.
+ *
+ * Funciona como construirArvoreBParalela, mas as folhas guardam também os registros.
+ *
+ * @param nomeArquivo Caminho do arquivo de registros.
+ * @param numThreads Número de threads.
+ * @param metricas Ponteiro para as métricas da construção.
+ * @return Ponteiro para a raiz da árvore B* ou NULL se não houver registros ou em caso de erro.
+ */
+NoArvoreBStar* construirArvoreBStarParalela(const char *nomeArquivo, int numThreads, Metricas *metricas) {
+    long quantidade;
+    ItemParticao *itens = ordenarPorParticoes(nomeArquivo, numThreads, &quantidade, metricas);
+    if (!itens) {
+        return NULL;
+    }
+
+    Registro *registros = malloc((quantidade > 0 ? quantidade : 1) * sizeof(Registro));
+    long *posicoes = malloc((quantidade > 0 ? quantidade : 1) * sizeof(long));
+    if (!registros || !posicoes) {
+        perror("Erro ao alocar os registros da árvore B*");
+        free(registros);
+        free(posicoes);
+        free(itens);
+        return NULL;
+    }
+    for (long i = 0; i < quantidade; i++) {
+        registros[i] = itens[i].registro;
+        posicoes[i] = itens[i].posicao;
+    }
+    free(itens);
+
+    NoArvoreBStar *raiz = montarArvoreBStar(registros, posicoes, quantidade);
+    free(registros);
+    free(posicoes);
+    return raiz;
+}
+
+/**
+ * Lê uma faixa do arquivo e guarda as entradas de índice que caem nela.
+ */
+static void* indexarFaixa(void *argumento) {
+    TarefaIndice *tarefa = argumento;
+    FILE *arquivo = abrirArquivoDados(tarefa->nomeArquivo, "rb");
+    if (!arquivo) {
+        tarefa->falhou = true;
+        return NULL;
+    }
+
+    Registro reg;
+    for (long posicao = tarefa->inicio; posicao < tarefa->fim; posicao++) {
+        if (!lerRegistro(arquivo, posicao, &reg, &tarefa->metricas)) {
+            tarefa->falhou = true;
+            break;
+        }
+        if (registroValido(&reg)) {
+            if (!tarefa->temValidas) {
+                tarefa->primeira = reg.chave;
+                tarefa->temValidas = true;
+            }
+            tarefa->ordenada = tarefa->ordenada && tarefa->ultima <= reg.chave;
+            tarefa->ultima = reg.chave;
+        }
+        if (posicao % tarefa->intervaloIndex != 0 || !registroValido(&reg)) {
+            continue;
+        }
+
+        if (tarefa->quantidade == tarefa->capacidade) {
+            long capacidade = tarefa->capacidade > 0 ? tarefa->capacidade * 2 : 16;
+            Indice *entradas = realloc(tarefa->entradas, capacidade * sizeof(Indice));
+            if (!entradas) {
+                tarefa->falhou = true;
+                break;
+            }
+            tarefa->entradas = entradas;
+            tarefa->capacidade = capacidade;
+        }
+        tarefa->entradas[tarefa->quantidade].chave = reg.chave;
+        tarefa->entradas[tarefa->quantidade].posicao = posicao;
+        tarefa->quantidade++;
+    }
+
+    fclose(arquivo);
+    return NULL;
+}
+
+/**
+ * Cria o índice do acesso sequencial indexado com várias threads.
+ *
+ * Cada thread lê uma faixa contígua do arquivo e as entradas das faixas são juntadas na
+ * ordem do arquivo, de modo que o índice é o mesmo produzido por criarIndice.
+ *
+ * @param nomeArquivo Caminho do arquivo de registros.
+ * @param indice Ponteiro para um ponteiro do índice a ser criado.
+ * @param tamanhoIndice Ponteiro para armazenar o tamanho do índice criado.
+ * @param intervaloIndex Intervalo entre registros para indexar.
+ * @param numThreads Número de threads.
+ * @param ordenado Onde será indicado se as chaves válidas do arquivo estão em ordem crescente.
+ * @param metricas Ponteiro para as métricas da construção.
+ */
+void criarIndiceParalelo(
+    const char *nomeArquivo,
+    Indice **indice,
+    long *tamanhoIndice,
+    int intervaloIndex,
+    int numThreads,
+    bool *ordenado,
+    Metricas *metricas
+) {
+    *indice = NULL;
+    *tamanhoIndice = 0;
+    *ordenado = true;
+
+    FILE *arquivo = abrirArquivoDados(nomeArquivo, "rb");
+    if (!arquivo) {
+        perror("Erro ao abrir o arquivo");
+        return;
+    }
+    registrarPosicionamento(metricas);
+    fseeko(arquivo, 0, SEEK_END);
+    long totalRegistros = ftello(arquivo) / sizeof(Registro);
+    fclose(arquivo);
+
+    if (numThreads > MAXIMO_THREADS_CONSTRUCAO) {
+        numThreads = MAXIMO_THREADS_CONSTRUCAO;
+    }
+    if (numThreads > totalRegistros) {
+        numThreads = totalRegistros > 0 ? totalRegistros : 1;
+    }
+
+    TarefaIndice tarefas[MAXIMO_THREADS_CONSTRUCAO];
+    memset(tarefas, 0, sizeof(tarefas));
+    for (int i = 0; i < numThreads; i++) {
+        tarefas[i].nomeArquivo = nomeArquivo;
+        tarefas[i].inicio = i * totalRegistros / numThreads;
+        tarefas[i].fim = (i + 1) * totalRegistros / numThreads;
+        tarefas[i].intervaloIndex = intervaloIndex;
+        tarefas[i].ordenada = true;
+        tarefas[i].ultima = CHAVE_MINIMA;
+    }
+
+    executarEmThreads(indexarFaixa, tarefas, sizeof(TarefaIndice), numThreads);
+
+    long total = 0;
+    bool falhou = false;
+    bool temAnterior = false;
+    Chave anterior = 0; // Última chave válida das faixas anteriores
+    for (int i = 0; i < numThreads; i++) {
+        acumularMetricas(metricas, &tarefas[i].metricas);
+        falhou = falhou || tarefas[i].falhou;
+        total += tarefas[i].quantidade;
+        if (tarefas[i].temValidas) {
+            *ordenado = *ordenado && tarefas[i].ordenada && (!temAnterior || anterior <= tarefas[i].primeira);
+            anterior = tarefas[i].ultima;
+            temAnterior = true;
+        }
+    }
+
+    *indice = falhou ? NULL : malloc((total > 0 ? total : 1) * sizeof(Indice));
+    for (int i = 0; i < numThreads; i++) {
+        if (*indice != NULL && tarefas[i].quantidade > 0) {
+            memcpy(*indice + *tamanhoIndice, tarefas[i].entradas, tarefas[i].quantidade * sizeof(Indice));
+            *tamanhoIndice += tarefas[i].quantidade;
+        }
+        free(tarefas[i].entradas);
+    }
+
+    if (*indice == NULL) {
+        fprintf(stderr, "Erro na construção paralela do índice.\n");
+    }
+
+    metricas->numNos = *tamanhoIndice;
+    metricas->altura = 1;
+}
+
+/*
+ * Construção encadeada em duas etapas.
+ *
+ * Uma thread leitora lê o arquivo sequencialmente em blocos grandes e os entrega, por um
+ * anel de BLOCOS_ENCADEADOS posições, à thread que insere na árvore. O anel tem um único
+ * produtor e um único consumidor e dispensa travas: cada lado só escreve o seu contador e
+ * lê o do outro, e uma posição só é reaproveitada depois que o consumidor a devolve. Assim
+ * a leitura do próximo bloco acontece enquanto o anterior é inserido.
+ */
+
+typedef struct {
+    Registro registros[REGISTROS_BLOCO_ENCADEADO];
+    long primeiraPosicao; // Posição no arquivo do primeiro registro do bloco
+    int quantidade;
+} BlocoEncadeado;
+
+typedef struct {
+    const char *nomeArquivo;
+    BlocoEncadeado *blocos; // Anel de BLOCOS_ENCADEADOS blocos
+    _Atomic unsigned long produzidos; // Blocos publicados pela leitora
+    _Atomic unsigned long consumidos; // Blocos devolvidos pela inseridora
+    atomic_bool terminou; // A leitora não publicará mais blocos
+    bool falhou;
+    Metricas metricas; // E/S da leitora
+} CanalEncadeado;
+
+typedef void (*InserirEncadeado)(void *contexto, const Registro *reg, long posicao, Metricas *metricas);
+
+/**
+ * Thread leitora: preenche os blocos do anel na ordem do arquivo, esperando quando todos
+ * ainda estão com a inseridora.
+ */
+static void* lerEncadeado(void *argumento) {
+    CanalEncadeado *canal = argumento;
+    FILE *arquivo = abrirArquivoDados(canal->nomeArquivo, "rb");
+    if (!arquivo) {
+        canal->falhou = true;
+        atomic_store_explicit(&canal->terminou, true, memory_order_release);
+        return NULL;
+    }
+
+    long posicao = 0;
+    for (unsigned long n = 0;; n++) {
+        while (n - atomic_load_explicit(&canal->consumidos, memory_order_acquire) >= BLOCOS_ENCADEADOS) {
+            sched_yield();
+        }
+
+        BlocoEncadeado *bloco = &canal->blocos[n % BLOCOS_ENCADEADOS];
+        size_t lidos = fread(bloco->registros, sizeof(Registro), REGISTROS_BLOCO_ENCADEADO, arquivo);
+        canal->metricas.transferencias += lidos;
+        canal->metricas.bytesLidos += lidos * sizeof(Registro);
+        canal->metricas.chamadasSistema++;
+        if (lidos == 0) {
+            break;
+        }
+
+        bloco->primeiraPosicao = posicao;
+        bloco->quantidade = (int)lidos;
+        posicao += lidos;
+        atomic_store_explicit(&canal->produzidos, n + 1, memory_order_release);
+        if (lidos < REGISTROS_BLOCO_ENCADEADO) {
+            break;
+        }
+    }
+
+    canal->falhou = ferror(arquivo) != 0;
+    fclose(arquivo);
+    atomic_store_explicit(&canal->terminou, true, memory_order_release);
+    return NULL;
+}
+
+/**
+ * Percorre o arquivo com a thread leitora, entregando cada registro válido à função de
+ * inserção na thread atual.
+ *
+ * @return Retorna false se a leitura falhou.
+ */
+static bool percorrerEncadeado(const char *nomeArquivo, InserirEncadeado inserir, void *contexto, Metricas *metricas) {
+    CanalEncadeado canal;
+    memset(&canal, 0, sizeof(canal));
+    canal.nomeArquivo = nomeArquivo;
+    canal.blocos = malloc(BLOCOS_ENCADEADOS * sizeof(BlocoEncadeado));
+    atomic_init(&canal.produzidos, 0);
+    atomic_init(&canal.consumidos, 0);
+    atomic_init(&canal.terminou, false);
+    iniciarMetricas(&canal.metricas);
+
+    pthread_t leitora;
+    if (!canal.blocos || pthread_create(&leitora, NULL, lerEncadeado, &canal) != 0) {
+        perror("Erro ao iniciar a leitura encadeada");
+        free(canal.blocos);
+        return false;
+    }
+
+    for (unsigned long n = 0;; n++) {
+        // O contador é relido depois do aviso de término: o último bloco pode ter sido
+        // publicado entre as duas leituras
+        while (atomic_load_explicit(&canal.produzidos, memory_order_acquire) <= n) {
+            if (atomic_load_explicit(&canal.terminou, memory_order_acquire) &&
+                atomic_load_explicit(&canal.produzidos, memory_order_acquire) <= n) {
+                break;
+            }
+            sched_yield();
+        }
+        if (atomic_load_explicit(&canal.produzidos, memory_order_acquire) <= n) {
+            break;
+        }
+
+        const BlocoEncadeado *bloco = &canal.blocos[n % BLOCOS_ENCADEADOS];
+        for (int i = 0; i < bloco->quantidade; i++) {
+            if (registroValido(&bloco->registros[i])) {
+                inserir(contexto, &bloco->registros[i], bloco->primeiraPosicao + i, metricas);
+            }
+        }
+        atomic_store_explicit(&canal.consumidos, n + 1, memory_order_release);
+    }
+
+    pthread_join(leitora, NULL);
+    acumularMetricas(metricas, &canal.metricas);
+    free(canal.blocos);
+    return !canal.falhou;
+}
+
+static void inserirEncadeadoArvoreB(void *contexto, const Registro *reg, long posicao, Metricas *metricas) {
+    NoArvoreB **raiz = contexto;
+    *raiz = inserirNoArvoreB(*raiz, reg->chave, posicao, metricas);
+}
+
+static void inserirEncadeadoArvoreBStar(void *contexto, const Registro *reg, long posicao, Metricas *metricas) {
+    NoArvoreBStar **raiz = contexto;
+    *raiz = inserirArvoreBStar(*raiz, *reg, posicao, metricas);
+}
+
+/**
+ * Constrói uma Árvore B inserindo os registros na ordem do arquivo, como a construção
+ * sequencial, enquanto uma thread leitora lê os blocos seguintes.
+ *
+ * @param nomeArquivo Caminho do arquivo de registros.
+ * @param metricas Ponteiro para as métricas da construção.
+ * @return Ponteiro para a raiz da Árvore B ou NULL se não houver registros ou em caso de erro.
+ */
+NoArvoreB* construirArvoreBEncadeada(const char *nomeArquivo, Metricas *metricas) {
+    NoArvoreB *raiz = NULL;
+    if (!percorrerEncadeado(nomeArquivo, inserirEncadeadoArvoreB, &raiz, metricas)) {
+        destruirArvoreB(raiz);
+        return NULL;
+    }
+    return raiz;
+}
+
+/**
+ * Constrói uma árvore B* inserindo os registros na ordem do arquivo enquanto uma thread
+ * leitora lê os blocos seguintes.
+ *
+ * @param nomeArquivo Caminho do arquivo de registros.
+ * @param metricas Ponteiro para as métricas da construção.
+ * @return Ponteiro para a raiz da árvore B* ou NULL se não houver registros ou em caso de erro.
+ */
+NoArvoreBStar* construirArvoreBStarEncadeada(const char *nomeArquivo, Metricas *metricas) {
+    NoArvoreBStar *raiz = NULL;
+    if (!percorrerEncadeado(nomeArquivo, inserirEncadeadoArvoreBStar, &raiz, metricas)) {
+        destruirArvoreBStar(raiz);
+        return NULL;
+    }
+    return raiz;
+}
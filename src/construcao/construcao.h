@@ -0,0 +1,28 @@
+#ifndef CONSTRUCAO_H
+#define CONSTRUCAO_H
+
+#include "../index/index.h"
+#include "../arvoreb/arvoreb.h"
+#include "../arvorebstar/arvorebstar.h"
+#include "../metricas/metricas.h"
+
+#define MAXIMO_THREADS_CONSTRUCAO 64 // Limite de threads da construção paralela
+#define AMOSTRAS_POR_PARTICAO 32 // Chaves sorteadas por partição para escolher os divisores
+#define BLOCOS_ENCADEADOS 3 // Blocos em trânsito entre a leitura e a inserção encadeadas
+#define REGISTROS_BLOCO_ENCADEADO 4096 // Registros lidos por bloco na construção encadeada
+
+void criarIndiceParalelo(
+    const char *nomeArquivo,
+    Indice **indice,
+    long *tamanhoIndice,
+    int intervaloIndex,
+    int numThreads,
+    bool *ordenado,
+    Metricas *metricas
+);
+NoArvoreB* construirArvoreBParalela(const char *nomeArquivo, int numThreads, Metricas *metricas);
+NoArvoreBStar* construirArvoreBStarParalela(const char *nomeArquivo, int numThreads, Metricas *metricas);
+NoArvoreB* construirArvoreBEncadeada(const char *nomeArquivo, Metricas *metricas);
+NoArvoreBStar* construirArvoreBStarEncadeada(const char *nomeArquivo, Metricas *metricas);
+
+#endif // CONSTRUCAO_H
@@ -0,0 +1,99 @@
+#include "contadores.h"
+#include <string.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+
+/**
+ * Abre um contador de hardware que conta só o processo atual, em modo usuário, começando
+ * desligado.
+ *
+ * @return Descritor do contador ou -1 se ele não está disponível.
+ */
+static int abrirContador(uint64_t configuracao) {
+    struct perf_event_attr atributos;
+    memset(&atributos, 0, sizeof(atributos));
+    atributos.type = PERF_TYPE_HARDWARE;
+    atributos.size = sizeof(atributos);
+    atributos.config = configuracao;
+    atributos.disabled = 1;
+    atributos.exclude_kernel = 1;
+    atributos.exclude_hv = 1;
+    return (int)syscall(SYS_perf_event_open, &atributos, 0, -1, -1, 0);
+}
+#endif
+
+/**
+ * Abre os contadores de ciclos, instruções, faltas de cache e desvios mal previstos.
+ *
+ * @param contadores Estrutura onde os descritores serão guardados.
+ * @return Número de contadores abertos (0 se nenhum está disponível).
+ */
+int abrirContadores(Contadores *contadores) {
+    int abertos = 0;
+    for (int i = 0; i < NUM_CONTADORES; i++) {
+        contadores->descritores[i] = -1;
+    }
+#ifdef __linux__
+    const uint64_t configuracoes[NUM_CONTADORES] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES
+    };
+    for (int i = 0; i < NUM_CONTADORES; i++) {
+        contadores->descritores[i] = abrirContador(configuracoes[i]);
+        abertos += contadores->descritores[i] >= 0;
+    }
+#endif
+    return abertos;
+}
+
+/**
+ * Zera e liga os contadores abertos.
+ */
+void iniciarContadores(Contadores *contadores) {
+#ifdef __linux__
+    for (int i = 0; i < NUM_CONTADORES; i++) {
+        if (contadores->descritores[i] >= 0) {
+            ioctl(contadores->descritores[i], PERF_EVENT_IOC_RESET, 0);
+            ioctl(contadores->descritores[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+#endif
+}
+
+/**
+ * Desliga os contadores e lê os seus valores.
+ *
+ * @param contadores Contadores abertos.
+ * @param valores Onde os valores serão gravados (CONTADOR_INDISPONIVEL para os que faltam).
+ */
+void pararContadores(Contadores *contadores, uint64_t valores[NUM_CONTADORES]) {
+    for (int i = 0; i < NUM_CONTADORES; i++) {
+        valores[i] = CONTADOR_INDISPONIVEL;
+#ifdef __linux__
+        if (contadores->descritores[i] >= 0) {
+            ioctl(contadores->descritores[i], PERF_EVENT_IOC_DISABLE, 0);
+            if (read(contadores->descritores[i], &valores[i], sizeof(uint64_t)) != sizeof(uint64_t)) {
+                valores[i] = CONTADOR_INDISPONIVEL;
+            }
+        }
+#endif
+    }
+}
+
+/**
+ * Fecha os descritores dos contadores.
+ */
+void fecharContadores(Contadores *contadores) {
+    for (int i = 0; i < NUM_CONTADORES; i++) {
+        if (contadores->descritores[i] >= 0) {
+            close(contadores->descritores[i]);
+            contadores->descritores[i] = -1;
+        }
+    }
+}
@@ -0,0 +1,31 @@
+#ifndef CONTADORES_H
+#define CONTADORES_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define CONTADOR_INDISPONIVEL UINT64_MAX // Valor lido de um contador que não pôde ser aberto
+
+/*
+ * Contadores de hardware do próprio processo, lidos com perf_event_open (só no Linux e
+ * quando o núcleo e as permissões deixam; em máquinas virtuais costumam faltar). Cada
+ * contador é aberto em separado, então os que faltam não impedem os outros.
+ */
+typedef enum {
+    CONTADOR_CICLOS,
+    CONTADOR_INSTRUCOES,
+    CONTADOR_FALTAS_CACHE,
+    CONTADOR_DESVIOS_ERRADOS,
+    NUM_CONTADORES
+} TipoContador;
+
+typedef struct {
+    int descritores[NUM_CONTADORES]; // -1 para os contadores indisponíveis
+} Contadores;
+
+int abrirContadores(Contadores *contadores);
+void iniciarContadores(Contadores *contadores);
+void pararContadores(Contadores *contadores, uint64_t valores[NUM_CONTADORES]);
+void fecharContadores(Contadores *contadores);
+
+#endif // CONTADORES_H
@@ -0,0 +1,279 @@
+#define _GNU_SOURCE
+#include "es.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+static ModoES modoAtual = MODO_ES_PADRAO; // Modo escolhido para a execução
+static bool avisoDiretoExibido = false;
+
+/*
+ * Estado de um arquivo aberto com O_DIRECT. O dispositivo só aceita transferências de
+ * blocos alinhados, então o arquivo mantém um único bloco alinhado em memória: leituras
+ * e escritas da stdio são atendidas a partir dele, e cada troca de bloco é uma leitura
+ * (ou escrita) real no dispositivo.
+ */
+typedef struct {
+    int descritor;
+    off_t posicao; // Posição lógica do arquivo
+    off_t tamanho; // Tamanho lógico do arquivo
+    char *bloco; // Bloco alinhado atualmente em memória
+    off_t inicioBloco; // Deslocamento do bloco em memória (-1 se nenhum)
+    bool blocoSujo; // Indica se o bloco foi alterado e precisa ser gravado
+    bool alterado; // Indica se o arquivo foi escrito e o tamanho precisa ser ajustado ao fechar
+} ArquivoDireto;
+
+/**
+ * Define o modo de E/S usado pelos arquivos de dados abertos a partir de agora.
+ *
+ * @param modo Modo de E/S escolhido para a execução.
+ */
+void definirModoES(ModoES modo) {
+    modoAtual = modo;
+}
+
+/**
+ * Retorna o modo de E/S em uso.
+ */
+ModoES obterModoES(void) {
+    return modoAtual;
+}
+
+/**
+ * Exibe, uma única vez, o aviso de que o O_DIRECT não pôde ser usado.
+ */
+static void avisarSemDireto(const char *caminho) {
+    if (!avisoDiretoExibido) {
+        fprintf(stderr, "Aviso: O_DIRECT indisponível para %s (%s); usando E/S com cache.\n", caminho, strerror(errno));
+        avisoDiretoExibido = true;
+    }
+}
+
+/**
+ * Grava o bloco em memória no dispositivo, se ele tiver sido alterado.
+ */
+static int gravarBloco(ArquivoDireto *arquivo) {
+    if (!arquivo->blocoSujo) {
+        return 0;
+    }
+    if (pwrite(arquivo->descritor, arquivo->bloco, ALINHAMENTO_DIRETO, arquivo->inicioBloco) != ALINHAMENTO_DIRETO) {
+        return -1;
+    }
+    arquivo->blocoSujo = false;
+    return 0;
+}
+
+/**
+ * Garante que o bloco que contém o deslocamento informado esteja em memória.
+ */
+static int carregarBloco(ArquivoDireto *arquivo, off_t deslocamento) {
+    off_t inicio = deslocamento - (deslocamento % ALINHAMENTO_DIRETO);
+    if (inicio == arquivo->inicioBloco) {
+        return 0;
+    }
+    if (gravarBloco(arquivo) != 0) {
+        return -1;
+    }
+
+    memset(arquivo->bloco, 0, ALINHAMENTO_DIRETO);
+    if (inicio < arquivo->tamanho) {
+        if (pread(arquivo->descritor, arquivo->bloco, ALINHAMENTO_DIRETO, inicio) < 0) {
+            return -1;
+        }
+    }
+    arquivo->inicioBloco = inicio;
+    return 0;
+}
+
+static ssize_t lerDireto(void *cookie, char *destino, size_t tamanho) {
+    ArquivoDireto *arquivo = cookie;
+    size_t copiados = 0;
+
+    while (copiados < tamanho && arquivo->posicao < arquivo->tamanho) {
+        if (carregarBloco(arquivo, arquivo->posicao) != 0) {
+            return copiados > 0 ? (ssize_t)copiados : -1;
+        }
+
+        size_t noBloco = arquivo->posicao - arquivo->inicioBloco;
+        size_t disponivel = ALINHAMENTO_DIRETO - noBloco;
+        if ((off_t)disponivel > arquivo->tamanho - arquivo->posicao) {
+            disponivel = arquivo->tamanho - arquivo->posicao;
+        }
+        if (disponivel > tamanho - copiados) {
+            disponivel = tamanho - copiados;
+        }
+
+        memcpy(destino + copiados, arquivo->bloco + noBloco, disponivel);
+        copiados += disponivel;
+        arquivo->posicao += disponivel;
+    }
+    return copiados;
+}
+
+static ssize_t escreverDireto(void *cookie, const char *origem, size_t tamanho) {
+    ArquivoDireto *arquivo = cookie;
+    size_t copiados = 0;
+
+    while (copiados < tamanho) {
+        if (carregarBloco(arquivo, arquivo->posicao) != 0) {
+            return copiados > 0 ? (ssize_t)copiados : -1;
+        }
+
+        size_t noBloco = arquivo->posicao - arquivo->inicioBloco;
+        size_t disponivel = ALINHAMENTO_DIRETO - noBloco;
+        if (disponivel > tamanho - copiados) {
+            disponivel = tamanho - copiados;
+        }
+
+        memcpy(arquivo->bloco + noBloco, origem + copiados, disponivel);
+        arquivo->blocoSujo = true;
+        arquivo->alterado = true;
+        copiados += disponivel;
+        arquivo->posicao += disponivel;
+        if (arquivo->posicao > arquivo->tamanho) {
+            arquivo->tamanho = arquivo->posicao;
+        }
+    }
+    return copiados;
+}
+
+static int posicionarDireto(void *cookie, off64_t *deslocamento, int origem) {
+    ArquivoDireto *arquivo = cookie;
+    off_t base = origem == SEEK_SET ? 0 : (origem == SEEK_CUR ? arquivo->posicao : arquivo->tamanho);
+    if (base + *deslocamento < 0) {
+        return -1;
+    }
+    arquivo->posicao = base + *deslocamento;
+    *deslocamento = arquivo->posicao;
+    return 0;
+}
+
+static int fecharDireto(void *cookie) {
+    ArquivoDireto *arquivo = cookie;
+    int resultado = gravarBloco(arquivo);
+
+    // Blocos são gravados inteiros; o arquivo volta ao seu tamanho lógico
+    if (arquivo->alterado && ftruncate(arquivo->descritor, arquivo->tamanho) != 0) {
+        resultado = -1;
+    }
+
+    close(arquivo->descritor);
+    free(arquivo->bloco);
+    free(arquivo);
+    return resultado;
+}
+
+/**
+ * Abre um arquivo de dados com O_DIRECT, devolvendo-o como um FILE da stdio.
+ *
+ * @param caminho Caminho do arquivo.
+ * @param modo Modo de abertura da stdio ("rb", "r+b", "wb" ou "wb+").
+ * @return Ponteiro para o arquivo ou NULL se o O_DIRECT não puder ser usado.
+ */
+static FILE* abrirArquivoDireto(const char *caminho, const char *modo) {
+    int flags;
+    if (modo[0] == 'r') {
+        flags = strchr(modo, '+') ? O_RDWR : O_RDONLY;
+    } else if (modo[0] == 'w') {
+        flags = O_RDWR | O_CREAT | O_TRUNC; // Blocos parcialmente escritos precisam ser relidos
+    } else {
+        errno = EINVAL;
+        return NULL; // Acréscimo ao final não é suportado no modo direto
+    }
+
+    int descritor = open(caminho, flags | O_DIRECT, 0644);
+    if (descritor < 0) {
+        return NULL;
+    }
+
+    struct stat estado;
+    ArquivoDireto *arquivo = calloc(1, sizeof(ArquivoDireto));
+    if (fstat(descritor, &estado) != 0 || posix_memalign((void **)&arquivo->bloco, ALINHAMENTO_DIRETO, ALINHAMENTO_DIRETO) != 0) {
+        close(descritor);
+        free(arquivo);
+        return NULL;
+    }
+    arquivo->descritor = descritor;
+    arquivo->tamanho = estado.st_size;
+    arquivo->inicioBloco = -1;
+
+    // O primeiro acesso confirma que o sistema de arquivos aceita O_DIRECT
+    if (arquivo->tamanho > 0 && carregarBloco(arquivo, 0) != 0) {
+        close(descritor);
+        free(arquivo->bloco);
+        free(arquivo);
+        return NULL;
+    }
+
+    cookie_io_functions_t funcoes = {
+        .read = lerDireto,
+        .write = escreverDireto,
+        .seek = posicionarDireto,
+        .close = fecharDireto
+    };
+    FILE *resultado = fopencookie(arquivo, modo, funcoes);
+    if (resultado == NULL) {
+        fecharDireto(arquivo);
+        return NULL;
+    }
+
+    // O bloco alinhado já faz o papel de buffer; a stdio não deve guardar outra cópia
+    setvbuf(resultado, NULL, _IONBF, 0);
+    return resultado;
+}
+
+/**
+ * Abre um arquivo de registros ou de índice de acordo com o modo de E/S da execução.
+ *
+ * No modo padrão, equivale a fopen. No modo direto, o arquivo é aberto com O_DIRECT e
+ * cada bloco lido ou gravado vai ao dispositivo, sem passar pelo cache de páginas, o que
+ * torna as medições independentes de execuções anteriores. Se o sistema de arquivos não
+ * aceitar O_DIRECT, a função avisa e recorre ao fopen.
+ *
+ * @param caminho Caminho do arquivo.
+ * @param modo Modo de abertura, como em fopen.
+ * @return Ponteiro para o arquivo aberto ou NULL em caso de erro.
+ */
+FILE* abrirArquivoDados(const char *caminho, const char *modo) {
+    if (modoAtual == MODO_ES_DIRETO) {
+        FILE *arquivo = abrirArquivoDireto(caminho, modo);
+        if (arquivo != NULL) {
+            return arquivo;
+        }
+        if (errno != ENOENT) {
+            avisarSemDireto(caminho);
+        }
+    }
+    return fopen(caminho, modo);
+}
+
+/**
+ * Abre um arquivo de dados somente para leitura, devolvendo o descritor.
+ *
+ * Usada por quem lê com pread ou io_uring em vez da stdio. No modo direto, as leituras
+ * pelo descritor devem usar buffers, deslocamentos e tamanhos múltiplos do alinhamento
+ * devolvido; no modo padrão, o alinhamento devolvido é zero.
+ *
+ * @param caminho Caminho do arquivo.
+ * @param alinhamento Ponteiro onde será armazenado o alinhamento exigido pelas leituras.
+ * @return Descritor do arquivo ou -1 em caso de erro.
+ */
+int abrirDescritorDados(const char *caminho, size_t *alinhamento) {
+    *alinhamento = 0;
+    if (modoAtual == MODO_ES_DIRETO) {
+        int descritor = open(caminho, O_RDONLY | O_DIRECT);
+        if (descritor >= 0) {
+            *alinhamento = ALINHAMENTO_DIRETO;
+            return descritor;
+        }
+        if (errno != ENOENT) {
+            avisarSemDireto(caminho);
+        }
+    }
+    return open(caminho, O_RDONLY);
+}
@@ -0,0 +1,19 @@
+#ifndef ES_H
+#define ES_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+#define ALINHAMENTO_DIRETO 4096 // Alinhamento exigido pelo O_DIRECT e tamanho do bloco lido do dispositivo
+
+typedef enum {
+    MODO_ES_PADRAO, // E/S pela stdio, passando pelo cache de páginas do sistema
+    MODO_ES_DIRETO // E/S com O_DIRECT, sem passar pelo cache de páginas
+} ModoES;
+
+void definirModoES(ModoES modo);
+ModoES obterModoES(void);
+FILE* abrirArquivoDados(const char *caminho, const char *modo);
+int abrirDescritorDados(const char *caminho, size_t *alinhamento);
+
+#endif // ES_H
@@ -7,36 +7,48 @@
  *
  * Esta função lê registros de um arquivo fornecido e cria um índice para esses registros.
  * O índice é construído a partir de chaves de registros em intervalos especificados.
- * Durante o processo, a função contabiliza transferências (leituras do arquivo) e
- * comparações (embora neste caso não pareça haver comparações entre chaves).
+ * Durante o processo, a função contabiliza as transferências (leituras do arquivo) e
+ * registra o tamanho do índice nas métricas; a construção não compara chaves.
  *
  * @param arquivo Ponteiro para o arquivo de onde os registros são lidos.
  * @param indice Ponteiro para um ponteiro do índice a ser criado.
  * @param tamanhoIndice Ponteiro para armazenar o tamanho do índice criado.
  * @param intervaloIndex Intervalo entre registros para indexar.
- * @param transferencias Ponteiro para contagem de transferências realizadas.
- * @param comparacoes Ponteiro para contagem de comparações realizadas.
+ * @param ordenado Onde será indicado se as chaves válidas do arquivo estão em ordem
+ *        crescente; inclusões reaproveitam posições livres e podem desfazer a ordem.
+ * @param metricas Ponteiro para as métricas da construção.
  */
 void criarIndice(
     FILE *arquivo,
     Indice **indice,
-    int *tamanhoIndice,
+    long *tamanhoIndice,
     int intervaloIndex,
-    int *transferencias,
-    int *comparacoes
+    bool *ordenado,
+    Metricas *metricas
 ) {
     long posicao = 0; 
+    long capacidade = 0;
     Registro reg;
     *tamanhoIndice = 0; 
     *indice = NULL; 
-    *transferencias = 0; 
-    *comparacoes = 0; 
+    *ordenado = true;
+    bool temAnterior = false;
+    Chave anterior = 0; // Última chave válida lida
     
-    while (lerRegistro(arquivo, posicao, &reg, transferencias)) {
+    while (lerRegistro(arquivo, posicao, &reg, metricas)) {
+        if (registroValido(&reg)) {
+            *ordenado = *ordenado && (!temAnterior || anterior <= reg.chave);
+            anterior = reg.chave;
+            temAnterior = true;
+        }
         // Adiciona uma entrada no índice a cada intervaloIndex registros
-        if (posicao % intervaloIndex == 0) {
-            // Realoca espaço para o índice
-            *indice = realloc(*indice, (*tamanhoIndice + 1) * sizeof(Indice));
+        if (posicao % intervaloIndex == 0 && registroValido(&reg)) {
+            // Dobra o espaço do índice quando ele enche, para que arquivos grandes não
+            // realoquem o vetor inteiro a cada entrada
+            if (*tamanhoIndice == capacidade) {
+                capacidade = capacidade > 0 ? capacidade * 2 : 16;
+                *indice = realloc(*indice, capacidade * sizeof(Indice));
+            }
             // Adiciona a chave e a posição do registro no índice
             (*indice)[*tamanhoIndice].chave = reg.chave;
             (*indice)[*tamanhoIndice].posicao = posicao;
@@ -44,4 +56,244 @@ void criarIndice(
         }
         posicao++; // Avança para a próxima posição no arquivo
     }
-}
\ No newline at end of file
+
+    metricas->numNos = *tamanhoIndice;
+    metricas->altura = 1;
+}
+
+/**
+ * Busca no índice ordenado a posição em que a leitura sequencial deve começar.
+ *
+ * A busca binária encontra a última entrada com chave menor ou igual à chave buscada,
+ * como a varredura linear do acesso sequencial indexado.
+ *
+ * @param indice Vetor de entradas em ordem crescente de chave.
+ * @param tamanho Número de entradas.
+ * @param chave Chave buscada.
+ * @param metricas Ponteiro para as métricas da pesquisa.
+ * @return Posição da entrada encontrada ou 0 se a chave for menor que todas.
+ */
+long buscarIndiceBinario(const Indice *indice, long tamanho, Chave chave, Metricas *metricas) {
+    long inicio = 0, fim = tamanho; // Primeira entrada com chave maior fica em [inicio, fim]
+    while (inicio < fim) {
+        long meio = inicio + (fim - inicio) / 2;
+        metricas->comparacoes++;
+        if (indice[meio].chave <= chave) {
+            inicio = meio + 1;
+        } else {
+            fim = meio;
+        }
+    }
+    return inicio > 0 ? indice[inicio - 1].posicao : 0;
+}
+
+/**
+ * Percorre em ordem simétrica a árvore implícita, copiando as entradas ordenadas para as
+ * posições de Eytzinger.
+ */
+static void preencherEytzinger(const Indice *indice, IndiceEytzinger *eytzinger) {
+    long pilha[64]; // Caminho da raiz até o nó atual; a altura não passa de 63
+    int topo = 0;
+    long proxima = 0;
+    long k = 1;
+    while (topo > 0 || k <= eytzinger->tamanho) {
+        while (k <= eytzinger->tamanho) {
+            pilha[topo++] = k;
+            k = 2 * k;
+        }
+        k = pilha[--topo];
+        eytzinger->chaves[k] = indice[proxima].chave;
+        eytzinger->posicoes[k] = indice[proxima].posicao;
+        proxima++;
+        k = 2 * k + 1;
+    }
+}
+
+/**
+ * Reorganiza o índice ordenado na ordem de Eytzinger.
+ *
+ * O vetor de chaves é alinhado a 64 bytes, de modo que os 16 descendentes de um nó quatro
+ * níveis abaixo (posições 16k a 16k + 15) ocupem uma única linha de cache.
+ *
+ * @param indice Vetor de entradas.
+ * @param tamanho Número de entradas.
+ * @param eytzinger Estrutura onde o índice reorganizado será montado.
+ * @return Retorna true se o índice foi montado; false se as chaves não estão em ordem
+ *         crescente (arquivo não ordenado) ou se faltou memória.
+ */
+bool montarIndiceEytzinger(const Indice *indice, long tamanho, IndiceEytzinger *eytzinger) {
+    eytzinger->chaves = NULL;
+    eytzinger->posicoes = NULL;
+    eytzinger->tamanho = 0;
+
+    for (long i = 1; i < tamanho; i++) {
+        if (indice[i - 1].chave > indice[i].chave) {
+            return false;
+        }
+    }
+
+    size_t bytes = ((size_t)tamanho + 1) * sizeof(Chave);
+    bytes = (bytes + 63) / 64 * 64; // aligned_alloc exige múltiplo do alinhamento
+    Chave *chaves = aligned_alloc(64, bytes);
+    long *posicoes = malloc(((size_t)tamanho + 1) * sizeof(long));
+    if (!chaves || !posicoes) {
+        free(chaves);
+        free(posicoes);
+        return false;
+    }
+
+    eytzinger->chaves = chaves;
+    eytzinger->posicoes = posicoes;
+    eytzinger->tamanho = tamanho;
+    eytzinger->posicoes[0] = 0;
+    eytzinger->chaves[0] = 0;
+    preencherEytzinger(indice, eytzinger);
+    return true;
+}
+
+/**
+ * Busca no índice na ordem de Eytzinger a posição em que a leitura sequencial deve começar.
+ *
+ * A descida não tem desvios dependentes dos dados: o próximo nó é 2k + (chave do nó <= chave
+ * buscada) e o último nó em que a descida seguiu para a direita é a entrada procurada. A cada
+ * nível a linha de cache dos descendentes quatro níveis abaixo é pedida antecipadamente; a
+ * pré-busca de um endereço além do fim do vetor é ignorada pelo processador.
+ *
+ * @param eytzinger Índice na ordem de Eytzinger.
+ * @param chave Chave buscada.
+ * @param metricas Ponteiro para as métricas da pesquisa.
+ * @return Posição da entrada encontrada ou 0 se a chave for menor que todas.
+ */
+long buscarIndiceEytzinger(const IndiceEytzinger *eytzinger, Chave chave, Metricas *metricas) {
+    const Chave *chaves = eytzinger->chaves;
+    long k = 1, encontrada = 0;
+    while (k <= eytzinger->tamanho) {
+        __builtin_prefetch(chaves + 16 * k);
+        int direita = chaves[k] <= chave;
+        encontrada = direita ? k : encontrada;
+        k = 2 * k + direita;
+        metricas->comparacoes++;
+    }
+    return eytzinger->posicoes[encontrada];
+}
+
+/**
+ * Resolve um lote de chaves em ordem crescente por junção com o índice esparso e com o
+ * arquivo ordenado, em uma única passada pelos dois.
+ *
+ * O lote e o índice avançam juntos: cada chave fica no bloco que vai da última entrada com
+ * chave menor ou igual a ela até a entrada seguinte. Cada bloco é lido inteiro, com uma só
+ * leitura, na primeira chave que cai nele e serve às chaves seguintes do mesmo bloco; como
+ * os blocos vêm em ordem crescente, cada página do arquivo é lida no máximo uma vez e o
+ * posicionamento é omitido quando o bloco segue o anterior.
+ *
+ * @param arquivo Ponteiro para o arquivo de registros, em ordem crescente de chave.
+ * @param indice Vetor de entradas do índice esparso.
+ * @param tamanho Número de entradas.
+ * @param chaves Chaves do lote, em ordem crescente (repetições permitidas).
+ * @param quantidade Número de chaves do lote.
+ * @param registros Vetor onde o registro de cada chave encontrada será armazenado.
+ * @param posicoes Vetor onde a posição de cada chave será armazenada (-1 se não existe).
+ * @param metricas Ponteiro para as métricas da pesquisa.
+ * @return Número de chaves encontradas, -1 se o índice não está em ordem crescente
+ *         (arquivo não ordenado) ou -2 se faltou memória.
+ */
+int juntarLoteIndice(
+    FILE *arquivo,
+    const Indice *indice,
+    long tamanho,
+    const Chave *chaves,
+    int quantidade,
+    Registro *registros,
+    long *posicoes,
+    Metricas *metricas
+) {
+    for (long i = 1; i < tamanho; i++) {
+        if (indice[i - 1].chave > indice[i].chave) {
+            return -1;
+        }
+    }
+
+    // Bloco da entrada j: de indice[j].posicao (0 para j = -1) até a entrada seguinte ou o fim
+    fseeko(arquivo, 0, SEEK_END);
+    long total = ftello(arquivo) / sizeof(Registro);
+    long maiorBloco = 1;
+    for (long j = -1; j < tamanho; j++) {
+        long inicio = j < 0 ? 0 : indice[j].posicao;
+        long fim = j + 1 < tamanho ? indice[j + 1].posicao : total;
+        if (fim - inicio > maiorBloco) {
+            maiorBloco = fim - inicio;
+        }
+    }
+    Registro *bloco = malloc(maiorBloco * sizeof(Registro));
+    if (!bloco) {
+        perror("Erro ao alocar o bloco da junção");
+        return -2;
+    }
+
+    int encontradas = 0;
+    long j = -1; // Entrada do índice cujo bloco contém a chave atual
+    long carregada = -2; // Entrada cujo bloco está em memória
+    long lidos = 0; // Registros do bloco em memória
+    long inicio = 0; // Posição do primeiro registro do bloco em memória
+    long seguinte = -1; // Posição em que o arquivo está depois da última leitura
+    long k = 0; // Cursor no bloco em memória
+    for (int q = 0; q < quantidade; q++) {
+        posicoes[q] = -1;
+        while (j + 1 < tamanho) {
+            metricas->comparacoes++;
+            if (indice[j + 1].chave > chaves[q]) {
+                break;
+            }
+            j++;
+        }
+
+        if (j != carregada) {
+            inicio = j < 0 ? 0 : indice[j].posicao;
+            long fim = j + 1 < tamanho ? indice[j + 1].posicao : total;
+            lidos = 0;
+            if (inicio != seguinte) {
+                registrarPosicionamento(metricas);
+                if (fseeko(arquivo, DESLOCAMENTO_REGISTRO(inicio), SEEK_SET) != 0) {
+                    perror("Erro ao buscar posição no arquivo");
+                    seguinte = -1;
+                    carregada = j;
+                    continue;
+                }
+            }
+            lidos = (long)fread(bloco, sizeof(Registro), fim - inicio, arquivo);
+            registrarLeitura(metricas, lidos * sizeof(Registro));
+            seguinte = inicio + lidos;
+            carregada = j;
+            k = 0;
+        }
+
+        // As lápides têm a menor chave possível e são simplesmente ultrapassadas
+        while (k < lidos) {
+            metricas->comparacoes++;
+            if (bloco[k].chave >= chaves[q]) {
+                break;
+            }
+            k++;
+        }
+        if (k < lidos && bloco[k].chave == chaves[q]) {
+            registros[q] = bloco[k];
+            posicoes[q] = inicio + k;
+            encontradas++;
+        }
+    }
+
+    free(bloco);
+    return encontradas;
+}
+
+/**
+ * Libera a memória de um índice na ordem de Eytzinger.
+ */
+void liberarIndiceEytzinger(IndiceEytzinger *eytzinger) {
+    free(eytzinger->chaves);
+    free(eytzinger->posicoes);
+    eytzinger->chaves = NULL;
+    eytzinger->posicoes = NULL;
+    eytzinger->tamanho = 0;
+}
@@ -3,19 +3,46 @@
 
 #include "../registro/registro.h"
 #include <stdio.h>
+#include <stdbool.h>
 
 typedef struct {
-    int chave;
+    Chave chave;
     long posicao;
 } Indice;
 
+/*
+ * Índice esparso na ordem de Eytzinger: as entradas ficam na ordem de uma busca em largura
+ * da árvore binária de busca implícita do vetor ordenado, com a raiz na posição 1 e os
+ * filhos de k nas posições 2k e 2k + 1. As chaves ficam separadas das posições para que uma
+ * linha de cache traga 16 chaves, que são os descendentes de um nó quatro níveis abaixo.
+ */
+typedef struct {
+    Chave *chaves; // Chaves na ordem de Eytzinger, a partir da posição 1
+    long *posicoes; // Posição no arquivo de cada chave; posicoes[0] vale 0
+    long tamanho; // Número de entradas
+} IndiceEytzinger;
+
 void criarIndice(
     FILE *arquivo,
     Indice **indice,
-    int *tamanhoIndice,
+    long *tamanhoIndice,
     int intervaloIndex,
-    int *transferencias,
-    int *comparacoes
+    bool *ordenado,
+    Metricas *metricas
+);
+long buscarIndiceBinario(const Indice *indice, long tamanho, Chave chave, Metricas *metricas);
+bool montarIndiceEytzinger(const Indice *indice, long tamanho, IndiceEytzinger *eytzinger);
+long buscarIndiceEytzinger(const IndiceEytzinger *eytzinger, Chave chave, Metricas *metricas);
+int juntarLoteIndice(
+    FILE *arquivo,
+    const Indice *indice,
+    long tamanho,
+    const Chave *chaves,
+    int quantidade,
+    Registro *registros,
+    long *posicoes,
+    Metricas *metricas
 );
+void liberarIndiceEytzinger(IndiceEytzinger *eytzinger);
 
 #endif // INDEX_H
@@ -0,0 +1,550 @@
+#include "instantaneo.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+/*
+ * Árvore binária em disco com cópia na escrita.
+ *
+ * Nenhuma página alcançável por uma versão publicada é alterada. Uma inserção grava o novo
+ * nó e uma cópia de cada nó do caminho da raiz até ele em páginas livres, e então publica a
+ * nova raiz em uma única escrita atômica. As páginas substituídas são aposentadas com o
+ * número da primeira versão que não as alcança mais.
+ *
+ * Um leitor fixa uma versão anunciando-a em uma vaga própria e lê a partir da raiz dela
+ * sem nenhuma trava. Uma página aposentada só volta a ser usada quando nenhuma vaga anuncia
+ * uma versão anterior à da aposentadoria.
+ */
+
+#define VAGA_LIVRE 0
+#define LIMITE_PUBLICACAO 0xFFFFFFFFu // Maior versão e maior página + 1 que cabem no valor publicado
+
+/**
+ * Junta versão e raiz no valor publicado. Cada uma ocupa 32 bits; inserirArvoreInstantanea
+ * recusa as inserções que passariam desse limite.
+ */
+static uint64_t empacotar(uint64_t versao, long raiz) {
+    return (versao << 32) | (uint32_t)(raiz + 1);
+}
+
+static uint64_t versaoPublicada(uint64_t publicada) {
+    return publicada >> 32;
+}
+
+static long raizPublicada(uint64_t publicada) {
+    return (long)(publicada & 0xFFFFFFFFu) - 1;
+}
+
+/**
+ * Lê uma página do arquivo. Pode ser chamada por várias threads ao mesmo tempo.
+ */
+static bool lerPagina(ArvoreInstantanea *arvore, long pagina, NoArvore *no, Metricas *metricas) {
+    if (pread(arvore->descritor, no, sizeof(NoArvore), (off_t)pagina * (off_t)sizeof(NoArvore)) != sizeof(NoArvore)) {
+        perror("Erro ao ler página da árvore");
+        return false;
+    }
+    registrarLeitura(metricas, sizeof(NoArvore));
+    return true;
+}
+
+/**
+ * Grava uma página do arquivo.
+ */
+static bool escreverPagina(ArvoreInstantanea *arvore, long pagina, const void *dados, Metricas *metricas) {
+    if (pwrite(arvore->descritor, dados, sizeof(NoArvore), (off_t)pagina * (off_t)sizeof(NoArvore)) != sizeof(NoArvore)) {
+        perror("Erro ao escrever página da árvore");
+        return false;
+    }
+    registrarEscrita(metricas, sizeof(NoArvore));
+    return true;
+}
+
+/**
+ * Grava o cabeçalho com a raiz e a versão que estão sendo publicadas.
+ */
+static bool escreverCabecalho(ArvoreInstantanea *arvore, long raiz, uint64_t versao, Metricas *metricas) {
+    NoArvore pagina;
+    CabecalhoInstantaneo cabecalho = {raiz, versao, arvore->proximaPagina, 0};
+    memset(&pagina, 0, sizeof(pagina));
+    memcpy(&pagina, &cabecalho, sizeof(cabecalho) < sizeof(pagina) ? sizeof(cabecalho) : sizeof(pagina));
+    return escreverPagina(arvore, 0, &pagina, metricas);
+}
+
+/**
+ * Cria o arquivo de uma árvore vazia, na versão 0.
+ *
+ * @param arvore Ponteiro para a árvore.
+ * @param caminho Caminho do arquivo de páginas, recriado se já existir.
+ * @return Retorna true se o arquivo foi criado.
+ */
+bool criarArvoreInstantanea(ArvoreInstantanea *arvore, const char *caminho) {
+    memset(arvore, 0, sizeof(ArvoreInstantanea));
+    arvore->descritor = open(caminho, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (arvore->descritor < 0) {
+        perror("Erro ao criar o arquivo da árvore");
+        return false;
+    }
+
+    pthread_mutex_init(&arvore->travaEscrita, NULL);
+    atomic_init(&arvore->publicada, empacotar(0, -1));
+    for (int i = 0; i < MAXIMO_LEITORES_INSTANTANEO; i++) {
+        atomic_init(&arvore->leitores[i], VAGA_LIVRE);
+    }
+    arvore->proximaPagina = 1; // A página 0 é o cabeçalho
+
+    Metricas descartadas = {0};
+    return escreverCabecalho(arvore, -1, 0, &descartadas);
+}
+
+/**
+ * Fecha o arquivo da árvore e libera as listas de páginas. Nenhum leitor pode estar ativo.
+ *
+ * @param arvore Ponteiro para a árvore.
+ */
+void fecharArvoreInstantanea(ArvoreInstantanea *arvore) {
+    close(arvore->descritor);
+    pthread_mutex_destroy(&arvore->travaEscrita);
+    free(arvore->aposentadas);
+    free(arvore->livres);
+}
+
+/**
+ * Escolhe uma página para um nó novo, preferindo as recuperadas às do fim do arquivo.
+ */
+static long alocarPagina(ArvoreInstantanea *arvore) {
+    arvore->paginasEscritas++;
+    if (arvore->numLivres > 0) {
+        arvore->paginasReaproveitadas++;
+        return arvore->livres[--arvore->numLivres];
+    }
+    return arvore->proximaPagina++;
+}
+
+/**
+ * Registra que uma página deixa de ser alcançada a partir de uma versão.
+ */
+static bool aposentarPagina(ArvoreInstantanea *arvore, long pagina, uint64_t versao) {
+    if (arvore->numAposentadas == arvore->capacidadeAposentadas) {
+        long capacidade = arvore->capacidadeAposentadas > 0 ? arvore->capacidadeAposentadas * 2 : 64;
+        PaginaAposentada *aposentadas = realloc(arvore->aposentadas, capacidade * sizeof(PaginaAposentada));
+        if (!aposentadas) {
+            return false;
+        }
+        arvore->aposentadas = aposentadas;
+        arvore->capacidadeAposentadas = capacidade;
+    }
+    arvore->aposentadas[arvore->numAposentadas].pagina = pagina;
+    arvore->aposentadas[arvore->numAposentadas].versao = versao;
+    arvore->numAposentadas++;
+    return true;
+}
+
+/**
+ * Passa para a lista de páginas livres as aposentadas que nenhum leitor pode mais alcançar,
+ * isto é, as aposentadas em uma versão menor ou igual à menor versão fixada.
+ */
+static void reaproveitarPaginas(ArvoreInstantanea *arvore) {
+    uint64_t minimo = versaoPublicada(atomic_load(&arvore->publicada));
+    for (int i = 0; i < MAXIMO_LEITORES_INSTANTANEO; i++) {
+        uint64_t anunciada = atomic_load(&arvore->leitores[i]);
+        if (anunciada != VAGA_LIVRE && anunciada - 1 < minimo) {
+            minimo = anunciada - 1;
+        }
+    }
+
+    long liberadas = 0;
+    while (liberadas < arvore->numAposentadas && arvore->aposentadas[liberadas].versao <= minimo) {
+        liberadas++;
+    }
+    if (liberadas == 0) {
+        return;
+    }
+
+    if (arvore->numLivres + liberadas > arvore->capacidadeLivres) {
+        long capacidade = (arvore->numLivres + liberadas) * 2;
+        long *livres = realloc(arvore->livres, capacidade * sizeof(long));
+        if (!livres) {
+            return; // As páginas continuam aposentadas e serão tentadas de novo
+        }
+        arvore->livres = livres;
+        arvore->capacidadeLivres = capacidade;
+    }
+
+    for (long i = 0; i < liberadas; i++) {
+        arvore->livres[arvore->numLivres++] = arvore->aposentadas[i].pagina;
+    }
+    arvore->numAposentadas -= liberadas;
+    memmove(arvore->aposentadas, arvore->aposentadas + liberadas, arvore->numAposentadas * sizeof(PaginaAposentada));
+}
+
+/**
+ * Insere uma chave copiando o caminho da raiz até o novo nó e publica a nova versão.
+ *
+ * Os escritores são atendidos um por vez; os leitores continuam lendo as versões que
+ * fixaram durante toda a inserção. Chaves repetidas são ignoradas e não geram versão nova:
+ * a árvore com cópia na escrita guarda só a primeira ocorrência de cada chave.
+ *
+ * @param arvore Ponteiro para a árvore.
+ * @param chave Chave a ser inserida.
+ * @param posicao Posição do registro no arquivo de registros.
+ * @param metricas Ponteiro para as métricas do escritor.
+ * @return Retorna true se a chave foi inserida ou já existia.
+ */
+bool inserirArvoreInstantanea(ArvoreInstantanea *arvore, Chave chave, long posicao, Metricas *metricas) {
+    pthread_mutex_lock(&arvore->travaEscrita);
+
+    uint64_t publicada = atomic_load(&arvore->publicada);
+    uint64_t novaVersao = versaoPublicada(publicada) + 1;
+    long pagina = raizPublicada(publicada);
+
+    // Descida até a folha, guardando o caminho que será copiado
+    long numCaminho = 0, capacidadeCaminho = 64;
+    long *paginas = malloc(capacidadeCaminho * sizeof(long));
+    NoArvore *nos = malloc(capacidadeCaminho * sizeof(NoArvore));
+    bool sucesso = paginas != NULL && nos != NULL;
+
+    while (sucesso && pagina != -1) {
+        if (numCaminho == capacidadeCaminho) {
+            capacidadeCaminho *= 2;
+            long *maisPaginas = realloc(paginas, capacidadeCaminho * sizeof(long));
+            NoArvore *maisNos = maisPaginas ? realloc(nos, capacidadeCaminho * sizeof(NoArvore)) : NULL;
+            if (maisPaginas) {
+                paginas = maisPaginas;
+            }
+            if (maisNos) {
+                nos = maisNos;
+            }
+            if (!maisPaginas || !maisNos) {
+                sucesso = false;
+                break;
+            }
+        }
+
+        if (!lerPagina(arvore, pagina, &nos[numCaminho], metricas)) {
+            sucesso = false;
+            break;
+        }
+        metricas->comparacoes++;
+        if (chave == nos[numCaminho].chave) {
+            free(paginas);
+            free(nos);
+            pthread_mutex_unlock(&arvore->travaEscrita);
+            return true;
+        }
+        paginas[numCaminho] = pagina;
+        pagina = chave < nos[numCaminho].chave ? nos[numCaminho].esquerda : nos[numCaminho].direita;
+        numCaminho++;
+    }
+
+    // As páginas novas ficam abaixo de proximaPagina + numCaminho + 1 e precisam caber no
+    // valor publicado; a recusa vem antes de qualquer escrita para não deixar páginas aposentadas
+    if (sucesso && (novaVersao > LIMITE_PUBLICACAO || (uint64_t)arvore->proximaPagina + numCaminho + 1 > LIMITE_PUBLICACAO)) {
+        fprintf(stderr, "A árvore com cópia na escrita admite no máximo %lu versões e %lu páginas.\n", (unsigned long)LIMITE_PUBLICACAO, (unsigned long)LIMITE_PUBLICACAO - 1);
+        sucesso = false;
+    }
+
+    // Novo nó e cópias do caminho, de baixo para cima, sempre em páginas fora da versão atual
+    long filho = -1;
+    if (sucesso) {
+        NoArvore novo = {chave, posicao, -1, -1};
+        filho = alocarPagina(arvore);
+        sucesso = escreverPagina(arvore, filho, &novo, metricas);
+    }
+    for (long i = numCaminho - 1; sucesso && i >= 0; i--) {
+        NoArvore copia = nos[i];
+        if (chave < copia.chave) {
+            copia.esquerda = filho;
+        } else {
+            copia.direita = filho;
+        }
+        filho = alocarPagina(arvore);
+        sucesso = escreverPagina(arvore, filho, &copia, metricas) && aposentarPagina(arvore, paginas[i], novaVersao);
+    }
+
+    // Publicação: o cabeçalho no arquivo e, por último, a raiz vista pelos leitores
+    if (sucesso) {
+        sucesso = escreverCabecalho(arvore, filho, novaVersao, metricas);
+    }
+    if (sucesso) {
+        atomic_store(&arvore->publicada, empacotar(novaVersao, filho));
+        reaproveitarPaginas(arvore);
+    }
+
+    free(paginas);
+    free(nos);
+    pthread_mutex_unlock(&arvore->travaEscrita);
+    return sucesso;
+}
+
+/**
+ * Fixa a versão publicada para leitura, sem travas.
+ *
+ * O leitor anuncia a versão em uma vaga livre e confere se ela ainda é a publicada; se não
+ * for, anuncia a nova e confere de novo. Um escritor que reaproveita páginas depois do
+ * anúncio vê a vaga ocupada; um que o fez antes já tinha publicado outra versão, e a
+ * conferência falha.
+ *
+ * @param arvore Ponteiro para a árvore.
+ * @param instantaneo Ponteiro onde a versão fixada será armazenada.
+ * @return Retorna true se havia uma vaga livre para o leitor.
+ */
+bool fixarInstantaneo(ArvoreInstantanea *arvore, Instantaneo *instantaneo) {
+    uint64_t publicada = atomic_load(&arvore->publicada);
+    int vaga = -1;
+    for (int i = 0; i < MAXIMO_LEITORES_INSTANTANEO && vaga < 0; i++) {
+        uint64_t livre = VAGA_LIVRE;
+        if (atomic_compare_exchange_strong(&arvore->leitores[i], &livre, versaoPublicada(publicada) + 1)) {
+            vaga = i;
+        }
+    }
+    if (vaga < 0) {
+        return false;
+    }
+
+    uint64_t atual;
+    while (versaoPublicada(atual = atomic_load(&arvore->publicada)) != versaoPublicada(publicada)) {
+        publicada = atual;
+        atomic_store(&arvore->leitores[vaga], versaoPublicada(publicada) + 1);
+    }
+
+    instantaneo->raiz = raizPublicada(atual);
+    instantaneo->versao = versaoPublicada(atual);
+    instantaneo->vaga = vaga;
+    return true;
+}
+
+/**
+ * Libera a versão fixada por um leitor. As páginas que só ela alcançava serão
+ * reaproveitadas pela próxima inserção.
+ *
+ * @param arvore Ponteiro para a árvore.
+ * @param instantaneo Ponteiro para a versão fixada.
+ */
+void liberarInstantaneo(ArvoreInstantanea *arvore, Instantaneo *instantaneo) {
+    atomic_store(&arvore->leitores[instantaneo->vaga], VAGA_LIVRE);
+    instantaneo->vaga = -1;
+}
+
+/**
+ * Busca uma chave em uma versão fixada.
+ *
+ * @param arvore Ponteiro para a árvore.
+ * @param instantaneo Ponteiro para a versão fixada.
+ * @param chave Chave a ser buscada.
+ * @param metricas Ponteiro para as métricas do leitor.
+ * @return Posição do registro no arquivo de registros ou -1 se a chave não existe na versão.
+ */
+long buscarInstantaneo(ArvoreInstantanea *arvore, const Instantaneo *instantaneo, Chave chave, Metricas *metricas) {
+    long pagina = instantaneo->raiz;
+    NoArvore no;
+
+    while (pagina != -1) {
+        if (!lerPagina(arvore, pagina, &no, metricas)) {
+            return -1;
+        }
+        metricas->comparacoes++;
+        if (chave == no.chave) {
+            return no.posicao;
+        }
+        pagina = chave < no.chave ? no.esquerda : no.direita;
+    }
+    return -1;
+}
+
+/**
+ * Conta as chaves de um intervalo em uma versão fixada, visitando apenas as subárvores que
+ * podem conter chaves do intervalo.
+ *
+ * @param arvore Ponteiro para a árvore.
+ * @param instantaneo Ponteiro para a versão fixada.
+ * @param minimo Menor chave do intervalo.
+ * @param maximo Maior chave do intervalo.
+ * @param metricas Ponteiro para as métricas do leitor.
+ * @return Número de chaves no intervalo ou -1 em caso de erro.
+ */
+long contarIntervaloInstantaneo(ArvoreInstantanea *arvore, const Instantaneo *instantaneo, Chave minimo, Chave maximo, Metricas *metricas) {
+    long capacidade = 64, topo = 0, total = 0;
+    long *pilha = malloc(capacidade * sizeof(long));
+    if (!pilha) {
+        return -1;
+    }
+    if (instantaneo->raiz != -1) {
+        pilha[topo++] = instantaneo->raiz;
+    }
+
+    while (topo > 0) {
+        NoArvore no;
+        if (!lerPagina(arvore, pilha[--topo], &no, metricas)) {
+            total = -1;
+            break;
+        }
+
+        metricas->comparacoes += 2;
+        if (no.chave >= minimo && no.chave <= maximo) {
+            total++;
+        }
+
+        if (topo + 2 > capacidade) {
+            capacidade *= 2;
+            long *maior = realloc(pilha, capacidade * sizeof(long));
+            if (!maior) {
+                total = -1;
+                break;
+            }
+            pilha = maior;
+        }
+        if (no.esquerda != -1 && no.chave > minimo) {
+            pilha[topo++] = no.esquerda;
+        }
+        if (no.direita != -1 && no.chave < maximo) {
+            pilha[topo++] = no.direita;
+        }
+    }
+
+    free(pilha);
+    return total;
+}
+
+/* ---------- Rodada de ingestão com leitores ---------- */
+
+typedef struct {
+    ArvoreInstantanea *arvore;
+    const Chave *chaves;
+    long inicio; // Primeira posição inserida pelo escritor
+    long fim;
+    atomic_bool *escritorAtivo;
+    uint64_t operacoes;
+    uint64_t inconsistencias;
+    Metricas metricas;
+} TarefaInstantanea;
+
+/**
+ * Insere as posições válidas da segunda metade do arquivo.
+ */
+static void* escreverInstantaneo(void *argumento) {
+    TarefaInstantanea *tarefa = argumento;
+    for (long posicao = tarefa->inicio; posicao < tarefa->fim; posicao++) {
+        if (tarefa->chaves[posicao] != CHAVE_REMOVIDA) {
+            inserirArvoreInstantanea(tarefa->arvore, tarefa->chaves[posicao], posicao, &tarefa->metricas);
+            tarefa->operacoes++;
+        }
+    }
+    atomic_store(tarefa->escritorAtivo, false);
+    return NULL;
+}
+
+/**
+ * Faz relatórios completos enquanto o escritor trabalha. Como cada versão acrescenta
+ * exatamente uma chave, o total de uma versão fixada precisa ser igual ao seu número.
+ */
+static void* lerInstantaneo(void *argumento) {
+    TarefaInstantanea *tarefa = argumento;
+    while (atomic_load(tarefa->escritorAtivo)) {
+        Instantaneo instantaneo;
+        if (!fixarInstantaneo(tarefa->arvore, &instantaneo)) {
+            break;
+        }
+        long total = contarIntervaloInstantaneo(tarefa->arvore, &instantaneo, CHAVE_MINIMA + 1, CHAVE_MAXIMA, &tarefa->metricas);
+        if (total < 0 || (uint64_t)total != instantaneo.versao) {
+            tarefa->inconsistencias++;
+        }
+        liberarInstantaneo(tarefa->arvore, &instantaneo);
+        tarefa->operacoes++;
+    }
+    return NULL;
+}
+
+/**
+ * Executa uma rodada de ingestão com relatórios simultâneos sobre a árvore com cópia na
+ * escrita.
+ *
+ * A primeira metade do arquivo é inserida antes da rodada. Durante a rodada, um escritor
+ * insere a segunda metade e os leitores fazem relatórios completos sobre versões fixadas,
+ * conferindo o total de cada uma.
+ *
+ * @param caminho Caminho do arquivo de páginas.
+ * @param chaves Chave de cada posição do arquivo de registros (CHAVE_REMOVIDA nas removidas).
+ * @param totalPosicoes Número de posições do arquivo de registros.
+ * @param leitores Número de threads leitoras.
+ * @param escrita Ponteiro para as métricas do escritor.
+ * @param leitura Ponteiro para as métricas dos leitores.
+ * @param resultado Ponteiro para os totais da rodada.
+ * @return Retorna true se nenhum relatório foi inconsistente.
+ */
+bool executarRodadaInstantanea(
+    const char *caminho,
+    const Chave *chaves,
+    long totalPosicoes,
+    int leitores,
+    Metricas *escrita,
+    Metricas *leitura,
+    ResultadoInstantaneo *resultado
+) {
+    memset(resultado, 0, sizeof(ResultadoInstantaneo));
+    ArvoreInstantanea arvore;
+    if (!criarArvoreInstantanea(&arvore, caminho)) {
+        return false;
+    }
+
+    Metricas preenchimento = {0};
+    long metade = totalPosicoes / 2;
+    for (long posicao = 0; posicao < metade; posicao++) {
+        if (chaves[posicao] != CHAVE_REMOVIDA) {
+            inserirArvoreInstantanea(&arvore, chaves[posicao], posicao, &preenchimento);
+        }
+    }
+    uint64_t escritasAntes = arvore.paginasEscritas;
+    uint64_t reaproveitadasAntes = arvore.paginasReaproveitadas;
+
+    if (leitores > MAXIMO_LEITORES_INSTANTANEO) {
+        leitores = MAXIMO_LEITORES_INSTANTANEO;
+    }
+
+    TarefaInstantanea tarefas[MAXIMO_LEITORES_INSTANTANEO + 1] = {0};
+    pthread_t threads[MAXIMO_LEITORES_INSTANTANEO + 1];
+    bool criada[MAXIMO_LEITORES_INSTANTANEO + 1];
+    atomic_bool escritorAtivo;
+    atomic_init(&escritorAtivo, true);
+
+    iniciarMetricas(escrita);
+    iniciarMetricas(leitura);
+    for (int t = 0; t <= leitores; t++) {
+        tarefas[t].arvore = &arvore;
+        tarefas[t].chaves = chaves;
+        tarefas[t].inicio = metade;
+        tarefas[t].fim = totalPosicoes;
+        tarefas[t].escritorAtivo = &escritorAtivo;
+
+        void *(*funcao)(void *) = t == 0 ? escreverInstantaneo : lerInstantaneo;
+        criada[t] = pthread_create(&threads[t], NULL, funcao, &tarefas[t]) == 0;
+        if (!criada[t] && t == 0) {
+            funcao(&tarefas[t]); // O escritor precisa terminar mesmo sem thread
+        }
+    }
+
+    for (int t = 0; t <= leitores; t++) {
+        if (criada[t]) {
+            pthread_join(threads[t], NULL);
+        }
+    }
+    finalizarMetricas(escrita);
+    finalizarMetricas(leitura);
+
+    acumularMetricas(escrita, &tarefas[0].metricas);
+    resultado->insercoes = tarefas[0].operacoes;
+    for (int t = 1; t <= leitores; t++) {
+        acumularMetricas(leitura, &tarefas[t].metricas);
+        leitura->consultas += tarefas[t].operacoes;
+        resultado->relatorios += tarefas[t].operacoes;
+        resultado->inconsistencias += tarefas[t].inconsistencias;
+    }
+
+    resultado->paginasEscritas = arvore.paginasEscritas - escritasAntes;
+    resultado->paginasReaproveitadas = arvore.paginasReaproveitadas - reaproveitadasAntes;
+    resultado->paginasArquivo = arvore.proximaPagina;
+
+    fecharArvoreInstantanea(&arvore);
+    return resultado->inconsistencias == 0;
+}
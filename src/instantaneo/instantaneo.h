@@ -0,0 +1,79 @@
+#ifndef INSTANTANEO_H
+#define INSTANTANEO_H
+
+#include "../arvore/arvore.h"
+#include "../metricas/metricas.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#define MAXIMO_LEITORES_INSTANTANEO 64 // Leitores que podem fixar uma versão ao mesmo tempo
+
+/*
+ * Página 0 do arquivo da árvore. Os nós ocupam as páginas seguintes, cada uma do tamanho
+ * de um NoArvore; o cabeçalho é regravado por último a cada nova versão.
+ */
+typedef struct {
+    long raiz; // Página da raiz (-1 para a árvore vazia)
+    uint64_t versao; // Número de inserções publicadas
+    long proximaPagina; // Primeira página ainda não usada no fim do arquivo
+    long reservado;
+} CabecalhoInstantaneo;
+
+typedef struct {
+    long pagina; // Página que deixou de fazer parte da versão atual
+    uint64_t versao; // Primeira versão que não alcança mais a página
+} PaginaAposentada;
+
+typedef struct {
+    int descritor; // Arquivo de páginas, lido e escrito com pread e pwrite
+    pthread_mutex_t travaEscrita; // Um escritor por vez; os leitores nunca a usam
+    _Atomic uint64_t publicada; // Versão (32 bits altos) e página da raiz + 1 (32 bits baixos)
+    _Atomic uint64_t leitores[MAXIMO_LEITORES_INSTANTANEO]; // Versão fixada + 1, ou 0 se a vaga está livre
+
+    // Estado dos escritores, protegido por travaEscrita
+    long proximaPagina;
+    PaginaAposentada *aposentadas; // Em ordem crescente de versão
+    long numAposentadas;
+    long capacidadeAposentadas;
+    long *livres; // Páginas que nenhuma versão fixada alcança
+    long numLivres;
+    long capacidadeLivres;
+    uint64_t paginasEscritas;
+    uint64_t paginasReaproveitadas;
+} ArvoreInstantanea;
+
+typedef struct {
+    long raiz; // Raiz da versão fixada
+    uint64_t versao; // Versão fixada
+    int vaga; // Vaga ocupada em ArvoreInstantanea.leitores
+} Instantaneo;
+
+typedef struct {
+    uint64_t insercoes; // Inserções publicadas durante a rodada
+    uint64_t relatorios; // Relatórios completos feitos pelos leitores
+    uint64_t inconsistencias; // Relatórios cujo total não corresponde à versão fixada
+    uint64_t paginasEscritas; // Páginas gravadas durante a rodada
+    uint64_t paginasReaproveitadas; // Gravações feitas em páginas recuperadas
+    long paginasArquivo; // Páginas ocupadas pelo arquivo ao final
+} ResultadoInstantaneo;
+
+bool criarArvoreInstantanea(ArvoreInstantanea *arvore, const char *caminho);
+void fecharArvoreInstantanea(ArvoreInstantanea *arvore);
+bool inserirArvoreInstantanea(ArvoreInstantanea *arvore, Chave chave, long posicao, Metricas *metricas);
+bool fixarInstantaneo(ArvoreInstantanea *arvore, Instantaneo *instantaneo);
+void liberarInstantaneo(ArvoreInstantanea *arvore, Instantaneo *instantaneo);
+long buscarInstantaneo(ArvoreInstantanea *arvore, const Instantaneo *instantaneo, Chave chave, Metricas *metricas);
+long contarIntervaloInstantaneo(ArvoreInstantanea *arvore, const Instantaneo *instantaneo, Chave minimo, Chave maximo, Metricas *metricas);
+bool executarRodadaInstantanea(
+    const char *caminho,
+    const Chave *chaves,
+    long totalPosicoes,
+    int leitores,
+    Metricas *escrita,
+    Metricas *leitura,
+    ResultadoInstantaneo *resultado
+);
+
+#endif // INSTANTANEO_H
@@ -0,0 +1,755 @@
+#include "lsm.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#define REGISTROS_BLOCO_LSM 256 // Registros por leitura ou escrita sequencial de um segmento
+
+typedef enum {
+    FONTE_MEMTABLE, // Lista de saltos percorrida no nível 0
+    FONTE_VETOR, // Registros copiados de uma memtable congelada
+    FONTE_SEGMENTO // Segmento lido em blocos
+} TipoFonteLSM;
+
+/*
+ * Origem ordenada de registros usada nas intercalações: compactações e leituras de
+ * intervalo. As fontes são passadas da mais nova para a mais antiga.
+ */
+typedef struct {
+    TipoFonteLSM tipo;
+    NoMemtableLSM *no; // Próximo nó (FONTE_MEMTABLE)
+    const Registro *vetor; // Registros em ordem (FONTE_VETOR)
+    long tamanhoVetor;
+    long posicaoVetor;
+    SegmentoLSM *segmento; // Segmento percorrido (FONTE_SEGMENTO)
+    long proximo; // Próximo registro do arquivo a ser lido
+    Registro bloco[REGISTROS_BLOCO_LSM]; // Registros lidos e ainda não consumidos
+    int noBloco;
+    int posicaoBloco;
+    int tamanhoLeitura; // Registros da próxima leitura: começa pequena e dobra até o bloco
+} FonteLSM;
+
+typedef struct {
+    SegmentoLSM *segmento;
+    Registro bloco[REGISTROS_BLOCO_LSM]; // Registros aguardando a próxima escrita
+    int noBloco;
+    long capacidadeIndice;
+    bool falhou;
+} EscritorSegmentoLSM;
+
+/**
+ * Cria uma memtable vazia.
+ */
+static MemtableLSM* criarMemtable(uint64_t semente) {
+    MemtableLSM *memtable = malloc(sizeof(MemtableLSM));
+    memtable->cabeca = calloc(1, sizeof(NoMemtableLSM) + NIVEIS_MEMTABLE_LSM * sizeof(NoMemtableLSM *));
+    memtable->cabeca->nivel = NIVEIS_MEMTABLE_LSM;
+    memtable->nivel = 1;
+    memtable->numRegistros = 0;
+    memtable->semente = semente | 1;
+    return memtable;
+}
+
+/**
+ * Sorteia o número de níveis de um novo nó: cada nível a mais tem probabilidade 1/4.
+ */
+static int sortearNivel(MemtableLSM *memtable) {
+    uint64_t x = memtable->semente;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    memtable->semente = x;
+
+    int nivel = 1;
+    while (nivel < NIVEIS_MEMTABLE_LSM && (x & 3) == 0) {
+        nivel++;
+        x >>= 2;
+    }
+    return nivel;
+}
+
+/**
+ * Localiza, em cada nível da lista de saltos, o último nó com chave menor que a dada.
+ *
+ * @return Primeiro nó com chave maior ou igual à chave dada, ou NULL.
+ */
+static NoMemtableLSM* localizarMemtable(const MemtableLSM *memtable, Chave chave, NoMemtableLSM **anteriores, Metricas *metricas) {
+    NoMemtableLSM *no = memtable->cabeca;
+    for (int nivel = memtable->nivel - 1; nivel >= 0; nivel--) {
+        while (no->proximos[nivel] != NULL) {
+            metricas->comparacoes++;
+            if (no->proximos[nivel]->registro.chave >= chave) {
+                break;
+            }
+            no = no->proximos[nivel];
+        }
+        if (anteriores != NULL) {
+            anteriores[nivel] = no;
+        }
+    }
+    return no->proximos[0];
+}
+
+/**
+ * Insere um registro na memtable; uma chave repetida tem o registro substituído.
+ */
+static void inserirMemtable(MemtableLSM *memtable, const Registro *reg, Metricas *metricas) {
+    NoMemtableLSM *anteriores[NIVEIS_MEMTABLE_LSM];
+    NoMemtableLSM *seguinte = localizarMemtable(memtable, reg->chave, anteriores, metricas);
+    if (seguinte != NULL && seguinte->registro.chave == reg->chave) {
+        seguinte->registro = *reg;
+        return;
+    }
+
+    int nivel = sortearNivel(memtable);
+    for (int n = memtable->nivel; n < nivel; n++) {
+        anteriores[n] = memtable->cabeca;
+    }
+    if (nivel > memtable->nivel) {
+        memtable->nivel = nivel;
+    }
+
+    NoMemtableLSM *novo = malloc(sizeof(NoMemtableLSM) + nivel * sizeof(NoMemtableLSM *));
+    novo->registro = *reg;
+    novo->nivel = nivel;
+    for (int n = 0; n < nivel; n++) {
+        novo->proximos[n] = anteriores[n]->proximos[n];
+        anteriores[n]->proximos[n] = novo;
+    }
+    memtable->numRegistros++;
+}
+
+static void destruirMemtable(MemtableLSM *memtable) {
+    NoMemtableLSM *no = memtable->cabeca;
+    while (no != NULL) {
+        NoMemtableLSM *proximo = no->proximos[0];
+        free(no);
+        no = proximo;
+    }
+    free(memtable);
+}
+
+/**
+ * Espalha os bits de uma chave para o filtro de Bloom (finalizador do MurmurHash3).
+ */
+static uint64_t misturarChave(Chave chave) {
+    uint64_t h = (uint64_t)chave;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+/**
+ * Marca ou consulta uma chave no filtro de Bloom do segmento, com as posições geradas por
+ * duplo hashing a partir das duas metades do hash.
+ *
+ * @return Retorna false se a chave certamente não está no segmento.
+ */
+static bool filtroSegmento(SegmentoLSM *segmento, Chave chave, bool marcar) {
+    uint64_t h = misturarChave(chave);
+    uint64_t passo = (h >> 32) | 1;
+    for (int i = 0; i < FUNCOES_FILTRO_LSM; i++) {
+        uint64_t bit = (h + i * passo) % segmento->bitsFiltro;
+        if (marcar) {
+            segmento->filtro[bit / 64] |= 1ULL << (bit % 64);
+        } else if (!(segmento->filtro[bit / 64] & (1ULL << (bit % 64)))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Libera uma referência a um segmento; a última apaga seu arquivo.
+ */
+static void liberarSegmento(SegmentoLSM *segmento) {
+    if (atomic_fetch_sub(&segmento->referencias, 1) != 1) {
+        return;
+    }
+    close(segmento->descritor);
+    unlink(segmento->caminho);
+    free(segmento->indice);
+    free(segmento->filtro);
+    free(segmento);
+}
+
+/**
+ * Lê registros consecutivos de um segmento com uma única chamada.
+ *
+ * @return Número de registros lidos.
+ */
+static int lerBlocoSegmento(SegmentoLSM *segmento, long inicio, Registro *bloco, int maximo, Metricas *metricas) {
+    long restantes = segmento->numRegistros - inicio;
+    int quantidade = restantes < maximo ? (int)restantes : maximo;
+    if (quantidade <= 0) {
+        return 0;
+    }
+
+    ssize_t lidos = pread(segmento->descritor, bloco, quantidade * sizeof(Registro), DESLOCAMENTO_REGISTRO(inicio));
+    quantidade = lidos > 0 ? (int)(lidos / sizeof(Registro)) : 0;
+    metricas->transferencias += quantidade;
+    metricas->bytesLidos += quantidade * sizeof(Registro);
+    metricas->chamadasSistema++;
+    return quantidade;
+}
+
+/**
+ * Grava os registros acumulados pelo escritor no fim do arquivo do segmento.
+ */
+static void esvaziarEscritor(EscritorSegmentoLSM *escritor, Metricas *metricas) {
+    size_t bytes = escritor->noBloco * sizeof(Registro);
+    const char *dados = (const char *)escritor->bloco;
+    while (bytes > 0 && !escritor->falhou) {
+        ssize_t escritos = write(escritor->segmento->descritor, dados, bytes);
+        metricas->chamadasSistema++;
+        if (escritos <= 0) {
+            escritor->falhou = true;
+            break;
+        }
+        dados += escritos;
+        bytes -= escritos;
+    }
+    metricas->transferencias += escritor->noBloco;
+    metricas->bytesEscritos += escritor->noBloco * sizeof(Registro);
+    escritor->noBloco = 0;
+}
+
+/**
+ * Cria o arquivo de um novo segmento e prepara o escritor.
+ *
+ * @param maximoRegistros Limite de registros do segmento, usado para dimensionar o filtro.
+ * @return Retorna false se o arquivo não pôde ser criado.
+ */
+static bool iniciarSegmento(ArvoreLSM *arvore, long maximoRegistros, EscritorSegmentoLSM *escritor) {
+    SegmentoLSM *segmento = calloc(1, sizeof(SegmentoLSM));
+    snprintf(segmento->caminho, sizeof(segmento->caminho), "%s/segmento_%06u.bin", arvore->diretorio, arvore->proximoSegmento++);
+    segmento->descritor = open(segmento->caminho, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (segmento->descritor < 0) {
+        perror("Erro ao criar o segmento");
+        free(segmento);
+        return false;
+    }
+
+    segmento->bitsFiltro = ((uint64_t)maximoRegistros * BITS_POR_CHAVE_LSM + 63) / 64 * 64;
+    segmento->filtro = calloc(segmento->bitsFiltro / 64, sizeof(uint64_t));
+    atomic_init(&segmento->referencias, 1);
+
+    escritor->segmento = segmento;
+    escritor->noBloco = 0;
+    escritor->capacidadeIndice = 0;
+    escritor->falhou = false;
+    return true;
+}
+
+/**
+ * Acrescenta ao segmento o próximo registro, em ordem crescente de chave.
+ */
+static void acrescentarSegmento(EscritorSegmentoLSM *escritor, const Registro *reg, Metricas *metricas) {
+    SegmentoLSM *segmento = escritor->segmento;
+
+    if (segmento->numRegistros % INTERVALO_INDICE_LSM == 0) {
+        if (segmento->tamanhoIndice == escritor->capacidadeIndice) {
+            escritor->capacidadeIndice = escritor->capacidadeIndice ? 2 * escritor->capacidadeIndice : 64;
+            segmento->indice = realloc(segmento->indice, escritor->capacidadeIndice * sizeof(Indice));
+        }
+        segmento->indice[segmento->tamanhoIndice].chave = reg->chave;
+        segmento->indice[segmento->tamanhoIndice].posicao = segmento->numRegistros;
+        segmento->tamanhoIndice++;
+    }
+    if (segmento->numRegistros == 0) {
+        segmento->menorChave = reg->chave;
+    }
+    segmento->maiorChave = reg->chave;
+    filtroSegmento(segmento, reg->chave, true);
+
+    escritor->bloco[escritor->noBloco++] = *reg;
+    segmento->numRegistros++;
+    if (escritor->noBloco == REGISTROS_BLOCO_LSM) {
+        esvaziarEscritor(escritor, metricas);
+    }
+}
+
+/**
+ * Grava o restante do segmento.
+ *
+ * @return O segmento pronto para leitura, ou NULL se a gravação falhou ou ele ficou vazio.
+ */
+static SegmentoLSM* finalizarSegmento(EscritorSegmentoLSM *escritor, Metricas *metricas) {
+    esvaziarEscritor(escritor, metricas);
+    SegmentoLSM *segmento = escritor->segmento;
+    if (escritor->falhou || segmento->numRegistros == 0) {
+        if (escritor->falhou) {
+            perror("Erro ao gravar o segmento");
+        }
+        liberarSegmento(segmento);
+        return NULL;
+    }
+    return segmento;
+}
+
+/**
+ * Devolve o registro atual de uma fonte, ou NULL se ela se esgotou.
+ */
+static const Registro* atualFonte(FonteLSM *fonte, Metricas *metricas) {
+    switch (fonte->tipo) {
+        case FONTE_MEMTABLE:
+            return fonte->no != NULL ? &fonte->no->registro : NULL;
+        case FONTE_VETOR:
+            return fonte->posicaoVetor < fonte->tamanhoVetor ? &fonte->vetor[fonte->posicaoVetor] : NULL;
+        default:
+            if (fonte->posicaoBloco == fonte->noBloco) {
+                fonte->noBloco = lerBlocoSegmento(fonte->segmento, fonte->proximo, fonte->bloco, fonte->tamanhoLeitura, metricas);
+                fonte->proximo += fonte->noBloco;
+                if (fonte->tamanhoLeitura < REGISTROS_BLOCO_LSM) {
+                    fonte->tamanhoLeitura *= 2;
+                }
+                fonte->posicaoBloco = 0;
+                if (fonte->noBloco == 0) {
+                    return NULL;
+                }
+            }
+            return &fonte->bloco[fonte->posicaoBloco];
+    }
+}
+
+static void avancarFonte(FonteLSM *fonte) {
+    switch (fonte->tipo) {
+        case FONTE_MEMTABLE:
+            fonte->no = fonte->no->proximos[0];
+            break;
+        case FONTE_VETOR:
+            fonte->posicaoVetor++;
+            break;
+        default:
+            fonte->posicaoBloco++;
+            break;
+    }
+}
+
+/**
+ * Posiciona uma fonte de segmento no primeiro registro com chave maior ou igual à dada,
+ * começando pelo bloco apontado pelo índice esparso. A primeira leitura cobre só esse
+ * bloco, para que intervalos curtos não leiam o segmento além do necessário.
+ */
+static void posicionarFonteSegmento(FonteLSM *fonte, SegmentoLSM *segmento, Chave minimo, Metricas *metricas) {
+    fonte->tipo = FONTE_SEGMENTO;
+    fonte->segmento = segmento;
+    fonte->noBloco = 0;
+    fonte->posicaoBloco = 0;
+    fonte->tamanhoLeitura = INTERVALO_INDICE_LSM;
+    fonte->proximo = buscarIndiceBinario(segmento->indice, segmento->tamanhoIndice, minimo, metricas);
+
+    const Registro *reg;
+    while ((reg = atualFonte(fonte, metricas)) != NULL && reg->chave < minimo) {
+        metricas->comparacoes++;
+        avancarFonte(fonte);
+    }
+}
+
+/**
+ * Intercala fontes ordenadas, da mais nova para a mais antiga, mantendo de cada chave só a
+ * versão da fonte mais nova.
+ *
+ * @param escritor Segmento que recebe o resultado, ou NULL para copiá-lo em registros.
+ * @return Número de registros produzidos.
+ */
+static long intercalarFontes(
+    FonteLSM *fontes,
+    int numFontes,
+    Chave maximo,
+    long limite,
+    EscritorSegmentoLSM *escritor,
+    Registro *registros,
+    Metricas *metricas
+) {
+    long produzidos = 0;
+    while (produzidos < limite) {
+        // Em caso de empate, a primeira fonte (a mais nova) vence
+        const Registro *menor = NULL;
+        for (int i = 0; i < numFontes; i++) {
+            const Registro *reg = atualFonte(&fontes[i], metricas);
+            if (reg == NULL) {
+                continue;
+            }
+            metricas->comparacoes++;
+            if (menor == NULL || reg->chave < menor->chave) {
+                menor = reg;
+            }
+        }
+        if (menor == NULL || menor->chave > maximo) {
+            break;
+        }
+
+        Registro escolhido = *menor;
+        if (escritor != NULL) {
+            acrescentarSegmento(escritor, &escolhido, metricas);
+        } else {
+            registros[produzidos] = escolhido;
+        }
+        produzidos++;
+
+        for (int i = 0; i < numFontes; i++) {
+            const Registro *reg = atualFonte(&fontes[i], metricas);
+            if (reg != NULL && reg->chave == escolhido.chave) {
+                avancarFonte(&fontes[i]);
+            }
+        }
+    }
+    return produzidos;
+}
+
+/**
+ * Grava uma memtable congelada como um novo segmento.
+ */
+static SegmentoLSM* descarregarMemtable(ArvoreLSM *arvore, MemtableLSM *memtable) {
+    EscritorSegmentoLSM *escritor = malloc(sizeof(EscritorSegmentoLSM));
+    SegmentoLSM *segmento = NULL;
+    if (iniciarSegmento(arvore, memtable->numRegistros, escritor)) {
+        for (NoMemtableLSM *no = memtable->cabeca->proximos[0]; no != NULL; no = no->proximos[0]) {
+            acrescentarSegmento(escritor, &no->registro, &arvore->metricasFundo);
+        }
+        segmento = finalizarSegmento(escritor, &arvore->metricasFundo);
+    }
+    free(escritor);
+    return segmento;
+}
+
+/**
+ * Intercala todos os segmentos de um nível em um único segmento do nível seguinte (ou do
+ * mesmo nível, no último).
+ *
+ * Só a thread de fundo altera os níveis, então os segmentos lidos aqui não mudam; a trava
+ * é tomada apenas para trocar os segmentos antigos pelo novo.
+ */
+static void compactarNivel(ArvoreLSM *arvore, int nivel) {
+    int numFontes = arvore->numSegmentos[nivel];
+    FonteLSM *fontes = malloc(numFontes * sizeof(FonteLSM));
+    EscritorSegmentoLSM *escritor = malloc(sizeof(EscritorSegmentoLSM));
+    SegmentoLSM *antigos[FATOR_NIVEL_LSM];
+    long total = 0;
+
+    for (int i = 0; i < numFontes; i++) {
+        // Os mais novos ficam no fim do nível e devem vir primeiro na intercalação
+        antigos[i] = arvore->niveis[nivel][numFontes - 1 - i];
+        posicionarFonteSegmento(&fontes[i], antigos[i], CHAVE_MINIMA, &arvore->metricasFundo);
+        total += antigos[i]->numRegistros;
+    }
+
+    SegmentoLSM *novo = NULL;
+    if (iniciarSegmento(arvore, total, escritor)) {
+        intercalarFontes(fontes, numFontes, CHAVE_MAXIMA, total, escritor, NULL, &arvore->metricasFundo);
+        novo = finalizarSegmento(escritor, &arvore->metricasFundo);
+    }
+    free(escritor);
+    free(fontes);
+    if (novo == NULL) {
+        return; // Os segmentos antigos continuam válidos
+    }
+
+    int destino = nivel + 1 < NIVEIS_LSM ? nivel + 1 : nivel;
+    pthread_mutex_lock(&arvore->trava);
+    arvore->numSegmentos[nivel] = 0;
+    arvore->niveis[destino][arvore->numSegmentos[destino]++] = novo;
+    arvore->compactacoes++;
+    pthread_mutex_unlock(&arvore->trava);
+
+    for (int i = 0; i < numFontes; i++) {
+        liberarSegmento(antigos[i]);
+    }
+}
+
+/**
+ * Laço da thread de fundo: descarrega cada memtable congelada e compacta os níveis cheios.
+ */
+static void* executarFundo(void *argumento) {
+    ArvoreLSM *arvore = argumento;
+
+    pthread_mutex_lock(&arvore->trava);
+    while (true) {
+        while (arvore->congelada == NULL && !arvore->encerrar) {
+            pthread_cond_wait(&arvore->temTrabalho, &arvore->trava);
+        }
+        if (arvore->congelada == NULL) {
+            break;
+        }
+
+        arvore->ocupada = true;
+        MemtableLSM *memtable = arvore->congelada;
+        pthread_mutex_unlock(&arvore->trava);
+
+        SegmentoLSM *segmento = descarregarMemtable(arvore, memtable);
+
+        pthread_mutex_lock(&arvore->trava);
+        if (segmento != NULL) {
+            arvore->niveis[0][arvore->numSegmentos[0]++] = segmento;
+        }
+        arvore->congelada = NULL;
+        arvore->descargas++;
+        pthread_cond_broadcast(&arvore->trabalhoConcluido);
+        pthread_mutex_unlock(&arvore->trava);
+
+        // Os leitores só consultam a memtable congelada com a trava, e ela já foi retirada
+        destruirMemtable(memtable);
+
+        for (int nivel = 0; nivel < NIVEIS_LSM; nivel++) {
+            if (arvore->numSegmentos[nivel] == FATOR_NIVEL_LSM) {
+                compactarNivel(arvore, nivel);
+            }
+        }
+
+        pthread_mutex_lock(&arvore->trava);
+        arvore->ocupada = false;
+        pthread_cond_broadcast(&arvore->trabalhoConcluido);
+    }
+    pthread_mutex_unlock(&arvore->trava);
+    return NULL;
+}
+
+/**
+ * Cria uma árvore LSM vazia e inicia sua thread de fundo.
+ *
+ * @param arvore Estrutura a ser iniciada.
+ * @param diretorio Diretório onde os segmentos serão gravados (criado se não existir).
+ * @return Retorna true se a árvore foi criada.
+ */
+bool criarArvoreLSM(ArvoreLSM *arvore, const char *diretorio) {
+    memset(arvore, 0, sizeof(ArvoreLSM));
+    snprintf(arvore->diretorio, sizeof(arvore->diretorio), "%s", diretorio);
+    mkdir(diretorio, 0755);
+
+    pthread_mutex_init(&arvore->trava, NULL);
+    pthread_cond_init(&arvore->temTrabalho, NULL);
+    pthread_cond_init(&arvore->trabalhoConcluido, NULL);
+    iniciarMetricas(&arvore->metricasFundo);
+    arvore->ativa = criarMemtable(0x9e3779b97f4a7c15ULL);
+
+    if (pthread_create(&arvore->fundo, NULL, executarFundo, arvore) != 0) {
+        destruirMemtable(arvore->ativa);
+        pthread_mutex_destroy(&arvore->trava);
+        pthread_cond_destroy(&arvore->temTrabalho);
+        pthread_cond_destroy(&arvore->trabalhoConcluido);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Congela a memtable ativa e a entrega à thread de fundo, esperando se a anterior ainda
+ * não foi descarregada. Deve ser chamada com a trava.
+ */
+static void congelarMemtable(ArvoreLSM *arvore) {
+    if (arvore->congelada != NULL) {
+        arvore->esperasEscrita++;
+        while (arvore->congelada != NULL) {
+            pthread_cond_wait(&arvore->trabalhoConcluido, &arvore->trava);
+        }
+    }
+    arvore->congelada = arvore->ativa;
+    arvore->ativa = criarMemtable(arvore->ativa->semente);
+    pthread_cond_signal(&arvore->temTrabalho);
+}
+
+/**
+ * Insere ou substitui um registro.
+ *
+ * A inserção só altera a memtable em memória; a gravação em disco acontece na thread de
+ * fundo, sequencialmente, quando a memtable enche.
+ *
+ * @param arvore Árvore LSM.
+ * @param reg Registro a ser inserido.
+ * @param metricas Ponteiro para as métricas da fase em andamento.
+ */
+void inserirArvoreLSM(ArvoreLSM *arvore, const Registro *reg, Metricas *metricas) {
+    inserirMemtable(arvore->ativa, reg, metricas);
+    if (arvore->ativa->numRegistros < LIMITE_MEMTABLE_LSM) {
+        return;
+    }
+
+    pthread_mutex_lock(&arvore->trava);
+    congelarMemtable(arvore);
+    pthread_mutex_unlock(&arvore->trava);
+}
+
+/**
+ * Copia os segmentos atuais, do mais novo para o mais antigo, tomando uma referência a
+ * cada um. Deve ser chamada com a trava.
+ *
+ * @return Número de segmentos copiados.
+ */
+static int fixarSegmentos(ArvoreLSM *arvore, SegmentoLSM **segmentos) {
+    int quantidade = 0;
+    for (int nivel = 0; nivel < NIVEIS_LSM; nivel++) {
+        for (int i = arvore->numSegmentos[nivel] - 1; i >= 0; i--) {
+            SegmentoLSM *segmento = arvore->niveis[nivel][i];
+            atomic_fetch_add(&segmento->referencias, 1);
+            segmentos[quantidade++] = segmento;
+        }
+    }
+    return quantidade;
+}
+
+/**
+ * Busca uma chave em um segmento: descarta-o pelas chaves extremas ou pelo filtro de Bloom
+ * e, se preciso, lê o bloco apontado pelo índice esparso.
+ */
+static bool buscarSegmento(SegmentoLSM *segmento, Chave chave, Registro *reg, Metricas *metricas) {
+    metricas->comparacoes += 2;
+    if (chave < segmento->menorChave || chave > segmento->maiorChave || !filtroSegmento(segmento, chave, false)) {
+        return false;
+    }
+
+    Registro bloco[INTERVALO_INDICE_LSM];
+    long inicio = buscarIndiceBinario(segmento->indice, segmento->tamanhoIndice, chave, metricas);
+    int lidos = lerBlocoSegmento(segmento, inicio, bloco, INTERVALO_INDICE_LSM, metricas);
+    for (int i = 0; i < lidos && bloco[i].chave <= chave; i++) {
+        metricas->comparacoes++;
+        if (bloco[i].chave == chave) {
+            *reg = bloco[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Busca a versão mais recente de um registro.
+ *
+ * @param arvore Árvore LSM.
+ * @param chave Chave buscada.
+ * @param reg Onde o registro encontrado será copiado.
+ * @param metricas Ponteiro para as métricas da fase em andamento.
+ * @return Retorna true se a chave foi encontrada.
+ */
+bool buscarArvoreLSM(ArvoreLSM *arvore, Chave chave, Registro *reg, Metricas *metricas) {
+    NoMemtableLSM *no = localizarMemtable(arvore->ativa, chave, NULL, metricas);
+    if (no != NULL && no->registro.chave == chave) {
+        *reg = no->registro;
+        return true;
+    }
+
+    SegmentoLSM *segmentos[NIVEIS_LSM * FATOR_NIVEL_LSM];
+    pthread_mutex_lock(&arvore->trava);
+    if (arvore->congelada != NULL) {
+        no = localizarMemtable(arvore->congelada, chave, NULL, metricas);
+        if (no != NULL && no->registro.chave == chave) {
+            *reg = no->registro;
+            pthread_mutex_unlock(&arvore->trava);
+            return true;
+        }
+    }
+    int numSegmentos = fixarSegmentos(arvore, segmentos);
+    pthread_mutex_unlock(&arvore->trava);
+
+    bool encontrado = false;
+    for (int i = 0; i < numSegmentos && !encontrado; i++) {
+        encontrado = buscarSegmento(segmentos[i], chave, reg, metricas);
+    }
+    for (int i = 0; i < numSegmentos; i++) {
+        liberarSegmento(segmentos[i]);
+    }
+    return encontrado;
+}
+
+/**
+ * Busca as chaves de um intervalo, intercalando memtables e segmentos.
+ *
+ * Da memtable congelada são copiados, com a trava, no máximo os primeiros registros do
+ * intervalo que podem entrar no resultado; os segmentos ficam fixados enquanto são lidos.
+ *
+ * @param arvore Árvore LSM.
+ * @param minimo Menor chave do intervalo.
+ * @param maximo Maior chave do intervalo.
+ * @param registros Vetor onde os registros encontrados serão copiados, em ordem de chave.
+ * @param limite Capacidade do vetor de registros.
+ * @param metricas Ponteiro para as métricas da fase em andamento.
+ * @return Número de registros encontrados.
+ */
+long buscarIntervaloArvoreLSM(ArvoreLSM *arvore, Chave minimo, Chave maximo, Registro *registros, long limite, Metricas *metricas) {
+    SegmentoLSM *segmentos[NIVEIS_LSM * FATOR_NIVEL_LSM];
+    FonteLSM *fontes = malloc((2 + NIVEIS_LSM * FATOR_NIVEL_LSM) * sizeof(FonteLSM));
+    Registro *congelados = malloc(limite * sizeof(Registro));
+    int numFontes = 0;
+
+    fontes[numFontes].tipo = FONTE_MEMTABLE;
+    fontes[numFontes++].no = localizarMemtable(arvore->ativa, minimo, NULL, metricas);
+
+    pthread_mutex_lock(&arvore->trava);
+    long numCongelados = 0;
+    if (arvore->congelada != NULL) {
+        NoMemtableLSM *no = localizarMemtable(arvore->congelada, minimo, NULL, metricas);
+        for (; no != NULL && no->registro.chave <= maximo && numCongelados < limite; no = no->proximos[0]) {
+            congelados[numCongelados++] = no->registro;
+        }
+    }
+    int numSegmentos = fixarSegmentos(arvore, segmentos);
+    pthread_mutex_unlock(&arvore->trava);
+
+    fontes[numFontes].tipo = FONTE_VETOR;
+    fontes[numFontes].vetor = congelados;
+    fontes[numFontes].tamanhoVetor = numCongelados;
+    fontes[numFontes++].posicaoVetor = 0;
+    for (int i = 0; i < numSegmentos; i++) {
+        posicionarFonteSegmento(&fontes[numFontes++], segmentos[i], minimo, metricas);
+    }
+
+    long encontrados = intercalarFontes(fontes, numFontes, maximo, limite, NULL, registros, metricas);
+
+    for (int i = 0; i < numSegmentos; i++) {
+        liberarSegmento(segmentos[i]);
+    }
+    free(congelados);
+    free(fontes);
+    return encontrados;
+}
+
+/**
+ * Descarrega a memtable ativa e espera a thread de fundo terminar as compactações
+ * pendentes, deixando todos os registros em segmentos.
+ *
+ * @param arvore Árvore LSM.
+ */
+void sincronizarArvoreLSM(ArvoreLSM *arvore) {
+    pthread_mutex_lock(&arvore->trava);
+    if (arvore->ativa->numRegistros > 0) {
+        congelarMemtable(arvore);
+    }
+    while (arvore->congelada != NULL || arvore->ocupada) {
+        pthread_cond_wait(&arvore->trabalhoConcluido, &arvore->trava);
+    }
+    pthread_mutex_unlock(&arvore->trava);
+}
+
+/**
+ * Encerra a thread de fundo e libera a árvore, apagando os arquivos dos segmentos.
+ *
+ * Os segmentos servem apenas à execução atual: os índices e filtros ficam em memória e não
+ * há manifesto para reabri-los.
+ *
+ * @param arvore Árvore LSM.
+ */
+void fecharArvoreLSM(ArvoreLSM *arvore) {
+    pthread_mutex_lock(&arvore->trava);
+    arvore->encerrar = true;
+    pthread_cond_signal(&arvore->temTrabalho);
+    pthread_mutex_unlock(&arvore->trava);
+    pthread_join(arvore->fundo, NULL);
+
+    destruirMemtable(arvore->ativa);
+    for (int nivel = 0; nivel < NIVEIS_LSM; nivel++) {
+        for (int i = 0; i < arvore->numSegmentos[nivel]; i++) {
+            liberarSegmento(arvore->niveis[nivel][i]);
+        }
+        arvore->numSegmentos[nivel] = 0;
+    }
+    rmdir(arvore->diretorio);
+
+    pthread_mutex_destroy(&arvore->trava);
+    pthread_cond_destroy(&arvore->temTrabalho);
+    pthread_cond_destroy(&arvore->trabalhoConcluido);
+}
@@ -0,0 +1,89 @@
+#ifndef LSM_H
+#define LSM_H
+
+#include "../registro/registro.h"
+#include "../index/index.h"
+#include "../metricas/metricas.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#define LIMITE_MEMTABLE_LSM 8192 // Registros da memtable antes de ela ser descarregada
+#define NIVEIS_MEMTABLE_LSM 12 // Níveis da lista de saltos da memtable
+#define NIVEIS_LSM 8 // Níveis de segmentos
+#define FATOR_NIVEL_LSM 4 // Segmentos acumulados em um nível antes de serem compactados
+#define INTERVALO_INDICE_LSM 32 // Registros entre duas entradas do índice esparso de um segmento
+#define BITS_POR_CHAVE_LSM 10 // Tamanho do filtro de Bloom (cerca de 1% de falsos positivos)
+#define FUNCOES_FILTRO_LSM 7 // Posições marcadas por chave no filtro de Bloom
+
+/*
+ * Motor de ingestão LSM sobre o formato Registro.
+ *
+ * As inserções vão para uma memtable em memória (lista de saltos ordenada por chave).
+ * Cheia, ela é congelada e uma thread de fundo a grava como um segmento: um arquivo de
+ * registros em ordem crescente de chave, escrito sequencialmente, com índice esparso e
+ * filtro de Bloom mantidos em memória. Os segmentos são organizados em camadas (tiering):
+ * quando um nível junta FATOR_NIVEL_LSM segmentos, a thread de fundo os intercala em um
+ * único segmento do nível seguinte. Todo segmento de um nível é mais novo que os dos níveis
+ * abaixo, e dentro de um nível os mais novos ficam no fim.
+ *
+ * As leituras consultam a memtable, a memtable congelada e os segmentos do mais novo para o
+ * mais antigo; a primeira versão encontrada de uma chave é a válida.
+ */
+
+typedef struct NoMemtableLSM {
+    Registro registro;
+    int nivel; // Níveis da lista de saltos em que o nó aparece
+    struct NoMemtableLSM *proximos[]; // Próximo nó em cada nível
+} NoMemtableLSM;
+
+typedef struct {
+    NoMemtableLSM *cabeca; // Sentinela com todos os níveis
+    int nivel; // Maior nível ocupado
+    long numRegistros;
+    uint64_t semente; // Estado do sorteio dos níveis
+} MemtableLSM;
+
+typedef struct {
+    char caminho[260];
+    int descritor; // Lido com pread
+    long numRegistros;
+    Chave menorChave, maiorChave;
+    Indice *indice; // Chave e número do registro a cada INTERVALO_INDICE_LSM registros
+    long tamanhoIndice;
+    uint64_t *filtro; // Filtro de Bloom das chaves
+    uint64_t bitsFiltro;
+    atomic_int referencias; // Leitores usando o segmento, mais uma enquanto está na árvore
+} SegmentoLSM;
+
+typedef struct {
+    char diretorio[200]; // Onde os segmentos são gravados
+    pthread_mutex_t trava; // Protege memtables, níveis e estado da thread de fundo
+    pthread_cond_t temTrabalho; // Sinalizada quando uma memtable é congelada ou no encerramento
+    pthread_cond_t trabalhoConcluido; // Sinalizada quando a thread de fundo termina uma tarefa
+    pthread_t fundo;
+    bool encerrar;
+    bool ocupada; // A thread de fundo está descarregando ou compactando
+
+    MemtableLSM *ativa; // Recebe as inserções; usada só pela thread que insere e lê
+    MemtableLSM *congelada; // Aguardando descarga, ou NULL
+
+    SegmentoLSM *niveis[NIVEIS_LSM][FATOR_NIVEL_LSM]; // Segmentos de cada nível, do mais antigo ao mais novo
+    int numSegmentos[NIVEIS_LSM];
+    unsigned proximoSegmento; // Número do próximo arquivo de segmento
+
+    Metricas metricasFundo; // E/S das descargas e compactações (só a thread de fundo as altera)
+    uint64_t descargas;
+    uint64_t compactacoes;
+    uint64_t esperasEscrita; // Inserções que esperaram a descarga da memtable anterior
+} ArvoreLSM;
+
+bool criarArvoreLSM(ArvoreLSM *arvore, const char *diretorio);
+void inserirArvoreLSM(ArvoreLSM *arvore, const Registro *reg, Metricas *metricas);
+bool buscarArvoreLSM(ArvoreLSM *arvore, Chave chave, Registro *reg, Metricas *metricas);
+long buscarIntervaloArvoreLSM(ArvoreLSM *arvore, Chave minimo, Chave maximo, Registro *registros, long limite, Metricas *metricas);
+void sincronizarArvoreLSM(ArvoreLSM *arvore);
+void fecharArvoreLSM(ArvoreLSM *arvore);
+
+#endif // LSM_H
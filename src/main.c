@@ -1,31 +1,304 @@
 #include "pesquisa/pesquisa.h"
 #include "registro/registro.h"
 #include "util/util.h"
+#include "es/es.h"
+#include "servidor/servidor.h"
+#include "carga/carga.h"
+#include "rastro/rastro.h"
+#include "ajuste/ajuste.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 
 int main(int argc, char *argv[]) {
-    if (argc < 5 || argc > 6) {
-        fprintf(stderr, "Uso: %s <método> <quantidade> <situação> <chave> [-P]\n", argv[0]);
+    // Subcomandos: "servidor" mantém árvores B* em memória e atende consultas por um socket
+    // Unix; "carga" abre conexões contra ele e mede vazão e latências; "indice" compara a
+    // busca binária e a ordem de Eytzinger em um índice esparso sintético; "escala" grava e
+    // pesquisa amostras de um arquivo esparso com o número de registros pedido; "rastro" gera
+    // um rastro de consultas (uniforme ou Zipf, com uma fração de chaves ausentes) para -X;
+    // "ajuste" mede as variantes de tamanho de nó das árvores B e B* e grava a escolha para -N
+    if (argc >= 5 && strcmp(argv[1], "servidor") == 0) {
+        return executarServidor(argv[2], atoi(argv[3]), argv + 4, argc - 4);
+    }
+    if (argc == 4 && strcmp(argv[1], "indice") == 0 && atoi(argv[2]) > 0 && atoi(argv[3]) > 0) {
+        return compararLayoutsIndice(atoi(argv[2]), atoi(argv[3]));
+    }
+    if ((argc == 3 || argc == 4) && strcmp(argv[1], "escala") == 0 && atol(argv[2]) > 0) {
+        char caminho[100];
+        sprintf(caminho, "testes/escala_%ld.bin", atol(argv[2]));
+        return testarEscala(caminho, atol(argv[2]), argc == 4 && atoi(argv[3]) > 0 ? atoi(argv[3]) : 64);
+    }
+    if (argc >= 6 && argc <= 8 && strcmp(argv[1], "rastro") == 0) {
+        DistribuicaoRastro distribuicao;
+        double assimetria = argc >= 7 ? atof(argv[6]) : 1.0;
+        double taxaFaltas = argc == 8 ? atof(argv[7]) : 0.0;
+        if (atol(argv[4]) < 1 || !interpretarDistribuicaoRastro(argv[5], &distribuicao) || assimetria < 0.0 || taxaFaltas < 0.0 || taxaFaltas > 1.0) {
+            fprintf(stderr, "Uso: %s rastro <arquivo> <saída> <consultas> uniforme|zipf [assimetria] [fração de ausentes]\n", argv[0]);
+            return 1;
+        }
+        return gerarRastro(argv[2], argv[3], atol(argv[4]), distribuicao, assimetria, taxaFaltas);
+    }
+    if (argc >= 3 && argc <= 5 && strcmp(argv[1], "ajuste") == 0 && (argc < 5 || strcmp(argv[4], "-D") == 0)) {
+        int argumentos = argc;
+        if (strcmp(argv[argc - 1], "-D") == 0) {
+            definirModoES(MODO_ES_DIRETO); // A amostra é lida sem o cache de páginas
+            argumentos--;
+        }
+        return ajustarVariantes(argv[2], argumentos == 4 && atol(argv[3]) > 0 ? atol(argv[3]) : AMOSTRA_AJUSTE);
+    }
+    if ((argc == 7 || argc == 8) && strcmp(argv[1], "carga") == 0) {
+        return executarCarga(argv[2], argv[3], atoi(argv[4]), atoi(argv[5]), atoi(argv[6]), argc == 8 ? atoi(argv[7]) : 0);
+    }
+
+    if (argc < 5) {
+        fprintf(stderr, "Uso: %s <método> <quantidade> <situação> <chave> [-P] [-I <chave>] [-A <chave>] [-R <chave>] [-F texto|json|csv] [-M <arquivo>] [-L <lote>] [-Q <profundidade>] [-D] [-T <threads>] [-C <threads>] [-S <leitores>] [-E] [-O] [-Z] [-V <dado1>] [-X <rastro>] [-K <bytes>] [-N <bytes>|padrao|auto] [-G] [-U] [-J]\n", argv[0]);
+        fprintf(stderr, "     %s servidor <socket> <trabalhadores> <arquivo>...\n", argv[0]);
+        fprintf(stderr, "     %s carga <socket> <arquivo> <índice> <conexões> <pedidos> [intervalo]\n", argv[0]);
+        fprintf(stderr, "     %s indice <entradas> <consultas>\n", argv[0]);
+        fprintf(stderr, "     %s escala <registros> [amostras]\n", argv[0]);
+        fprintf(stderr, "     %s rastro <arquivo> <saída> <consultas> uniforme|zipf [assimetria] [fração de ausentes]\n", argv[0]);
+        fprintf(stderr, "     %s ajuste <arquivo> [amostra] [-D]\n", argv[0]);
         return 1;
     }
 
     int metodo = atoi(argv[1]);
-    int quantidade = atoi(argv[2]);
+    long quantidade = atol(argv[2]);
     int situacao = atoi(argv[3]);
-    int chave = atoi(argv[4]);
-    int exibirChaves = (argc == 6 && argv[5][0] == '-' && argv[5][1] == 'P');
+    Chave chave = (Chave)strtoll(argv[4], NULL, 10);
+
+    // Opções adicionais:
+    // -P exibe as chaves
+    // -I, -A e -R incluem, atualizam e removem o registro da chave dada
+    // -F escolhe o formato das métricas (texto, json ou csv)
+    // -M acrescenta as métricas a um arquivo
+    // -L pesquisa um lote de chaves sorteadas (em grupos com pré-busca nas árvores B e B*)
+    // -Q define quantas consultas do lote ficam em andamento na árvore binária
+    // -D lê e grava os arquivos de dados com O_DIRECT, sem o cache de páginas
+    // -T constrói o índice ou a árvore com várias threads (no método 0, divide a varredura)
+    // -C mede a Árvore B concorrente com inserções e buscas simultâneas
+    // -S mede a árvore binária com cópia na escrita e leitores de versões fixadas
+    // -E pesquisa o índice esparso na ordem de Eytzinger
+    // -O constrói a árvore com uma thread lendo o arquivo e outra inserindo
+    // -Z pesquisa pelo mapa de zonas, que também serve para arquivos fora de ordem
+    // -V pesquisa também os registros com o dado1 dado, pelo índice secundário
+    // -X reproduz um rastro de consultas na Árvore B
+    // -K define o orçamento, em bytes, da cache de resultados comparada no rastro
+    // -N escolhe a variante de tamanho de nó das árvores B e B* (auto: a de "pesquisa ajuste")
+    // -G guarda os registros em páginas com fendas, indexados por RID nas árvores B e B*
+    // -U pesquisa também todas as ocorrências da chave
+    // -J resolve o lote de -L também por junção com as folhas da B* ou com o índice esparso
+    Operacao operacoes[argc];
+    OpcoesPesquisa opcoes = {0};
+    opcoes.operacoes = operacoes;
+
+    for (int i = 5; i < argc; i++) {
+        if (argv[i][0] != '-' || argv[i][1] == '\0' || argv[i][2] != '\0') {
+            fprintf(stderr, "Opção inválida: %s\n", argv[i]);
+            return 1;
+        }
+
+        switch (argv[i][1]) {
+            case 'P':
+                opcoes.exibirChaves = 1;
+                break;
+            case 'D':
+                definirModoES(MODO_ES_DIRETO);
+                break;
+            case 'E':
+                opcoes.indiceEytzinger = 1;
+                break;
+            case 'O':
+                opcoes.construcaoEncadeada = 1;
+                break;
+            case 'G':
+                opcoes.paginas = 1;
+                break;
+            case 'U':
+                opcoes.todasOcorrencias = 1;
+                break;
+            case 'J':
+                opcoes.juncaoLote = 1;
+                break;
+            case 'Z':
+                opcoes.mapaZonas = 1;
+                break;
+            case 'I':
+            case 'A':
+            case 'R':
+                if (i + 1 >= argc) {
+                    fprintf(stderr, "A opção %s exige uma chave.\n", argv[i]);
+                    return 1;
+                }
+                operacoes[opcoes.numOperacoes].tipo = (TipoOperacao)argv[i][1];
+                operacoes[opcoes.numOperacoes].chave = (Chave)strtoll(argv[++i], NULL, 10);
+                opcoes.numOperacoes++;
+                break;
+            case 'V':
+                if (i + 1 >= argc) {
+                    fprintf(stderr, "A opção -V exige um valor de dado1.\n");
+                    return 1;
+                }
+                opcoes.pesquisarDado1 = 1;
+                opcoes.valorDado1 = strtol(argv[++i], NULL, 10);
+                break;
+            case 'X':
+                if (i + 1 >= argc) {
+                    fprintf(stderr, "A opção -X exige o caminho de um rastro.\n");
+                    return 1;
+                }
+                opcoes.rastro = argv[++i];
+                break;
+            case 'N':
+                if (i + 1 >= argc) {
+                    fprintf(stderr, "A opção -N exige um tamanho de nó, padrao ou auto.\n");
+                    return 1;
+                }
+                opcoes.varianteNo = argv[++i];
+                break;
+            case 'K':
+                if (i + 1 >= argc || atol(argv[i + 1]) < 1) {
+                    fprintf(stderr, "A opção -K exige um número positivo de bytes.\n");
+                    return 1;
+                }
+                opcoes.orcamentoCache = (size_t)atol(argv[++i]);
+                break;
+            case 'F':
+                if (i + 1 >= argc || !interpretarFormatoMetricas(argv[i + 1], &opcoes.formatoMetricas)) {
+                    fprintf(stderr, "A opção -F exige o formato texto, json ou csv.\n");
+                    return 1;
+                }
+                i++;
+                break;
+            case 'M':
+                if (i + 1 >= argc) {
+                    fprintf(stderr, "A opção -M exige o caminho de um arquivo.\n");
+                    return 1;
+                }
+                opcoes.arquivoMetricas = argv[++i];
+                break;
+            case 'L':
+            case 'Q':
+            case 'T':
+            case 'C':
+            case 'S':
+                if (i + 1 >= argc || atoi(argv[i + 1]) < 1) {
+                    fprintf(stderr, "A opção %s exige um número positivo.\n", argv[i]);
+                    return 1;
+                }
+                if (argv[i][1] == 'L') {
+                    opcoes.tamanhoLote = atoi(argv[++i]);
+                } else if (argv[i][1] == 'Q') {
+                    opcoes.profundidadeFila = atoi(argv[++i]);
+                } else if (argv[i][1] == 'T') {
+                    opcoes.numThreads = atoi(argv[++i]);
+                } else if (argv[i][1] == 'C') {
+                    opcoes.threadsConcorrentes = atoi(argv[++i]);
+                } else {
+                    opcoes.leitoresInstantaneos = atoi(argv[++i]);
+                }
+                break;
+            default:
+                fprintf(stderr, "Opção inválida: %s\n", argv[i]);
+                return 1;
+        }
+    }
 
     // Verificar se os argumentos são válidos
-    if (metodo < 1 || metodo > 4 || situacao < 1 || situacao > 3) {
+    if (metodo < 0 || metodo > 6 || situacao < 1 || situacao > 3 || quantidade < 1) {
         fprintf(stderr, "Argumentos inválidos.\n");
         return 1;
     }
 
+    if (quantidade > (long)CHAVE_MAXIMA - 1) {
+        fprintf(stderr, "Com chaves de %d bits o arquivo pode ter no máximo %ld registros; compile com make CHAVE=64.\n", (int)(8 * sizeof(Chave)), (long)CHAVE_MAXIMA - 1);
+        return 1;
+    }
+
+    if (opcoes.numOperacoes > 0 && metodo != 3 && metodo != 4) {
+        fprintf(stderr, "Operações de atualização disponíveis apenas para os métodos 3 e 4.\n");
+        return 1;
+    }
+
+    if (opcoes.juncaoLote && (opcoes.tamanhoLote == 0 || (metodo != 1 && metodo != 4) || opcoes.mapaZonas)) {
+        fprintf(stderr, "A junção do lote está disponível apenas para os métodos 1 e 4, com -L e sem -Z.\n");
+        return 1;
+    }
+
+    if (opcoes.tamanhoLote > 0 && metodo == 1 && !opcoes.mapaZonas && !opcoes.juncaoLote) {
+        fprintf(stderr, "A pesquisa em lote está disponível apenas para os métodos 0 e 2 a 6 e para o método 1 com -Z ou -J.\n");
+        return 1;
+    }
+
+    if ((opcoes.rastro != NULL && (metodo != 3 || opcoes.threadsConcorrentes > 0)) || (opcoes.orcamentoCache > 0 && opcoes.rastro == NULL)) {
+        fprintf(stderr, "A reprodução de rastro está disponível apenas para o método 3, sem -C; -K exige -X.\n");
+        return 1;
+    }
+
+    if (opcoes.varianteNo != NULL && ((metodo != 3 && metodo != 4) || opcoes.numOperacoes > 0 || opcoes.numThreads > 1 || opcoes.threadsConcorrentes > 0 || opcoes.construcaoEncadeada || opcoes.rastro != NULL)) {
+        fprintf(stderr, "As variantes de tamanho de nó estão disponíveis apenas para os métodos 3 e 4, sem -I, -A, -R, -T, -C, -O e -X.\n");
+        return 1;
+    }
+
+    if (opcoes.paginas && ((metodo != 3 && metodo != 4) || (opcoes.numOperacoes > 0 && metodo != 3) || opcoes.numThreads > 1 || opcoes.threadsConcorrentes > 0 || opcoes.construcaoEncadeada || opcoes.rastro != NULL || opcoes.varianteNo != NULL)) {
+        fprintf(stderr, "O arquivo paginado está disponível apenas para os métodos 3 e 4 (atualizações só no 3), sem -T, -C, -O, -X e -N.\n");
+        return 1;
+    }
+
+    if (opcoes.todasOcorrencias && (metodo == 1 || metodo == 6 || opcoes.tamanhoLote > 0 || opcoes.threadsConcorrentes > 0 || opcoes.leitoresInstantaneos > 0 || opcoes.rastro != NULL || opcoes.varianteNo != NULL || opcoes.paginas)) {
+        fprintf(stderr, "A pesquisa de todas as ocorrências está disponível apenas para os métodos 0 e 2 a 5, sem -L, -C, -S, -X, -N e -G.\n");
+        return 1;
+    }
+
+    if (opcoes.leitoresInstantaneos > 0 && metodo != 2) {
+        fprintf(stderr, "A ingestão com cópia na escrita está disponível apenas para o método 2.\n");
+        return 1;
+    }
+
+    if (opcoes.threadsConcorrentes > 0 && metodo != 3) {
+        fprintf(stderr, "As rodadas concorrentes estão disponíveis apenas para o método 3.\n");
+        return 1;
+    }
+
+    if (opcoes.indiceEytzinger && metodo != 1) {
+        fprintf(stderr, "A ordem de Eytzinger está disponível apenas para o método 1.\n");
+        return 1;
+    }
+
+    if (opcoes.mapaZonas && (metodo != 1 || opcoes.indiceEytzinger || opcoes.numThreads > 1)) {
+        fprintf(stderr, "O mapa de zonas está disponível apenas para o método 1, sem -E e sem -T.\n");
+        return 1;
+    }
+
+    if (opcoes.construcaoEncadeada && ((metodo != 3 && metodo != 4) || opcoes.numThreads > 1)) {
+        fprintf(stderr, "A construção encadeada está disponível apenas para os métodos 3 e 4, sem -T.\n");
+        return 1;
+    }
+
+    if (opcoes.numThreads > 1 && (metodo == 2 || metodo >= 5)) {
+        fprintf(stderr, "A construção paralela está disponível apenas para os métodos 0, 1, 3 e 4.\n");
+        return 1;
+    }
+
+    // Métricas JSON ou CSV na saída padrão: ela fica só com as métricas, e os textos da pesquisa
+    // vão para a saída de erros, para que a saída possa ser lida por outras ferramentas
+    if (opcoes.formatoMetricas != FORMATO_TEXTO && opcoes.arquivoMetricas == NULL) {
+        int descritor = dup(STDOUT_FILENO);
+        opcoes.saidaMetricas = descritor >= 0 ? fdopen(descritor, "w") : NULL;
+        if (opcoes.saidaMetricas == NULL || dup2(STDERR_FILENO, STDOUT_FILENO) < 0) {
+            perror("Erro ao separar as métricas da saída padrão");
+            return 1;
+        }
+    }
+
     char nomeArquivo[100];
     char caminhoCompleto[260]; 
     const char *situacaoStr = situacao == 1 ? "asc" : (situacao == 2 ? "desc" : "rand");
-    sprintf(nomeArquivo, "teste_%s_%d.bin", situacaoStr, quantidade);
+#ifdef CHAVE_64_BITS
+    sprintf(nomeArquivo, "teste_%s_%ld_64.bin", situacaoStr, quantidade); // O formato muda com a largura da chave
+#else
+    sprintf(nomeArquivo, "teste_%s_%ld.bin", situacaoStr, quantidade);
+#endif
     sprintf(caminhoCompleto, "testes/%s", nomeArquivo);
 
     if (gerarArquivo(caminhoCompleto, quantidade, situacao) != 1) {
@@ -33,27 +306,40 @@ int main(int argc, char *argv[]) {
         return 1; // Encerra o programa em caso de falha
     }
 
-    if (exibirChaves) {
+    if (opcoes.exibirChaves) {
         exibirRegistros(caminhoCompleto, quantidade);
     }
 
     switch (metodo) {
+        case 0:
+            varreduraCompleta(caminhoCompleto, chave, &opcoes);
+            break;
         case 1:
-            acessoSequencialIndexado(caminhoCompleto, chave, exibirChaves);
+            acessoSequencialIndexado(caminhoCompleto, chave, &opcoes);
             break;
         case 2:
-            arvoreBinariaPesquisa(caminhoCompleto, chave, exibirChaves);
+            arvoreBinariaPesquisa(caminhoCompleto, chave, &opcoes);
             break;
         case 3:
-            arvoreB(caminhoCompleto, chave, exibirChaves);
+            arvoreB(caminhoCompleto, chave, &opcoes);
             break;
         case 4:
-            arvoreBStar(caminhoCompleto, chave, exibirChaves);
+            arvoreBStar(caminhoCompleto, chave, &opcoes);
+            break;
+        case 5:
+            arvoreRadix(caminhoCompleto, chave, &opcoes);
+            break;
+        case 6:
+            arvoreLSM(caminhoCompleto, chave, &opcoes);
             break;
         default:
             fprintf(stderr, "Método de pesquisa inválido.\n");
             return 1;
     }
 
+    if (opcoes.pesquisarDado1) {
+        pesquisarDado1(caminhoCompleto, opcoes.valorDado1, &opcoes);
+    }
+
     return 0;
 }
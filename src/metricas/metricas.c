@@ -0,0 +1,264 @@
+#include "metricas.h"
+#include <string.h>
+
+/**
+ * Converte a diferença entre duas marcas de tempo para segundos.
+ */
+static double segundosEntre(const struct timespec *inicio, const struct timespec *fim) {
+    return (double)(fim->tv_sec - inicio->tv_sec) + (double)(fim->tv_nsec - inicio->tv_nsec) / 1e9;
+}
+
+/**
+ * Zera as métricas de uma fase e registra o instante em que ela começa.
+ *
+ * @param metricas Ponteiro para as métricas da fase.
+ */
+void iniciarMetricas(Metricas *metricas) {
+    memset(metricas, 0, sizeof(Metricas));
+    getrusage(RUSAGE_SELF, &metricas->inicioUso);
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &metricas->inicioCPU);
+    clock_gettime(CLOCK_MONOTONIC, &metricas->inicioReal);
+}
+
+/**
+ * Encerra uma fase, calculando os tempos e os contadores do sistema desde iniciarMetricas.
+ *
+ * @param metricas Ponteiro para as métricas da fase.
+ */
+void finalizarMetricas(Metricas *metricas) {
+    struct timespec fimReal, fimCPU;
+    struct rusage fimUso;
+
+    clock_gettime(CLOCK_MONOTONIC, &fimReal);
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &fimCPU);
+    getrusage(RUSAGE_SELF, &fimUso);
+
+    metricas->tempoReal = segundosEntre(&metricas->inicioReal, &fimReal);
+    metricas->tempoCPU = segundosEntre(&metricas->inicioCPU, &fimCPU);
+    metricas->falhasPaginaMenores = fimUso.ru_minflt - metricas->inicioUso.ru_minflt;
+    metricas->falhasPaginaMaiores = fimUso.ru_majflt - metricas->inicioUso.ru_majflt;
+    metricas->blocosLidos = fimUso.ru_inblock - metricas->inicioUso.ru_inblock;
+    metricas->blocosEscritos = fimUso.ru_oublock - metricas->inicioUso.ru_oublock;
+}
+
+/**
+ * Contabiliza a leitura de um registro, nó ou entrada do armazenamento externo.
+ *
+ * @param metricas Ponteiro para as métricas da fase.
+ * @param bytes Quantidade de bytes lidos.
+ */
+void registrarLeitura(Metricas *metricas, size_t bytes) {
+    metricas->transferencias++;
+    metricas->bytesLidos += bytes;
+    metricas->chamadasSistema++;
+}
+
+/**
+ * Contabiliza a escrita de um registro, nó ou entrada no armazenamento externo.
+ *
+ * @param metricas Ponteiro para as métricas da fase.
+ * @param bytes Quantidade de bytes escritos.
+ */
+void registrarEscrita(Metricas *metricas, size_t bytes) {
+    metricas->transferencias++;
+    metricas->bytesEscritos += bytes;
+    metricas->chamadasSistema++;
+}
+
+/**
+ * Contabiliza um posicionamento no arquivo, que não transfere dados.
+ *
+ * @param metricas Ponteiro para as métricas da fase.
+ */
+void registrarPosicionamento(Metricas *metricas) {
+    metricas->chamadasSistema++;
+}
+
+/**
+ * Soma os contadores de E/S e de comparações de uma métrica parcial a outra.
+ *
+ * Usada quando várias threads trabalham na mesma fase, cada uma com suas próprias métricas.
+ * Tempos, altura e número de nós não são somados: ficam a cargo de quem mede a fase inteira.
+ *
+ * @param destino Ponteiro para as métricas da fase.
+ * @param origem Ponteiro para as métricas parciais.
+ */
+void acumularMetricas(Metricas *destino, const Metricas *origem) {
+    destino->transferencias += origem->transferencias;
+    destino->bytesLidos += origem->bytesLidos;
+    destino->bytesEscritos += origem->bytesEscritos;
+    destino->chamadasSistema += origem->chamadasSistema;
+    destino->comparacoes += origem->comparacoes;
+    destino->divisoes += origem->divisoes;
+}
+
+/**
+ * Interpreta o nome de um formato de saída das métricas.
+ *
+ * @param nome Nome do formato ("texto", "json" ou "csv").
+ * @param formato Ponteiro onde o formato interpretado será armazenado.
+ * @return Retorna 1 se o nome for válido ou 0 caso contrário.
+ */
+int interpretarFormatoMetricas(const char *nome, FormatoMetricas *formato) {
+    if (strcmp(nome, "texto") == 0) {
+        *formato = FORMATO_TEXTO;
+    } else if (strcmp(nome, "json") == 0) {
+        *formato = FORMATO_JSON;
+    } else if (strcmp(nome, "csv") == 0) {
+        *formato = FORMATO_CSV;
+    } else {
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * Imprime um texto como string JSON, entre aspas, escapando aspas, barras invertidas e
+ * caracteres de controle.
+ */
+static void imprimirTextoJSON(FILE *saida, const char *texto) {
+    fputc('"', saida);
+    for (const unsigned char *c = (const unsigned char *)texto; *c != '\0'; c++) {
+        if (*c == '"' || *c == '\\') {
+            fprintf(saida, "\\%c", *c);
+        } else if (*c < 0x20) {
+            fprintf(saida, "\\u%04x", *c);
+        } else {
+            fputc(*c, saida);
+        }
+    }
+    fputc('"', saida);
+}
+
+/**
+ * Imprime um campo CSV, entre aspas (com as aspas internas dobradas) se ele tiver vírgula,
+ * aspas ou quebra de linha.
+ */
+static void imprimirCampoCSV(FILE *saida, const char *texto) {
+    if (strpbrk(texto, ",\"\r\n") == NULL) {
+        fputs(texto, saida);
+        return;
+    }
+    fputc('"', saida);
+    for (const char *c = texto; *c != '\0'; c++) {
+        if (*c == '"') {
+            fputc('"', saida);
+        }
+        fputc(*c, saida);
+    }
+    fputc('"', saida);
+}
+
+/**
+ * Imprime as métricas de uma fase no formato escolhido.
+ *
+ * No formato texto, apenas transferências, comparações e tempo de CPU são exibidos, como
+ * sempre foram, acrescidos da vazão quando a fase respondeu um lote de consultas. Os
+ * formatos JSON e CSV trazem todos os contadores e identificam o método, o arquivo e a
+ * fase, com os textos escapados, para que possam ser consumidos por outras ferramentas. O
+ * cabeçalho CSV só é impresso quando o arquivo de destino está vazio, já que -M acrescenta
+ * ao arquivo existente; em saídas sem posição, como um pipe, ele sai uma vez por execução.
+ *
+ * @param saida Arquivo onde as métricas serão impressas.
+ * @param formato Formato de saída.
+ * @param metodo Nome do método de pesquisa.
+ * @param arquivo Caminho do arquivo de registros.
+ * @param fase Identificador da fase ("construcao", "pesquisa" ou "atualizacao").
+ * @param titulo Título da fase exibido no formato texto.
+ * @param metricas Ponteiro para as métricas da fase.
+ */
+void imprimirMetricas(
+    FILE *saida,
+    FormatoMetricas formato,
+    const char *metodo,
+    const char *arquivo,
+    const char *fase,
+    const char *titulo,
+    const Metricas *metricas
+) {
+    static int cabecalhoCSVImpresso = 0;
+
+    switch (formato) {
+        case FORMATO_TEXTO:
+            fprintf(
+                saida,
+                "\nMétricas da %s:\n - Transferências: %llu\n - Comparações: %llu\n - Tempo de execução: %.7f segundos\n",
+                titulo,
+                (unsigned long long)metricas->transferencias,
+                (unsigned long long)metricas->comparacoes,
+                metricas->tempoCPU
+            );
+            if (metricas->consultas > 0 && metricas->tempoReal > 0) {
+                fprintf(
+                    saida,
+                    " - Consultas: %llu\n - Vazão: %.0f consultas/s\n",
+                    (unsigned long long)metricas->consultas,
+                    metricas->consultas / metricas->tempoReal
+                );
+            }
+            break;
+        case FORMATO_JSON:
+            fputs("{\"metodo\":", saida);
+            imprimirTextoJSON(saida, metodo);
+            fputs(",\"arquivo\":", saida);
+            imprimirTextoJSON(saida, arquivo);
+            fputs(",\"fase\":", saida);
+            imprimirTextoJSON(saida, fase);
+            fprintf(
+                saida,
+                ",\"transferencias\":%llu,\"bytes_lidos\":%llu,\"bytes_escritos\":%llu,"
+                "\"chamadas_sistema\":%llu,\"comparacoes\":%llu,\"divisoes\":%llu,"
+                "\"altura\":%llu,\"nos\":%llu,\"consultas\":%llu,\"tempo_real_s\":%.9f,\"tempo_cpu_s\":%.9f,"
+                "\"falhas_pagina_menores\":%ld,\"falhas_pagina_maiores\":%ld,"
+                "\"blocos_lidos\":%ld,\"blocos_escritos\":%ld}\n",
+                (unsigned long long)metricas->transferencias,
+                (unsigned long long)metricas->bytesLidos,
+                (unsigned long long)metricas->bytesEscritos,
+                (unsigned long long)metricas->chamadasSistema,
+                (unsigned long long)metricas->comparacoes,
+                (unsigned long long)metricas->divisoes,
+                (unsigned long long)metricas->altura,
+                (unsigned long long)metricas->numNos,
+                (unsigned long long)metricas->consultas,
+                metricas->tempoReal, metricas->tempoCPU,
+                metricas->falhasPaginaMenores, metricas->falhasPaginaMaiores,
+                metricas->blocosLidos, metricas->blocosEscritos
+            );
+            break;
+        case FORMATO_CSV: {
+            long posicao = ftell(saida);
+
+            if (posicao < 0 ? !cabecalhoCSVImpresso : posicao == 0) {
+                fprintf(
+                    saida,
+                    "metodo,arquivo,fase,transferencias,bytes_lidos,bytes_escritos,chamadas_sistema,"
+                    "comparacoes,divisoes,altura,nos,consultas,tempo_real_s,tempo_cpu_s,"
+                    "falhas_pagina_menores,falhas_pagina_maiores,blocos_lidos,blocos_escritos\n"
+                );
+                cabecalhoCSVImpresso = 1;
+            }
+            imprimirCampoCSV(saida, metodo);
+            fputc(',', saida);
+            imprimirCampoCSV(saida, arquivo);
+            fputc(',', saida);
+            imprimirCampoCSV(saida, fase);
+            fprintf(
+                saida,
+                ",%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%.9f,%.9f,%ld,%ld,%ld,%ld\n",
+                (unsigned long long)metricas->transferencias,
+                (unsigned long long)metricas->bytesLidos,
+                (unsigned long long)metricas->bytesEscritos,
+                (unsigned long long)metricas->chamadasSistema,
+                (unsigned long long)metricas->comparacoes,
+                (unsigned long long)metricas->divisoes,
+                (unsigned long long)metricas->altura,
+                (unsigned long long)metricas->numNos,
+                (unsigned long long)metricas->consultas,
+                metricas->tempoReal, metricas->tempoCPU,
+                metricas->falhasPaginaMenores, metricas->falhasPaginaMaiores,
+                metricas->blocosLidos, metricas->blocosEscritos
+            );
+            break;
+        }
+    }
+}
@@ -0,0 +1,63 @@
+#ifndef METRICAS_H
+#define METRICAS_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <time.h>
+#include <sys/resource.h>
+
+typedef enum {
+    FORMATO_TEXTO, // Texto explicativo, como nas versões anteriores
+    FORMATO_JSON, // Um objeto JSON por linha e por fase
+    FORMATO_CSV // Uma linha CSV por fase, precedida de cabeçalho
+} FormatoMetricas;
+
+/*
+ * Métricas de uma fase (construção, pesquisa ou atualização).
+ *
+ * Uma transferência é a leitura ou escrita lógica de um registro, nó ou entrada de índice
+ * no armazenamento externo; movimentações em memória não contam. As chamadas de sistema
+ * contam cada posicionamento, leitura ou escrita pedida ao arquivo.
+ */
+typedef struct {
+    uint64_t transferencias; // Leituras e escritas lógicas no armazenamento externo
+    uint64_t bytesLidos; // Bytes lidos do armazenamento externo
+    uint64_t bytesEscritos; // Bytes escritos no armazenamento externo
+    uint64_t chamadasSistema; // Posicionamentos, leituras e escritas pedidos ao arquivo
+    uint64_t comparacoes; // Comparações de chaves
+    uint64_t divisoes; // Divisões de nós
+    uint64_t altura; // Altura da estrutura ao final da fase
+    uint64_t numNos; // Número de nós da estrutura ao final da fase
+    uint64_t consultas; // Consultas respondidas na fase (pesquisas em lote)
+
+    double tempoReal; // Tempo decorrido, em segundos
+    double tempoCPU; // Tempo de CPU do processo, em segundos
+    long falhasPaginaMenores; // Falhas de página atendidas sem E/S
+    long falhasPaginaMaiores; // Falhas de página que exigiram E/S
+    long blocosLidos; // Operações de entrada contadas pelo sistema
+    long blocosEscritos; // Operações de saída contadas pelo sistema
+
+    struct timespec inicioReal; // Marcas do início da fase
+    struct timespec inicioCPU;
+    struct rusage inicioUso;
+} Metricas;
+
+void iniciarMetricas(Metricas *metricas);
+void finalizarMetricas(Metricas *metricas);
+void registrarLeitura(Metricas *metricas, size_t bytes);
+void registrarEscrita(Metricas *metricas, size_t bytes);
+void registrarPosicionamento(Metricas *metricas);
+void acumularMetricas(Metricas *destino, const Metricas *origem);
+int interpretarFormatoMetricas(const char *nome, FormatoMetricas *formato);
+void imprimirMetricas(
+    FILE *saida,
+    FormatoMetricas formato,
+    const char *metodo,
+    const char *arquivo,
+    const char *fase,
+    const char *titulo,
+    const Metricas *metricas
+);
+
+#endif // METRICAS_H
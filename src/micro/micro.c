@@ -0,0 +1,420 @@
+#include "micro.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static volatile long sumidouro; // Impede que o compilador descarte os resultados medidos
+
+/**
+ * Busca a posição de chaves sorteadas em uma folha cheia da árvore B*.
+ *
+ * @return Número de operações feitas.
+ */
+static long medirBuscaNo(const CasoMicro *caso) {
+    Chave chaves[ORDEM_ARVORE_BSTAR - 1];
+    int numChaves = ORDEM_ARVORE_BSTAR - 1;
+    for (int i = 0; i < numChaves; i++) {
+        chaves[i] = 2 * i + 1;
+    }
+
+    long soma = 0;
+    for (int passada = 0; passada < PASSADAS_NO_MICRO; passada++) {
+        for (long i = 0; i < CHAVES_MICRO; i++) {
+            soma += encontrarPosicaoInsercao(chaves, numChaves, caso->chaves[i] % (2 * numChaves + 2));
+        }
+    }
+    sumidouro = soma;
+    return PASSADAS_NO_MICRO * CHAVES_MICRO;
+}
+
+/**
+ * Enche uma folha da Árvore B com as chaves na ordem do caso, esvaziando-a quando fica cheia.
+ */
+static long medirInsercaoNoB(const CasoMicro *caso) {
+    NoArvoreB *no = criarNoArvoreB();
+    Metricas metricas = {0};
+    for (int passada = 0; passada < PASSADAS_NO_MICRO; passada++) {
+        for (long i = 0; i < CHAVES_MICRO; i++) {
+            if (no->numChaves == ORDEM_ARVORE_B - 1) {
+                no->numChaves = 0;
+            }
+            inserirNoNaoCheio(no, caso->chaves[i], i, &metricas);
+        }
+    }
+    sumidouro = metricas.comparacoes;
+    free(no);
+    return PASSADAS_NO_MICRO * CHAVES_MICRO;
+}
+
+/**
+ * Enche uma folha da árvore B* com as chaves na ordem do caso, esvaziando-a quando fica cheia.
+ */
+static long medirInsercaoFolhaBStar(const CasoMicro *caso) {
+    NoFolhaArvoreBStar *folha = calloc(1, sizeof(NoFolhaArvoreBStar));
+    Registro reg = {0};
+    Metricas metricas = {0};
+    for (int passada = 0; passada < PASSADAS_NO_MICRO; passada++) {
+        for (long i = 0; i < CHAVES_MICRO; i++) {
+            if (folha->numChaves == ORDEM_ARVORE_BSTAR - 1) {
+                folha->numChaves = 0;
+            }
+            reg.chave = caso->chaves[i];
+            inserirRegistroNoNóFolha(folha, reg, i, &metricas);
+        }
+    }
+    sumidouro = metricas.comparacoes;
+    free(folha);
+    return PASSADAS_NO_MICRO * CHAVES_MICRO;
+}
+
+/**
+ * Divide uma folha cheia da Árvore B sob um pai vazio. Cada operação inclui a cópia da folha
+ * cheia de volta e a liberação do nó criado pela divisão.
+ */
+static long medirDivisaoNoB(const CasoMicro *caso) {
+    NoArvoreB cheio;
+    memset(&cheio, 0, sizeof(cheio));
+    cheio.folha = true;
+    cheio.numChaves = ORDEM_ARVORE_B - 1;
+    for (int i = 0; i < ORDEM_ARVORE_B - 1; i++) {
+        cheio.entradas[i].chave = i + 1;
+        cheio.entradas[i].posicao = i;
+    }
+
+    NoArvoreB *pai = criarNoArvoreB();
+    NoArvoreB *filho = criarNoArvoreB();
+    Metricas metricas = {0};
+    for (int passada = 0; passada < PASSADAS_NO_MICRO; passada++) {
+        for (long i = 0; i < CHAVES_MICRO; i++) {
+            *filho = cheio;
+            pai->numChaves = 0;
+            pai->folha = false;
+            pai->filhos[0] = filho;
+            dividirNo(0, pai, filho, &metricas);
+            free(pai->filhos[1]);
+        }
+    }
+    sumidouro = metricas.divisoes;
+    free(pai);
+    free(filho);
+    return PASSADAS_NO_MICRO * CHAVES_MICRO;
+}
+
+/**
+ * Pesquisa chaves existentes na Árvore B inteira.
+ */
+static long medirBuscaArvoreB(const CasoMicro *caso) {
+    Metricas metricas = {0};
+    long encontradas = 0;
+    for (long i = 0; i < CONSULTAS_MICRO; i++) {
+        encontradas += buscarNoArvoreB(caso->arvoreB, caso->consultas[i], &metricas) != NULL;
+    }
+    if (encontradas != CONSULTAS_MICRO) {
+        fprintf(stderr, "A Árvore B achou %ld de %ld chaves.\n", encontradas, CONSULTAS_MICRO);
+    }
+    sumidouro = encontradas;
+    return CONSULTAS_MICRO;
+}
+
+/**
+ * Pesquisa chaves existentes na árvore B* inteira.
+ */
+static long medirBuscaArvoreBStar(const CasoMicro *caso) {
+    Metricas metricas = {0};
+    long encontradas = 0;
+    for (long i = 0; i < CONSULTAS_MICRO; i++) {
+        encontradas += buscarArvoreBStar(caso->arvoreBStar, caso->consultas[i], NULL, &metricas) != NULL;
+    }
+    if (encontradas != CONSULTAS_MICRO) {
+        fprintf(stderr, "A árvore B* achou %ld de %ld chaves.\n", encontradas, CONSULTAS_MICRO);
+    }
+    sumidouro = encontradas;
+    return CONSULTAS_MICRO;
+}
+
+static int compararTempos(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Mede uma operação várias vezes e guarda a repetição mais rápida, com os contadores de
+ * hardware dela divididos pelo número de operações, e o ruído das repetições: quanto a
+ * mediana fica acima da mais rápida. As repetições vêm depois de uma passada de aquecimento.
+ */
+static void medirOperacao(
+    const char *operacao,
+    int ordem,
+    long (*medir)(const CasoMicro *),
+    const CasoMicro *caso,
+    const char *distribuicao,
+    Contadores *contadores,
+    int repeticoes,
+    ResultadoMicro *resultado
+) {
+    resultado->operacao = operacao;
+    resultado->medir = medir;
+    resultado->distribuicao = distribuicao;
+    resultado->ordem = ordem;
+    resultado->nanossegundos = -1.0;
+    resultado->ruido = 0.0;
+    double *tempos = malloc(repeticoes * sizeof(double));
+
+    // Uma passada de aquecimento, fora da medida, traz os dados ao cache e a frequência do processador ao regime
+    medir(caso);
+    for (int r = 0; r < repeticoes; r++) {
+        struct timespec inicio, fim;
+        uint64_t valores[NUM_CONTADORES];
+        clock_gettime(CLOCK_MONOTONIC, &inicio);
+        iniciarContadores(contadores);
+        long operacoes = medir(caso);
+        pararContadores(contadores, valores);
+        clock_gettime(CLOCK_MONOTONIC, &fim);
+
+        double nanossegundos = ((fim.tv_sec - inicio.tv_sec) * 1e9 + (fim.tv_nsec - inicio.tv_nsec)) / operacoes;
+        if (tempos != NULL) {
+            tempos[r] = nanossegundos;
+        }
+        if (resultado->nanossegundos < 0.0 || nanossegundos < resultado->nanossegundos) {
+            resultado->nanossegundos = nanossegundos;
+            for (int i = 0; i < NUM_CONTADORES; i++) {
+                resultado->contadores[i] = valores[i] == CONTADOR_INDISPONIVEL ? -1.0 : (double)valores[i] / operacoes;
+            }
+        }
+    }
+
+    if (tempos != NULL) {
+        qsort(tempos, repeticoes, sizeof(double), compararTempos);
+        double mediana = repeticoes % 2 == 1 ? tempos[repeticoes / 2] : (tempos[repeticoes / 2 - 1] + tempos[repeticoes / 2]) / 2.0;
+        resultado->ruido = 100.0 * (mediana - resultado->nanossegundos) / resultado->nanossegundos;
+        free(tempos);
+    }
+}
+
+/**
+ * Procura na base a medida da mesma operação, ordem e distribuição.
+ *
+ * @param ruido Ponteiro onde será armazenado o ruído da medida na base, em %.
+ * @return Nanossegundos por operação na base ou -1 se a base não tem a medida.
+ */
+static double procurarBase(FILE *base, const ResultadoMicro *resultado, double *ruido) {
+    char linha[256];
+    rewind(base);
+    while (fgets(linha, sizeof(linha), base) != NULL) {
+        int ordem;
+        char operacao[64], distribuicao[16];
+        double nanossegundos;
+        if (sscanf(linha, "%d,%63[^,],%15[^,],%lf,%lf", &ordem, operacao, distribuicao, &nanossegundos, ruido) == 5 &&
+            ordem == resultado->ordem &&
+            strcmp(operacao, resultado->operacao) == 0 &&
+            strcmp(distribuicao, resultado->distribuicao) == 0) {
+            return nanossegundos;
+        }
+    }
+    return -1.0;
+}
+
+/**
+ * Imprime o valor de um contador por operação ou "n/d" se ele não está disponível.
+ */
+static void imprimirContador(double valor) {
+    if (valor < 0.0) {
+        printf(" %12s", "n/d");
+    } else {
+        printf(" %12.2f", valor);
+    }
+}
+
+/**
+ * Monta as chaves de um caso na ordem de inserção pedida.
+ */
+static void montarChaves(Chave *chaves, const char *distribuicao) {
+    for (long i = 0; i < CHAVES_MICRO; i++) {
+        chaves[i] = (Chave)(2 * i + 1);
+    }
+    if (strcmp(distribuicao, "desc") == 0) {
+        for (long i = 0; i < CHAVES_MICRO / 2; i++) {
+            Chave troca = chaves[i];
+            chaves[i] = chaves[CHAVES_MICRO - 1 - i];
+            chaves[CHAVES_MICRO - 1 - i] = troca;
+        }
+    } else if (strcmp(distribuicao, "rand") == 0) {
+        for (long i = CHAVES_MICRO - 1; i > 0; i--) {
+            long j = rand() % (i + 1);
+            Chave troca = chaves[i];
+            chaves[i] = chaves[j];
+            chaves[j] = troca;
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    // Opções: -r define as repetições; -g acrescenta os resultados a um arquivo CSV (a base);
+    // -b compara com uma base gravada antes e -t define a tolerância, em %, da comparação.
+    // Uma medida só é regressão se piorar mais que a tolerância somada ao maior ruído, o da
+    // medida ou o da base, para que a variação entre execuções não seja tomada por regressão
+    int repeticoes = REPETICOES_MICRO;
+    double tolerancia = TOLERANCIA_MICRO;
+    const char *caminhoSaida = NULL, *caminhoBase = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc || argv[i][0] != '-' || argv[i][1] == '\0' || argv[i][2] != '\0') {
+            fprintf(stderr, "Uso: %s [-r <repetições>] [-g <saída.csv>] [-b <base.csv>] [-t <tolerância %%>]\n", argv[0]);
+            return 1;
+        }
+        switch (argv[i][1]) {
+            case 'r':
+                repeticoes = atoi(argv[++i]) > 0 ? atoi(argv[i]) : REPETICOES_MICRO;
+                break;
+            case 'g':
+                caminhoSaida = argv[++i];
+                break;
+            case 'b':
+                caminhoBase = argv[++i];
+                break;
+            case 't':
+                tolerancia = atof(argv[++i]);
+                break;
+            default:
+                fprintf(stderr, "Opção inválida: %s\n", argv[i]);
+                return 1;
+        }
+    }
+
+    if (caminhoBase != NULL && repeticoes < REPETICOES_MINIMAS_COMPARACAO) {
+        fprintf(stderr, "A comparação com a base usa ao menos %d repetições.\n", REPETICOES_MINIMAS_COMPARACAO);
+        repeticoes = REPETICOES_MINIMAS_COMPARACAO;
+    }
+
+    FILE *base = NULL, *saida = NULL;
+    if (caminhoBase != NULL && !(base = fopen(caminhoBase, "r"))) {
+        perror("Erro ao abrir a base");
+        return 1;
+    }
+    if (caminhoSaida != NULL) {
+        saida = fopen(caminhoSaida, "a");
+        if (!saida) {
+            perror("Erro ao abrir o arquivo de saída");
+            return 1;
+        }
+        if (ftell(saida) == 0) {
+            fprintf(saida, "ordem,operacao,distribuicao,ns_op,ruido_pct,ciclos_op,instrucoes_op,faltas_cache_op,desvios_errados_op\n");
+        }
+    }
+
+    Contadores contadores;
+    int abertos = abrirContadores(&contadores);
+    printf(
+        "Microbenchmarks com Árvore B de ordem %d e B* de ordem %d (melhor de %d repetições; %d de %d contadores de hardware):\n",
+        ORDEM_ARVORE_B,
+        ORDEM_ARVORE_BSTAR,
+        repeticoes,
+        abertos,
+        NUM_CONTADORES
+    );
+    printf(
+        "%-22s %-6s %10s %12s %12s %12s %12s%s\n",
+        "operação",
+        "dist.",
+        "ns/op",
+        "ciclos/op",
+        "instr./op",
+        "faltas/op",
+        "desvios/op",
+        base != NULL ? "  base (ns/op)" : ""
+    );
+
+    const char *distribuicoes[] = {"asc", "desc", "rand"};
+    Chave *chaves = malloc(CHAVES_MICRO * sizeof(Chave));
+    Chave *consultas = malloc(CONSULTAS_MICRO * sizeof(Chave));
+    if (!chaves || !consultas) {
+        perror("Erro ao alocar as chaves");
+        return 1;
+    }
+    srand(1);
+    montarChaves(consultas, "rand");
+
+    int regressoes = 0;
+    for (int d = 0; d < 3; d++) {
+        CasoMicro caso = {distribuicoes[d], chaves, consultas, NULL, NULL};
+        montarChaves(chaves, distribuicoes[d]);
+        Metricas metricas = {0};
+        Registro reg = {0};
+        for (long i = 0; i < CHAVES_MICRO; i++) {
+            caso.arvoreB = inserirNoArvoreB(caso.arvoreB, chaves[i], i, &metricas);
+            reg.chave = chaves[i];
+            caso.arvoreBStar = inserirArvoreBStar(caso.arvoreBStar, reg, i, &metricas);
+        }
+
+        // A divisão não depende da ordem das chaves: só é medida uma vez
+        ResultadoMicro resultados[6];
+        int numResultados = 0;
+        medirOperacao("busca_no_bstar", ORDEM_ARVORE_BSTAR, medirBuscaNo, &caso, caso.distribuicao, &contadores, repeticoes, &resultados[numResultados++]);
+        medirOperacao("insercao_no_b", ORDEM_ARVORE_B, medirInsercaoNoB, &caso, caso.distribuicao, &contadores, repeticoes, &resultados[numResultados++]);
+        medirOperacao("insercao_folha_bstar", ORDEM_ARVORE_BSTAR, medirInsercaoFolhaBStar, &caso, caso.distribuicao, &contadores, repeticoes, &resultados[numResultados++]);
+        if (d == 0) {
+            medirOperacao("divisao_no_b", ORDEM_ARVORE_B, medirDivisaoNoB, &caso, "-", &contadores, repeticoes, &resultados[numResultados++]);
+        }
+        medirOperacao("busca_arvore_b", ORDEM_ARVORE_B, medirBuscaArvoreB, &caso, caso.distribuicao, &contadores, repeticoes, &resultados[numResultados++]);
+        medirOperacao("busca_arvore_bstar", ORDEM_ARVORE_BSTAR, medirBuscaArvoreBStar, &caso, caso.distribuicao, &contadores, repeticoes, &resultados[numResultados++]);
+
+        for (int i = 0; i < numResultados; i++) {
+            ResultadoMicro *r = &resultados[i];
+            double anterior = -1.0, ruidoBase = 0.0, variacao = 0.0;
+            bool regressao = false;
+            if (base != NULL && (anterior = procurarBase(base, r, &ruidoBase)) > 0.0) {
+                // Uma medida acima da tolerância é medida de novo antes de contar como regressão,
+                // pois uma interferência passageira da máquina pode atrasar todas as repetições
+                for (int c = 0; c <= CONFIRMACOES_MICRO; c++) {
+                    if (c > 0) {
+                        ResultadoMicro nova;
+                        medirOperacao(r->operacao, r->ordem, r->medir, &caso, r->distribuicao, &contadores, repeticoes, &nova);
+                        if (nova.nanossegundos < r->nanossegundos) {
+                            *r = nova;
+                        }
+                    }
+                    variacao = 100.0 * (r->nanossegundos - anterior) / anterior;
+                    regressao = variacao > tolerancia + (r->ruido > ruidoBase ? r->ruido : ruidoBase);
+                    if (!regressao) {
+                        break;
+                    }
+                }
+                regressoes += regressao;
+            }
+
+            printf("%-22s %-6s %10.2f", r->operacao, r->distribuicao, r->nanossegundos);
+            for (int c = 0; c < NUM_CONTADORES; c++) {
+                imprimirContador(r->contadores[c]);
+            }
+            if (anterior > 0.0) {
+                printf("  %10.2f (%+.1f%%)%s", anterior, variacao, regressao ? " REGRESSÃO" : "");
+            } else if (base != NULL) {
+                printf("  %10s", "sem base");
+            }
+            printf("\n");
+
+            if (saida != NULL) {
+                fprintf(saida, "%d,%s,%s,%.3f,%.1f", r->ordem, r->operacao, r->distribuicao, r->nanossegundos, r->ruido);
+                for (int c = 0; c < NUM_CONTADORES; c++) {
+                    fprintf(saida, ",%.3f", r->contadores[c]);
+                }
+                fprintf(saida, "\n");
+            }
+        }
+
+        destruirArvoreB(caso.arvoreB);
+        destruirArvoreBStar(caso.arvoreBStar);
+    }
+
+    if (base != NULL) {
+        printf("%d medida(s) acima da tolerância de %.1f%% mais o ruído em relação à base %s.\n", regressoes, tolerancia, caminhoBase);
+        fclose(base);
+    }
+    if (saida != NULL) {
+        fclose(saida);
+    }
+    fecharContadores(&contadores);
+    free(chaves);
+    free(consultas);
+    return regressoes == 0 ? 0 : 1;
+}
@@ -0,0 +1,42 @@
+#ifndef MICRO_H
+#define MICRO_H
+
+#include "../registro/registro.h"
+#include "../arvoreb/arvoreb.h"
+#include "../arvorebstar/arvorebstar.h"
+#include "../contadores/contadores.h"
+
+#define CHAVES_MICRO (1L << 17) // Chaves inseridas nas árvores e nos nós a cada passada
+#define CONSULTAS_MICRO (1L << 17) // Chaves pesquisadas a cada passada
+#define PASSADAS_NO_MICRO 8 // Passadas das operações de nó, mais baratas que as de árvore
+#define REPETICOES_MICRO 11 // Repetições de cada medida; vale a mais rápida
+#define REPETICOES_MINIMAS_COMPARACAO 5 // Repetições usadas, no mínimo, ao comparar com uma base
+#define CONFIRMACOES_MICRO 2 // Novas medidas de uma operação acima da tolerância antes de contá-la como regressão
+#define TOLERANCIA_MICRO 10.0 // Piora, em %, a partir da qual uma medida conta como regressão, somada ao ruído
+
+/*
+ * Microbenchmarks das operações de nó das árvores B e B*, sem E/S: busca da posição em um nó
+ * (encontrarPosicaoInsercao), inserção em nó com espaço (inserirNoNaoCheio e
+ * inserirRegistroNoNóFolha), divisão (dividirNo) e busca na árvore inteira (buscarNoArvoreB e
+ * buscarArvoreBStar). A ordem das árvores é fixada na compilação, então cada ordem é um
+ * executável (make micro compila um para cada valor de ORDENS_MICRO).
+ */
+typedef struct {
+    const char *distribuicao; // Ordem de inserção das chaves: "asc", "desc" ou "rand"
+    const Chave *chaves; // Chaves na ordem de inserção
+    const Chave *consultas; // Chaves existentes, em ordem aleatória
+    NoArvoreB *arvoreB; // Árvore B com todas as chaves, montada por inserções
+    NoArvoreBStar *arvoreBStar; // Árvore B* com todas as chaves, montada por inserções
+} CasoMicro;
+
+typedef struct {
+    const char *operacao;
+    long (*medir)(const CasoMicro *); // Função medida, para medir de novo na confirmação
+    const char *distribuicao;
+    int ordem;
+    double nanossegundos; // Por operação, na repetição mais rápida
+    double ruido; // Distância, em %, da mediana das repetições à mais rápida
+    double contadores[NUM_CONTADORES]; // Por operação, na mesma repetição (negativo se indisponível)
+} ResultadoMicro;
+
+#endif // MICRO_H
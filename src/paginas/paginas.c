@@ -0,0 +1,519 @@
+#include "paginas.h"
+#include "../util/util.h"
+#include "../es/es.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define REGISTROS_BLOCO_CONVERSAO 1024 // Registros de tamanho fixo lidos por vez na conversão
+
+static CabecalhoPagina* cabecalhoPagina(uint8_t *pagina) {
+    return (CabecalhoPagina *)pagina;
+}
+
+static Fenda* fendasPagina(uint8_t *pagina) {
+    return (Fenda *)(pagina + sizeof(CabecalhoPagina));
+}
+
+static void iniciarPagina(uint8_t *pagina) {
+    memset(pagina, 0, TAMANHO_PAGINA);
+    cabecalhoPagina(pagina)->inicioDados = TAMANHO_PAGINA;
+}
+
+/**
+ * Bytes entre o fim do vetor de fendas e o registro mais baixo da página.
+ */
+static size_t espacoContiguo(uint8_t *pagina) {
+    CabecalhoPagina *cabecalho = cabecalhoPagina(pagina);
+    return cabecalho->inicioDados - sizeof(CabecalhoPagina) - cabecalho->numFendas * sizeof(Fenda);
+}
+
+/**
+ * Bytes livres da página, contando os buracos deixados por registros removidos ou encolhidos,
+ * que a compactação junta ao espaço contíguo.
+ */
+static size_t espacoLivre(uint8_t *pagina) {
+    CabecalhoPagina *cabecalho = cabecalhoPagina(pagina);
+    Fenda *fendas = fendasPagina(pagina);
+    size_t ocupado = sizeof(CabecalhoPagina) + cabecalho->numFendas * sizeof(Fenda);
+    for (int i = 0; i < cabecalho->numFendas; i++) {
+        ocupado += fendas[i].tamanho;
+    }
+    return TAMANHO_PAGINA - ocupado;
+}
+
+/**
+ * Move os registros da página para o fim dela, sem buracos entre eles; as fendas, e portanto
+ * os RIDs, não mudam.
+ */
+static void compactarPagina(uint8_t *pagina) {
+    uint8_t copia[TAMANHO_PAGINA];
+    memcpy(copia, pagina, TAMANHO_PAGINA);
+    CabecalhoPagina *cabecalho = cabecalhoPagina(pagina);
+    Fenda *fendas = fendasPagina(pagina);
+    cabecalho->inicioDados = TAMANHO_PAGINA;
+    for (int i = 0; i < cabecalho->numFendas; i++) {
+        if (fendas[i].tamanho > 0) {
+            cabecalho->inicioDados -= fendas[i].tamanho;
+            memcpy(pagina + cabecalho->inicioDados, copia + fendas[i].deslocamento, fendas[i].tamanho);
+            fendas[i].deslocamento = cabecalho->inicioDados;
+        }
+    }
+}
+
+static size_t tamanhoCodificado(const Registro *reg) {
+    return sizeof(Chave) + sizeof(long) + strnlen(reg->dado2, TAMANHO_DADO - 1);
+}
+
+/**
+ * Grava um registro no espaço contíguo da página e aponta a fenda para ele. A fenda pode ser
+ * uma fenda livre do vetor ou a seguinte à última, que é acrescentada.
+ */
+static void colocarRegistro(uint8_t *pagina, int fenda, const Registro *reg, size_t tamanho) {
+    CabecalhoPagina *cabecalho = cabecalhoPagina(pagina);
+    Fenda *fendas = fendasPagina(pagina);
+    if (fenda == cabecalho->numFendas) {
+        cabecalho->numFendas++;
+    }
+    cabecalho->inicioDados -= tamanho;
+    uint8_t *destino = pagina + cabecalho->inicioDados;
+    memcpy(destino, &reg->chave, sizeof(Chave));
+    memcpy(destino + sizeof(Chave), &reg->dado1, sizeof(long));
+    memcpy(destino + sizeof(Chave) + sizeof(long), reg->dado2, tamanho - sizeof(Chave) - sizeof(long));
+    fendas[fenda].deslocamento = cabecalho->inicioDados;
+    fendas[fenda].tamanho = tamanho;
+}
+
+static void decodificarRegistro(uint8_t *pagina, const Fenda *fenda, Registro *reg) {
+    const uint8_t *origem = pagina + fenda->deslocamento;
+    memset(reg, 0, sizeof(Registro));
+    memcpy(&reg->chave, origem, sizeof(Chave));
+    memcpy(&reg->dado1, origem + sizeof(Chave), sizeof(long));
+    memcpy(reg->dado2, origem + sizeof(Chave) + sizeof(long), fenda->tamanho - sizeof(Chave) - sizeof(long));
+}
+
+/**
+ * Aumenta o mapa de espaço livre, se preciso, para que caibam as páginas pedidas.
+ */
+static bool garantirMapaEspaco(ArquivoPaginado *paginado, long paginas) {
+    if (paginas <= paginado->capacidadeEspaco) {
+        return true;
+    }
+    long capacidade = paginado->capacidadeEspaco > 0 ? paginado->capacidadeEspaco : 64;
+    while (capacidade < paginas) {
+        capacidade *= 2;
+    }
+    uint8_t *espaco = realloc(paginado->espaco, capacidade);
+    if (!espaco) {
+        perror("Erro ao alocar o mapa de espaço livre");
+        return false;
+    }
+    paginado->espaco = espaco;
+    paginado->capacidadeEspaco = capacidade;
+    return true;
+}
+
+static bool carregarPagina(ArquivoPaginado *paginado, long numero, Metricas *metricas) {
+    if (numero == paginado->paginaCarregada) {
+        return true;
+    }
+    registrarPosicionamento(metricas);
+    if (fseeko(paginado->arquivo, (off_t)numero * TAMANHO_PAGINA, SEEK_SET) != 0 ||
+        fread(paginado->pagina, TAMANHO_PAGINA, 1, paginado->arquivo) != 1) {
+        perror("Erro ao ler página");
+        paginado->paginaCarregada = -1;
+        return false;
+    }
+    registrarLeitura(metricas, TAMANHO_PAGINA);
+    paginado->paginaCarregada = numero;
+    return true;
+}
+
+/**
+ * Grava a página do buffer no lugar dela e atualiza a sua entrada no mapa de espaço livre.
+ */
+static bool gravarPagina(ArquivoPaginado *paginado, Metricas *metricas) {
+    long numero = paginado->paginaCarregada;
+    if (!garantirMapaEspaco(paginado, numero + 1)) {
+        return false;
+    }
+    size_t livre = espacoLivre(paginado->pagina) / GRANULO_ESPACO;
+    paginado->espaco[numero] = livre > UINT8_MAX ? UINT8_MAX : (uint8_t)livre;
+
+    registrarPosicionamento(metricas);
+    if (fseeko(paginado->arquivo, (off_t)numero * TAMANHO_PAGINA, SEEK_SET) != 0 ||
+        fwrite(paginado->pagina, TAMANHO_PAGINA, 1, paginado->arquivo) != 1) {
+        perror("Erro ao gravar página");
+        return false;
+    }
+    registrarEscrita(metricas, TAMANHO_PAGINA);
+    return true;
+}
+
+static bool gravarMapaEspaco(ArquivoPaginado *paginado) {
+    FILE *arquivo = fopen(paginado->caminhoEspaco, "wb");
+    if (!arquivo) {
+        perror("Erro ao gravar o mapa de espaço livre");
+        return false;
+    }
+    CabecalhoEspaco cabecalho = {paginado->numPaginas, paginado->numRegistros, paginado->alterado};
+    bool gravado = fwrite(&cabecalho, sizeof(cabecalho), 1, arquivo) == 1 &&
+                   (long)fwrite(paginado->espaco, 1, paginado->numPaginas, arquivo) == paginado->numPaginas;
+    return fclose(arquivo) == 0 && gravado;
+}
+
+/**
+ * Tenta carregar o mapa de espaço livre do arquivo auxiliar. O mapa só é aceito se tem uma
+ * entrada para cada página do arquivo paginado.
+ */
+static bool lerMapaEspaco(ArquivoPaginado *paginado) {
+    FILE *arquivo = fopen(paginado->caminhoEspaco, "rb");
+    if (!arquivo) {
+        return false;
+    }
+    fseeko(paginado->arquivo, 0, SEEK_END);
+    long numPaginas = ftello(paginado->arquivo) / TAMANHO_PAGINA;
+
+    CabecalhoEspaco cabecalho;
+    bool valido = fread(&cabecalho, sizeof(cabecalho), 1, arquivo) == 1 &&
+                  cabecalho.numPaginas == numPaginas &&
+                  garantirMapaEspaco(paginado, numPaginas) &&
+                  (long)fread(paginado->espaco, 1, numPaginas, arquivo) == numPaginas;
+    fclose(arquivo);
+
+    if (valido) {
+        paginado->numPaginas = numPaginas;
+        paginado->numRegistros = cabecalho.numRegistros;
+        paginado->alterado = cabecalho.alterado;
+    }
+    return valido;
+}
+
+/**
+ * Marca o arquivo paginado como alterado antes da primeira alteração, gravando a marca no mapa
+ * de espaço livre para que o arquivo não seja convertido de novo por cima dela.
+ */
+static bool marcarAlterado(ArquivoPaginado *paginado) {
+    if (paginado->alterado) {
+        return true;
+    }
+    paginado->alterado = true;
+    return gravarMapaEspaco(paginado);
+}
+
+/**
+ * Converte o arquivo de registros de tamanho fixo em páginas com fendas, com uma leitura
+ * sequencial. Os registros válidos são acomodados na ordem do arquivo; as lápides ficam de fora.
+ */
+static bool converterArquivoPaginado(const char *nomeArquivo, ArquivoPaginado *paginado, Metricas *metricas) {
+    FILE *origem = abrirArquivoDados(nomeArquivo, "rb");
+    Registro *bloco = malloc(REGISTROS_BLOCO_CONVERSAO * sizeof(Registro));
+    if (!origem || !bloco) {
+        perror("Erro ao converter o arquivo em páginas");
+        if (origem) {
+            fclose(origem);
+        }
+        free(bloco);
+        return false;
+    }
+
+    bool convertido = true;
+    long atual = 0;
+    size_t lidos;
+    iniciarPagina(paginado->pagina);
+    paginado->paginaCarregada = 0;
+    while (convertido && (lidos = fread(bloco, sizeof(Registro), REGISTROS_BLOCO_CONVERSAO, origem)) > 0) {
+        metricas->transferencias += lidos;
+        metricas->bytesLidos += lidos * sizeof(Registro);
+        metricas->chamadasSistema++;
+        for (size_t i = 0; convertido && i < lidos; i++) {
+            if (!registroValido(&bloco[i])) {
+                continue;
+            }
+            size_t tamanho = tamanhoCodificado(&bloco[i]);
+            if (espacoContiguo(paginado->pagina) < tamanho + sizeof(Fenda)) {
+                convertido = gravarPagina(paginado, metricas);
+                iniciarPagina(paginado->pagina);
+                paginado->paginaCarregada = ++atual;
+            }
+            colocarRegistro(paginado->pagina, cabecalhoPagina(paginado->pagina)->numFendas, &bloco[i], tamanho);
+            paginado->numRegistros++;
+        }
+    }
+    if (convertido && cabecalhoPagina(paginado->pagina)->numFendas > 0) {
+        convertido = gravarPagina(paginado, metricas);
+        atual++;
+    }
+    paginado->numPaginas = atual;
+
+    free(bloco);
+    fclose(origem);
+    return convertido && fflush(paginado->arquivo) == 0;
+}
+
+/**
+ * Abre o arquivo paginado de um arquivo de registros de tamanho fixo, convertendo-o de novo
+ * quando o arquivo paginado ou o mapa de espaço livre falta ou está desatualizado. Um arquivo
+ * paginado já alterado por inclusões, atualizações ou remoções nunca é convertido de novo, pois
+ * a conversão perderia essas alterações; se o arquivo de tamanho fixo mudou depois dele, as
+ * mudanças deste não chegam ao arquivo paginado e a função avisa.
+ *
+ * @param nomeArquivo Caminho do arquivo de registros de tamanho fixo.
+ * @param metricas Ponteiro para as métricas da construção; só a conversão lê e grava arquivos.
+ * @return Arquivo paginado aberto ou NULL em caso de erro.
+ */
+ArquivoPaginado* abrirArquivoPaginado(const char *nomeArquivo, Metricas *metricas) {
+    ArquivoPaginado *paginado = calloc(1, sizeof(ArquivoPaginado));
+    if (!paginado) {
+        perror("Erro ao alocar o arquivo paginado");
+        return NULL;
+    }
+    char caminhoPaginas[300];
+    snprintf(caminhoPaginas, sizeof(caminhoPaginas), "%s.paginas", nomeArquivo);
+    snprintf(paginado->caminhoEspaco, sizeof(paginado->caminhoEspaco), "%s.espaco", nomeArquivo);
+    paginado->paginaCarregada = -1;
+
+    bool atualizado = auxiliarAtualizado(nomeArquivo, caminhoPaginas) && auxiliarAtualizado(nomeArquivo, paginado->caminhoEspaco);
+    paginado->arquivo = abrirArquivoDados(caminhoPaginas, "r+b");
+    if (paginado->arquivo) {
+        if (lerMapaEspaco(paginado) && (atualizado || paginado->alterado)) {
+            if (!atualizado) {
+                fprintf(stderr, "Aviso: %s foi alterado com -G e não é convertido de novo; as mudanças posteriores de %s não aparecem nele.\n", caminhoPaginas, nomeArquivo);
+            }
+            return paginado;
+        }
+        fclose(paginado->arquivo);
+        paginado->numPaginas = 0;
+        paginado->numRegistros = 0;
+        paginado->alterado = false;
+    }
+
+    paginado->arquivo = abrirArquivoDados(caminhoPaginas, "w+b");
+    if (!paginado->arquivo) {
+        perror("Erro ao criar o arquivo paginado");
+        free(paginado);
+        return NULL;
+    }
+    if (!converterArquivoPaginado(nomeArquivo, paginado, metricas) || !gravarMapaEspaco(paginado)) {
+        fclose(paginado->arquivo);
+        free(paginado->espaco);
+        free(paginado);
+        return NULL;
+    }
+    return paginado;
+}
+
+/**
+ * Carrega a página de um RID e devolve a fenda dele, se estiver ocupada.
+ */
+static Fenda* localizarRid(ArquivoPaginado *paginado, Rid rid, Metricas *metricas) {
+    long numero = PAGINA_RID(rid);
+    int fenda = FENDA_RID(rid);
+    if (rid < 0 || numero >= paginado->numPaginas || !carregarPagina(paginado, numero, metricas)) {
+        return NULL;
+    }
+    Fenda *fendas = fendasPagina(paginado->pagina);
+    if (fenda >= cabecalhoPagina(paginado->pagina)->numFendas || fendas[fenda].tamanho == 0) {
+        return NULL;
+    }
+    return &fendas[fenda];
+}
+
+/**
+ * Lê o registro de um RID, com a leitura de uma página (nenhuma se a página já está no buffer).
+ *
+ * @param paginado Arquivo paginado.
+ * @param rid Página e fenda do registro.
+ * @param reg Ponteiro para o registro onde os dados lidos serão armazenados.
+ * @param metricas Ponteiro para as métricas da fase em andamento.
+ * @return Retorna true se a fenda do RID está ocupada.
+ */
+bool lerRegistroPaginado(ArquivoPaginado *paginado, Rid rid, Registro *reg, Metricas *metricas) {
+    Fenda *fenda = localizarRid(paginado, rid, metricas);
+    if (fenda == NULL) {
+        return false;
+    }
+    decodificarRegistro(paginado->pagina, fenda, reg);
+    return true;
+}
+
+/**
+ * Percorre os registros do arquivo paginado na ordem das páginas e das fendas, lendo cada
+ * página uma única vez.
+ *
+ * @param paginado Arquivo paginado.
+ * @param cursor Posição do percurso; deve começar em RID(0, 0).
+ * @param reg Ponteiro para o próximo registro.
+ * @param rid Ponteiro para o RID do próximo registro.
+ * @param metricas Ponteiro para as métricas da fase em andamento.
+ * @return Retorna true enquanto houver registros.
+ */
+bool proximoRegistroPaginado(ArquivoPaginado *paginado, Rid *cursor, Registro *reg, Rid *rid, Metricas *metricas) {
+    while (PAGINA_RID(*cursor) < paginado->numPaginas) {
+        long numero = PAGINA_RID(*cursor);
+        if (!carregarPagina(paginado, numero, metricas)) {
+            return false;
+        }
+        Fenda *fendas = fendasPagina(paginado->pagina);
+        int numFendas = cabecalhoPagina(paginado->pagina)->numFendas;
+        for (int fenda = FENDA_RID(*cursor); fenda < numFendas; fenda++) {
+            if (fendas[fenda].tamanho > 0) {
+                decodificarRegistro(paginado->pagina, &fendas[fenda], reg);
+                *rid = RID(numero, fenda);
+                *cursor = RID(numero, fenda + 1);
+                return true;
+            }
+        }
+        *cursor = RID(numero + 1, 0);
+    }
+    return false;
+}
+
+/**
+ * Procura no mapa de espaço livre, a partir da página da última inclusão, uma página com
+ * pelo menos os bytes pedidos.
+ *
+ * @return Número da página ou -1 se nenhuma tem espaço.
+ */
+static long procurarPagina(ArquivoPaginado *paginado, size_t necessario) {
+    for (long i = 0; i < paginado->numPaginas; i++) {
+        long numero = (paginado->proximaProcura + i) % paginado->numPaginas;
+        if ((size_t)paginado->espaco[numero] * GRANULO_ESPACO >= necessario) {
+            paginado->proximaProcura = numero;
+            return numero;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Inclui um registro na primeira página, pelo mapa de espaço livre, em que ele cabe, ou em
+ * uma página nova no fim do arquivo.
+ *
+ * @param paginado Arquivo paginado.
+ * @param reg Ponteiro para o registro a incluir.
+ * @param metricas Ponteiro para as métricas da fase em andamento.
+ * @return RID do registro incluído ou -1 em caso de erro.
+ */
+Rid inserirRegistroPaginado(ArquivoPaginado *paginado, const Registro *reg, Metricas *metricas) {
+    if (!marcarAlterado(paginado)) {
+        return -1;
+    }
+    size_t tamanho = tamanhoCodificado(reg);
+    long numero = procurarPagina(paginado, tamanho + sizeof(Fenda));
+    if (numero == -1) {
+        numero = paginado->numPaginas++;
+        iniciarPagina(paginado->pagina);
+        paginado->paginaCarregada = numero;
+    } else if (!carregarPagina(paginado, numero, metricas)) {
+        return -1;
+    }
+
+    CabecalhoPagina *cabecalho = cabecalhoPagina(paginado->pagina);
+    Fenda *fendas = fendasPagina(paginado->pagina);
+    int fenda = 0;
+    while (fenda < cabecalho->numFendas && fendas[fenda].tamanho > 0) {
+        fenda++;
+    }
+    if (espacoContiguo(paginado->pagina) < tamanho + (fenda == cabecalho->numFendas ? sizeof(Fenda) : 0)) {
+        compactarPagina(paginado->pagina);
+    }
+    colocarRegistro(paginado->pagina, fenda, reg, tamanho);
+    if (!gravarPagina(paginado, metricas)) {
+        return -1;
+    }
+    paginado->numRegistros++;
+    return RID(numero, fenda);
+}
+
+/**
+ * Regrava um registro. Ele fica no mesmo RID quando cabe na sua página, mesmo que tenha
+ * crescido; senão é removido dela e incluído em outra, e o RID novo é devolvido.
+ *
+ * @param paginado Arquivo paginado.
+ * @param rid RID do registro.
+ * @param reg Ponteiro para os novos dados do registro.
+ * @param novoRid Ponteiro onde será armazenado o RID do registro depois da regravação.
+ * @param metricas Ponteiro para as métricas da fase em andamento.
+ * @return Retorna true se o registro foi regravado.
+ */
+bool atualizarRegistroPaginado(ArquivoPaginado *paginado, Rid rid, const Registro *reg, Rid *novoRid, Metricas *metricas) {
+    *novoRid = rid;
+    Fenda *fenda = localizarRid(paginado, rid, metricas);
+    if (fenda == NULL || !marcarAlterado(paginado)) {
+        return false;
+    }
+
+    size_t tamanho = tamanhoCodificado(reg);
+    uint16_t anterior = fenda->tamanho;
+    if (tamanho <= anterior) {
+        uint8_t *destino = paginado->pagina + fenda->deslocamento;
+        memcpy(destino, &reg->chave, sizeof(Chave));
+        memcpy(destino + sizeof(Chave), &reg->dado1, sizeof(long));
+        memcpy(destino + sizeof(Chave) + sizeof(long), reg->dado2, tamanho - sizeof(Chave) - sizeof(long));
+        fenda->tamanho = tamanho;
+        return gravarPagina(paginado, metricas);
+    }
+
+    fenda->tamanho = 0;
+    if (espacoLivre(paginado->pagina) >= tamanho) {
+        if (espacoContiguo(paginado->pagina) < tamanho) {
+            compactarPagina(paginado->pagina);
+        }
+        colocarRegistro(paginado->pagina, FENDA_RID(rid), reg, tamanho);
+        return gravarPagina(paginado, metricas);
+    }
+    fenda->tamanho = anterior;
+
+    if (!removerRegistroPaginado(paginado, rid, metricas)) {
+        return false;
+    }
+    *novoRid = inserirRegistroPaginado(paginado, reg, metricas);
+    return *novoRid != -1;
+}
+
+/**
+ * Remove um registro, liberando a sua fenda. As fendas livres do fim do vetor saem dele; as
+ * demais são reaproveitadas pelas inclusões na página.
+ *
+ * @param paginado Arquivo paginado.
+ * @param rid RID do registro.
+ * @param metricas Ponteiro para as métricas da fase em andamento.
+ * @return Retorna true se o registro foi removido.
+ */
+bool removerRegistroPaginado(ArquivoPaginado *paginado, Rid rid, Metricas *metricas) {
+    Fenda *fenda = localizarRid(paginado, rid, metricas);
+    if (fenda == NULL || !marcarAlterado(paginado)) {
+        return false;
+    }
+    fenda->tamanho = 0;
+    fenda->deslocamento = 0;
+
+    CabecalhoPagina *cabecalho = cabecalhoPagina(paginado->pagina);
+    Fenda *fendas = fendasPagina(paginado->pagina);
+    while (cabecalho->numFendas > 0 && fendas[cabecalho->numFendas - 1].tamanho == 0) {
+        cabecalho->numFendas--;
+    }
+    if (cabecalho->numFendas == 0) {
+        cabecalho->inicioDados = TAMANHO_PAGINA;
+    }
+    if (!gravarPagina(paginado, metricas)) {
+        return false;
+    }
+    paginado->numRegistros--;
+    return true;
+}
+
+/**
+ * Grava o mapa de espaço livre e fecha o arquivo paginado.
+ *
+ * @param paginado Arquivo paginado (pode ser NULL).
+ */
+void fecharArquivoPaginado(ArquivoPaginado *paginado) {
+    if (paginado == NULL) {
+        return;
+    }
+    gravarMapaEspaco(paginado);
+    fclose(paginado->arquivo);
+    free(paginado->espaco);
+    free(paginado);
+}
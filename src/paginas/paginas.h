@@ -0,0 +1,73 @@
+#ifndef PAGINAS_H
+#define PAGINAS_H
+
+#include "../registro/registro.h"
+#include "../metricas/metricas.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define TAMANHO_PAGINA 4096 // Bytes de uma página do arquivo paginado
+#define BITS_FENDA 12 // Bits do RID que guardam a fenda; uma página tem menos de 2^12 fendas
+#define GRANULO_ESPACO 16 // Bytes livres representados por uma unidade do mapa de espaço livre
+
+/*
+ * Identificador de registro (RID) no arquivo paginado: a página e a fenda juntas em um long.
+ * As folhas das árvores B e B* guardam o RID no lugar da posição do registro.
+ */
+typedef long Rid;
+#define RID(pagina, fenda) (((Rid)(pagina) << BITS_FENDA) | (Rid)(fenda))
+#define PAGINA_RID(rid) ((long)((rid) >> BITS_FENDA))
+#define FENDA_RID(rid) ((int)((rid) & ((1 << BITS_FENDA) - 1)))
+
+/*
+ * Página com fendas: o cabeçalho e o vetor de fendas crescem a partir do início da página e
+ * os registros, a partir do fim. Cada registro guarda a chave, dado1 e só os caracteres
+ * usados de dado2, sem o terminador; a fenda diz onde ele está e quantos bytes ocupa, de modo
+ * que o registro pode mudar de lugar na página (compactação) sem mudar de RID.
+ */
+typedef struct {
+    uint16_t numFendas; // Fendas do vetor, livres ou ocupadas
+    uint16_t inicioDados; // Deslocamento do registro mais baixo (TAMANHO_PAGINA na página vazia)
+} CabecalhoPagina;
+
+typedef struct {
+    uint16_t deslocamento; // Deslocamento do registro na página
+    uint16_t tamanho; // Bytes do registro (0 para fenda livre)
+} Fenda;
+
+typedef struct {
+    long numPaginas; // Páginas do arquivo paginado
+    long numRegistros; // Registros ocupando fendas
+    bool alterado; // O arquivo paginado recebeu inclusões, atualizações ou remoções depois da conversão
+} CabecalhoEspaco;
+
+/*
+ * Arquivo de registros paginado, gravado ao lado do arquivo de registros de tamanho fixo com
+ * a extensão ".paginas". O mapa de espaço livre (um byte por página com os bytes livres em
+ * unidades de GRANULO_ESPACO) fica em ".espaco" e escolhe a página das inclusões. Os dois
+ * são convertidos de novo a partir do arquivo de tamanho fixo quando ele muda, a menos que o
+ * arquivo paginado já tenha sido alterado: daí em diante ele é o arquivo de registros de -G.
+ */
+typedef struct {
+    FILE *arquivo;
+    char caminhoEspaco[300];
+    uint8_t *espaco; // Mapa de espaço livre
+    long capacidadeEspaco; // Páginas que cabem no mapa alocado
+    long numPaginas;
+    long numRegistros;
+    bool alterado; // Ver CabecalhoEspaco
+    long paginaCarregada; // Página no buffer (-1 para nenhuma)
+    long proximaProcura; // Página em que a próxima procura por espaço livre começa
+    uint8_t pagina[TAMANHO_PAGINA]; // Buffer da última página lida ou gravada
+} ArquivoPaginado;
+
+ArquivoPaginado* abrirArquivoPaginado(const char *nomeArquivo, Metricas *metricas);
+bool lerRegistroPaginado(ArquivoPaginado *paginado, Rid rid, Registro *reg, Metricas *metricas);
+bool proximoRegistroPaginado(ArquivoPaginado *paginado, Rid *cursor, Registro *reg, Rid *rid, Metricas *metricas);
+Rid inserirRegistroPaginado(ArquivoPaginado *paginado, const Registro *reg, Metricas *metricas);
+bool atualizarRegistroPaginado(ArquivoPaginado *paginado, Rid rid, const Registro *reg, Rid *novoRid, Metricas *metricas);
+bool removerRegistroPaginado(ArquivoPaginado *paginado, Rid rid, Metricas *metricas);
+void fecharArquivoPaginado(ArquivoPaginado *paginado);
+
+#endif // PAGINAS_H
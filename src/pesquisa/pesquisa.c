@@ -4,11 +4,571 @@
 #include "../arvore/arvore.h"
 #include "../arvoreb/arvoreb.h"
 #include "../arvorebstar/arvorebstar.h"
+#include "../util/util.h"
+#include "../assincrono/assincrono.h"
+#include "../es/es.h"
+#include "../construcao/construcao.h"
+#include "../arvorebconcorrente/arvorebconcorrente.h"
+#include "../instantaneo/instantaneo.h"
+#include "../arvoreradix/arvoreradix.h"
+#include "../lsm/lsm.h"
+#include "../zonas/zonas.h"
+#include "../varredura/varredura.h"
+#include "../secundario/secundario.h"
+#include "../cache/cache.h"
+#include "../rastro/rastro.h"
+#include "../ajuste/ajuste.h"
+#include "../paginas/paginas.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/stat.h>
 #include <time.h>
 
+/**
+ * Imprime as métricas de uma fase no formato e no destino escolhidos nas opções.
+ *
+ * @param opcoes Opções da pesquisa (formato e arquivo de saída das métricas).
+ * @param metodo Nome do método de pesquisa.
+ * @param nomeArquivo Caminho do arquivo de registros.
+ * @param fase Identificador da fase.
+ * @param titulo Título da fase exibido no formato texto.
+ * @param metricas Ponteiro para as métricas da fase.
+ */
+static void relatarMetricas(
+    const OpcoesPesquisa *opcoes,
+    const char *metodo,
+    const char *nomeArquivo,
+    const char *fase,
+    const char *titulo,
+    const Metricas *metricas
+) {
+    FILE *saida = opcoes->saidaMetricas != NULL ? opcoes->saidaMetricas : stdout;
+    if (opcoes->arquivoMetricas != NULL) {
+        saida = fopen(opcoes->arquivoMetricas, "a");
+        if (!saida) {
+            perror("Erro ao abrir o arquivo de métricas");
+            return;
+        }
+    }
+
+    imprimirMetricas(saida, opcoes->formatoMetricas, metodo, nomeArquivo, fase, titulo, metricas);
+
+    if (opcoes->arquivoMetricas != NULL) {
+        fclose(saida);
+    } else {
+        fflush(saida);
+    }
+}
+
+/**
+ * Imprime as métricas de pesquisa, construção e, se houver operações, de atualização.
+ */
+static void relatarFases(
+    const OpcoesPesquisa *opcoes,
+    const char *metodo,
+    const char *nomeArquivo,
+    const Metricas *pesquisa,
+    const Metricas *construcao,
+    const Metricas *atualizacao
+) {
+    relatarMetricas(opcoes, metodo, nomeArquivo, "pesquisa", "Pesquisa", pesquisa);
+    relatarMetricas(opcoes, metodo, nomeArquivo, "construcao", "Construção do Índice", construcao);
+    if (atualizacao != NULL && opcoes->numOperacoes > 0) {
+        relatarMetricas(opcoes, metodo, nomeArquivo, "atualizacao", "Atualização", atualizacao);
+    }
+}
+
+static int compararChavesLote(const void *a, const void *b) {
+    Chave x = *(const Chave *)a;
+    Chave y = *(const Chave *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Copia as chaves de um lote e as ordena para a pesquisa por junção; a ordenação faz parte
+ * do custo medido da junção.
+ */
+static Chave* ordenarChavesLote(const Chave *chaves, int quantidade) {
+    Chave *ordenadas = malloc(quantidade * sizeof(Chave));
+    if (ordenadas) {
+        memcpy(ordenadas, chaves, quantidade * sizeof(Chave));
+        qsort(ordenadas, quantidade, sizeof(Chave), compararChavesLote);
+    }
+    return ordenadas;
+}
+
+/**
+ * Exibe as ocorrências de uma chave encontradas pela pesquisa de todas as ocorrências, em
+ * ordem de posição no arquivo.
+ */
+static void imprimirOcorrencias(Chave chave, const long *posicoes, const Registro *registros, int encontradas) {
+    int exibidas = encontradas < LIMITE_OCORRENCIAS ? encontradas : LIMITE_OCORRENCIAS;
+    printf("%d ocorrência(s) da chave %" FORMATO_CHAVE, encontradas, chave);
+    if (exibidas < encontradas) {
+        printf(" (exibidas as %d primeiras)", exibidas);
+    }
+    printf(".\n");
+    for (int i = 0; i < exibidas; i++) {
+        if (registroValido(&registros[i])) {
+            printf("Posição %ld: Dado1: %ld Dado2: %.50s...\n", posicoes[i], registros[i].dado1, registros[i].dado2);
+        }
+    }
+}
+
+/**
+ * Conclui a pesquisa de todas as ocorrências de uma chave nos índices que guardam só a
+ * posição dos registros: as posições encontradas na travessia do índice são lidas do arquivo
+ * em ordem crescente, e a leitura entra nas métricas da pesquisa.
+ *
+ * @param arquivo Ponteiro para o arquivo de registros.
+ * @param metodo Nome do método de pesquisa.
+ * @param nomeArquivo Caminho do arquivo de registros.
+ * @param chave Chave pesquisada.
+ * @param posicoes Posições encontradas pelo índice (até LIMITE_OCORRENCIAS).
+ * @param encontradas Número de ocorrências da chave.
+ * @param metricas Métricas da pesquisa, iniciadas antes da travessia do índice.
+ * @param opcoes Opções da pesquisa (saída das métricas).
+ */
+static void relatarOcorrencias(
+    FILE *arquivo,
+    const char *metodo,
+    const char *nomeArquivo,
+    Chave chave,
+    long *posicoes,
+    int encontradas,
+    Metricas *metricas,
+    const OpcoesPesquisa *opcoes
+) {
+    int lidas = encontradas < LIMITE_OCORRENCIAS ? encontradas : LIMITE_OCORRENCIAS;
+    Registro *registros = malloc((lidas > 0 ? lidas : 1) * sizeof(Registro));
+    if (!registros) {
+        perror("Erro ao alocar as ocorrências");
+        return;
+    }
+    lerRegistrosOrdenados(arquivo, posicoes, lidas, registros, metricas);
+    finalizarMetricas(metricas);
+
+    imprimirOcorrencias(chave, posicoes, registros, encontradas);
+    relatarMetricas(opcoes, metodo, nomeArquivo, "todas", "Pesquisa de Todas as Ocorrências", metricas);
+    free(registros);
+}
+
+/**
+ * Aplica as operações de atualização a um arquivo de registros e à Árvore B que o indexa.
+ *
+ * Cada operação localiza o registro pela árvore, altera o arquivo de registros no lugar
+ * (inclusão, regravação ou remoção com lápide) e atualiza a árvore sem reconstruí-la.
+ *
+ * @param arquivo Ponteiro para o arquivo de registros, aberto para leitura e escrita.
+ * @param nomeArquivo Caminho do arquivo de registros.
+ * @param raiz Ponteiro para a raiz da Árvore B.
+ * @param opcoes Opções da pesquisa com as operações a aplicar.
+ * @param metricas Ponteiro para as métricas da atualização.
+ * @return Ponteiro para a raiz atualizada da Árvore B.
+ */
+static NoArvoreB* aplicarOperacoesArvoreB(FILE *arquivo, const char *nomeArquivo, NoArvoreB *raiz, const OpcoesPesquisa *opcoes, Metricas *metricas) {
+    for (int i = 0; i < opcoes->numOperacoes; i++) {
+        const Operacao *op = &opcoes->operacoes[i];
+        Entrada *entrada = buscarNoArvoreB(raiz, op->chave, metricas);
+        Registro reg;
+        long posicao;
+
+        switch (op->tipo) {
+            case OPERACAO_INCLUIR:
+                if (entrada != NULL) {
+                    printf("Chave %" FORMATO_CHAVE " já existe; inclusão ignorada.\n", op->chave);
+                    break;
+                }
+                gerarDadosAleatorios(&reg, op->chave);
+                posicao = incluirRegistro(arquivo, nomeArquivo, &reg, metricas);
+                if (posicao != -1) {
+                    raiz = inserirNoArvoreB(raiz, op->chave, posicao, metricas);
+                }
+                break;
+            case OPERACAO_ATUALIZAR:
+                if (entrada == NULL) {
+                    printf("Chave %" FORMATO_CHAVE " não encontrada; atualização ignorada.\n", op->chave);
+                    break;
+                }
+                gerarDadosAleatorios(&reg, op->chave);
+                atualizarRegistro(arquivo, entrada->posicao, &reg, metricas);
+                break;
+            case OPERACAO_REMOVER:
+                if (entrada == NULL) {
+                    printf("Chave %" FORMATO_CHAVE " não encontrada; remoção ignorada.\n", op->chave);
+                    break;
+                }
+                raiz = removerDaArvoreB(raiz, op->chave, &posicao, metricas);
+                if (posicao != -1) {
+                    removerRegistro(arquivo, nomeArquivo, posicao, metricas);
+                }
+                break;
+        }
+    }
+    return raiz;
+}
+
+/**
+ * Aplica as operações de atualização a um arquivo de registros e à árvore B* que o indexa.
+ *
+ * Funciona como aplicarOperacoesArvoreB, mas também mantém atualizadas as cópias dos
+ * registros guardadas nas folhas da árvore B*.
+ *
+ * @param arquivo Ponteiro para o arquivo de registros, aberto para leitura e escrita.
+ * @param nomeArquivo Caminho do arquivo de registros.
+ * @param raiz Ponteiro para a raiz da árvore B*.
+ * @param opcoes Opções da pesquisa com as operações a aplicar.
+ * @param metricas Ponteiro para as métricas da atualização.
+ * @return Ponteiro para a raiz atualizada da árvore B*.
+ */
+static NoArvoreBStar* aplicarOperacoesArvoreBStar(FILE *arquivo, const char *nomeArquivo, NoArvoreBStar *raiz, const OpcoesPesquisa *opcoes, Metricas *metricas) {
+    for (int i = 0; i < opcoes->numOperacoes; i++) {
+        const Operacao *op = &opcoes->operacoes[i];
+        long posicao;
+        Registro *existente = buscarArvoreBStar(raiz, op->chave, &posicao, metricas);
+        Registro reg;
+
+        switch (op->tipo) {
+            case OPERACAO_INCLUIR:
+                if (existente != NULL) {
+                    printf("Chave %" FORMATO_CHAVE " já existe; inclusão ignorada.\n", op->chave);
+                    break;
+                }
+                gerarDadosAleatorios(&reg, op->chave);
+                posicao = incluirRegistro(arquivo, nomeArquivo, &reg, metricas);
+                if (posicao != -1) {
+                    raiz = inserirArvoreBStar(raiz, reg, posicao, metricas);
+                }
+                break;
+            case OPERACAO_ATUALIZAR:
+                if (existente == NULL) {
+                    printf("Chave %" FORMATO_CHAVE " não encontrada; atualização ignorada.\n", op->chave);
+                    break;
+                }
+                gerarDadosAleatorios(&reg, op->chave);
+                if (atualizarRegistro(arquivo, posicao, &reg, metricas)) {
+                    *existente = reg;
+                }
+                break;
+            case OPERACAO_REMOVER:
+                if (existente == NULL) {
+                    printf("Chave %" FORMATO_CHAVE " não encontrada; remoção ignorada.\n", op->chave);
+                    break;
+                }
+                raiz = removerArvoreBStar(raiz, op->chave, &posicao, metricas);
+                if (posicao != -1) {
+                    removerRegistro(arquivo, nomeArquivo, posicao, metricas);
+                }
+                break;
+        }
+    }
+    return raiz;
+}
+
+/**
+ * Pesquisa um lote de chaves sorteadas por força bruta na coluna de chaves.
+ *
+ * @param arquivo Ponteiro para o arquivo de registros, de onde as chaves são sorteadas.
+ * @param coluna Coluna de chaves do arquivo.
+ * @param nomeArquivo Caminho do arquivo de registros.
+ * @param opcoes Opções da pesquisa (tamanho do lote, threads e saída das métricas).
+ */
+static void pesquisarLoteVarredura(FILE *arquivo, const ColunaChaves *coluna, const char *nomeArquivo, const OpcoesPesquisa *opcoes) {
+    int quantidade = opcoes->tamanhoLote;
+    Chave *chaves = malloc(quantidade * sizeof(Chave));
+    long *posicoes = malloc(quantidade * sizeof(long));
+    Metricas lote;
+
+    sortearChaves(arquivo, chaves, quantidade);
+
+    iniciarMetricas(&lote);
+    buscarLoteColunaChaves(coluna, chaves, quantidade, posicoes, opcoes->numThreads, &lote);
+    lote.consultas = quantidade;
+    finalizarMetricas(&lote);
+
+    int encontradas = 0;
+    for (int i = 0; i < quantidade; i++) {
+        encontradas += posicoes[i] >= 0;
+    }
+    printf("Lote de %d consultas: %d encontradas.\n", quantidade, encontradas);
+
+    relatarMetricas(opcoes, "varredura", nomeArquivo, "lote", "Pesquisa em Lote", &lote);
+
+    free(posicoes);
+    free(chaves);
+}
+
+/**
+ * Pesquisa uma chave sem índice, comparando-a com todas as chaves do arquivo.
+ *
+ * A construção apenas copia as chaves do arquivo para uma coluna contígua em memória; a
+ * pesquisa compara várias chaves por instrução (AVX-512 ou AVX2, conforme o processador) e
+ * pode dividir a coluna entre threads (-T). Serve de referência para saber a partir de
+ * quantas consultas a construção de cada índice compensa.
+ *
+ * @param nomeArquivo Caminho para o arquivo binário onde a pesquisa será realizada.
+ * @param chave Chave do registro a ser pesquisado.
+ * @param opcoes Opções da pesquisa (threads, lote e saída das métricas).
+ */
+void varreduraCompleta(const char *nomeArquivo, Chave chave, const OpcoesPesquisa *opcoes) {
+    FILE *arquivo = abrirArquivoDados(nomeArquivo, "rb");
+    if (!arquivo) {
+        perror("Erro ao abrir o arquivo");
+        return;
+    }
+
+    Metricas construcao, pesquisa;
+    ColunaChaves coluna;
+    Registro reg;
+
+    iniciarMetricas(&construcao);
+    bool extraida = extrairColunaChaves(nomeArquivo, opcoes->numThreads, &coluna, &construcao);
+    finalizarMetricas(&construcao);
+    if (!extraida) {
+        fclose(arquivo);
+        return;
+    }
+    printf("Varredura com instruções %s.\n", instrucoesVarredura());
+
+    iniciarMetricas(&pesquisa);
+    long posicao = buscarColunaChaves(&coluna, chave, opcoes->numThreads, &pesquisa);
+    bool encontrado = posicao >= 0 && lerRegistro(arquivo, posicao, &reg, &pesquisa);
+    finalizarMetricas(&pesquisa);
+
+    if (encontrado) {
+        printf("Registro encontrado!\n");
+        printf("Chave: %" FORMATO_CHAVE "\nDado1: %ld\nDado2: %.50s...\n", reg.chave, reg.dado1, reg.dado2);
+    } else {
+        printf("Registro não encontrado no arquivo.\n");
+    }
+
+    relatarFases(opcoes, "varredura", nomeArquivo, &pesquisa, &construcao, NULL);
+
+    if (opcoes->todasOcorrencias) {
+        long posicoes[LIMITE_OCORRENCIAS];
+        Metricas todas;
+        iniciarMetricas(&todas);
+        int encontradas = buscarTodasColunaChaves(&coluna, chave, posicoes, LIMITE_OCORRENCIAS, &todas);
+        relatarOcorrencias(arquivo, "varredura", nomeArquivo, chave, posicoes, encontradas, &todas, opcoes);
+    }
+
+    if (opcoes->tamanhoLote > 0) {
+        pesquisarLoteVarredura(arquivo, &coluna, nomeArquivo, opcoes);
+    }
+
+    liberarColunaChaves(&coluna);
+    fclose(arquivo);
+}
+
+#define LARGURA_INTERVALO_ZONAS 1000 // Chaves cobertas por cada intervalo do lote com mapa de zonas
+
+/**
+ * Pesquisa um lote de chaves sorteadas com o mapa de zonas: cada chave é buscada sozinha e
+ * como início de um intervalo de LARGURA_INTERVALO_ZONAS chaves cujos registros são contados.
+ * As contagens são conferidas com uma única varredura completa do arquivo.
+ *
+ * @param arquivo Ponteiro para o arquivo de registros.
+ * @param mapa Mapa de zonas do arquivo.
+ * @param nomeArquivo Caminho do arquivo de registros.
+ * @param opcoes Opções da pesquisa (tamanho do lote e saída das métricas).
+ */
+static void pesquisarLoteMapaZonas(FILE *arquivo, const MapaZonas *mapa, const char *nomeArquivo, const OpcoesPesquisa *opcoes) {
+    int quantidade = opcoes->tamanhoLote;
+    Chave *chaves = malloc(quantidade * sizeof(Chave));
+    Chave *maximos = malloc(quantidade * sizeof(Chave));
+    long *contagens = calloc(quantidade, sizeof(long));
+    long *conferencia = calloc(quantidade, sizeof(long));
+    Metricas pontuais, intervalos, varredura;
+    Registro reg;
+
+    sortearChaves(arquivo, chaves, quantidade);
+    for (int i = 0; i < quantidade; i++) {
+        // Limita o fim do intervalo para não estourar o tipo da chave perto de CHAVE_MAXIMA
+        maximos[i] = chaves[i] > CHAVE_MAXIMA - (LARGURA_INTERVALO_ZONAS - 1) ? CHAVE_MAXIMA : chaves[i] + LARGURA_INTERVALO_ZONAS - 1;
+    }
+
+    int encontradas = 0;
+    iniciarMetricas(&pontuais);
+    for (int i = 0; i < quantidade; i++) {
+        encontradas += buscarMapaZonas(arquivo, mapa, chaves[i], &reg, NULL, &pontuais);
+    }
+    pontuais.consultas = quantidade;
+    finalizarMetricas(&pontuais);
+
+    long zonasLidas = 0;
+    iniciarMetricas(&intervalos);
+    for (int i = 0; i < quantidade; i++) {
+        contagens[i] = contarIntervaloMapaZonas(arquivo, mapa, chaves[i], maximos[i], &zonasLidas, &intervalos);
+    }
+    intervalos.consultas = quantidade;
+    finalizarMetricas(&intervalos);
+
+    iniciarMetricas(&varredura);
+    for (long posicao = 0; lerRegistro(arquivo, posicao, &reg, &varredura); posicao++) {
+        if (!registroValido(&reg)) {
+            continue;
+        }
+        for (int i = 0; i < quantidade; i++) {
+            varredura.comparacoes += 2;
+            if (reg.chave >= chaves[i] && reg.chave <= maximos[i]) {
+                conferencia[i]++;
+            }
+        }
+    }
+    varredura.consultas = quantidade;
+    finalizarMetricas(&varredura);
+
+    int divergentes = 0;
+    for (int i = 0; i < quantidade; i++) {
+        divergentes += contagens[i] != conferencia[i];
+    }
+
+    printf(
+        "Lote de %d consultas: %d encontradas; intervalos de %d chaves leram %ld de %ld blocos (%d contagens divergentes da varredura completa).\n",
+        quantidade,
+        encontradas,
+        LARGURA_INTERVALO_ZONAS,
+        zonasLidas,
+        mapa->numZonas * quantidade,
+        divergentes
+    );
+
+    relatarMetricas(opcoes, "sequencial_indexado", nomeArquivo, "lote_zonas", "Pesquisa em Lote com Zonas", &pontuais);
+    relatarMetricas(opcoes, "sequencial_indexado", nomeArquivo, "intervalos_zonas", "Contagem de Intervalos com Zonas", &intervalos);
+    relatarMetricas(opcoes, "sequencial_indexado", nomeArquivo, "intervalos_varredura", "Contagem de Intervalos por Varredura", &varredura);
+
+    free(conferencia);
+    free(contagens);
+    free(maximos);
+    free(chaves);
+}
+
+/**
+ * Pesquisa uma chave com o mapa de zonas do arquivo, que não exige o arquivo em ordem:
+ * só os blocos cuja menor e maior chave envolvem a chave buscada são lidos.
+ *
+ * @param arquivo Ponteiro para o arquivo de registros.
+ * @param nomeArquivo Caminho do arquivo de registros.
+ * @param chave Chave do registro a ser pesquisado.
+ * @param opcoes Opções da pesquisa (tamanho do lote e saída das métricas).
+ */
+static void pesquisarMapaZonas(FILE *arquivo, const char *nomeArquivo, Chave chave, const OpcoesPesquisa *opcoes) {
+    Metricas construcao, pesquisa;
+    MapaZonas mapa;
+    Registro reg;
+    long posicao;
+
+    iniciarMetricas(&construcao);
+    bool carregado = carregarMapaZonas(nomeArquivo, arquivo, &mapa, &construcao);
+    finalizarMetricas(&construcao);
+    if (!carregado) {
+        return;
+    }
+
+    iniciarMetricas(&pesquisa);
+    bool encontrado = buscarMapaZonas(arquivo, &mapa, chave, &reg, &posicao, &pesquisa);
+    finalizarMetricas(&pesquisa);
+
+    if (encontrado) {
+        printf("Registro encontrado!\n");
+        printf("Chave: %" FORMATO_CHAVE "\nDado1: %ld\nDado2: %.50s...\n", reg.chave, reg.dado1, reg.dado2);
+    } else {
+        printf("Registro não encontrado no arquivo.\n");
+    }
+
+    relatarFases(opcoes, "sequencial_indexado", nomeArquivo, &pesquisa, &construcao, NULL);
+
+    if (opcoes->tamanhoLote > 0) {
+        pesquisarLoteMapaZonas(arquivo, &mapa, nomeArquivo, opcoes);
+    }
+
+    liberarMapaZonas(&mapa);
+}
+
+/**
+ * Pesquisa um lote de chaves sorteadas no arquivo ordenado de duas formas: uma a uma, cada
+ * chave com a busca binária no índice esparso e a leitura sequencial a partir da entrada
+ * encontrada, e por junção do lote ordenado com o índice e o arquivo, em uma única passada.
+ *
+ * @param arquivo Ponteiro para o arquivo de registros.
+ * @param indice Índice esparso do arquivo.
+ * @param tamanhoIndice Número de entradas do índice.
+ * @param nomeArquivo Caminho do arquivo de registros.
+ * @param opcoes Opções da pesquisa (tamanho do lote e saída das métricas).
+ */
+static void pesquisarLoteIndice(FILE *arquivo, const Indice *indice, long tamanhoIndice, const char *nomeArquivo, const OpcoesPesquisa *opcoes) {
+    int quantidade = opcoes->tamanhoLote;
+    Chave *chaves = malloc(quantidade * sizeof(Chave));
+    Registro *registros = malloc(quantidade * sizeof(Registro));
+    long *posicoes = malloc(quantidade * sizeof(long));
+    if (!chaves || !registros || !posicoes) {
+        perror("Erro ao alocar o lote");
+        free(chaves);
+        free(registros);
+        free(posicoes);
+        return;
+    }
+    Metricas individual, juncao;
+    Registro reg;
+
+    sortearChaves(arquivo, chaves, quantidade);
+
+    int encontradasIndividual = 0;
+    iniciarMetricas(&individual);
+    for (int i = 0; i < quantidade; i++) {
+        long posicao = buscarIndiceBinario(indice, tamanhoIndice, chaves[i], &individual);
+        while (lerRegistro(arquivo, posicao, &reg, &individual)) {
+            individual.comparacoes++;
+            if (reg.chave == chaves[i]) {
+                encontradasIndividual++;
+                break;
+            }
+            if (reg.chave > chaves[i]) {
+                break;
+            }
+            posicao++;
+        }
+    }
+    individual.consultas = quantidade;
+    finalizarMetricas(&individual);
+
+    iniciarMetricas(&juncao);
+    Chave *ordenadas = ordenarChavesLote(chaves, quantidade);
+    if (!ordenadas) {
+        perror("Erro ao ordenar o lote");
+    }
+    int encontradasJuncao = ordenadas ? juntarLoteIndice(arquivo, indice, tamanhoIndice, ordenadas, quantidade, registros, posicoes, &juncao) : -2;
+    juncao.consultas = quantidade;
+    finalizarMetricas(&juncao);
+
+    if (encontradasJuncao == -1) {
+        printf("O índice não está em ordem crescente; a junção do lote exige o arquivo ordenado.\n");
+    } else if (encontradasJuncao < 0) {
+        printf("A junção do lote não pôde ser feita por falta de memória.\n");
+    } else {
+        printf(
+            "Lote de %d consultas: %d encontradas uma a uma e %d por junção com o índice.\n",
+            quantidade,
+            encontradasIndividual,
+            encontradasJuncao
+        );
+    }
+
+    relatarMetricas(opcoes, "sequencial_indexado", nomeArquivo, "lote_individual", "Pesquisa em Lote Uma a Uma", &individual);
+    if (encontradasJuncao >= 0) {
+        relatarMetricas(opcoes, "sequencial_indexado", nomeArquivo, "lote_juncao", "Pesquisa em Lote por Junção", &juncao);
+    }
+
+    free(ordenadas);
+    free(posicoes);
+    free(registros);
+    free(chaves);
+}
+
 /**
  * Realiza uma pesquisa sequencial indexada em um arquivo binário de registros.
  *
@@ -16,135 +576,1143 @@
  * um registro com a chave especificada. A função também mede o tempo de execução da pesquisa,
  * além de contar o número de transferências de dados e comparações de chaves realizadas.
  *
- * @param nomeArquivo Caminho para o arquivo binário onde a pesquisa será realizada.
+ * @param nomeArquivo Caminho para o arquivo binário onde a pesquisa será realizada.
+ * @param chave Chave do registro a ser pesquisado.
+ * @param opcoes Opções da pesquisa (exibição das chaves, operações e saída das métricas).
+ */
+void acessoSequencialIndexado(const char *nomeArquivo, Chave chave, const OpcoesPesquisa *opcoes) {
+    FILE *arquivo = abrirArquivoDados(nomeArquivo, "rb");
+    if (!arquivo) {
+        perror("Erro ao abrir o arquivo");
+        return;
+    }
+
+    if (opcoes->mapaZonas) {
+        pesquisarMapaZonas(arquivo, nomeArquivo, chave, opcoes);
+        fclose(arquivo);
+        return;
+    }
+
+    Metricas construcao, pesquisa;
+    bool encontrado = false;
+    Registro reg;
+    Indice *indice = NULL;
+
+    // Criando o índice
+    iniciarMetricas(&construcao);
+    long tamanhoIndice = 0; // Número de entradas do índice, que indexa um registro a cada 100
+    bool ordenado = false;
+    if (opcoes->numThreads > 1) {
+        criarIndiceParalelo(nomeArquivo, &indice, &tamanhoIndice, 100, opcoes->numThreads, &ordenado, &construcao);
+    } else {
+        criarIndice(
+            arquivo, 
+            &indice,
+            &tamanhoIndice, 
+            100, 
+            &ordenado,
+            &construcao
+        );
+    }
+    IndiceEytzinger eytzinger = {0};
+    bool usarEytzinger = opcoes->indiceEytzinger && ordenado && montarIndiceEytzinger(indice, tamanhoIndice, &eytzinger);
+    finalizarMetricas(&construcao);
+    if (!ordenado) {
+        // Arquivo decrescente ou com inclusões fora de ordem: o índice não localiza a chave
+        printf("O arquivo não está em ordem crescente; a pesquisa lê o arquivo desde o início.\n");
+    }
+
+    iniciarMetricas(&pesquisa);
+    long posicao = 0;
+    if (usarEytzinger) {
+        posicao = buscarIndiceEytzinger(&eytzinger, chave, &pesquisa);
+    } else if (ordenado) {
+        for (long i = 0; i < tamanhoIndice; i++) {
+            pesquisa.comparacoes++;
+            if (indice[i].chave > chave) {
+                break;
+            }
+            posicao = indice[i].posicao;
+        }
+    }
+
+    while (lerRegistro(arquivo, posicao, &reg, &pesquisa)) {
+        pesquisa.comparacoes++;
+        if (reg.chave == chave) {
+            encontrado = true;
+            printf("Registro encontrado!\n");
+            printf("Chave: %" FORMATO_CHAVE "\nDado1: %ld\nDado2: %.50s...\n", reg.chave, reg.dado1, reg.dado2);
+            break;
+        }
+        posicao++;
+    }
+    finalizarMetricas(&pesquisa);
+
+    // Imprimindo resultados da pesquisa
+    if (!encontrado) {
+        printf("Registro não encontrado no arquivo.\n");
+    }
+
+    relatarFases(opcoes, "sequencial_indexado", nomeArquivo, &pesquisa, &construcao, NULL);
+
+    if (opcoes->tamanhoLote > 0 && ordenado) {
+        pesquisarLoteIndice(arquivo, indice, tamanhoIndice, nomeArquivo, opcoes);
+    } else if (opcoes->tamanhoLote > 0) {
+        printf("O lote com junção exige o arquivo em ordem crescente; use -Z para arquivos fora de ordem.\n");
+    }
+
+    liberarIndiceEytzinger(&eytzinger);
+    free(indice);
+    fclose(arquivo);
+}
+
+
+
+/**
+ * Compara a busca binária no índice esparso ordenado com a busca no mesmo índice na ordem
+ * de Eytzinger, sobre um índice sintético do tamanho pedido.
+ *
+ * As chaves do índice são os ímpares de 1 a 2 * entradas - 1 e as consultas são sorteadas
+ * entre 0 e 2 * entradas, de modo que metade cai entre duas entradas.
+ *
+ * @param entradas Número de entradas do índice.
+ * @param consultas Número de consultas de cada forma.
+ * @return 0 se as duas formas deram os mesmos resultados ou 1 caso contrário.
+ */
+int compararLayoutsIndice(int entradas, int consultas) {
+    Indice *indice = malloc((size_t)entradas * sizeof(Indice));
+    Chave *chaves = malloc((size_t)consultas * sizeof(Chave));
+    long *binaria = malloc((size_t)consultas * sizeof(long));
+    IndiceEytzinger eytzinger;
+    if (!indice || !chaves || !binaria) {
+        perror("Erro ao alocar o índice");
+        free(indice);
+        free(chaves);
+        free(binaria);
+        return 1;
+    }
+
+    for (int i = 0; i < entradas; i++) {
+        indice[i].chave = 2 * i + 1;
+        indice[i].posicao = (long)i * 100;
+    }
+    for (int i = 0; i < consultas; i++) {
+        chaves[i] = (Chave)(((unsigned long)rand() * RAND_MAX + rand()) % (2UL * entradas + 1));
+    }
+
+    Metricas construcao, pesquisaBinaria, pesquisaEytzinger;
+    iniciarMetricas(&construcao);
+    bool montado = montarIndiceEytzinger(indice, entradas, &eytzinger);
+    finalizarMetricas(&construcao);
+    if (!montado) {
+        perror("Erro ao montar o índice na ordem de Eytzinger");
+        free(indice);
+        free(chaves);
+        free(binaria);
+        return 1;
+    }
+
+    iniciarMetricas(&pesquisaBinaria);
+    for (int i = 0; i < consultas; i++) {
+        binaria[i] = buscarIndiceBinario(indice, entradas, chaves[i], &pesquisaBinaria);
+    }
+    pesquisaBinaria.consultas = consultas;
+    finalizarMetricas(&pesquisaBinaria);
+
+    int divergencias = 0;
+    iniciarMetricas(&pesquisaEytzinger);
+    for (int i = 0; i < consultas; i++) {
+        divergencias += buscarIndiceEytzinger(&eytzinger, chaves[i], &pesquisaEytzinger) != binaria[i];
+    }
+    pesquisaEytzinger.consultas = consultas;
+    finalizarMetricas(&pesquisaEytzinger);
+
+    printf("Índice de %d entradas, %d consultas: %d resultado(s) divergente(s).\n", entradas, consultas, divergencias);
+    imprimirMetricas(stdout, FORMATO_TEXTO, "indice", "sintetico", "construcao", "Montagem na Ordem de Eytzinger", &construcao);
+    imprimirMetricas(stdout, FORMATO_TEXTO, "indice", "sintetico", "busca_binaria", "Busca Binária no Vetor Ordenado", &pesquisaBinaria);
+    imprimirMetricas(stdout, FORMATO_TEXTO, "indice", "sintetico", "busca_eytzinger", "Busca na Ordem de Eytzinger", &pesquisaEytzinger);
+
+    liberarIndiceEytzinger(&eytzinger);
+    free(indice);
+    free(chaves);
+    free(binaria);
+    return divergencias == 0 ? 0 : 1;
+}
+
+/**
+ * Testa o armazenamento com arquivos de muitos registros (acima de 2^31) sem ocupar o disco.
+ *
+ * O arquivo é criado esparso com o tamanho de todos os registros, mas só as posições de
+ * amostra são gravadas: igualmente espaçadas, mais a primeira, a última e as vizinhas de 2^31
+ * e 2^32. A chave de cada amostra é a posição + 1, de modo que as amostras ficam em ordem
+ * crescente e formam o índice esparso do arquivo. Cada chave é então pesquisada pelo índice
+ * e lida pela stdio (fseeko) e com pread, conferindo a chave e a posição gravada em dado1.
+ * O arquivo é removido ao final.
+ *
+ * @param caminho Caminho do arquivo de teste.
+ * @param registros Número de registros do arquivo.
+ * @param amostras Número de posições gravadas e pesquisadas.
+ * @return 0 se todas as amostras foram encontradas e conferem ou 1 caso contrário.
+ */
+int testarEscala(const char *caminho, long registros, int amostras) {
+    if (registros > (long)CHAVE_MAXIMA - 1) {
+        fprintf(stderr, "Com chaves de %d bits o arquivo pode ter no máximo %ld registros; compile com make CHAVE=64.\n", (int)(8 * sizeof(Chave)), (long)CHAVE_MAXIMA - 1);
+        return 1;
+    }
+
+    // Posições de amostra em ordem crescente, sem repetições
+    long limites[] = {(1L << 31) - 1, 1L << 31, (1L << 32) - 1, 1L << 32};
+    int capacidade = amostras + 4;
+    Indice *indice = malloc(capacidade * sizeof(Indice));
+    if (!indice) {
+        perror("Erro ao alocar as amostras");
+        return 1;
+    }
+    long tamanhoIndice = 0;
+    int proximoLimite = 0;
+    for (int i = 0; i < amostras; i++) {
+        long posicao = amostras > 1 ? (long)((__int128)(registros - 1) * i / (amostras - 1)) : 0;
+        while (proximoLimite < 4 && limites[proximoLimite] <= posicao) {
+            long limite = limites[proximoLimite++];
+            if (limite < registros && (tamanhoIndice == 0 || indice[tamanhoIndice - 1].posicao < limite)) {
+                indice[tamanhoIndice].posicao = limite;
+                indice[tamanhoIndice++].chave = (Chave)(limite + 1);
+            }
+        }
+        if (tamanhoIndice == 0 || indice[tamanhoIndice - 1].posicao < posicao) {
+            indice[tamanhoIndice].posicao = posicao;
+            indice[tamanhoIndice++].chave = (Chave)(posicao + 1);
+        }
+    }
+
+    int descritor = open(caminho, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (descritor < 0 || ftruncate(descritor, DESLOCAMENTO_REGISTRO(registros)) != 0) {
+        perror("Erro ao criar o arquivo esparso");
+        if (descritor >= 0) {
+            close(descritor);
+            unlink(caminho);
+        }
+        free(indice);
+        return 1;
+    }
+
+    Metricas construcao, pesquisa;
+    Registro reg;
+    iniciarMetricas(&construcao);
+    FILE *arquivo = fdopen(descritor, "r+b");
+    for (long i = 0; arquivo != NULL && i < tamanhoIndice; i++) {
+        memset(&reg, 0, sizeof(Registro));
+        reg.chave = indice[i].chave;
+        reg.dado1 = indice[i].posicao;
+        snprintf(reg.dado2, TAMANHO_DADO, "amostra %ld", indice[i].posicao);
+        registrarPosicionamento(&construcao);
+        escreverRegistro(arquivo, indice[i].posicao, &reg);
+        registrarEscrita(&construcao, sizeof(Registro));
+    }
+    if (arquivo != NULL) {
+        fflush(arquivo);
+    }
+    construcao.numNos = tamanhoIndice;
+    construcao.altura = 1;
+    finalizarMetricas(&construcao);
+
+    int erros = arquivo == NULL ? 1 : 0;
+    iniciarMetricas(&pesquisa);
+    for (long i = 0; arquivo != NULL && i < tamanhoIndice; i++) {
+        Chave chave = indice[i].chave;
+        long posicao = buscarIndiceBinario(indice, tamanhoIndice, chave, &pesquisa);
+        bool lido = lerRegistro(arquivo, posicao, &reg, &pesquisa);
+        pesquisa.comparacoes++;
+        if (!lido || reg.chave != chave || reg.dado1 != posicao) {
+            fprintf(stderr, "Amostra na posição %ld não confere pela stdio.\n", indice[i].posicao);
+            erros++;
+            continue;
+        }
+
+        Registro direto;
+        registrarPosicionamento(&pesquisa);
+        ssize_t lidos = pread(descritor, &direto, sizeof(Registro), DESLOCAMENTO_REGISTRO(posicao));
+        if (lidos == sizeof(Registro)) {
+            registrarLeitura(&pesquisa, sizeof(Registro));
+        }
+        if (lidos != sizeof(Registro) || direto.chave != chave || direto.dado1 != posicao) {
+            fprintf(stderr, "Amostra na posição %ld não confere com pread.\n", indice[i].posicao);
+            erros++;
+        }
+    }
+    pesquisa.consultas = tamanhoIndice;
+    finalizarMetricas(&pesquisa);
+
+    struct stat estado;
+    if (fstat(descritor, &estado) == 0) {
+        printf(
+            "Arquivo de %ld registros (%.1f GiB aparentes, %.1f MiB ocupados), chaves de %d bits: %ld amostras, %d erro(s).\n",
+            registros,
+            (double)estado.st_size / (1 << 30),
+            (double)estado.st_blocks * 512 / (1 << 20),
+            (int)(8 * sizeof(Chave)),
+            tamanhoIndice,
+            erros
+        );
+    }
+    imprimirMetricas(stdout, FORMATO_TEXTO, "escala", caminho, "construcao", "Gravação das Amostras", &construcao);
+    imprimirMetricas(stdout, FORMATO_TEXTO, "escala", caminho, "pesquisa", "Pesquisa das Amostras", &pesquisa);
+
+    if (arquivo != NULL) {
+        fclose(arquivo);
+    } else {
+        close(descritor);
+    }
+    unlink(caminho);
+    free(indice);
+    return erros == 0 ? 0 : 1;
+}
+
+/**
+ * Carrega a chave de cada posição do arquivo de registros. Essas leituras preparam rodadas
+ * de avaliação e não entram nas métricas.
+ *
+ * @param arquivo Ponteiro para o arquivo de registros.
+ * @param totalPosicoes Ponteiro onde será armazenado o número de posições do arquivo.
+ * @return Vetor de chaves, com CHAVE_REMOVIDA nas posições removidas (liberado por quem chama).
+ */
+static Chave* carregarChaves(FILE *arquivo, long *totalPosicoes) {
+    Metricas carga = {0};
+    fseeko(arquivo, 0, SEEK_END);
+    *totalPosicoes = ftello(arquivo) / sizeof(Registro);
+    Chave *chaves = malloc((*totalPosicoes > 0 ? *totalPosicoes : 1) * sizeof(Chave));
+    Registro reg;
+    for (long posicao = 0; chaves != NULL && posicao < *totalPosicoes; posicao++) {
+        chaves[posicao] = lerRegistro(arquivo, posicao, &reg, &carga) ? reg.chave : CHAVE_REMOVIDA;
+    }
+    return chaves;
+}
+
+/**
+ * Avalia a árvore binária com cópia na escrita: um escritor insere a segunda metade do
+ * arquivo enquanto leitores fazem relatórios completos sobre versões fixadas.
+ *
+ * @param arquivo Ponteiro para o arquivo de registros.
+ * @param nomeArquivo Caminho do arquivo de registros.
+ * @param opcoes Opções da pesquisa (número de leitores e saída das métricas).
+ */
+static void avaliarArvoreInstantanea(FILE *arquivo, const char *nomeArquivo, const OpcoesPesquisa *opcoes) {
+    long totalPosicoes;
+    Chave *chaves = carregarChaves(arquivo, &totalPosicoes);
+    if (!chaves) {
+        perror("Erro ao carregar as chaves");
+        return;
+    }
+
+    Metricas escrita, leitura;
+    ResultadoInstantaneo resultado;
+    executarRodadaInstantanea(
+        "src/arvore/arvore_instantanea.bin",
+        chaves,
+        totalPosicoes,
+        opcoes->leitoresInstantaneos,
+        &escrita,
+        &leitura,
+        &resultado
+    );
+
+    printf(
+        "Ingestão com cópia na escrita: %llu inserções, %llu relatórios de %d leitor(es), %llu inconsistentes.\n",
+        (unsigned long long)resultado.insercoes,
+        (unsigned long long)resultado.relatorios,
+        opcoes->leitoresInstantaneos,
+        (unsigned long long)resultado.inconsistencias
+    );
+    printf(
+        "Páginas gravadas: %llu (%llu reaproveitadas); o arquivo terminou com %ld páginas.\n",
+        (unsigned long long)resultado.paginasEscritas,
+        (unsigned long long)resultado.paginasReaproveitadas,
+        resultado.paginasArquivo
+    );
+
+    relatarMetricas(opcoes, "arvore_binaria", nomeArquivo, "instantaneo_escrita", "Ingestão com Cópia na Escrita", &escrita);
+    relatarMetricas(opcoes, "arvore_binaria", nomeArquivo, "instantaneo_leitura", "Leitura de Versões Fixadas", &leitura);
+
+    free(chaves);
+}
+
+/**
+ * Pesquisa um lote de chaves sorteadas na árvore binária em disco, primeiro uma consulta
+ * por vez e depois com o executor assíncrono, e imprime as métricas das duas formas.
+ * O executor lê os arquivos por descritores próprios, abertos no mesmo modo de E/S.
+ *
+ * @param arquivoRegistros Ponteiro para o arquivo de registros.
+ * @param arquivoArvore Ponteiro para o arquivo da árvore binária.
+ * @param posicaoRaiz Posição da raiz da árvore no arquivo.
+ * @param nomeArquivo Caminho do arquivo de registros.
+ * @param opcoes Opções da pesquisa (tamanho do lote e profundidade da fila).
+ */
+static void pesquisarLoteArvoreBinaria(
+    FILE *arquivoRegistros,
+    FILE *arquivoArvore,
+    long posicaoRaiz,
+    const char *nomeArquivo,
+    const OpcoesPesquisa *opcoes
+) {
+    int quantidade = opcoes->tamanhoLote;
+    int profundidade = opcoes->profundidadeFila > 0 ? opcoes->profundidadeFila : PROFUNDIDADE_FILA_PADRAO;
+    Chave *chaves = malloc(quantidade * sizeof(Chave));
+    ResultadoConsulta *resultados = malloc(quantidade * sizeof(ResultadoConsulta));
+    Metricas sincrono, assincrono;
+
+    sortearChaves(arquivoRegistros, chaves, quantidade);
+
+    // Caminho síncrono: cada nível de cada consulta espera sua leitura terminar
+    int encontradasSincrono = 0;
+    iniciarMetricas(&sincrono);
+    for (int i = 0; i < quantidade; i++) {
+        Registro reg;
+        long posicao = buscarNoArvore(arquivoArvore, posicaoRaiz, chaves[i], &sincrono);
+        if (posicao != -1 && lerRegistro(arquivoRegistros, posicao, &reg, &sincrono)) {
+            encontradasSincrono++;
+        }
+    }
+    sincrono.consultas = quantidade;
+    finalizarMetricas(&sincrono);
+
+    // Caminho assíncrono: várias consultas com leituras pendentes ao mesmo tempo
+    size_t alinhamentoArvore, alinhamentoRegistros;
+    int descritorArvore = abrirDescritorDados("src/arvore/arvore.bin", &alinhamentoArvore);
+    int descritorRegistros = abrirDescritorDados(nomeArquivo, &alinhamentoRegistros);
+    if (descritorArvore < 0 || descritorRegistros < 0) {
+        perror("Erro ao abrir os arquivos para a pesquisa assíncrona");
+        if (descritorArvore >= 0) close(descritorArvore);
+        if (descritorRegistros >= 0) close(descritorRegistros);
+        free(resultados);
+        free(chaves);
+        return;
+    }
+
+    iniciarMetricas(&assincrono);
+    TipoMotorES motor = buscarLoteArvoreAssincrono(
+        descritorArvore,
+        descritorRegistros,
+        alinhamentoArvore > alinhamentoRegistros ? alinhamentoArvore : alinhamentoRegistros,
+        posicaoRaiz,
+        chaves,
+        quantidade,
+        profundidade,
+        resultados,
+        &assincrono
+    );
+    assincrono.consultas = quantidade;
+    finalizarMetricas(&assincrono);
+    close(descritorArvore);
+    close(descritorRegistros);
+
+    int encontradasAssincrono = 0;
+    for (int i = 0; i < quantidade; i++) {
+        encontradasAssincrono += resultados[i].encontrado;
+    }
+
+    printf(
+        "Lote de %d consultas: %d encontradas na pesquisa síncrona e %d na assíncrona (%s, profundidade %d).\n",
+        quantidade,
+        encontradasSincrono,
+        encontradasAssincrono,
+        motor == MOTOR_IO_URING ? "io_uring" : "threads com pread",
+        profundidade
+    );
+
+    relatarMetricas(opcoes, "arvore_binaria", nomeArquivo, "lote_sincrono", "Pesquisa em Lote Síncrona", &sincrono);
+    relatarMetricas(opcoes, "arvore_binaria", nomeArquivo, "lote_assincrono", "Pesquisa em Lote Assíncrona", &assincrono);
+
+    free(resultados);
+    free(chaves);
+}
+
+void arvoreBinariaPesquisa(const char *nomeArquivo, Chave chave, const OpcoesPesquisa *opcoes) {
+    FILE *arquivoRegistros = abrirArquivoDados(nomeArquivo, "rb");
+    if (!arquivoRegistros) {
+        perror("Erro ao abrir o arquivo de registros");
+        return;
+    }
+
+    if (opcoes->leitoresInstantaneos > 0) {
+        avaliarArvoreInstantanea(arquivoRegistros, nomeArquivo, opcoes);
+        fclose(arquivoRegistros);
+        return;
+    }
+
+    Metricas construcao, pesquisa;
+    long posicaoRaiz = -1;
+
+    iniciarMetricas(&construcao);
+    construirArvoreBinaria(arquivoRegistros, &construcao, &posicaoRaiz);
+    finalizarMetricas(&construcao);
+
+    FILE *arquivoArvore = abrirArquivoDados("src/arvore/arvore.bin", "rb");
+    if (!arquivoArvore) {
+        perror("Erro ao abrir o arquivo da árvore");
+        fclose(arquivoRegistros);
+        return;
+    }
+
+    if (opcoes->tamanhoLote > 0) {
+        pesquisarLoteArvoreBinaria(arquivoRegistros, arquivoArvore, posicaoRaiz, nomeArquivo, opcoes);
+        relatarMetricas(opcoes, "arvore_binaria", nomeArquivo, "construcao", "Construção do Índice", &construcao);
+        fclose(arquivoRegistros);
+        fclose(arquivoArvore);
+        return;
+    }
+
+    iniciarMetricas(&pesquisa);
+
+    long posicaoEncontrada = buscarNoArvore(arquivoArvore, posicaoRaiz, chave, &pesquisa);
+    Registro resultado;
+    bool registroEncontrado = false;
+
+    if (posicaoEncontrada != -1) {
+        registroEncontrado = lerRegistro(arquivoRegistros, posicaoEncontrada, &resultado, &pesquisa);
+    }
+
+    finalizarMetricas(&pesquisa);
+
+    if (registroEncontrado) {
+        printf("Registro encontrado!\n");
+        printf("Chave: %" FORMATO_CHAVE "\nDado1: %ld\nDado2: %.50s...\n", resultado.chave, resultado.dado1, resultado.dado2);
+    } else {
+        printf("Registro não encontrado no arquivo.\n");
+    }
+
+    relatarFases(opcoes, "arvore_binaria", nomeArquivo, &pesquisa, &construcao, NULL);
+
+    if (opcoes->todasOcorrencias) {
+        long posicoes[LIMITE_OCORRENCIAS];
+        Metricas todas;
+        iniciarMetricas(&todas);
+        int encontradas = buscarTodosArvore(arquivoArvore, posicaoRaiz, chave, posicoes, LIMITE_OCORRENCIAS, &todas);
+        relatarOcorrencias(arquivoRegistros, "arvore_binaria", nomeArquivo, chave, posicoes, encontradas, &todas, opcoes);
+    }
+
+    fclose(arquivoRegistros);
+    fclose(arquivoArvore);
+}
+
+/**
+ * Avalia a Árvore B concorrente com rodadas de inserções e buscas simultâneas.
+ *
+ * As primeiras rodadas têm um escritor e um número crescente de leitores (1, 2, 4, ... até
+ * o número de threads pedido), para medir como a vazão dos leitores escala com um escritor
+ * ativo. A última divide as threads entre escritores e leitores, para exercitar várias
+ * escritas ao mesmo tempo; com até duas threads ela não existe. Cada rodada confere ao final todas as chaves inseridas.
+ *
+ * @param arquivo Ponteiro para o arquivo de registros.
+ * @param nomeArquivo Caminho do arquivo de registros.
+ * @param opcoes Opções da pesquisa (número de threads e saída das métricas).
+ */
+static void avaliarArvoreBConcorrente(FILE *arquivo, const char *nomeArquivo, const OpcoesPesquisa *opcoes) {
+    long totalPosicoes;
+    Chave *chaves = carregarChaves(arquivo, &totalPosicoes);
+    if (!chaves) {
+        perror("Erro ao carregar as chaves");
+        return;
+    }
+
+    int threads = opcoes->threadsConcorrentes;
+    if (threads > MAXIMO_THREADS_CONCORRENTES - 1) {
+        threads = MAXIMO_THREADS_CONCORRENTES - 1;
+    }
+
+    int leitores = 1;
+    while (true) {
+        bool ultima = leitores > threads;
+        int escritores = ultima ? (threads + 1) / 2 : 1;
+        if (ultima && escritores == 1) {
+            break; // Com até duas threads a divisão teria um só escritor e repetiria uma rodada anterior
+        }
+        if (ultima) {
+            leitores = threads - escritores > 0 ? threads - escritores : 1;
+        }
+
+        Metricas rodada;
+        uint64_t insercoes, falhas;
+        executarRodadaConcorrente(chaves, totalPosicoes, leitores, escritores, &rodada, &insercoes, &falhas);
+
+        printf(
+            "Rodada com %d escritor(es) e %d leitor(es): %llu inserções (%.0f/s), %llu buscas (%.0f/s), %llu falhas.\n",
+            escritores,
+            leitores,
+            (unsigned long long)insercoes,
+            rodada.tempoReal > 0 ? insercoes / rodada.tempoReal : 0.0,
+            (unsigned long long)rodada.consultas,
+            rodada.tempoReal > 0 ? rodada.consultas / rodada.tempoReal : 0.0,
+            (unsigned long long)falhas
+        );
+
+        char fase[64], titulo[96];
+        snprintf(fase, sizeof(fase), "concorrente_%de_%dl", escritores, leitores);
+        snprintf(titulo, sizeof(titulo), "Rodada Concorrente (%d escritores, %d leitores)", escritores, leitores);
+        relatarMetricas(opcoes, "arvore_b", nomeArquivo, fase, titulo, &rodada);
+
+        if (ultima) {
+            break;
+        }
+        leitores = leitores < threads && leitores * 2 > threads ? threads : leitores * 2;
+    }
+
+    free(chaves);
+}
+
+/**
+ * Pesquisa um lote de chaves sorteadas na Árvore B em memória, primeiro uma consulta por
+ * vez e depois em grupos que descem a árvore juntos com pré-busca dos nós, e imprime as
+ * métricas das duas formas. Só a descida na árvore é medida; os registros não são lidos.
+ *
+ * @param arquivo Ponteiro para o arquivo de registros, de onde as chaves são sorteadas.
+ * @param variante Variante (tamanho de nó) com que a árvore foi construída.
+ * @param raiz Raiz da Árvore B já construída.
+ * @param metodo Nome do método nas métricas.
+ * @param nomeArquivo Caminho do arquivo de registros.
+ * @param opcoes Opções da pesquisa (tamanho do lote e saída das métricas).
+ */
+static void pesquisarLoteArvoreB(
+    FILE *arquivo,
+    const VarianteArvoreB *variante,
+    void *raiz,
+    const char *metodo,
+    const char *nomeArquivo,
+    const OpcoesPesquisa *opcoes
+) {
+    int quantidade = opcoes->tamanhoLote;
+    Chave *chaves = malloc(quantidade * sizeof(Chave));
+    Entrada **resultados = malloc(quantidade * sizeof(Entrada *));
+    Metricas individual, agrupado;
+
+    sortearChaves(arquivo, chaves, quantidade);
+
+    int encontradasIndividual = 0;
+    iniciarMetricas(&individual);
+    for (int i = 0; i < quantidade; i++) {
+        encontradasIndividual += variante->buscar(raiz, chaves[i], &individual) != NULL;
+    }
+    individual.consultas = quantidade;
+    finalizarMetricas(&individual);
+
+    iniciarMetricas(&agrupado);
+    variante->buscarLote(raiz, chaves, quantidade, resultados, &agrupado);
+    agrupado.consultas = quantidade;
+    finalizarMetricas(&agrupado);
+
+    int encontradasAgrupado = 0;
+    for (int i = 0; i < quantidade; i++) {
+        encontradasAgrupado += resultados[i] != NULL;
+    }
+
+    printf(
+        "Lote de %d consultas: %d encontradas uma a uma e %d em grupos de %d.\n",
+        quantidade,
+        encontradasIndividual,
+        encontradasAgrupado,
+        GRUPO_LOTE_ARVORE_B
+    );
+
+    relatarMetricas(opcoes, metodo, nomeArquivo, "lote_individual", "Pesquisa em Lote Uma a Uma", &individual);
+    relatarMetricas(opcoes, metodo, nomeArquivo, "lote_agrupado", "Pesquisa em Lote Agrupada", &agrupado);
+
+    free(resultados);
+    free(chaves);
+}
+
+static double diferencaMicrossegundos(const struct timespec *inicio, const struct timespec *fim) {
+    return (fim->tv_sec - inicio->tv_sec) * 1e6 + (fim->tv_nsec - inicio->tv_nsec) / 1e3;
+}
+
+static int compararLatencias(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Reproduz as consultas de um rastro na Árvore B: cada uma desce a árvore e lê o registro
+ * no arquivo, a não ser que a cache (se houver) já o tenha.
+ *
+ * @param latencias Onde a latência de cada consulta, em microssegundos, é gravada e ordenada.
+ * @return Número de consultas cujo registro foi encontrado.
+ */
+static long reproduzirConsultasArvoreB(
+    FILE *arquivo,
+    NoArvoreB *raiz,
+    const Chave *chaves,
+    long quantidade,
+    Cache *cache,
+    double *latencias,
+    Metricas *metricas
+) {
+    long encontradas = 0;
+    struct timespec inicio, fim;
+    iniciarMetricas(metricas);
+    for (long i = 0; i < quantidade; i++) {
+        Registro reg;
+        clock_gettime(CLOCK_MONOTONIC, &inicio);
+        bool achado = cache != NULL && consultarCache(cache, chaves[i], &reg);
+        if (!achado) {
+            Entrada *entrada = buscarNoArvoreB(raiz, chaves[i], metricas);
+            achado = entrada != NULL && lerRegistro(arquivo, entrada->posicao, &reg, metricas);
+            if (achado && cache != NULL) {
+                guardarCache(cache, chaves[i], &reg);
+            }
+        }
+        clock_gettime(CLOCK_MONOTONIC, &fim);
+        latencias[i] = diferencaMicrossegundos(&inicio, &fim);
+        encontradas += achado;
+    }
+    metricas->consultas = quantidade;
+    finalizarMetricas(metricas);
+    qsort(latencias, quantidade, sizeof(double), compararLatencias);
+    return encontradas;
+}
+
+/**
+ * Imprime a vazão e os percentis de latência de uma reprodução de rastro.
+ */
+static void imprimirLatenciasRastro(const char *rotulo, long encontradas, long quantidade, const double *latencias, const Metricas *metricas) {
+    printf(
+        "%s: %ld de %ld encontradas; %.0f consultas/s; latência (µs): p50 %.2f, p90 %.2f, p99 %.2f, máxima %.2f.\n",
+        rotulo,
+        encontradas,
+        quantidade,
+        metricas->tempoReal > 0 ? quantidade / metricas->tempoReal : 0.0,
+        latencias[(quantidade - 1) * 50 / 100],
+        latencias[(quantidade - 1) * 90 / 100],
+        latencias[(quantidade - 1) * 99 / 100],
+        latencias[quantidade - 1]
+    );
+}
+
+/**
+ * Reproduz um rastro de consultas na Árvore B sem cache e, se houver orçamento, com a cache
+ * de resultados 2Q, comparando a taxa de acertos, as leituras do arquivo e as latências. Na
+ * comparação, uma reprodução de aquecimento, fora das medidas, vem antes das duas, para que
+ * ambas partam do cache de páginas do sistema e dos nós da árvore já aquecidos.
+ *
+ * @param arquivo Ponteiro para o arquivo de registros.
+ * @param raiz Raiz da Árvore B já construída.
+ * @param nomeArquivo Caminho do arquivo de registros.
+ * @param opcoes Opções da pesquisa (rastro, orçamento da cache e saída das métricas).
+ */
+static void reproduzirRastroArvoreB(FILE *arquivo, NoArvoreB *raiz, const char *nomeArquivo, const OpcoesPesquisa *opcoes) {
+    long quantidade = 0;
+    Chave *chaves = carregarRastro(opcoes->rastro, &quantidade);
+    if (!chaves) {
+        return;
+    }
+    double *latencias = malloc((quantidade > 0 ? quantidade : 1) * sizeof(double));
+    if (quantidade == 0 || !latencias) {
+        fprintf(stderr, "O rastro %s não tem consultas.\n", opcoes->rastro);
+        free(chaves);
+        free(latencias);
+        return;
+    }
+
+    Metricas aquecimento, semCache, comCache;
+    printf("Reprodução do rastro %s (%ld consultas):\n", opcoes->rastro, quantidade);
+    if (opcoes->orcamentoCache > 0) {
+        // Sem o aquecimento, só a reprodução sem cache encontraria o arquivo e os nós frios
+        reproduzirConsultasArvoreB(arquivo, raiz, chaves, quantidade, NULL, latencias, &aquecimento);
+    }
+    long encontradas = reproduzirConsultasArvoreB(arquivo, raiz, chaves, quantidade, NULL, latencias, &semCache);
+    imprimirLatenciasRastro("Sem cache", encontradas, quantidade, latencias, &semCache);
+    relatarMetricas(opcoes, "arvore_b", nomeArquivo, "rastro_sem_cache", "Reprodução do Rastro sem Cache", &semCache);
+
+    Cache cache;
+    if (opcoes->orcamentoCache > 0) {
+        if (!criarCache(&cache, opcoes->orcamentoCache)) {
+            fprintf(stderr, "O orçamento de %zu bytes não comporta a cache.\n", opcoes->orcamentoCache);
+        } else {
+            encontradas = reproduzirConsultasArvoreB(arquivo, raiz, chaves, quantidade, &cache, latencias, &comCache);
+            char rotulo[160];
+            snprintf(
+                rotulo,
+                sizeof(rotulo),
+                "Com cache 2Q de %zu bytes (%d registros, %.1f%% de acertos)",
+                cache.bytes,
+                cache.capacidade,
+                100.0 * cache.acertos / quantidade
+            );
+            imprimirLatenciasRastro(rotulo, encontradas, quantidade, latencias, &comCache);
+            printf(
+                "Cache: %ld acertos, %ld faltas, %ld promoções à lista principal, %ld expulsões.\n",
+                cache.acertos,
+                cache.faltas,
+                cache.promocoes,
+                cache.expulsoes
+            );
+            relatarMetricas(opcoes, "arvore_b", nomeArquivo, "rastro_com_cache", "Reprodução do Rastro com Cache", &comCache);
+            destruirCache(&cache);
+        }
+    }
+
+    free(latencias);
+    free(chaves);
+}
+
+/**
+ * Pesquisa um lote de chaves sorteadas na árvore B* em memória, uma consulta por vez e em
+ * grupos com pré-busca dos nós, como pesquisarLoteArvoreB.
+ *
+ * @param arquivo Ponteiro para o arquivo de registros, de onde as chaves são sorteadas.
+ * @param variante Variante (tamanho de nó) com que a árvore foi construída.
+ * @param raiz Raiz da árvore B* já construída.
+ * @param metodo Nome do método nas métricas.
+ * @param nomeArquivo Caminho do arquivo de registros.
+ * @param opcoes Opções da pesquisa (tamanho do lote e saída das métricas).
+ */
+static void pesquisarLoteArvoreBStar(
+    FILE *arquivo,
+    const VarianteArvoreBStar *variante,
+    void *raiz,
+    const char *metodo,
+    const char *nomeArquivo,
+    const OpcoesPesquisa *opcoes
+) {
+    int quantidade = opcoes->tamanhoLote;
+    Chave *chaves = malloc(quantidade * sizeof(Chave));
+    Registro **resultados = malloc(quantidade * sizeof(Registro *));
+    Metricas individual, agrupado;
+
+    sortearChaves(arquivo, chaves, quantidade);
+
+    int encontradasIndividual = 0;
+    iniciarMetricas(&individual);
+    for (int i = 0; i < quantidade; i++) {
+        encontradasIndividual += variante->buscar(raiz, chaves[i], NULL, &individual) != NULL;
+    }
+    individual.consultas = quantidade;
+    finalizarMetricas(&individual);
+
+    iniciarMetricas(&agrupado);
+    variante->buscarLote(raiz, chaves, quantidade, resultados, NULL, &agrupado);
+    agrupado.consultas = quantidade;
+    finalizarMetricas(&agrupado);
+
+    int encontradasAgrupado = 0;
+    for (int i = 0; i < quantidade; i++) {
+        encontradasAgrupado += resultados[i] != NULL;
+    }
+
+    printf(
+        "Lote de %d consultas: %d encontradas uma a uma e %d em grupos de %d.\n",
+        quantidade,
+        encontradasIndividual,
+        encontradasAgrupado,
+        GRUPO_LOTE_ARVORE_BSTAR
+    );
+
+    relatarMetricas(opcoes, metodo, nomeArquivo, "lote_individual", "Pesquisa em Lote Uma a Uma", &individual);
+    relatarMetricas(opcoes, metodo, nomeArquivo, "lote_agrupado", "Pesquisa em Lote Agrupada", &agrupado);
+
+    if (opcoes->juncaoLote) {
+        Metricas juncao;
+        iniciarMetricas(&juncao);
+        Chave *ordenadas = ordenarChavesLote(chaves, quantidade);
+        if (ordenadas) {
+            variante->juntarLote(raiz, ordenadas, quantidade, resultados, NULL, &juncao);
+        }
+        juncao.consultas = quantidade;
+        finalizarMetricas(&juncao);
+
+        int encontradasJuncao = 0;
+        for (int i = 0; ordenadas && i < quantidade; i++) {
+            encontradasJuncao += resultados[i] != NULL;
+        }
+        printf("Junção do lote ordenado com a lista de folhas: %d encontradas.\n", encontradasJuncao);
+        relatarMetricas(opcoes, metodo, nomeArquivo, "lote_juncao", "Pesquisa em Lote por Junção", &juncao);
+        free(ordenadas);
+    }
+
+    free(resultados);
+    free(chaves);
+}
+
+/**
+ * Constrói, por inserções, a Árvore B de uma variante de tamanho de nó escolhida com -N
+ * (um tamanho, "padrao" ou "auto" para a escolha do ajuste) e pesquisa a chave nela.
+ *
+ * @param arquivo Ponteiro para o arquivo de registros.
+ * @param nomeArquivo Caminho do arquivo de registros.
+ * @param chave Chave do registro a ser pesquisado.
+ * @param opcoes Opções da pesquisa (variante, lote e saída das métricas).
+ */
+static void pesquisarVarianteArvoreB(FILE *arquivo, const char *nomeArquivo, Chave chave, const OpcoesPesquisa *opcoes) {
+    const VarianteArvoreB *variante = escolherVarianteArvoreB(nomeArquivo, opcoes->varianteNo);
+    if (variante == NULL) {
+        return;
+    }
+    char metodo[64];
+    snprintf(metodo, sizeof(metodo), "arvore_b_%s", variante->nome);
+    printf("Árvore B com nós de %s bytes (ordem %d, %zu bytes por nó).\n", variante->nome, variante->ordem, variante->bytesNo);
+
+    void *raiz = NULL;
+    Metricas construcao, pesquisa;
+    Registro reg;
+    long posicao = 0;
+
+    iniciarMetricas(&construcao);
+    while (lerRegistro(arquivo, posicao, &reg, &construcao)) {
+        if (registroValido(&reg)) {
+            raiz = variante->inserir(raiz, reg.chave, posicao, &construcao);
+        }
+        posicao++;
+    }
+    finalizarMetricas(&construcao);
+    variante->medir(raiz, &construcao);
+
+    iniciarMetricas(&pesquisa);
+    Registro resultado;
+    Entrada *entradaEncontrada = variante->buscar(raiz, chave, &pesquisa);
+    bool registroEncontrado = entradaEncontrada != NULL && lerRegistro(arquivo, entradaEncontrada->posicao, &resultado, &pesquisa);
+    finalizarMetricas(&pesquisa);
+
+    if (registroEncontrado) {
+        printf("Registro encontrado!\n");
+        printf("Chave: %" FORMATO_CHAVE "\nDado1: %ld\nDado2: %.50s...\n", resultado.chave, resultado.dado1, resultado.dado2);
+    } else {
+        printf("Registro não encontrado no arquivo.\n");
+    }
+
+    relatarFases(opcoes, metodo, nomeArquivo, &pesquisa, &construcao, NULL);
+
+    if (opcoes->tamanhoLote > 0) {
+        pesquisarLoteArvoreB(arquivo, variante, raiz, metodo, nomeArquivo, opcoes);
+    }
+
+    variante->destruir(raiz);
+}
+
+/**
+ * Constrói, por inserções, a árvore B* de uma variante de tamanho de nó escolhida com -N
+ * e pesquisa a chave nela, como pesquisarVarianteArvoreB.
+ *
+ * @param arquivo Ponteiro para o arquivo de registros.
+ * @param nomeArquivo Caminho do arquivo de registros.
  * @param chave Chave do registro a ser pesquisado.
- * @param exibirChaves Flag para indicar se os detalhes do registro encontrado devem ser exibidos.
+ * @param opcoes Opções da pesquisa (variante, lote e saída das métricas).
  */
-void acessoSequencialIndexado(const char *nomeArquivo, int chave, int exibirChaves) {
-    FILE *arquivo = fopen(nomeArquivo, "rb");
-    if (!arquivo) {
-        perror("Erro ao abrir o arquivo");
+static void pesquisarVarianteArvoreBStar(FILE *arquivo, const char *nomeArquivo, Chave chave, const OpcoesPesquisa *opcoes) {
+    const VarianteArvoreBStar *variante = escolherVarianteArvoreBStar(nomeArquivo, opcoes->varianteNo);
+    if (variante == NULL) {
         return;
     }
+    char metodo[64];
+    snprintf(metodo, sizeof(metodo), "arvore_bstar_%s", variante->nome);
+    printf("Árvore B* com nós de %s bytes (ordem %d, %zu bytes por nó).\n", variante->nome, variante->ordem, variante->bytesNo);
 
-    int transferenciasConstrucao = 0, comparacoesConstrucao = 0;
-    bool encontrado = false;
+    void *raiz = NULL;
+    Metricas construcao, pesquisa;
     Registro reg;
-    Indice *indice = NULL;
-
-    // Criando o índice
-    clock_t inicioConstrucao = clock();
-    int intervaloIndex = 100; // Definindo o intervalo para o índice
-    criarIndice(
-        arquivo, 
-        &indice,
-        &intervaloIndex, 
-        100, 
-        &transferenciasConstrucao, 
-        &comparacoesConstrucao
-    );
-    clock_t fimConstrucao = clock();
-    double tempoExecucaoConstrucao = (double)(fimConstrucao - inicioConstrucao) / CLOCKS_PER_SEC;
-    
-
-    int transferenciasPesquisa = 0, comparacoesPesquisa = 0;
-    clock_t inicioPesquisa = clock();
     long posicao = 0;
-    for (int i = 0; i < intervaloIndex; i++) {
-        if (indice[i].chave > chave) {
-            break;
-        }
-        posicao = indice[i].posicao;
-    }
 
-    while (lerRegistro(arquivo, posicao, &reg, &transferenciasPesquisa)) {
-        comparacoesPesquisa++;
-        if (reg.chave == chave) {
-            encontrado = true;
-            printf("Registro encontrado!\n");
-            printf("Chave: %d\nDado1: %ld\nDado2: %.50s...\n", reg.chave, reg.dado1, reg.dado2);
-            break;
+    iniciarMetricas(&construcao);
+    while (lerRegistro(arquivo, posicao, &reg, &construcao)) {
+        if (registroValido(&reg)) {
+            raiz = variante->inserir(raiz, reg, posicao, &construcao);
         }
         posicao++;
     }
+    finalizarMetricas(&construcao);
+    variante->medir(raiz, &construcao);
 
-    clock_t fimPesquisa = clock();
-    double tempoExecucaoPesquisa = (double)(fimPesquisa - inicioPesquisa) / CLOCKS_PER_SEC;
+    iniciarMetricas(&pesquisa);
+    Registro *resultado = variante->buscar(raiz, chave, NULL, &pesquisa);
+    finalizarMetricas(&pesquisa);
 
-    // Imprimindo resultados da pesquisa
-    if (!encontrado) {
+    if (resultado != NULL) {
+        printf("Registro de chave %" FORMATO_CHAVE " encontrado!\n", resultado->chave);
+        printf("Chave: %" FORMATO_CHAVE "\nDado1: %ld\nDado2: %.50s...\n", resultado->chave, resultado->dado1, resultado->dado2);
+    } else {
         printf("Registro não encontrado no arquivo.\n");
     }
 
+    relatarFases(opcoes, metodo, nomeArquivo, &pesquisa, &construcao, NULL);
+
+    if (opcoes->tamanhoLote > 0) {
+        pesquisarLoteArvoreBStar(arquivo, variante, raiz, metodo, nomeArquivo, opcoes);
+    }
+
+    variante->destruir(raiz);
+}
+
+/**
+ * Compara o tamanho do arquivo paginado com o do arquivo de registros de tamanho fixo.
+ */
+static void imprimirTamanhoPaginado(FILE *arquivo, const ArquivoPaginado *paginado) {
+    fseeko(arquivo, 0, SEEK_END);
+    off_t bytesFixo = ftello(arquivo);
+    off_t bytesPaginado = (off_t)paginado->numPaginas * TAMANHO_PAGINA;
+    long registros = paginado->numRegistros > 0 ? paginado->numRegistros : 1;
     printf(
-        "\nMétricas da Pesquisa:\n - Transferências: %d\n - Comparações: %d\n - Tempo de execução: %.7f segundos\n", 
-        transferenciasPesquisa, 
-        comparacoesPesquisa, 
-        tempoExecucaoPesquisa
-    );
-    printf(
-        "\nMétricas da Construção do Índice:\n - Transferências: %d\n - Comparações: %d\n - Tempo de execução: %.7f segundos\n", 
-        transferenciasConstrucao, 
-        comparacoesConstrucao, 
-        tempoExecucaoConstrucao
+        "Páginas com fendas: %ld registros em %ld páginas, %lld bytes (%.1f por registro); formato fixo: %lld bytes (%zu por registro, %.2fx).\n",
+        paginado->numRegistros,
+        paginado->numPaginas,
+        (long long)bytesPaginado,
+        (double)bytesPaginado / registros,
+        (long long)bytesFixo,
+        sizeof(Registro),
+        bytesPaginado > 0 ? (double)bytesFixo / bytesPaginado : 0.0
     );
+}
 
-    fclose(arquivo);
+/**
+ * Aplica as operações de atualização ao arquivo paginado e à Árvore B que guarda os RIDs.
+ * As inclusões usam o mapa de espaço livre; uma regravação que não cabe na página do
+ * registro o muda de página, e a entrada da árvore passa a apontar para o RID novo.
+ */
+static NoArvoreB* aplicarOperacoesPaginadas(ArquivoPaginado *paginado, NoArvoreB *raiz, const OpcoesPesquisa *opcoes, Metricas *metricas) {
+    for (int i = 0; i < opcoes->numOperacoes; i++) {
+        const Operacao *op = &opcoes->operacoes[i];
+        Entrada *entrada = buscarNoArvoreB(raiz, op->chave, metricas);
+        Registro reg;
+        long posicao;
+        Rid rid;
+
+        switch (op->tipo) {
+            case OPERACAO_INCLUIR:
+                if (entrada != NULL) {
+                    printf("Chave %" FORMATO_CHAVE " já existe; inclusão ignorada.\n", op->chave);
+                    break;
+                }
+                gerarDadosAleatorios(&reg, op->chave);
+                rid = inserirRegistroPaginado(paginado, &reg, metricas);
+                if (rid != -1) {
+                    raiz = inserirNoArvoreB(raiz, op->chave, rid, metricas);
+                }
+                break;
+            case OPERACAO_ATUALIZAR:
+                if (entrada == NULL) {
+                    printf("Chave %" FORMATO_CHAVE " não encontrada; atualização ignorada.\n", op->chave);
+                    break;
+                }
+                gerarDadosAleatorios(&reg, op->chave);
+                if (atualizarRegistroPaginado(paginado, entrada->posicao, &reg, &rid, metricas)) {
+                    entrada->posicao = rid;
+                }
+                break;
+            case OPERACAO_REMOVER:
+                if (entrada == NULL) {
+                    printf("Chave %" FORMATO_CHAVE " não encontrada; remoção ignorada.\n", op->chave);
+                    break;
+                }
+                raiz = removerDaArvoreB(raiz, op->chave, &posicao, metricas);
+                if (posicao != -1) {
+                    removerRegistroPaginado(paginado, posicao, metricas);
+                }
+                break;
+        }
+    }
+    return raiz;
 }
 
+/**
+ * Pesquisa pela Árvore B sobre o arquivo paginado (-G): a árvore é construída com uma leitura
+ * das páginas, guarda o RID (página e fenda) de cada registro e a pesquisa lê uma página.
+ *
+ * @param arquivo Ponteiro para o arquivo de registros de tamanho fixo.
+ * @param nomeArquivo Caminho do arquivo de registros de tamanho fixo.
+ * @param chave Chave do registro a ser pesquisado.
+ * @param opcoes Opções da pesquisa (operações, lote e saída das métricas).
+ */
+static void pesquisarPaginasArvoreB(FILE *arquivo, const char *nomeArquivo, Chave chave, const OpcoesPesquisa *opcoes) {
+    NoArvoreB *raiz = NULL;
+    Metricas construcao, atualizacao, pesquisa;
+    Registro reg;
+    Rid cursor = RID(0, 0), rid;
 
-void arvoreBinariaPesquisa(const char *nomeArquivo, int chave, int exibirChaves) {
-    FILE *arquivoRegistros = fopen(nomeArquivo, "rb");
-    if (!arquivoRegistros) {
-        perror("Erro ao abrir o arquivo de registros");
+    iniciarMetricas(&construcao);
+    ArquivoPaginado *paginado = abrirArquivoPaginado(nomeArquivo, &construcao);
+    if (paginado == NULL) {
         return;
     }
+    while (proximoRegistroPaginado(paginado, &cursor, &reg, &rid, &construcao)) {
+        raiz = inserirNoArvoreB(raiz, reg.chave, rid, &construcao);
+    }
+    finalizarMetricas(&construcao);
+    medirArvoreB(raiz, &construcao);
 
-    int transferenciasConstrucao = 0;
-    int comparacoesConstrucao = 0;
-    long posicaoRaiz = -1;
+    iniciarMetricas(&atualizacao);
+    raiz = aplicarOperacoesPaginadas(paginado, raiz, opcoes, &atualizacao);
+    finalizarMetricas(&atualizacao);
+    medirArvoreB(raiz, &atualizacao);
+    imprimirTamanhoPaginado(arquivo, paginado);
 
-    clock_t inicioConstrucao = clock();
-    construirArvoreBinaria(arquivoRegistros, &transferenciasConstrucao, &comparacoesConstrucao, &posicaoRaiz);
-    clock_t fimConstrucao = clock();
-    double tempoExecucaoConstrucao = (double)(fimConstrucao - inicioConstrucao) / CLOCKS_PER_SEC;
+    iniciarMetricas(&pesquisa);
+    Registro resultado;
+    Entrada *entradaEncontrada = buscarNoArvoreB(raiz, chave, &pesquisa);
+    bool registroEncontrado = entradaEncontrada != NULL && lerRegistroPaginado(paginado, entradaEncontrada->posicao, &resultado, &pesquisa);
+    finalizarMetricas(&pesquisa);
 
-    FILE *arquivoArvore = fopen("src/arvore/arvore.bin", "rb");
-    if (!arquivoArvore) {
-        perror("Erro ao abrir o arquivo da árvore");
-        fclose(arquivoRegistros);
-        return;
+    if (registroEncontrado) {
+        printf("Registro encontrado!\n");
+        printf("Chave: %" FORMATO_CHAVE "\nDado1: %ld\nDado2: %.50s...\n", resultado.chave, resultado.dado1, resultado.dado2);
+    } else {
+        printf("Registro não encontrado no arquivo.\n");
     }
 
-    int transferenciasPesquisa = 0;
-    int comparacoesPesquisa = 0;
-    clock_t inicioPesquisa = clock();
+    relatarFases(opcoes, "arvore_b_paginas", nomeArquivo, &pesquisa, &construcao, &atualizacao);
 
-    long posicaoEncontrada = buscarNoArvore(arquivoArvore, posicaoRaiz, chave, &transferenciasPesquisa, &comparacoesPesquisa);
-    Registro resultado;
-    bool registroEncontrado = false;
+    if (opcoes->tamanhoLote > 0) {
+        VarianteArvoreB padrao;
+        descreverVarianteArvoreB(&padrao);
+        pesquisarLoteArvoreB(arquivo, &padrao, raiz, "arvore_b_paginas", nomeArquivo, opcoes);
+    }
 
-    if (posicaoEncontrada != -1) {
-        registroEncontrado = lerRegistro(arquivoRegistros, posicaoEncontrada, &resultado, &transferenciasPesquisa);
+    fecharArquivoPaginado(paginado);
+    destruirArvoreB(raiz);
+}
+
+/**
+ * Pesquisa pela árvore B* sobre o arquivo paginado (-G): as folhas guardam, com cada
+ * registro, o seu RID no lugar da posição no arquivo de tamanho fixo.
+ *
+ * @param arquivo Ponteiro para o arquivo de registros de tamanho fixo.
+ * @param nomeArquivo Caminho do arquivo de registros de tamanho fixo.
+ * @param chave Chave do registro a ser pesquisado.
+ * @param opcoes Opções da pesquisa (lote e saída das métricas).
+ */
+static void pesquisarPaginasArvoreBStar(FILE *arquivo, const char *nomeArquivo, Chave chave, const OpcoesPesquisa *opcoes) {
+    NoArvoreBStar *raiz = NULL;
+    Metricas construcao, pesquisa;
+    Registro reg;
+    Rid cursor = RID(0, 0), rid;
+
+    iniciarMetricas(&construcao);
+    ArquivoPaginado *paginado = abrirArquivoPaginado(nomeArquivo, &construcao);
+    if (paginado == NULL) {
+        return;
     }
+    while (proximoRegistroPaginado(paginado, &cursor, &reg, &rid, &construcao)) {
+        raiz = inserirArvoreBStar(raiz, reg, rid, &construcao);
+    }
+    finalizarMetricas(&construcao);
+    medirArvoreBStar(raiz, &construcao);
+    imprimirTamanhoPaginado(arquivo, paginado);
 
-    clock_t fimPesquisa = clock();
-    double tempoExecucaoPesquisa = (double)(fimPesquisa - inicioPesquisa) / CLOCKS_PER_SEC;
+    iniciarMetricas(&pesquisa);
+    Registro *resultado = buscarArvoreBStar(raiz, chave, &rid, &pesquisa);
+    finalizarMetricas(&pesquisa);
 
-    if (registroEncontrado) {
-        printf("Registro encontrado!\n");
-        printf("Chave: %d\nDado1: %ld\nDado2: %.50s...\n", resultado.chave, resultado.dado1, resultado.dado2);
+    if (resultado != NULL) {
+        printf("Registro de chave %" FORMATO_CHAVE " encontrado na página %ld, fenda %d!\n", resultado->chave, PAGINA_RID(rid), FENDA_RID(rid));
+        printf("Chave: %" FORMATO_CHAVE "\nDado1: %ld\nDado2: %.50s...\n", resultado->chave, resultado->dado1, resultado->dado2);
     } else {
         printf("Registro não encontrado no arquivo.\n");
     }
 
-    printf("\nMétricas da Pesquisa:\n - Transferências: %d\n - Comparações: %d\n - Tempo de execução: %.7f segundos\n", 
-        transferenciasPesquisa, comparacoesPesquisa, tempoExecucaoPesquisa);
-    printf("\nMétricas da Construção do Índice:\n - Transferências: %d\n - Comparações: %d\n - Tempo de execução: %.7f segundos\n", 
-        transferenciasConstrucao, comparacoesConstrucao, tempoExecucaoConstrucao);
+    relatarFases(opcoes, "arvore_bstar_paginas", nomeArquivo, &pesquisa, &construcao, NULL);
 
-    fclose(arquivoRegistros);
-    fclose(arquivoArvore);
+    if (opcoes->tamanhoLote > 0) {
+        VarianteArvoreBStar padrao;
+        descreverVarianteArvoreBStar(&padrao);
+        pesquisarLoteArvoreBStar(arquivo, &padrao, raiz, "arvore_bstar_paginas", nomeArquivo, opcoes);
+    }
+
+    fecharArquivoPaginado(paginado);
+    destruirArvoreBStar(raiz);
 }
 
 /**
@@ -156,65 +1724,101 @@ void arvoreBinariaPesquisa(const char *nomeArquivo, int chave, int exibirChaves)
  *
  * @param nomeArquivo Caminho para o arquivo binário de onde os registros são lidos.
  * @param chave Chave do registro a ser pesquisado.
- * @param exibirChaves Flag para indicar se os detalhes do registro encontrado devem ser exibidos.
+ * @param opcoes Opções da pesquisa (exibição das chaves, operações e saída das métricas).
  */
-void arvoreB(const char *nomeArquivo, int chave, int exibirChaves) {
-    FILE *arquivo = fopen(nomeArquivo, "rb");
+void arvoreB(const char *nomeArquivo, Chave chave, const OpcoesPesquisa *opcoes) {
+    FILE *arquivo = abrirArquivoDados(nomeArquivo, opcoes->numOperacoes > 0 ? "r+b" : "rb");
     if (!arquivo) {
         perror("Erro ao abrir o arquivo");
         return;
     }
 
+    if (opcoes->threadsConcorrentes > 0) {
+        avaliarArvoreBConcorrente(arquivo, nomeArquivo, opcoes);
+        fclose(arquivo);
+        return;
+    }
+
+    if (opcoes->varianteNo != NULL) {
+        pesquisarVarianteArvoreB(arquivo, nomeArquivo, chave, opcoes);
+        fclose(arquivo);
+        return;
+    }
+
+    if (opcoes->paginas) {
+        pesquisarPaginasArvoreB(arquivo, nomeArquivo, chave, opcoes);
+        fclose(arquivo);
+        return;
+    }
+
     NoArvoreB *raiz = NULL;
-    int transferenciasConstrucao = 0, comparacoesConstrucao = 0;
+    Metricas construcao, atualizacao, pesquisa;
     long posicao = 0;
 
     // Início da construção da árvore
     Registro reg;
-    clock_t inicioConstrucao = clock();
-    while (lerRegistro(arquivo, posicao, &reg, &transferenciasConstrucao)) {
-        raiz = inserirNoArvoreB(raiz, reg.chave, posicao, &transferenciasConstrucao, &comparacoesConstrucao);
-        posicao++;
+    iniciarMetricas(&construcao);
+    if (opcoes->numThreads > 1) {
+        raiz = construirArvoreBParalela(nomeArquivo, opcoes->numThreads, &construcao);
+    } else if (opcoes->construcaoEncadeada) {
+        raiz = construirArvoreBEncadeada(nomeArquivo, &construcao);
+    } else {
+        while (lerRegistro(arquivo, posicao, &reg, &construcao)) {
+            if (registroValido(&reg)) {
+                raiz = inserirNoArvoreB(raiz, reg.chave, posicao, &construcao);
+            }
+            posicao++;
+        }
     }
-    clock_t fimConstrucao = clock();
-    double tempoExecucaoConstrucao = (double)(fimConstrucao - inicioConstrucao) / CLOCKS_PER_SEC;
+    finalizarMetricas(&construcao);
+    medirArvoreB(raiz, &construcao);
+
+    // Atualizações incrementais sobre a árvore já construída
+    iniciarMetricas(&atualizacao);
+    raiz = aplicarOperacoesArvoreB(arquivo, nomeArquivo, raiz, opcoes, &atualizacao);
+    finalizarMetricas(&atualizacao);
+    medirArvoreB(raiz, &atualizacao);
 
     // Início da pesquisa
-    int transferenciasPesquisa = 0; 
-    int comparacoesPesquisa = 0;    
-    clock_t inicioPesquisa = clock();
+    iniciarMetricas(&pesquisa);
 
     Registro resultado;
-    Entrada *entradaEncontrada = buscarNoArvoreB(raiz, chave, &transferenciasPesquisa, &comparacoesPesquisa);
+    Entrada *entradaEncontrada = buscarNoArvoreB(raiz, chave, &pesquisa);
     bool registroEncontrado = false;
     
     if(entradaEncontrada != NULL){
-        registroEncontrado = lerRegistro(arquivo, entradaEncontrada->posicao, &resultado, &transferenciasPesquisa);
+        registroEncontrado = lerRegistro(arquivo, entradaEncontrada->posicao, &resultado, &pesquisa);
     } 
     
-    clock_t fimPesquisa = clock();
-    double tempoExecucaoPesquisa = (double)(fimPesquisa - inicioPesquisa) / CLOCKS_PER_SEC;
+    finalizarMetricas(&pesquisa);
 
     // Imprimindo o resultado da pesquisa
     if (registroEncontrado) {
         printf("Registro encontrado!\n");
-        printf("Chave: %d\nDado1: %ld\nDado2: %.50s...\n", resultado.chave, resultado.dado1, resultado.dado2);
+        printf("Chave: %" FORMATO_CHAVE "\nDado1: %ld\nDado2: %.50s...\n", resultado.chave, resultado.dado1, resultado.dado2);
     } else {
         printf("Registro não encontrado no arquivo.\n");
     }
 
-    printf(
-        "\nMétricas da Pesquisa:\n - Transferências: %d\n - Comparações: %d\n - Tempo de execução: %.7f segundos\n", 
-        transferenciasPesquisa, 
-        comparacoesPesquisa, 
-        tempoExecucaoPesquisa
-    );
-    printf(
-        "\nMétricas da Construção do Índice:\n - Transferências: %d\n - Comparações: %d\n - Tempo de execução: %.7f segundos\n", 
-        transferenciasConstrucao, 
-        comparacoesConstrucao, 
-        tempoExecucaoConstrucao
-    );
+    relatarFases(opcoes, "arvore_b", nomeArquivo, &pesquisa, &construcao, &atualizacao);
+
+    if (opcoes->todasOcorrencias) {
+        long posicoes[LIMITE_OCORRENCIAS];
+        Metricas todas;
+        iniciarMetricas(&todas);
+        int encontradas = buscarTodosArvoreB(raiz, chave, posicoes, LIMITE_OCORRENCIAS, &todas);
+        relatarOcorrencias(arquivo, "arvore_b", nomeArquivo, chave, posicoes, encontradas, &todas, opcoes);
+    }
+
+    if (opcoes->tamanhoLote > 0) {
+        VarianteArvoreB padrao;
+        descreverVarianteArvoreB(&padrao);
+        pesquisarLoteArvoreB(arquivo, &padrao, raiz, "arvore_b", nomeArquivo, opcoes);
+    }
+
+    if (opcoes->rastro != NULL) {
+        reproduzirRastroArvoreB(arquivo, raiz, nomeArquivo, opcoes);
+    }
 
     fclose(arquivo);
     destruirArvoreB(raiz);
@@ -229,55 +1833,457 @@ void arvoreB(const char *nomeArquivo, int chave, int exibirChaves) {
  *
  * @param nomeArquivo Caminho para o arquivo binário de onde os registros são lidos.
  * @param chave Chave do registro a ser pesquisado.
- * @param exibirChaves Flag para indicar se os detalhes do registro encontrado devem ser exibidos.
+ * @param opcoes Opções da pesquisa (exibição das chaves, operações e saída das métricas).
  */
-void arvoreBStar(const char *nomeArquivo, int chave, int exibirChaves) {
-    FILE *arquivo = fopen(nomeArquivo, "rb");
+void arvoreBStar(const char *nomeArquivo, Chave chave, const OpcoesPesquisa *opcoes) {
+    FILE *arquivo = abrirArquivoDados(nomeArquivo, opcoes->numOperacoes > 0 ? "r+b" : "rb");
     if (!arquivo) {
         perror("Erro ao abrir o arquivo");
         return;
     }
 
+    if (opcoes->varianteNo != NULL) {
+        pesquisarVarianteArvoreBStar(arquivo, nomeArquivo, chave, opcoes);
+        fclose(arquivo);
+        return;
+    }
+
+    if (opcoes->paginas) {
+        pesquisarPaginasArvoreBStar(arquivo, nomeArquivo, chave, opcoes);
+        fclose(arquivo);
+        return;
+    }
+
     NoArvoreBStar *raiz = NULL;
     Registro reg;
-    int transferenciasConstrucao = 0, comparacoesConstrucao = 0;
+    Metricas construcao, atualizacao, pesquisa;
+    long posicao = 0;
 
-    clock_t inicioConstrucao = clock();
-    while (fread(&reg, sizeof(Registro), 1, arquivo)) {
-        raiz = inserirArvoreBStar(raiz, reg, &transferenciasConstrucao, &comparacoesConstrucao);
-        transferenciasConstrucao++;
+    iniciarMetricas(&construcao);
+    if (opcoes->numThreads > 1) {
+        raiz = construirArvoreBStarParalela(nomeArquivo, opcoes->numThreads, &construcao);
+    } else if (opcoes->construcaoEncadeada) {
+        raiz = construirArvoreBStarEncadeada(nomeArquivo, &construcao);
+    } else {
+        while (lerRegistro(arquivo, posicao, &reg, &construcao)) {
+            if (registroValido(&reg)) {
+                raiz = inserirArvoreBStar(raiz, reg, posicao, &construcao);
+            }
+            posicao++;
+        }
     }
-    clock_t fimConstrucao = clock();
-    double tempoExecucaoConstrucao = (double)(fimConstrucao - inicioConstrucao) / CLOCKS_PER_SEC;
+    finalizarMetricas(&construcao);
+    medirArvoreBStar(raiz, &construcao);
 
-    fclose(arquivo);
+    // Atualizações incrementais sobre a árvore já construída
+    iniciarMetricas(&atualizacao);
+    raiz = aplicarOperacoesArvoreBStar(arquivo, nomeArquivo, raiz, opcoes, &atualizacao);
+    finalizarMetricas(&atualizacao);
+    medirArvoreBStar(raiz, &atualizacao);
 
-    int transferenciasPesquisa = 0, comparacoesPesquisa = 0;
-    clock_t inicioPesquisa = clock();
-    Registro *resultado = buscarArvoreBStar(raiz, chave, &transferenciasPesquisa, &comparacoesPesquisa);
-    clock_t fimPesquisa = clock();
-    double tempoExecucaoPesquisa = (double)(fimPesquisa - inicioPesquisa) / CLOCKS_PER_SEC;
+    iniciarMetricas(&pesquisa);
+    Registro *resultado = buscarArvoreBStar(raiz, chave, NULL, &pesquisa);
+    finalizarMetricas(&pesquisa);
 
     // Imprimindo o resultado da pesquisa
     if (resultado != NULL) {
-        printf("Registro de chave %d encontrado!\n", resultado->chave);
-        printf("Chave: %d\nDado1: %ld\nDado2: %.50s...\n", resultado->chave, resultado->dado1, resultado->dado2);
+        printf("Registro de chave %" FORMATO_CHAVE " encontrado!\n", resultado->chave);
+        printf("Chave: %" FORMATO_CHAVE "\nDado1: %ld\nDado2: %.50s...\n", resultado->chave, resultado->dado1, resultado->dado2);
+    } else {
+        printf("Registro não encontrado no arquivo.\n");
+    }
+
+    relatarFases(opcoes, "arvore_bstar", nomeArquivo, &pesquisa, &construcao, &atualizacao);
+
+    if (opcoes->todasOcorrencias) {
+        // As folhas guardam cópias dos registros, em ordem de posição: nada é lido do arquivo
+        Registro *encontrados[LIMITE_OCORRENCIAS];
+        long posicoes[LIMITE_OCORRENCIAS];
+        Metricas todas;
+        iniciarMetricas(&todas);
+        int encontradas = buscarTodosArvoreBStar(raiz, chave, encontrados, posicoes, LIMITE_OCORRENCIAS, &todas);
+        finalizarMetricas(&todas);
+
+        int exibidas = encontradas < LIMITE_OCORRENCIAS ? encontradas : LIMITE_OCORRENCIAS;
+        Registro *registros = malloc((exibidas > 0 ? exibidas : 1) * sizeof(Registro));
+        if (registros) {
+            for (int i = 0; i < exibidas; i++) {
+                registros[i] = *encontrados[i];
+            }
+            imprimirOcorrencias(chave, posicoes, registros, encontradas);
+            relatarMetricas(opcoes, "arvore_bstar", nomeArquivo, "todas", "Pesquisa de Todas as Ocorrências", &todas);
+            free(registros);
+        }
+    }
+
+    if (opcoes->tamanhoLote > 0) {
+        VarianteArvoreBStar padrao;
+        descreverVarianteArvoreBStar(&padrao);
+        pesquisarLoteArvoreBStar(arquivo, &padrao, raiz, "arvore_bstar", nomeArquivo, opcoes);
+    }
+
+    fclose(arquivo);
+    destruirArvoreBStar(raiz);
+}
+
+/**
+ * Compara, sobre um lote de chaves sorteadas, a árvore radix adaptativa com uma Árvore B
+ * construída em memória com as mesmas chaves: tempo das buscas e memória por chave.
+ *
+ * @param arquivo Ponteiro para o arquivo de registros.
+ * @param raiz Raiz da árvore radix já construída.
+ * @param nomeArquivo Caminho do arquivo de registros.
+ * @param opcoes Opções da pesquisa (tamanho do lote e saída das métricas).
+ */
+static void compararArvoreRadixComArvoreB(FILE *arquivo, NoArvoreRadix *raiz, const char *nomeArquivo, const OpcoesPesquisa *opcoes) {
+    long totalPosicoes;
+    Chave *todas = carregarChaves(arquivo, &totalPosicoes);
+    int quantidade = opcoes->tamanhoLote;
+    Chave *chaves = malloc(quantidade * sizeof(Chave));
+    if (!todas || !chaves) {
+        perror("Erro ao carregar as chaves");
+        free(todas);
+        free(chaves);
+        return;
+    }
+
+    Metricas construcaoB;
+    NoArvoreB *arvoreB = NULL;
+    iniciarMetricas(&construcaoB);
+    for (long posicao = 0; posicao < totalPosicoes; posicao++) {
+        if (todas[posicao] != CHAVE_REMOVIDA) {
+            arvoreB = inserirNoArvoreB(arvoreB, todas[posicao], posicao, &construcaoB);
+        }
+    }
+    finalizarMetricas(&construcaoB);
+    medirArvoreB(arvoreB, &construcaoB);
+
+    sortearChaves(arquivo, chaves, quantidade);
+
+    Metricas buscaRadix, buscaB;
+    int encontradasRadix = 0, encontradasB = 0;
+    iniciarMetricas(&buscaRadix);
+    for (int i = 0; i < quantidade; i++) {
+        encontradasRadix += buscarArvoreRadix(raiz, chaves[i], &buscaRadix) != NULL;
+    }
+    buscaRadix.consultas = quantidade;
+    finalizarMetricas(&buscaRadix);
+
+    iniciarMetricas(&buscaB);
+    for (int i = 0; i < quantidade; i++) {
+        encontradasB += buscarNoArvoreB(arvoreB, chaves[i], &buscaB) != NULL;
+    }
+    buscaB.consultas = quantidade;
+    finalizarMetricas(&buscaB);
+
+    Metricas medidaRadix;
+    medirArvoreRadix(raiz, &medidaRadix);
+    long chavesValidas = 0;
+    for (long posicao = 0; posicao < totalPosicoes; posicao++) {
+        chavesValidas += todas[posicao] != CHAVE_REMOVIDA;
+    }
+    double porChave = chavesValidas > 0 ? 1.0 / chavesValidas : 0.0;
+
+    printf(
+        "Lote de %d consultas: %d encontradas na árvore radix e %d na Árvore B.\n",
+        quantidade,
+        encontradasRadix,
+        encontradasB
+    );
+    printf(
+        "Memória por chave: %.1f bytes na árvore radix, %.1f bytes na Árvore B (ordem %d).\n",
+        memoriaArvoreRadix(raiz) * porChave,
+        construcaoB.numNos * sizeof(NoArvoreB) * porChave,
+        ORDEM_ARVORE_B
+    );
+
+    relatarMetricas(opcoes, "arvore_radix", nomeArquivo, "lote_radix", "Pesquisa em Lote na Árvore Radix", &buscaRadix);
+    relatarMetricas(opcoes, "arvore_radix", nomeArquivo, "lote_arvore_b", "Pesquisa em Lote na Árvore B", &buscaB);
+
+    destruirArvoreB(arvoreB);
+    free(chaves);
+    free(todas);
+}
+
+/**
+ * Realiza uma pesquisa em uma árvore radix adaptativa construída em memória a partir de um
+ * arquivo de registros.
+ *
+ * A árvore guarda a posição de cada registro; encontrada a chave, o registro é lido do
+ * arquivo, como na Árvore B.
+ *
+ * @param nomeArquivo Caminho para o arquivo binário de onde os registros são lidos.
+ * @param chave Chave do registro a ser pesquisado.
+ * @param opcoes Opções da pesquisa (exibição das chaves, lote e saída das métricas).
+ */
+void arvoreRadix(const char *nomeArquivo, Chave chave, const OpcoesPesquisa *opcoes) {
+    FILE *arquivo = abrirArquivoDados(nomeArquivo, "rb");
+    if (!arquivo) {
+        perror("Erro ao abrir o arquivo");
+        return;
+    }
+
+    NoArvoreRadix *raiz = NULL;
+    Metricas construcao, pesquisa;
+    Registro reg;
+    long posicao = 0;
+
+    iniciarMetricas(&construcao);
+    while (lerRegistro(arquivo, posicao, &reg, &construcao)) {
+        if (registroValido(&reg)) {
+            raiz = inserirArvoreRadix(raiz, reg.chave, posicao, &construcao);
+        }
+        posicao++;
+    }
+    finalizarMetricas(&construcao);
+    medirArvoreRadix(raiz, &construcao);
+
+    iniciarMetricas(&pesquisa);
+    Registro resultado;
+    FolhaArvoreRadix *folha = buscarArvoreRadix(raiz, chave, &pesquisa);
+    bool registroEncontrado = folha != NULL && lerRegistro(arquivo, folha->posicao, &resultado, &pesquisa);
+    finalizarMetricas(&pesquisa);
+
+    if (registroEncontrado) {
+        printf("Registro encontrado!\n");
+        printf("Chave: %" FORMATO_CHAVE "\nDado1: %ld\nDado2: %.50s...\n", resultado.chave, resultado.dado1, resultado.dado2);
     } else {
         printf("Registro não encontrado no arquivo.\n");
     }
 
+    relatarFases(opcoes, "arvore_radix", nomeArquivo, &pesquisa, &construcao, NULL);
+
+    if (opcoes->todasOcorrencias) {
+        long posicoes[LIMITE_OCORRENCIAS];
+        Metricas todas;
+        iniciarMetricas(&todas);
+        int encontradas = buscarTodosArvoreRadix(raiz, chave, posicoes, LIMITE_OCORRENCIAS, &todas);
+        relatarOcorrencias(arquivo, "arvore_radix", nomeArquivo, chave, posicoes, encontradas, &todas, opcoes);
+    }
+
+    if (opcoes->tamanhoLote > 0) {
+        compararArvoreRadixComArvoreB(arquivo, raiz, nomeArquivo, opcoes);
+    }
+
+    fclose(arquivo);
+    destruirArvoreRadix(raiz);
+}
+
+/**
+ * Pesquisa na árvore LSM um lote de chaves sorteadas, uma a uma, e um lote de intervalos
+ * de mesma largura começando nessas chaves, e imprime as métricas das duas formas.
+ *
+ * @param arquivo Ponteiro para o arquivo de registros, de onde as chaves são sorteadas.
+ * @param arvore Árvore LSM com os registros já ingeridos.
+ * @param nomeArquivo Caminho do arquivo de registros.
+ * @param opcoes Opções da pesquisa (tamanho do lote e saída das métricas).
+ */
+static void pesquisarLoteArvoreLSM(FILE *arquivo, ArvoreLSM *arvore, const char *nomeArquivo, const OpcoesPesquisa *opcoes) {
+    const int largura = 100; // Chaves cobertas por intervalo
+    int quantidade = opcoes->tamanhoLote;
+    Chave *chaves = malloc(quantidade * sizeof(Chave));
+    Registro *intervalo = malloc(largura * sizeof(Registro));
+    Metricas pontual, intervalos;
+
+    sortearChaves(arquivo, chaves, quantidade);
+
+    int encontradas = 0;
+    iniciarMetricas(&pontual);
+    for (int i = 0; i < quantidade; i++) {
+        Registro reg;
+        encontradas += buscarArvoreLSM(arvore, chaves[i], &reg, &pontual);
+    }
+    pontual.consultas = quantidade;
+    finalizarMetricas(&pontual);
+
+    long registrosIntervalos = 0;
+    iniciarMetricas(&intervalos);
+    for (int i = 0; i < quantidade; i++) {
+        Chave maximo = chaves[i] > CHAVE_MAXIMA - (largura - 1) ? CHAVE_MAXIMA : chaves[i] + largura - 1;
+        registrosIntervalos += buscarIntervaloArvoreLSM(arvore, chaves[i], maximo, intervalo, largura, &intervalos);
+    }
+    intervalos.consultas = quantidade;
+    finalizarMetricas(&intervalos);
+
     printf(
-        "\nMétricas da Pesquisa:\n - Transferências: %d\n - Comparações: %d\n - Tempo de execução: %.7f segundos\n", 
-        transferenciasPesquisa, 
-        comparacoesPesquisa, 
-        tempoExecucaoPesquisa
+        "Lote de %d consultas: %d chaves encontradas; %ld registros em intervalos de %d chaves.\n",
+        quantidade,
+        encontradas,
+        registrosIntervalos,
+        largura
     );
+
+    relatarMetricas(opcoes, "arvore_lsm", nomeArquivo, "lote_pontual", "Pesquisa em Lote Pontual", &pontual);
+    relatarMetricas(opcoes, "arvore_lsm", nomeArquivo, "lote_intervalos", "Pesquisa em Lote de Intervalos", &intervalos);
+
+    free(intervalo);
+    free(chaves);
+}
+
+/**
+ * Ingere os registros de um arquivo em uma árvore LSM e pesquisa uma chave.
+ *
+ * A construção mede a ingestão: as inserções vão para a memtable e as descargas e
+ * compactações rodam na thread de fundo, cuja E/S é relatada à parte. A fase termina
+ * quando todos os registros estão em segmentos.
+ *
+ * @param nomeArquivo Caminho para o arquivo binário de onde os registros são lidos.
+ * @param chave Chave do registro a ser pesquisado.
+ * @param opcoes Opções da pesquisa (exibição das chaves, lote e saída das métricas).
+ */
+void arvoreLSM(const char *nomeArquivo, Chave chave, const OpcoesPesquisa *opcoes) {
+    FILE *arquivo = abrirArquivoDados(nomeArquivo, "rb");
+    if (!arquivo) {
+        perror("Erro ao abrir o arquivo");
+        return;
+    }
+
+    ArvoreLSM arvore;
+    if (!criarArvoreLSM(&arvore, "testes/lsm")) {
+        perror("Erro ao criar a árvore LSM");
+        fclose(arquivo);
+        return;
+    }
+
+    Metricas construcao, pesquisa;
+    Registro reg;
+    long posicao = 0, ingeridos = 0;
+
+    iniciarMetricas(&construcao);
+    while (lerRegistro(arquivo, posicao, &reg, &construcao)) {
+        if (registroValido(&reg)) {
+            inserirArvoreLSM(&arvore, &reg, &construcao);
+            ingeridos++;
+        }
+        posicao++;
+    }
+    sincronizarArvoreLSM(&arvore);
+    finalizarMetricas(&construcao);
+    finalizarMetricas(&arvore.metricasFundo);
+
+    int segmentos = 0;
+    for (int nivel = 0; nivel < NIVEIS_LSM; nivel++) {
+        segmentos += arvore.numSegmentos[nivel];
+        if (arvore.numSegmentos[nivel] > 0) {
+            construcao.altura = nivel + 1;
+        }
+    }
+    construcao.numNos = segmentos;
+
+    iniciarMetricas(&pesquisa);
+    bool encontrado = buscarArvoreLSM(&arvore, chave, &reg, &pesquisa);
+    finalizarMetricas(&pesquisa);
+
+    if (encontrado) {
+        printf("Registro encontrado!\n");
+        printf("Chave: %" FORMATO_CHAVE "\nDado1: %ld\nDado2: %.50s...\n", reg.chave, reg.dado1, reg.dado2);
+    } else {
+        printf("Registro não encontrado no arquivo.\n");
+    }
+
     printf(
-        "\nMétricas da Construção do Índice:\n - Transferências: %d\n - Comparações: %d\n - Tempo de execução: %.7f segundos\n", 
-        transferenciasConstrucao, 
-        comparacoesConstrucao, 
-        tempoExecucaoConstrucao
+        "Ingestão: %ld registros em %.3f s (%.0f registros/s); %llu descargas, %llu compactações, "
+        "%llu esperas pela descarga; %d segmento(s) em %llu nível(is); amplificação de escrita %.2f.\n",
+        ingeridos,
+        construcao.tempoReal,
+        construcao.tempoReal > 0 ? ingeridos / construcao.tempoReal : 0.0,
+        (unsigned long long)arvore.descargas,
+        (unsigned long long)arvore.compactacoes,
+        (unsigned long long)arvore.esperasEscrita,
+        segmentos,
+        (unsigned long long)construcao.altura,
+        ingeridos > 0 ? arvore.metricasFundo.bytesEscritos / ((double)ingeridos * sizeof(Registro)) : 0.0
     );
 
-    destruirArvoreBStar(raiz);
-}
\ No newline at end of file
+    relatarFases(opcoes, "arvore_lsm", nomeArquivo, &pesquisa, &construcao, NULL);
+    relatarMetricas(opcoes, "arvore_lsm", nomeArquivo, "segundo_plano", "Gravação em Segundo Plano", &arvore.metricasFundo);
+
+    if (opcoes->tamanhoLote > 0) {
+        pesquisarLoteArvoreLSM(arquivo, &arvore, nomeArquivo, opcoes);
+    }
+
+    fecharArvoreLSM(&arvore);
+    fclose(arquivo);
+}
+
+/**
+ * Pesquisa os registros por um valor de dado1 pelo índice secundário e, como referência,
+ * por uma varredura completa do arquivo, que também confere o número de registros achados.
+ *
+ * @param nomeArquivo Caminho do arquivo de registros.
+ * @param valor Valor de dado1 pesquisado.
+ * @param opcoes Opções da pesquisa.
+ */
+void pesquisarDado1(const char *nomeArquivo, long valor, const OpcoesPesquisa *opcoes) {
+    FILE *arquivo = abrirArquivoDados(nomeArquivo, "rb");
+    if (!arquivo) {
+        perror("Erro ao abrir o arquivo");
+        return;
+    }
+
+    Metricas construcao, pesquisa, varredura;
+    IndiceSecundario indice;
+    iniciarMetricas(&construcao);
+    bool aberto = abrirIndiceSecundario(nomeArquivo, arquivo, &indice, &construcao);
+    finalizarMetricas(&construcao);
+    if (!aberto) {
+        fprintf(stderr, "Falha ao abrir o índice secundário.\n");
+        fclose(arquivo);
+        return;
+    }
+
+    iniciarMetricas(&pesquisa);
+    long *posicoes = NULL;
+    long total = buscarIndiceSecundario(&indice, valor, &posicoes, &pesquisa);
+    long encontrados = 0;
+    for (long i = 0; i < total; i++) {
+        Registro reg;
+        pesquisa.comparacoes++;
+        if (!lerRegistro(arquivo, posicoes[i], &reg, &pesquisa) || !registroValido(&reg) || reg.dado1 != valor) {
+            continue;
+        }
+        if (encontrados++ < 10) {
+            printf("Posição %ld\nChave: %" FORMATO_CHAVE "\nDado1: %ld\nDado2: %.50s...\n", posicoes[i], reg.chave, reg.dado1, reg.dado2);
+        }
+    }
+    pesquisa.consultas = 1;
+    finalizarMetricas(&pesquisa);
+    free(posicoes);
+    fecharIndiceSecundario(&indice);
+
+    // Varredura de referência: o custo que o índice secundário evita
+    iniciarMetricas(&varredura);
+    Registro *bloco = malloc(REGISTROS_BLOCO_SECUNDARIO * sizeof(Registro));
+    long conferidos = 0;
+    registrarPosicionamento(&varredura);
+    fseeko(arquivo, 0, SEEK_SET);
+    long lidos;
+    while (bloco != NULL && (lidos = (long)fread(bloco, sizeof(Registro), REGISTROS_BLOCO_SECUNDARIO, arquivo)) > 0) {
+        varredura.transferencias += lidos;
+        varredura.bytesLidos += lidos * sizeof(Registro);
+        varredura.chamadasSistema++;
+        for (long i = 0; i < lidos; i++) {
+            varredura.comparacoes++;
+            if (registroValido(&bloco[i]) && bloco[i].dado1 == valor) {
+                conferidos++;
+            }
+        }
+    }
+    varredura.consultas = 1;
+    finalizarMetricas(&varredura);
+    free(bloco);
+    fclose(arquivo);
+
+    if (encontrados == 0) {
+        printf("Nenhum registro com dado1 igual a %ld.\n", valor);
+    } else {
+        printf("Registros com dado1 igual a %ld: %ld\n", valor, encontrados);
+    }
+    if (conferidos != encontrados) {
+        fprintf(stderr, "O índice secundário achou %ld registros e a varredura, %ld.\n", encontrados, conferidos);
+    }
+
+    relatarMetricas(opcoes, "secundario", nomeArquivo, "pesquisa", "Pesquisa por Dado1", &pesquisa);
+    relatarMetricas(opcoes, "secundario", nomeArquivo, "construcao", "Construção do Índice Secundário", &construcao);
+    relatarMetricas(opcoes, "secundario", nomeArquivo, "varredura", "Varredura por Dado1", &varredura);
+}
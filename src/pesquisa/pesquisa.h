@@ -1,9 +1,45 @@
 #ifndef PESQUISA_H
 #define PESQUISA_H
 
-void acessoSequencialIndexado(const char *nomeArquivo, int chave, int exibirChaves);
-void arvoreBinariaPesquisa(const char *nomeArquivo, int chave, int exibirChaves);
-void arvoreB(const char *nomeArquivo, int chave, int exibirChaves);
-void arvoreBStar(const char *nomeArquivo, int chave, int exibirChaves);
+#include "../atualizacao/atualizacao.h"
+#include "../metricas/metricas.h"
+
+#define LIMITE_OCORRENCIAS 1024 // Ocorrências de uma chave lidas e exibidas pela pesquisa de todas as ocorrências
+
+typedef struct {
+    int exibirChaves; // Indica se os detalhes dos registros devem ser exibidos
+    const Operacao *operacoes; // Operações de atualização aplicadas após a construção
+    int numOperacoes; // Número de operações de atualização
+    FormatoMetricas formatoMetricas; // Formato de saída das métricas
+    const char *arquivoMetricas; // Arquivo onde as métricas são acrescentadas (NULL para a saída padrão)
+    FILE *saidaMetricas; // Saída padrão original, quando os textos foram desviados para a de erros (NULL se não foram)
+    int tamanhoLote; // Número de chaves sorteadas para uma pesquisa em lote (0 para pesquisa única)
+    int profundidadeFila; // Consultas mantidas em andamento na pesquisa em lote assíncrona
+    int numThreads; // Threads da construção paralela (0 ou 1 para a construção sequencial)
+    int threadsConcorrentes; // Threads das rodadas de inserções e buscas simultâneas (0 para desligar)
+    int leitoresInstantaneos; // Leitores da rodada de ingestão com cópia na escrita (0 para desligar)
+    int indiceEytzinger; // Indica se o índice esparso é pesquisado na ordem de Eytzinger
+    int construcaoEncadeada; // Indica se uma thread lê o arquivo enquanto outra insere na árvore
+    int mapaZonas; // Indica se a pesquisa lê só os blocos do arquivo cujas zonas contêm a chave
+    int pesquisarDado1; // Indica se os registros também são pesquisados pelo valor de dado1
+    long valorDado1; // Valor de dado1 pesquisado pelo índice secundário
+    const char *rastro; // Rastro de consultas reproduzido na Árvore B (NULL para nenhum)
+    size_t orcamentoCache; // Bytes da cache de resultados na reprodução do rastro (0 para sem cache)
+    const char *varianteNo; // Tamanho de nó das árvores B e B* ("auto" para o do ajuste; NULL para a ordem padrão)
+    int paginas; // Indica se as árvores B e B* indexam os registros do arquivo paginado, por RID
+    int todasOcorrencias; // Indica se todas as ocorrências da chave também são pesquisadas
+    int juncaoLote; // Indica se o lote também é resolvido por junção ordenada com as folhas ou o índice esparso
+} OpcoesPesquisa;
+
+void varreduraCompleta(const char *nomeArquivo, Chave chave, const OpcoesPesquisa *opcoes);
+void acessoSequencialIndexado(const char *nomeArquivo, Chave chave, const OpcoesPesquisa *opcoes);
+void arvoreBinariaPesquisa(const char *nomeArquivo, Chave chave, const OpcoesPesquisa *opcoes);
+void arvoreB(const char *nomeArquivo, Chave chave, const OpcoesPesquisa *opcoes);
+void arvoreBStar(const char *nomeArquivo, Chave chave, const OpcoesPesquisa *opcoes);
+void arvoreRadix(const char *nomeArquivo, Chave chave, const OpcoesPesquisa *opcoes);
+void arvoreLSM(const char *nomeArquivo, Chave chave, const OpcoesPesquisa *opcoes);
+int compararLayoutsIndice(int entradas, int consultas);
+int testarEscala(const char *caminho, long registros, int amostras);
+void pesquisarDado1(const char *nomeArquivo, long valor, const OpcoesPesquisa *opcoes);
 
 #endif
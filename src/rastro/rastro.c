@@ -0,0 +1,262 @@
+#include "rastro.h"
+#include "../es/es.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define REGISTROS_BLOCO_RASTRO 1024 // Registros lidos por vez ao carregar as chaves
+
+/**
+ * Sorteia um inteiro em [0, limite) combinando chamadas de rand(), que sozinho não cobre
+ * arquivos grandes.
+ */
+static uint64_t sortearRastro(uint64_t limite) {
+    uint64_t valor = ((uint64_t)rand() << 62) ^ ((uint64_t)rand() << 31) ^ (uint64_t)rand();
+    return valor % limite;
+}
+
+/**
+ * Sorteia um número real em [0, 1).
+ */
+static double sortearFracao(void) {
+    return (double)sortearRastro(1ULL << 53) / (double)(1ULL << 53);
+}
+
+static int compararChavesRastro(const void *a, const void *b) {
+    Chave x = *(const Chave *)a;
+    Chave y = *(const Chave *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Lê as chaves válidas de um arquivo de registros com leituras sequenciais em blocos.
+ */
+static Chave* lerChavesValidas(const char *nomeArquivo, long *total) {
+    FILE *arquivo = abrirArquivoDados(nomeArquivo, "rb");
+    if (!arquivo) {
+        perror("Erro ao abrir o arquivo");
+        return NULL;
+    }
+    fseeko(arquivo, 0, SEEK_END);
+    long totalRegistros = ftello(arquivo) / sizeof(Registro);
+    fseeko(arquivo, 0, SEEK_SET);
+
+    Registro *bloco = malloc(REGISTROS_BLOCO_RASTRO * sizeof(Registro));
+    Chave *chaves = malloc((totalRegistros > 0 ? totalRegistros : 1) * sizeof(Chave));
+    if (!bloco || !chaves) {
+        perror("Erro ao alocar as chaves");
+        free(bloco);
+        free(chaves);
+        fclose(arquivo);
+        return NULL;
+    }
+
+    *total = 0;
+    size_t lidos;
+    while ((lidos = fread(bloco, sizeof(Registro), REGISTROS_BLOCO_RASTRO, arquivo)) > 0) {
+        for (size_t i = 0; i < lidos; i++) {
+            if (registroValido(&bloco[i])) {
+                chaves[(*total)++] = bloco[i].chave;
+            }
+        }
+    }
+    free(bloco);
+    fclose(arquivo);
+    return chaves;
+}
+
+/**
+ * Interpreta o nome de uma distribuição ("uniforme" ou "zipf").
+ *
+ * @return Retorna true se o nome é conhecido.
+ */
+bool interpretarDistribuicaoRastro(const char *nome, DistribuicaoRastro *distribuicao) {
+    if (strcmp(nome, "uniforme") == 0) {
+        *distribuicao = DISTRIBUICAO_UNIFORME;
+    } else if (strcmp(nome, "zipf") == 0) {
+        *distribuicao = DISTRIBUICAO_ZIPF;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Gera um rastro de consultas sobre as chaves de um arquivo de registros.
+ *
+ * A popularidade das chaves é uma permutação aleatória delas, para que as chaves quentes
+ * fiquem espalhadas pelo arquivo e pela árvore, e não concentradas no começo. Na
+ * distribuição de Zipf, a chave de popularidade k (a partir de 1) sai com probabilidade
+ * proporcional a 1/k^assimetria, sorteada por busca binária na distribuição acumulada. Uma
+ * fração taxaFaltas das consultas pede chaves que não estão no arquivo, sorteadas entre a
+ * menor chave e a maior mais o número de chaves.
+ *
+ * @param nomeArquivo Caminho do arquivo de registros.
+ * @param caminhoRastro Caminho do arquivo de texto onde o rastro é gravado.
+ * @param consultas Número de consultas do rastro.
+ * @param distribuicao Distribuição das chaves presentes.
+ * @param assimetria Expoente da distribuição de Zipf (ignorado na uniforme).
+ * @param taxaFaltas Fração das consultas com chaves ausentes, entre 0 e 1.
+ * @return 0 em caso de sucesso ou 1 em caso de falha.
+ */
+int gerarRastro(
+    const char *nomeArquivo,
+    const char *caminhoRastro,
+    long consultas,
+    DistribuicaoRastro distribuicao,
+    double assimetria,
+    double taxaFaltas
+) {
+    long total = 0;
+    Chave *chaves = lerChavesValidas(nomeArquivo, &total);
+    if (!chaves) {
+        return 1;
+    }
+    if (total == 0) {
+        fprintf(stderr, "O arquivo não tem registros válidos.\n");
+        free(chaves);
+        return 1;
+    }
+
+    // Cópia ordenada para reconhecer as chaves ausentes; a original vira a ordem de popularidade
+    Chave *ordenadas = malloc(total * sizeof(Chave));
+    double *acumulada = distribuicao == DISTRIBUICAO_ZIPF ? malloc(total * sizeof(double)) : NULL;
+    FILE *rastro = fopen(caminhoRastro, "w");
+    if (!ordenadas || (distribuicao == DISTRIBUICAO_ZIPF && !acumulada) || !rastro) {
+        perror("Erro ao preparar o rastro");
+        free(chaves);
+        free(ordenadas);
+        free(acumulada);
+        if (rastro) {
+            fclose(rastro);
+        }
+        return 1;
+    }
+    memcpy(ordenadas, chaves, total * sizeof(Chave));
+    qsort(ordenadas, total, sizeof(Chave), compararChavesRastro);
+    for (long i = total - 1; i > 0; i--) {
+        long j = (long)sortearRastro((uint64_t)i + 1);
+        Chave troca = chaves[i];
+        chaves[i] = chaves[j];
+        chaves[j] = troca;
+    }
+    if (acumulada != NULL) {
+        double soma = 0.0;
+        for (long k = 0; k < total; k++) {
+            soma += 1.0 / pow((double)(k + 1), assimetria);
+            acumulada[k] = soma;
+        }
+        for (long k = 0; k < total; k++) {
+            acumulada[k] /= soma;
+        }
+    }
+
+    Chave menor = ordenadas[0];
+    Chave maior = ordenadas[total - 1];
+    Chave limiteFaltas = maior > CHAVE_MAXIMA - total ? CHAVE_MAXIMA : maior + (Chave)total;
+    uint64_t faixaFaltas = (uint64_t)limiteFaltas - (uint64_t)menor + 1;
+
+    long faltas = 0, populares = 0;
+    long limitePopulares = total / 100 > 0 ? total / 100 : 1;
+    for (long i = 0; i < consultas; i++) {
+        Chave chave;
+        if (taxaFaltas > 0.0 && sortearFracao() < taxaFaltas) {
+            // Sorteia até cair fora do conjunto; a faixa tem pelo menos "total" chaves livres
+            do {
+                chave = (Chave)((uint64_t)menor + sortearRastro(faixaFaltas));
+            } while (bsearch(&chave, ordenadas, total, sizeof(Chave), compararChavesRastro) != NULL);
+            faltas++;
+        } else {
+            long posicao;
+            if (distribuicao == DISTRIBUICAO_ZIPF) {
+                double sorteio = sortearFracao();
+                long inicio = 0, fim = total - 1;
+                while (inicio < fim) {
+                    long meio = inicio + (fim - inicio) / 2;
+                    if (acumulada[meio] > sorteio) {
+                        fim = meio;
+                    } else {
+                        inicio = meio + 1;
+                    }
+                }
+                posicao = inicio;
+            } else {
+                posicao = (long)sortearRastro((uint64_t)total);
+            }
+            populares += posicao < limitePopulares;
+            chave = chaves[posicao];
+        }
+        fprintf(rastro, "%" FORMATO_CHAVE "\n", chave);
+    }
+    bool gravado = fclose(rastro) == 0;
+
+    if (gravado) {
+        char descricao[64];
+        if (distribuicao == DISTRIBUICAO_ZIPF) {
+            snprintf(descricao, sizeof(descricao), "Zipf com s = %.2f", assimetria);
+        } else {
+            snprintf(descricao, sizeof(descricao), "uniforme");
+        }
+        printf("Rastro gravado em %s: %ld consultas (%s), %ld com chaves ausentes.\n", caminhoRastro, consultas, descricao, faltas);
+        if (consultas > faltas) {
+            printf(
+                "As %ld chaves mais populares (1%%) recebem %.1f%% das consultas a chaves presentes.\n",
+                limitePopulares,
+                100.0 * populares / (consultas - faltas)
+            );
+        }
+    } else {
+        perror("Erro ao gravar o rastro");
+    }
+
+    free(chaves);
+    free(ordenadas);
+    free(acumulada);
+    return gravado ? 0 : 1;
+}
+
+/**
+ * Carrega as chaves de um rastro de consultas.
+ *
+ * @param caminhoRastro Caminho do arquivo de texto com uma chave por linha.
+ * @param quantidade Onde o número de consultas será armazenado.
+ * @return Vetor de chaves (NULL em caso de falha), que deve ser liberado por quem chama.
+ */
+Chave* carregarRastro(const char *caminhoRastro, long *quantidade) {
+    FILE *rastro = fopen(caminhoRastro, "r");
+    if (!rastro) {
+        perror("Erro ao abrir o rastro");
+        return NULL;
+    }
+
+    long capacidade = 1024;
+    Chave *chaves = malloc(capacidade * sizeof(Chave));
+    char linha[64];
+    *quantidade = 0;
+    while (chaves != NULL && fgets(linha, sizeof(linha), rastro) != NULL) {
+        char *fim;
+        Chave chave = (Chave)strtoll(linha, &fim, 10);
+        if (fim == linha) {
+            continue; // Linha vazia ou sem chave
+        }
+        if (*quantidade == capacidade) {
+            capacidade *= 2;
+            Chave *maiores = realloc(chaves, capacidade * sizeof(Chave));
+            if (!maiores) {
+                free(chaves);
+                chaves = NULL;
+                break;
+            }
+            chaves = maiores;
+        }
+        chaves[(*quantidade)++] = chave;
+    }
+    fclose(rastro);
+
+    if (!chaves) {
+        perror("Erro ao alocar o rastro");
+    }
+    return chaves;
+}
@@ -0,0 +1,28 @@
+#ifndef RASTRO_H
+#define RASTRO_H
+
+#include "../registro/registro.h"
+#include <stdbool.h>
+
+typedef enum {
+    DISTRIBUICAO_UNIFORME, // Todas as chaves do arquivo com a mesma probabilidade
+    DISTRIBUICAO_ZIPF // A chave de popularidade k sai com probabilidade proporcional a 1/k^s
+} DistribuicaoRastro;
+
+/*
+ * Um rastro de consultas é um arquivo de texto com uma chave por linha, na ordem em que as
+ * consultas são feitas. Ele é gerado a partir das chaves de um arquivo de registros e pode
+ * ser reproduzido várias vezes, com e sem cache, sobre o mesmo arquivo.
+ */
+bool interpretarDistribuicaoRastro(const char *nome, DistribuicaoRastro *distribuicao);
+int gerarRastro(
+    const char *nomeArquivo,
+    const char *caminhoRastro,
+    long consultas,
+    DistribuicaoRastro distribuicao,
+    double assimetria,
+    double taxaFaltas
+);
+Chave* carregarRastro(const char *caminhoRastro, long *quantidade);
+
+#endif // RASTRO_H
@@ -8,21 +8,22 @@
  *
  * Esta função posiciona o ponteiro do arquivo na posição especificada e lê um registro.
  * Em caso de erro na busca ou leitura, exibe uma mensagem apropriada. A função também
- * incrementa a contagem de transferências de dados do armazenamento externo para a memória interna.
+ * contabiliza a transferência de dados do armazenamento externo para a memória interna.
  *
  * @param arquivo Ponteiro para o arquivo binário de onde o registro será lido.
  * @param posicao Posição do registro no arquivo, baseada no índice do registro.
  * @param reg Ponteiro para o registro onde os dados lidos serão armazenados.
- * @param transferencias Ponteiro para a contagem de transferências de dados.
+ * @param metricas Ponteiro para as métricas da fase em andamento.
  */
-bool lerRegistro(FILE *arquivo, long posicao, Registro *reg, int *transferencias) {
-    if (fseek(arquivo, posicao * sizeof(Registro), SEEK_SET) != 0) {
+bool lerRegistro(FILE *arquivo, long posicao, Registro *reg, Metricas *metricas) {
+    registrarPosicionamento(metricas);
+    if (fseeko(arquivo, DESLOCAMENTO_REGISTRO(posicao), SEEK_SET) != 0) {
         perror("Erro ao buscar posição no arquivo");
         return false;
     }
 
     if (fread(reg, sizeof(Registro), 1, arquivo) == 1) {
-        (*transferencias)++;
+        registrarLeitura(metricas, sizeof(Registro));
         return true;
     } else {
         if (feof(arquivo)) {
@@ -35,6 +36,53 @@ bool lerRegistro(FILE *arquivo, long posicao, Registro *reg, int *transferencias
 }
 
 
+/**
+ * Compara duas posições de registro para o qsort, em ordem crescente.
+ */
+static int compararPosicoes(const void *a, const void *b) {
+    long x = *(const long *)a, y = *(const long *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Lê vários registros do arquivo em ordem crescente de posição, para que a leitura avance
+ * sempre no mesmo sentido: o vetor de posições é ordenado e o posicionamento é omitido
+ * quando um registro vem logo depois do anterior.
+ *
+ * @param arquivo Ponteiro para o arquivo binário de onde os registros serão lidos.
+ * @param posicoes Posições dos registros; o vetor sai ordenado.
+ * @param quantidade Número de posições.
+ * @param registros Onde os registros lidos serão armazenados, na ordem das posições.
+ * @param metricas Ponteiro para as métricas da fase em andamento.
+ * @return Número de registros lidos com sucesso; os que falharem recebem a chave CHAVE_REMOVIDA.
+ */
+int lerRegistrosOrdenados(FILE *arquivo, long *posicoes, int quantidade, Registro *registros, Metricas *metricas) {
+    qsort(posicoes, quantidade, sizeof(long), compararPosicoes);
+    int lidos = 0;
+    long seguinte = -1; // Posição em que o arquivo está depois da última leitura
+    for (int i = 0; i < quantidade; i++) {
+        if (posicoes[i] != seguinte) {
+            registrarPosicionamento(metricas);
+            if (fseeko(arquivo, DESLOCAMENTO_REGISTRO(posicoes[i]), SEEK_SET) != 0) {
+                perror("Erro ao buscar posição no arquivo");
+                registros[i].chave = CHAVE_REMOVIDA;
+                seguinte = -1;
+                continue;
+            }
+        }
+        if (fread(&registros[i], sizeof(Registro), 1, arquivo) == 1) {
+            registrarLeitura(metricas, sizeof(Registro));
+            seguinte = posicoes[i] + 1;
+            lidos++;
+        } else {
+            perror("Erro ao ler registro do arquivo");
+            registros[i].chave = CHAVE_REMOVIDA;
+            seguinte = -1;
+        }
+    }
+    return lidos;
+}
+
 /**
  * Escreve um registro em um arquivo binário em uma posição específica.
  *
@@ -46,7 +94,7 @@ bool lerRegistro(FILE *arquivo, long posicao, Registro *reg, int *transferencias
  * @param reg Ponteiro para o registro que contém os dados a serem escritos.
  */
 void escreverRegistro(FILE *arquivo, long posicao, const Registro *reg) {
-    if (fseek(arquivo, posicao * sizeof(Registro), SEEK_SET) != 0) {
+    if (fseeko(arquivo, DESLOCAMENTO_REGISTRO(posicao), SEEK_SET) != 0) {
         perror("Erro ao buscar posição no arquivo");
         return;
     }
@@ -64,7 +112,7 @@ void escreverRegistro(FILE *arquivo, long posicao, const Registro *reg) {
  *
  * @param nomeArquivo Caminho para o arquivo binário de onde os registros serão lidos e exibidos.
  */
-void exibirRegistros(const char *nomeArquivo, int quantidade) {
+void exibirRegistros(const char *nomeArquivo, long quantidade) {
     FILE *arquivo = fopen(nomeArquivo, "rb");
     if (!arquivo) {
         perror("Erro ao abrir o arquivo");
@@ -72,19 +120,23 @@ void exibirRegistros(const char *nomeArquivo, int quantidade) {
     }
 
     // Calcular o intervalo de salto
-    int salto = (quantidade > 20) ? quantidade / 20 : 1;
+    long salto = (quantidade > 20) ? quantidade / 20 : 1;
     int registrosExibidos = 0;
 
     Registro reg;
-    int i = 0;
+    long i = 0;
 
     while (registrosExibidos < 20 && i < quantidade) {
-        fseek(arquivo, i * sizeof(Registro), SEEK_SET);
+        fseeko(arquivo, DESLOCAMENTO_REGISTRO(i), SEEK_SET);
         if (!fread(&reg, sizeof(Registro), 1, arquivo)) {
             break; // Sai do loop se não conseguir ler mais registros
         }
 
-        printf("Registro %d\nChave: %d\n\n", i, reg.chave);
+        if (registroValido(&reg)) {
+            printf("Registro %ld\nChave: %" FORMATO_CHAVE "\nDado1: %ld\n\n", i, reg.chave, reg.dado1);
+        } else {
+            printf("Registro %ld\n(removido)\n\n", i);
+        }
         i += salto;
         registrosExibidos++;
     }
@@ -92,4 +144,16 @@ void exibirRegistros(const char *nomeArquivo, int quantidade) {
     fclose(arquivo);
 }
 
-
+/**
+ * Verifica se um registro lido do arquivo ainda é válido.
+ *
+ * Registros removidos permanecem no arquivo como lápides (chave igual a CHAVE_REMOVIDA)
+ * até que sua posição seja reaproveitada por uma nova inclusão. Todos os métodos devem
+ * ignorar essas posições ao construir seus índices.
+ *
+ * @param reg Ponteiro para o registro a ser verificado.
+ * @return Retorna true se o registro não for uma lápide.
+ */
+bool registroValido(const Registro *reg) {
+    return reg->chave != CHAVE_REMOVIDA;
+}
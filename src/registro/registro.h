@@ -6,16 +6,46 @@
 #include <stdbool.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <limits.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <sys/types.h>
+#include "../metricas/metricas.h"
+
+/*
+ * Tipo da chave dos registros. A chave tem 32 bits por padrão; compilando com
+ * -DCHAVE_64_BITS (make CHAVE=64) ela passa a ter 64 bits, o que permite arquivos com mais
+ * de 2^31 registros em ordem crescente ou decrescente. O formato do arquivo muda com a
+ * largura da chave; com chaves de 64 bits os arquivos de teste recebem o sufixo "_64".
+ */
+#ifdef CHAVE_64_BITS
+typedef int64_t Chave;
+#define CHAVE_MINIMA INT64_MIN
+#define CHAVE_MAXIMA INT64_MAX
+#define FORMATO_CHAVE PRId64 // Conversão da chave no printf, usada como "%" FORMATO_CHAVE
+#else
+typedef int Chave;
+#define CHAVE_MINIMA INT_MIN
+#define CHAVE_MAXIMA INT_MAX
+#define FORMATO_CHAVE "d"
+#endif
+
+#define CHAVE_REMOVIDA CHAVE_MINIMA // Chave gravada nos registros removidos (lápide)
+
+// Deslocamento em bytes de um registro no arquivo, calculado em 64 bits para o fseeko e o pread
+#define DESLOCAMENTO_REGISTRO(posicao) ((off_t)(posicao) * (off_t)sizeof(Registro))
 
 typedef struct {
-    int chave;
+    Chave chave;
     long dado1;
     char dado2[TAMANHO_DADO];
 } Registro;
 
 // Protótipos para manipulação de registros
-bool lerRegistro(FILE *arquivo, long posicao, Registro *reg, int *transferencias);
+bool lerRegistro(FILE *arquivo, long posicao, Registro *reg, Metricas *metricas);
+int lerRegistrosOrdenados(FILE *arquivo, long *posicoes, int quantidade, Registro *registros, Metricas *metricas);
 void escreverRegistro(FILE *arquivo, long posicao, const Registro *reg);
-void exibirRegistros(const char *nomeArquivo, int quantidade);
+void exibirRegistros(const char *nomeArquivo, long quantidade);
+bool registroValido(const Registro *reg);
 
 #endif
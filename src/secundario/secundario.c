@@ -0,0 +1,319 @@
+#include "secundario.h"
+#include "../util/util.h"
+#include "../es/es.h"
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    long valor;
+    long posicao;
+} ParSecundario;
+
+/**
+ * Monta o caminho do arquivo auxiliar com o índice secundário de um arquivo de registros.
+ */
+static void caminhoIndiceSecundario(const char *nomeArquivo, char *caminho, size_t tamanho) {
+    snprintf(caminho, tamanho, "%s.dado1", nomeArquivo);
+}
+
+/**
+ * Deslocamento, no arquivo auxiliar, da primeira posição das listas (depois das páginas).
+ */
+static off_t inicioListas(const CabecalhoSecundario *cabecalho) {
+    return (off_t)(cabecalho->numPaginas + 1) * TAMANHO_PAGINA_SECUNDARIO;
+}
+
+/**
+ * Ordena os pares pelo valor e, entre valores iguais, pela posição.
+ */
+static int compararPares(const void *a, const void *b) {
+    const ParSecundario *x = a;
+    const ParSecundario *y = b;
+    if (x->valor != y->valor) {
+        return x->valor < y->valor ? -1 : 1;
+    }
+    return (x->posicao > y->posicao) - (x->posicao < y->posicao);
+}
+
+/**
+ * Tenta abrir o índice do arquivo auxiliar. O índice só é aceito se foi gravado depois da
+ * última alteração do arquivo de registros e para o mesmo número de registros.
+ */
+static bool lerIndiceSecundario(const char *nomeArquivo, long totalRegistros, IndiceSecundario *indice) {
+    char caminho[300];
+    caminhoIndiceSecundario(nomeArquivo, caminho, sizeof(caminho));
+
+    if (!auxiliarAtualizado(nomeArquivo, caminho)) {
+        return false;
+    }
+
+    FILE *arquivo = abrirArquivoDados(caminho, "rb");
+    if (!arquivo) {
+        return false;
+    }
+    if (fread(&indice->cabecalho, sizeof(CabecalhoSecundario), 1, arquivo) != 1 ||
+        indice->cabecalho.totalRegistros != totalRegistros ||
+        indice->cabecalho.tamanhoPagina != TAMANHO_PAGINA_SECUNDARIO) {
+        fclose(arquivo);
+        return false;
+    }
+    indice->arquivo = arquivo;
+    return true;
+}
+
+/**
+ * Lê os pares (dado1, posição) dos registros válidos com leituras sequenciais em blocos.
+ *
+ * @return Vetor de pares (NULL em caso de falha), com o número de pares em *numPares.
+ */
+static ParSecundario* extrairPares(FILE *arquivo, long totalRegistros, long *numPares, Metricas *metricas) {
+    Registro *bloco = malloc(REGISTROS_BLOCO_SECUNDARIO * sizeof(Registro));
+    ParSecundario *pares = malloc((totalRegistros > 0 ? totalRegistros : 1) * sizeof(ParSecundario));
+    if (!bloco || !pares) {
+        free(bloco);
+        free(pares);
+        return NULL;
+    }
+
+    *numPares = 0;
+    registrarPosicionamento(metricas);
+    fseeko(arquivo, 0, SEEK_SET);
+    for (long inicio = 0; inicio < totalRegistros; inicio += REGISTROS_BLOCO_SECUNDARIO) {
+        long lidos = (long)fread(bloco, sizeof(Registro), REGISTROS_BLOCO_SECUNDARIO, arquivo);
+        metricas->transferencias += lidos;
+        metricas->bytesLidos += lidos * sizeof(Registro);
+        metricas->chamadasSistema++;
+        for (long i = 0; i < lidos; i++) {
+            if (registroValido(&bloco[i])) {
+                pares[*numPares].valor = bloco[i].dado1;
+                pares[(*numPares)++].posicao = inicio + i;
+            }
+        }
+        if (lidos < REGISTROS_BLOCO_SECUNDARIO) {
+            break;
+        }
+    }
+    free(bloco);
+    return pares;
+}
+
+/**
+ * Extrai o índice do arquivo de registros e o grava no arquivo auxiliar.
+ *
+ * Os pares são ordenados e agrupados por valor; as folhas recebem os valores distintos em
+ * ordem e cada nível acima recebe o menor valor de cada página do nível de baixo, até
+ * sobrar uma página, que é a raiz. As páginas ficam cheias, exceto a última de cada nível.
+ */
+static bool extrairIndiceSecundario(const char *nomeArquivo, FILE *dados, long totalRegistros, Metricas *metricas) {
+    long numPares = 0;
+    ParSecundario *pares = extrairPares(dados, totalRegistros, &numPares, metricas);
+    if (!pares) {
+        perror("Erro ao alocar o índice secundário");
+        return false;
+    }
+    qsort(pares, numPares, sizeof(ParSecundario), compararPares);
+
+    // Folhas: um valor distinto por entrada, apontando para o trecho da lista de posições
+    long *posicoes = malloc((numPares > 0 ? numPares : 1) * sizeof(long));
+    EntradaSecundaria *nivel = malloc((numPares > 0 ? numPares : 1) * sizeof(EntradaSecundaria));
+    if (!posicoes || !nivel) {
+        perror("Erro ao alocar o índice secundário");
+        free(pares);
+        free(posicoes);
+        free(nivel);
+        return false;
+    }
+    long numValores = 0;
+    for (long i = 0; i < numPares; i++) {
+        posicoes[i] = pares[i].posicao;
+        metricas->comparacoes++;
+        if (numValores > 0 && nivel[numValores - 1].valor == pares[i].valor) {
+            nivel[numValores - 1].quantidade++;
+        } else {
+            nivel[numValores].valor = pares[i].valor;
+            nivel[numValores].inicio = i;
+            nivel[numValores++].quantidade = 1;
+        }
+    }
+    free(pares);
+
+    CabecalhoSecundario cabecalho = {totalRegistros, TAMANHO_PAGINA_SECUNDARIO, numValores, numPares, 0, 0, 0};
+    PaginaSecundaria *paginas = NULL;
+    long capacidadePaginas = 0;
+    long tamanhoNivel = numValores;
+    bool folha = true;
+    while (tamanhoNivel > 0) {
+        long paginasNivel = (tamanhoNivel + ENTRADAS_PAGINA_SECUNDARIO - 1) / ENTRADAS_PAGINA_SECUNDARIO;
+        if (cabecalho.numPaginas + paginasNivel > capacidadePaginas) {
+            capacidadePaginas = (cabecalho.numPaginas + paginasNivel) * 2;
+            PaginaSecundaria *novas = realloc(paginas, capacidadePaginas * sizeof(PaginaSecundaria));
+            if (!novas) {
+                perror("Erro ao alocar as páginas do índice secundário");
+                free(paginas);
+                free(posicoes);
+                free(nivel);
+                return false;
+            }
+            paginas = novas;
+        }
+
+        // O nível de cima reaproveita o início do vetor do nível atual
+        for (long p = 0; p < paginasNivel; p++) {
+            PaginaSecundaria *pagina = &paginas[cabecalho.numPaginas];
+            long primeira = p * ENTRADAS_PAGINA_SECUNDARIO;
+            long quantidade = tamanhoNivel - primeira < ENTRADAS_PAGINA_SECUNDARIO ? tamanhoNivel - primeira : ENTRADAS_PAGINA_SECUNDARIO;
+            memset(pagina, 0, sizeof(PaginaSecundaria));
+            pagina->folha = folha;
+            pagina->numEntradas = quantidade;
+            memcpy(pagina->entradas, &nivel[primeira], quantidade * sizeof(EntradaSecundaria));
+            cabecalho.numPaginas++;
+
+            nivel[p].valor = pagina->entradas[0].valor;
+            nivel[p].inicio = cabecalho.numPaginas;
+            nivel[p].quantidade = 0;
+        }
+        cabecalho.altura++;
+        folha = false;
+        if (paginasNivel == 1) {
+            cabecalho.raiz = cabecalho.numPaginas;
+            break;
+        }
+        tamanhoNivel = paginasNivel;
+    }
+    free(nivel);
+
+    char caminho[300];
+    caminhoIndiceSecundario(nomeArquivo, caminho, sizeof(caminho));
+    FILE *arquivo = abrirArquivoDados(caminho, "wb");
+    bool sucesso = arquivo != NULL;
+    if (sucesso) {
+        PaginaSecundaria primeira;
+        memset(&primeira, 0, sizeof(primeira));
+        memcpy(&primeira, &cabecalho, sizeof(cabecalho));
+        sucesso = fwrite(&primeira, sizeof(primeira), 1, arquivo) == 1 &&
+                  (long)fwrite(paginas, sizeof(PaginaSecundaria), cabecalho.numPaginas, arquivo) == cabecalho.numPaginas &&
+                  (long)fwrite(posicoes, sizeof(long), numPares, arquivo) == numPares;
+        sucesso = fclose(arquivo) == 0 && sucesso;
+        metricas->transferencias += cabecalho.numPaginas + 1;
+        metricas->bytesEscritos += (cabecalho.numPaginas + 1) * sizeof(PaginaSecundaria) + numPares * sizeof(long);
+        metricas->chamadasSistema += 3;
+    }
+    if (!sucesso) {
+        perror("Erro ao gravar o índice secundário");
+        remove(caminho);
+    }
+
+    free(paginas);
+    free(posicoes);
+    return sucesso;
+}
+
+/**
+ * Abre o índice secundário de um arquivo de registros, extraindo-o com uma leitura
+ * sequencial do arquivo quando o arquivo auxiliar falta ou está desatualizado. O arquivo
+ * auxiliar é aberto com abrirArquivoDados, de modo que, com -D, as páginas lidas na pesquisa
+ * também não passam pelo cache de páginas do sistema.
+ *
+ * @param nomeArquivo Caminho do arquivo de registros.
+ * @param dados Ponteiro para o arquivo de registros aberto com abrirArquivoDados.
+ * @param indice Estrutura onde o índice será aberto.
+ * @param metricas Ponteiro para as métricas da construção; só a extração lê o arquivo.
+ * @return Retorna true se o índice foi aberto.
+ */
+bool abrirIndiceSecundario(const char *nomeArquivo, FILE *dados, IndiceSecundario *indice, Metricas *metricas) {
+    memset(indice, 0, sizeof(IndiceSecundario));
+    fseeko(dados, 0, SEEK_END);
+    long totalRegistros = ftello(dados) / sizeof(Registro);
+
+    if (!lerIndiceSecundario(nomeArquivo, totalRegistros, indice)) {
+        if (!extrairIndiceSecundario(nomeArquivo, dados, totalRegistros, metricas) ||
+            !lerIndiceSecundario(nomeArquivo, totalRegistros, indice)) {
+            return false;
+        }
+    }
+
+    metricas->numNos = indice->cabecalho.numPaginas;
+    metricas->altura = indice->cabecalho.altura;
+    return true;
+}
+
+/**
+ * Lê uma página da árvore com um posicionamento e uma leitura.
+ */
+static bool lerPaginaSecundaria(IndiceSecundario *indice, long numero, PaginaSecundaria *pagina, Metricas *metricas) {
+    registrarPosicionamento(metricas);
+    if (fseeko(indice->arquivo, (off_t)numero * TAMANHO_PAGINA_SECUNDARIO, SEEK_SET) != 0 ||
+        fread(pagina, sizeof(PaginaSecundaria), 1, indice->arquivo) != 1) {
+        return false;
+    }
+    registrarLeitura(metricas, sizeof(PaginaSecundaria));
+    return true;
+}
+
+/**
+ * Busca as posições dos registros cujo dado1 tem o valor dado, descendo uma página por
+ * nível e lendo a lista de posições do valor com uma única leitura.
+ *
+ * @param indice Índice secundário aberto.
+ * @param valor Valor de dado1 buscado.
+ * @param posicoes Onde o vetor de posições, em ordem crescente, será devolvido (NULL se não
+ *                 houver nenhuma); quem chama deve liberá-lo.
+ * @param metricas Ponteiro para as métricas da pesquisa.
+ * @return Número de registros com o valor (0 se não houver nenhum).
+ */
+long buscarIndiceSecundario(IndiceSecundario *indice, long valor, long **posicoes, Metricas *metricas) {
+    *posicoes = NULL;
+    PaginaSecundaria pagina;
+    long numero = indice->cabecalho.raiz;
+
+    while (numero > 0 && lerPaginaSecundaria(indice, numero, &pagina, metricas)) {
+        // Última entrada com valor menor ou igual ao buscado
+        long inicio = 0, fim = pagina.numEntradas - 1, escolhida = -1;
+        while (inicio <= fim) {
+            long meio = inicio + (fim - inicio) / 2;
+            metricas->comparacoes++;
+            if (pagina.entradas[meio].valor <= valor) {
+                escolhida = meio;
+                inicio = meio + 1;
+            } else {
+                fim = meio - 1;
+            }
+        }
+        if (escolhida < 0) {
+            return 0;
+        }
+
+        EntradaSecundaria *entrada = &pagina.entradas[escolhida];
+        if (!pagina.folha) {
+            numero = entrada->inicio;
+            continue;
+        }
+
+        metricas->comparacoes++;
+        if (entrada->valor != valor) {
+            return 0;
+        }
+        long *lista = malloc(entrada->quantidade * sizeof(long));
+        registrarPosicionamento(metricas);
+        if (!lista ||
+            fseeko(indice->arquivo, inicioListas(&indice->cabecalho) + (off_t)entrada->inicio * (off_t)sizeof(long), SEEK_SET) != 0 ||
+            (long)fread(lista, sizeof(long), entrada->quantidade, indice->arquivo) != entrada->quantidade) {
+            free(lista);
+            return 0;
+        }
+        registrarLeitura(metricas, entrada->quantidade * sizeof(long));
+        *posicoes = lista;
+        return entrada->quantidade;
+    }
+    return 0;
+}
+
+/**
+ * Fecha o arquivo auxiliar do índice secundário.
+ */
+void fecharIndiceSecundario(IndiceSecundario *indice) {
+    if (indice->arquivo != NULL) {
+        fclose(indice->arquivo);
+        indice->arquivo = NULL;
+    }
+}
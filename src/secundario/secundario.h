@@ -0,0 +1,54 @@
+#ifndef SECUNDARIO_H
+#define SECUNDARIO_H
+
+#include "../registro/registro.h"
+#include "../metricas/metricas.h"
+#include <stdbool.h>
+#include <stdio.h>
+
+#define TAMANHO_PAGINA_SECUNDARIO 4096 // Bytes de uma página do índice secundário
+#define REGISTROS_BLOCO_SECUNDARIO 1024 // Registros lidos por vez na extração do índice
+
+/*
+ * Índice secundário sobre o campo dado1: uma Árvore B+ paginada, montada de baixo para cima
+ * a partir dos pares (dado1, posição) ordenados. Cada entrada de folha guarda um valor
+ * distinto e a sua lista de posições (valores repetidos aparecem uma vez, com todas as
+ * posições em ordem crescente); cada entrada interna guarda o menor valor da subárvore e o
+ * número da página filha. O índice fica em um arquivo auxiliar com a extensão ".dado1", no
+ * formato: cabeçalho na página 0, páginas da árvore e, por fim, as listas de posições. Como
+ * o mapa de zonas, é extraído de novo quando o arquivo de registros muda.
+ */
+typedef struct {
+    long valor; // Valor de dado1 (na página interna, o menor valor da subárvore)
+    long inicio; // Folha: índice da primeira posição na lista; interna: página filha
+    long quantidade; // Folha: número de posições com esse valor; interna: não usado
+} EntradaSecundaria;
+
+#define ENTRADAS_PAGINA_SECUNDARIO ((TAMANHO_PAGINA_SECUNDARIO - 2 * (int)sizeof(long)) / (int)sizeof(EntradaSecundaria))
+
+typedef struct {
+    long folha; // 1 nas folhas, 0 nas páginas internas
+    long numEntradas;
+    EntradaSecundaria entradas[ENTRADAS_PAGINA_SECUNDARIO];
+} PaginaSecundaria;
+
+typedef struct {
+    long totalRegistros; // Registros do arquivo quando o índice foi extraído
+    long tamanhoPagina;
+    long numValores; // Valores distintos de dado1 entre os registros válidos
+    long numPosicoes; // Registros válidos indexados
+    long numPaginas; // Páginas da árvore, numeradas a partir de 1
+    long raiz; // Página da raiz (0 se o arquivo não tem registros válidos)
+    long altura;
+} CabecalhoSecundario;
+
+typedef struct {
+    FILE *arquivo; // Arquivo auxiliar aberto para leitura
+    CabecalhoSecundario cabecalho;
+} IndiceSecundario;
+
+bool abrirIndiceSecundario(const char *nomeArquivo, FILE *dados, IndiceSecundario *indice, Metricas *metricas);
+long buscarIndiceSecundario(IndiceSecundario *indice, long valor, long **posicoes, Metricas *metricas);
+void fecharIndiceSecundario(IndiceSecundario *indice);
+
+#endif // SECUNDARIO_H
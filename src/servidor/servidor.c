@@ -0,0 +1,466 @@
+#define _GNU_SOURCE
+#include "servidor.h"
+#include "../arvorebstar/arvorebstar.h"
+#include "../construcao/construcao.h"
+#include "../metricas/metricas.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+
+#define EVENTOS_POR_ESPERA 64 // Eventos recolhidos a cada chamada de epoll_wait
+#define ESPERA_CONEXAO_SERVIDOR 2 // Segundos que uma trabalhadora espera pelo resto de um pedido ou pela vez de escrever
+
+/*
+ * Servidor de consultas.
+ *
+ * Cada arquivo da lista é carregado uma vez em uma árvore B*, que fica em memória e não
+ * muda mais, de modo que as threads trabalhadoras a consultam sem travas. A thread
+ * principal é um laço de eventos: aceita conexões e, quando uma conexão tem dados, a põe
+ * na fila das trabalhadoras. A conexão fica desarmada no epoll (EPOLLONESHOT) enquanto uma
+ * trabalhadora a atende e é rearmada quando não há mais pedidos para ler. As leituras e
+ * escritas de uma conexão têm prazo, para que um cliente parado no meio de um pedido não
+ * prenda a trabalhadora: a conexão é fechada quando o prazo acaba.
+ */
+
+typedef struct {
+    const char *nome;
+    NoArvoreBStar *raiz;
+} IndiceResidente;
+
+typedef struct {
+    IndiceResidente indices[MAXIMO_ARQUIVOS_SERVIDOR];
+    int numIndices;
+    int epoll;
+
+    pthread_mutex_t trava;
+    pthread_cond_t temConexao;
+    int *prontas; // Fila circular de conexões com dados para ler
+    int capacidade;
+    int inicioProntas, numProntas;
+    bool encerrar;
+
+    pthread_t trabalhadores[MAXIMO_TRABALHADORES_SERVIDOR];
+    Metricas metricas[MAXIMO_TRABALHADORES_SERVIDOR]; // Métricas de cada trabalhadora
+    int numTrabalhadores;
+} Servidor;
+
+typedef struct {
+    Servidor *servidor;
+    int indice;
+} Trabalhadora;
+
+static volatile sig_atomic_t sinalEncerrar = 0;
+
+static void tratarSinal(int sinal) {
+    (void)sinal;
+    sinalEncerrar = 1;
+}
+
+/**
+ * Lê exatamente a quantidade de bytes pedida, repetindo leituras parciais.
+ *
+ * @return Retorna true se todos os bytes foram lidos; false no fim da conexão ou em erro.
+ */
+bool lerCompleto(int descritor, void *dados, size_t tamanho) {
+    size_t lidos = 0;
+    while (lidos < tamanho) {
+        ssize_t n = recv(descritor, (char *)dados + lidos, tamanho - lidos, 0);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        lidos += n;
+    }
+    return true;
+}
+
+/**
+ * Escreve exatamente a quantidade de bytes pedida, repetindo escritas parciais.
+ *
+ * @return Retorna true se todos os bytes foram escritos.
+ */
+bool escreverCompleto(int descritor, const void *dados, size_t tamanho) {
+    size_t escritos = 0;
+    while (escritos < tamanho) {
+        ssize_t n = send(descritor, (const char *)dados + escritos, tamanho - escritos, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        escritos += n;
+    }
+    return true;
+}
+
+/**
+ * Responde a um pedido consultando a árvore do arquivo pedido.
+ *
+ * @return Retorna true se a resposta foi enviada.
+ */
+static bool responderPedido(Servidor *servidor, int conexao, const PedidoServidor *pedido, Metricas *metricas) {
+    char resposta[sizeof(CabecalhoResposta) + LIMITE_INTERVALO_SERVIDOR * sizeof(EntradaResposta)];
+    CabecalhoResposta *cabecalho = (CabecalhoResposta *)resposta;
+    size_t tamanho = sizeof(CabecalhoResposta);
+    memset(cabecalho, 0, sizeof(CabecalhoResposta));
+    cabecalho->status = RESPOSTA_ERRO;
+
+    // Chaves fora da faixa da Chave mudariam de valor na conversão, então o pedido é inválido
+    bool chavesValidas = pedido->chave >= CHAVE_MINIMA && pedido->chave <= CHAVE_MAXIMA &&
+                         (pedido->tipo != PEDIDO_INTERVALO || (pedido->maximo >= CHAVE_MINIMA && pedido->maximo <= CHAVE_MAXIMA));
+
+    if (chavesValidas && pedido->arquivo < servidor->numIndices) {
+        NoArvoreBStar *raiz = servidor->indices[pedido->arquivo].raiz;
+
+        if (pedido->tipo == PEDIDO_BUSCA) {
+            long posicao;
+            Registro *reg = buscarArvoreBStar(raiz, pedido->chave, &posicao, metricas);
+            cabecalho->status = reg != NULL ? RESPOSTA_ENCONTRADO : RESPOSTA_NAO_ENCONTRADO;
+            if (reg != NULL) {
+                RegistroResposta encontrado;
+                memset(&encontrado, 0, sizeof(encontrado));
+                encontrado.posicao = posicao;
+                encontrado.registro = *reg;
+                memcpy(resposta + tamanho, &encontrado, sizeof(encontrado));
+                tamanho += sizeof(encontrado);
+                cabecalho->quantidade = 1;
+            }
+        } else if (pedido->tipo == PEDIDO_INTERVALO) {
+            Chave chaves[LIMITE_INTERVALO_SERVIDOR];
+            long posicoes[LIMITE_INTERVALO_SERVIDOR];
+            int limite = pedido->limite > 0 && pedido->limite < LIMITE_INTERVALO_SERVIDOR ? pedido->limite : LIMITE_INTERVALO_SERVIDOR;
+            int encontradas = buscarIntervaloArvoreBStar(raiz, pedido->chave, pedido->maximo, chaves, posicoes, limite, metricas);
+
+            for (int i = 0; i < encontradas; i++) {
+                EntradaResposta entrada = {chaves[i], posicoes[i]};
+                memcpy(resposta + tamanho, &entrada, sizeof(entrada));
+                tamanho += sizeof(entrada);
+            }
+            cabecalho->status = encontradas > 0 ? RESPOSTA_ENCONTRADO : RESPOSTA_NAO_ENCONTRADO;
+            cabecalho->quantidade = encontradas;
+        }
+    }
+
+    metricas->consultas++;
+    return escreverCompleto(conexao, resposta, tamanho);
+}
+
+/**
+ * Atende os pedidos disponíveis em uma conexão e a devolve ao laço de eventos.
+ *
+ * O primeiro pedido já está disponível (o epoll avisou); os seguintes são lidos enquanto
+ * houver dados, sem esperar, para atender clientes que enviam vários pedidos seguidos.
+ */
+static void atenderConexao(Servidor *servidor, int conexao, Metricas *metricas) {
+    while (true) {
+        PedidoServidor pedido;
+        ssize_t n = recv(conexao, &pedido, sizeof(pedido), MSG_DONTWAIT);
+
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            struct epoll_event evento = {.events = EPOLLIN | EPOLLONESHOT, .data.fd = conexao};
+            if (epoll_ctl(servidor->epoll, EPOLL_CTL_MOD, conexao, &evento) != 0) {
+                close(conexao);
+            }
+            return;
+        }
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            close(conexao); // Cliente encerrou a conexão
+            return;
+        }
+
+        // Pedido chegou em partes: espera o restante, até o prazo da conexão
+        if ((size_t)n < sizeof(pedido) && !lerCompleto(conexao, (char *)&pedido + n, sizeof(pedido) - n)) {
+            close(conexao);
+            return;
+        }
+
+        if (!responderPedido(servidor, conexao, &pedido, metricas)) {
+            close(conexao);
+            return;
+        }
+    }
+}
+
+/**
+ * Laço de uma thread trabalhadora: retira conexões prontas da fila e as atende.
+ */
+static void* executarTrabalhadora(void *argumento) {
+    Trabalhadora *trabalhadora = argumento;
+    Servidor *servidor = trabalhadora->servidor;
+    Metricas *metricas = &servidor->metricas[trabalhadora->indice];
+
+    pthread_mutex_lock(&servidor->trava);
+    while (true) {
+        while (servidor->numProntas == 0 && !servidor->encerrar) {
+            pthread_cond_wait(&servidor->temConexao, &servidor->trava);
+        }
+        if (servidor->numProntas == 0) {
+            break;
+        }
+
+        int conexao = servidor->prontas[servidor->inicioProntas];
+        servidor->inicioProntas = (servidor->inicioProntas + 1) % servidor->capacidade;
+        servidor->numProntas--;
+        pthread_mutex_unlock(&servidor->trava);
+
+        atenderConexao(servidor, conexao, metricas);
+
+        pthread_mutex_lock(&servidor->trava);
+    }
+    pthread_mutex_unlock(&servidor->trava);
+    return NULL;
+}
+
+/**
+ * Põe uma conexão com dados na fila das trabalhadoras, ampliando a fila se necessário. Se não
+ * houver memória para ampliá-la, a conexão é fechada.
+ */
+static void enfileirarConexao(Servidor *servidor, int conexao) {
+    pthread_mutex_lock(&servidor->trava);
+    if (servidor->numProntas == servidor->capacidade) {
+        int capacidade = servidor->capacidade * 2;
+        int *prontas = malloc(capacidade * sizeof(int));
+        if (!prontas) {
+            pthread_mutex_unlock(&servidor->trava);
+            perror("Erro ao ampliar a fila de conexões");
+            close(conexao);
+            return;
+        }
+        for (int i = 0; i < servidor->numProntas; i++) {
+            prontas[i] = servidor->prontas[(servidor->inicioProntas + i) % servidor->capacidade];
+        }
+        free(servidor->prontas);
+        servidor->prontas = prontas;
+        servidor->capacidade = capacidade;
+        servidor->inicioProntas = 0;
+    }
+    servidor->prontas[(servidor->inicioProntas + servidor->numProntas) % servidor->capacidade] = conexao;
+    servidor->numProntas++;
+    pthread_cond_signal(&servidor->temConexao);
+    pthread_mutex_unlock(&servidor->trava);
+}
+
+/**
+ * Carrega os arquivos em árvores B* residentes, usando a construção paralela.
+ *
+ * @return Retorna true se todos os arquivos foram carregados.
+ */
+static bool carregarIndices(Servidor *servidor, char **arquivos, int numArquivos) {
+    long processadores = sysconf(_SC_NPROCESSORS_ONLN);
+    int threads = processadores > 0 ? (int)processadores : 1;
+
+    for (int i = 0; i < numArquivos; i++) {
+        Metricas construcao;
+        iniciarMetricas(&construcao);
+        NoArvoreBStar *raiz = construirArvoreBStarParalela(arquivos[i], threads, &construcao);
+        finalizarMetricas(&construcao);
+        medirArvoreBStar(raiz, &construcao);
+
+        if (raiz == NULL) {
+            fprintf(stderr, "Não foi possível carregar %s.\n", arquivos[i]);
+            return false;
+        }
+
+        servidor->indices[i].nome = arquivos[i];
+        servidor->indices[i].raiz = raiz;
+        servidor->numIndices++;
+        printf(
+            "Arquivo %d: %s carregado em %.3f s (altura %llu, %llu nós).\n",
+            i,
+            arquivos[i],
+            construcao.tempoReal,
+            (unsigned long long)construcao.altura,
+            (unsigned long long)construcao.numNos
+        );
+    }
+    return true;
+}
+
+/**
+ * Cria o socket de escuta no caminho dado, substituindo um socket antigo.
+ *
+ * @return Descritor do socket ou -1 em caso de erro.
+ */
+static int criarSocketEscuta(const char *caminhoSocket) {
+    struct sockaddr_un endereco;
+    if (strlen(caminhoSocket) >= sizeof(endereco.sun_path)) {
+        fprintf(stderr, "Caminho do socket muito longo: %s\n", caminhoSocket);
+        return -1;
+    }
+
+    int escuta = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (escuta < 0) {
+        perror("Erro ao criar o socket");
+        return -1;
+    }
+
+    memset(&endereco, 0, sizeof(endereco));
+    endereco.sun_family = AF_UNIX;
+    strcpy(endereco.sun_path, caminhoSocket);
+    unlink(caminhoSocket);
+
+    if (bind(escuta, (struct sockaddr *)&endereco, sizeof(endereco)) != 0 || listen(escuta, SOMAXCONN) != 0) {
+        perror("Erro ao escutar no socket");
+        close(escuta);
+        return -1;
+    }
+    return escuta;
+}
+
+/**
+ * Executa o servidor de consultas até receber SIGINT ou SIGTERM.
+ *
+ * @param caminhoSocket Caminho do socket Unix em que o servidor escuta.
+ * @param trabalhadores Número de threads que atendem os pedidos.
+ * @param arquivos Arquivos de registros servidos, na ordem dos índices do protocolo.
+ * @param numArquivos Número de arquivos.
+ * @return 0 se o servidor terminou normalmente ou 1 em caso de erro.
+ */
+int executarServidor(const char *caminhoSocket, int trabalhadores, char **arquivos, int numArquivos) {
+    if (numArquivos < 1 || numArquivos > MAXIMO_ARQUIVOS_SERVIDOR) {
+        fprintf(stderr, "O servidor aceita de 1 a %d arquivos.\n", MAXIMO_ARQUIVOS_SERVIDOR);
+        return 1;
+    }
+    if (trabalhadores < 1 || trabalhadores > MAXIMO_TRABALHADORES_SERVIDOR) {
+        trabalhadores = trabalhadores < 1 ? 1 : MAXIMO_TRABALHADORES_SERVIDOR;
+    }
+
+    Servidor *servidor = calloc(1, sizeof(Servidor));
+    if (!servidor) {
+        perror("Erro ao alocar o servidor");
+        return 1;
+    }
+    if (!carregarIndices(servidor, arquivos, numArquivos)) {
+        for (int i = 0; i < servidor->numIndices; i++) {
+            destruirArvoreBStar(servidor->indices[i].raiz);
+        }
+        free(servidor);
+        return 1;
+    }
+
+    int escuta = criarSocketEscuta(caminhoSocket);
+    servidor->epoll = epoll_create1(EPOLL_CLOEXEC);
+    struct epoll_event evento = {.events = EPOLLIN, .data.fd = escuta};
+    if (escuta < 0 || servidor->epoll < 0 || epoll_ctl(servidor->epoll, EPOLL_CTL_ADD, escuta, &evento) != 0) {
+        if (escuta >= 0) {
+            close(escuta);
+        }
+        for (int i = 0; i < servidor->numIndices; i++) {
+            destruirArvoreBStar(servidor->indices[i].raiz);
+        }
+        free(servidor);
+        return 1;
+    }
+
+    // Encerramento por sinal: o epoll_wait é interrompido e o laço termina
+    struct sigaction acao;
+    memset(&acao, 0, sizeof(acao));
+    acao.sa_handler = tratarSinal;
+    sigaction(SIGINT, &acao, NULL);
+    sigaction(SIGTERM, &acao, NULL);
+
+    pthread_mutex_init(&servidor->trava, NULL);
+    pthread_cond_init(&servidor->temConexao, NULL);
+    servidor->capacidade = 64;
+    servidor->prontas = malloc(servidor->capacidade * sizeof(int));
+    if (!servidor->prontas) {
+        perror("Erro ao alocar a fila de conexões");
+        close(escuta);
+        close(servidor->epoll);
+        unlink(caminhoSocket);
+        pthread_mutex_destroy(&servidor->trava);
+        pthread_cond_destroy(&servidor->temConexao);
+        for (int i = 0; i < servidor->numIndices; i++) {
+            destruirArvoreBStar(servidor->indices[i].raiz);
+        }
+        free(servidor);
+        return 1;
+    }
+
+    Trabalhadora dados[MAXIMO_TRABALHADORES_SERVIDOR];
+    for (int i = 0; i < trabalhadores; i++) {
+        dados[i].servidor = servidor;
+        dados[i].indice = i;
+        iniciarMetricas(&servidor->metricas[i]);
+        if (pthread_create(&servidor->trabalhadores[i], NULL, executarTrabalhadora, &dados[i]) != 0) {
+            break;
+        }
+        servidor->numTrabalhadores++;
+    }
+
+    printf("Servidor escutando em %s com %d trabalhadora(s).\n", caminhoSocket, servidor->numTrabalhadores);
+    fflush(stdout);
+
+    Metricas atendimento;
+    iniciarMetricas(&atendimento);
+
+    struct timeval prazo = {.tv_sec = ESPERA_CONEXAO_SERVIDOR};
+    struct epoll_event eventos[EVENTOS_POR_ESPERA];
+    while (!sinalEncerrar && servidor->numTrabalhadores > 0) {
+        int prontos = epoll_wait(servidor->epoll, eventos, EVENTOS_POR_ESPERA, -1);
+        if (prontos < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("Erro no laço de eventos");
+            break;
+        }
+
+        for (int i = 0; i < prontos; i++) {
+            if (eventos[i].data.fd != escuta) {
+                enfileirarConexao(servidor, eventos[i].data.fd);
+                continue;
+            }
+
+            // Novas conexões: cada uma entra no epoll desarmada após o primeiro aviso
+            int conexao;
+            while ((conexao = accept4(escuta, NULL, NULL, SOCK_CLOEXEC)) >= 0) {
+                struct epoll_event novo = {.events = EPOLLIN | EPOLLONESHOT, .data.fd = conexao};
+                if (setsockopt(conexao, SOL_SOCKET, SO_RCVTIMEO, &prazo, sizeof(prazo)) != 0 ||
+                    setsockopt(conexao, SOL_SOCKET, SO_SNDTIMEO, &prazo, sizeof(prazo)) != 0 ||
+                    epoll_ctl(servidor->epoll, EPOLL_CTL_ADD, conexao, &novo) != 0) {
+                    close(conexao);
+                }
+            }
+        }
+    }
+
+    pthread_mutex_lock(&servidor->trava);
+    servidor->encerrar = true;
+    pthread_cond_broadcast(&servidor->temConexao);
+    pthread_mutex_unlock(&servidor->trava);
+    for (int i = 0; i < servidor->numTrabalhadores; i++) {
+        pthread_join(servidor->trabalhadores[i], NULL);
+        acumularMetricas(&atendimento, &servidor->metricas[i]);
+        atendimento.consultas += servidor->metricas[i].consultas;
+    }
+    finalizarMetricas(&atendimento);
+
+    imprimirMetricas(stdout, FORMATO_TEXTO, "servidor", caminhoSocket, "sessao", "Sessão do Servidor", &atendimento);
+
+    close(escuta);
+    close(servidor->epoll);
+    unlink(caminhoSocket);
+    pthread_mutex_destroy(&servidor->trava);
+    pthread_cond_destroy(&servidor->temConexao);
+    free(servidor->prontas);
+    for (int i = 0; i < servidor->numIndices; i++) {
+        destruirArvoreBStar(servidor->indices[i].raiz);
+    }
+    free(servidor);
+    return 0;
+}
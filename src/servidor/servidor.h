@@ -0,0 +1,59 @@
+#ifndef SERVIDOR_H
+#define SERVIDOR_H
+
+#include "../registro/registro.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define MAXIMO_ARQUIVOS_SERVIDOR 16 // Arquivos de registros mantidos em memória pelo servidor
+#define MAXIMO_TRABALHADORES_SERVIDOR 64 // Limite de threads que atendem os pedidos
+#define LIMITE_INTERVALO_SERVIDOR 256 // Máximo de chaves devolvidas por um pedido de intervalo
+
+/*
+ * Protocolo binário do servidor, na ordem de bytes da máquina (o socket é local).
+ *
+ * Cada pedido é um PedidoServidor. A resposta começa com um CabecalhoResposta; uma busca
+ * encontrada é seguida de um RegistroResposta e um intervalo é seguido de "quantidade"
+ * EntradaResposta, em ordem crescente de chave.
+ */
+typedef enum {
+    PEDIDO_BUSCA = 1, // Busca de uma chave
+    PEDIDO_INTERVALO = 2 // Chaves entre chave e maximo, até o limite pedido
+} TipoPedido;
+
+typedef enum {
+    RESPOSTA_ENCONTRADO = 0,
+    RESPOSTA_NAO_ENCONTRADO = 1,
+    RESPOSTA_ERRO = 2 // Pedido inválido ou arquivo inexistente
+} StatusResposta;
+
+typedef struct {
+    uint8_t tipo; // TipoPedido
+    uint8_t arquivo; // Índice do arquivo na lista do servidor
+    uint16_t limite; // Máximo de chaves de um intervalo
+    int64_t chave; // Chave buscada ou início do intervalo
+    int64_t maximo; // Fim do intervalo
+} PedidoServidor;
+
+typedef struct {
+    uint8_t status; // StatusResposta
+    uint8_t reservado;
+    uint16_t quantidade; // Registros ou entradas que seguem o cabeçalho
+} CabecalhoResposta;
+
+typedef struct {
+    int64_t posicao; // Posição do registro no arquivo
+    Registro registro;
+} RegistroResposta;
+
+typedef struct {
+    int64_t chave;
+    int64_t posicao;
+} EntradaResposta;
+
+bool lerCompleto(int descritor, void *dados, size_t tamanho);
+bool escreverCompleto(int descritor, const void *dados, size_t tamanho);
+int executarServidor(const char *caminhoSocket, int trabalhadores, char **arquivos, int numArquivos);
+
+#endif // SERVIDOR_H
@@ -19,6 +19,25 @@ int arquivoExiste(const char *caminho) {
     return (stat(caminho, &buffer) == 0);
 }
 
+/**
+ * Sorteia um número entre 0 e limite - 1. Limites maiores que RAND_MAX, como as chaves de
+ * arquivos com milhões de registros ou as posições de arquivos com mais de 2^31 registros,
+ * juntam os bits de várias chamadas a rand.
+ *
+ * @param limite Quantidade de valores possíveis (positiva).
+ * @return Número sorteado.
+ */
+static uint64_t sortearAte(uint64_t limite) {
+    if (limite <= (uint64_t)RAND_MAX + 1) {
+        return (uint64_t)rand() % limite;
+    }
+    uint64_t valor = 0;
+    for (int i = 0; i < 3; i++) {
+        valor = (valor << 31) | (uint64_t)(rand() & 0x7fffffff);
+    }
+    return valor % limite;
+}
+
 /**
  * Gera dados aleatórios para um registro.
  *
@@ -29,7 +48,7 @@ int arquivoExiste(const char *caminho) {
  * @param reg Um ponteiro para a estrutura de Registro a ser preenchida.
  * @param chave Um inteiro que será usado como chave do registro.
  */
-void gerarDadosAleatorios(Registro *reg, int chave) {
+void gerarDadosAleatorios(Registro *reg, Chave chave) {
     reg->chave = chave;
     reg->dado1 = rand();
     for (int i = 0; i < TAMANHO_DADO - 1; i++) {
@@ -52,7 +71,7 @@ void gerarDadosAleatorios(Registro *reg, int chave) {
  * @param modo Modo de geração das chaves dos registros (ascendente, descendente ou aleatório).
  * @return Retorna 1 para sucesso ou -1 para falha na criação do arquivo.
  */
-int gerarArquivo(const char *caminhoCompleto, int quantidade, int modo) {
+int gerarArquivo(const char *caminhoCompleto, long quantidade, int modo) {
     // Verifica se o arquivo já existe
     if (arquivoExiste(caminhoCompleto)) {
         printf("Arquivo já existe: %s\n\n", caminhoCompleto);
@@ -67,17 +86,23 @@ int gerarArquivo(const char *caminhoCompleto, int quantidade, int modo) {
     }
 
     Registro reg;
-    int chaveAtual = (modo == 2) ? (quantidade + 1) : 0; // Define a chave inicial com base no modo
+    Chave chaveAtual = (modo == 2) ? (Chave)(quantidade + 1) : 0; // Define a chave inicial com base no modo
+
+    // Chaves aleatórias vão de 1 a quantidade * 1000, calculado em 64 bits e limitado à maior chave
+    uint64_t faixaAleatoria = (uint64_t)quantidade * 1000;
+    if (faixaAleatoria > (uint64_t)CHAVE_MAXIMA - 1) {
+        faixaAleatoria = (uint64_t)CHAVE_MAXIMA - 1;
+    }
 
     // Gera e escreve cada registro individualmente no arquivo
-    for (int i = 0; i < quantidade; i++) {
+    for (long i = 0; i < quantidade; i++) {
         // Gera a chave do registro de acordo com o modo especificado
         if (modo == 1) { // Modo ascendente
             chaveAtual++;
         } else if (modo == 2) { // Modo descendente
             chaveAtual--;
         } else if (modo == 3) { // Modo aleatório
-            chaveAtual = rand() % (quantidade * 1000) + 1;
+            chaveAtual = (Chave)(sortearAte(faixaAleatoria) + 1);
         }
 
         gerarDadosAleatorios(&reg, chaveAtual); // Gera dados aleatórios para o registro
@@ -92,3 +117,48 @@ int gerarArquivo(const char *caminhoCompleto, int quantidade, int modo) {
     return 1; // Retorna 1 para indicar sucesso na criação do arquivo
 }
 
+/**
+ * Sorteia chaves existentes em um arquivo de registros para compor um lote de consultas.
+ *
+ * Esta função escolhe posições aleatórias do arquivo e usa as chaves dos registros nelas
+ * guardados, ignorando posições removidas. As leituras feitas aqui não entram nas métricas.
+ *
+ * @param arquivo Ponteiro para o arquivo de registros.
+ * @param chaves Vetor onde as chaves sorteadas serão armazenadas.
+ * @param quantidade Número de chaves a sortear.
+ */
+void sortearChaves(FILE *arquivo, Chave *chaves, int quantidade) {
+    fseeko(arquivo, 0, SEEK_END);
+    long totalRegistros = ftello(arquivo) / sizeof(Registro);
+    Registro reg;
+
+    for (int i = 0; i < quantidade; i++) {
+        chaves[i] = CHAVE_REMOVIDA;
+        // Algumas tentativas para não sortear uma lápide
+        for (int tentativa = 0; tentativa < 8 && totalRegistros > 0; tentativa++) {
+            long posicao = (long)sortearAte(totalRegistros);
+            fseeko(arquivo, DESLOCAMENTO_REGISTRO(posicao), SEEK_SET);
+            if (fread(&reg, sizeof(Registro), 1, arquivo) == 1 && registroValido(&reg)) {
+                chaves[i] = reg.chave;
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * Verifica se um arquivo auxiliar (mapa de zonas, índice secundário, ajuste) foi gravado
+ * depois da última alteração do arquivo de registros a que se refere.
+ *
+ * @param nomeArquivo Caminho do arquivo de registros.
+ * @param caminhoAuxiliar Caminho do arquivo auxiliar.
+ * @return Retorna true se os dois arquivos existem e o auxiliar é mais recente.
+ */
+bool auxiliarAtualizado(const char *nomeArquivo, const char *caminhoAuxiliar) {
+    struct stat dados, auxiliar;
+    if (stat(nomeArquivo, &dados) != 0 || stat(caminhoAuxiliar, &auxiliar) != 0) {
+        return false;
+    }
+    return auxiliar.st_mtim.tv_sec > dados.st_mtim.tv_sec ||
+           (auxiliar.st_mtim.tv_sec == dados.st_mtim.tv_sec && auxiliar.st_mtim.tv_nsec > dados.st_mtim.tv_nsec);
+}
@@ -1,7 +1,12 @@
 #ifndef UTIL_H
 #define UTIL_H
 
+#include "../registro/registro.h"
+
 // Protótipos de funções utilitárias
-int gerarArquivo(const char *caminhoCompleto, int quantidade, int modo);
+void gerarDadosAleatorios(Registro *reg, Chave chave);
+int gerarArquivo(const char *caminhoCompleto, long quantidade, int modo);
+void sortearChaves(FILE *arquivo, Chave *chaves, int quantidade);
+bool auxiliarAtualizado(const char *nomeArquivo, const char *caminhoAuxiliar);
 
 #endif
@@ -0,0 +1,416 @@
+#include "varredura.h"
+#include <fcntl.h>
+#include <immintrin.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*
+ * Procura a primeira ocorrência de uma chave em chaves[inicio..fim).
+ * Retorna a posição encontrada ou -1.
+ */
+typedef long (*ProcurarChave)(const Chave *chaves, long inicio, long fim, Chave chave);
+
+static long procurarEscalar(const Chave *chaves, long inicio, long fim, Chave chave) {
+    for (long i = inicio; i < fim; i++) {
+        if (chaves[i] == chave) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/*
+ * Operações vetoriais conforme a largura da chave: um vetor AVX2 tem 8 chaves de 32 bits
+ * ou 4 de 64 bits, e um vetor AVX-512 tem o dobro.
+ */
+#ifdef CHAVE_64_BITS
+#define CHAVES_AVX2 4
+#define CHAVES_AVX512 8
+#define repetirAvx2(chave) _mm256_set1_epi64x(chave)
+#define mascaraAvx2(vetor, alvo) _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(vetor, alvo)))
+#define repetirAvx512(chave) _mm512_set1_epi64(chave)
+#define mascaraAvx512(vetor, alvo) _mm512_cmpeq_epi64_mask(vetor, alvo)
+#else
+#define CHAVES_AVX2 8
+#define CHAVES_AVX512 16
+#define repetirAvx2(chave) _mm256_set1_epi32(chave)
+#define mascaraAvx2(vetor, alvo) _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(vetor, alvo)))
+#define repetirAvx512(chave) _mm512_set1_epi32(chave)
+#define mascaraAvx512(vetor, alvo) _mm512_cmpeq_epi32_mask(vetor, alvo)
+#endif
+
+/**
+ * Compara quatro vetores AVX2 de chaves por iteração, juntando as máscaras das comparações.
+ */
+__attribute__((target("avx2")))
+static long procurarAvx2(const Chave *chaves, long inicio, long fim, Chave chave) {
+    __m256i alvo = repetirAvx2(chave);
+    long i = inicio;
+
+    for (; i + 4 * CHAVES_AVX2 <= fim; i += 4 * CHAVES_AVX2) {
+        uint64_t a = (uint64_t)mascaraAvx2(_mm256_loadu_si256((const __m256i *)(chaves + i)), alvo);
+        uint64_t b = (uint64_t)mascaraAvx2(_mm256_loadu_si256((const __m256i *)(chaves + i + CHAVES_AVX2)), alvo);
+        uint64_t c = (uint64_t)mascaraAvx2(_mm256_loadu_si256((const __m256i *)(chaves + i + 2 * CHAVES_AVX2)), alvo);
+        uint64_t d = (uint64_t)mascaraAvx2(_mm256_loadu_si256((const __m256i *)(chaves + i + 3 * CHAVES_AVX2)), alvo);
+        uint64_t mascara = a | (b << CHAVES_AVX2) | (c << 2 * CHAVES_AVX2) | (d << 3 * CHAVES_AVX2);
+        if (mascara != 0) {
+            return i + __builtin_ctzll(mascara);
+        }
+    }
+    for (; i + CHAVES_AVX2 <= fim; i += CHAVES_AVX2) {
+        int mascara = mascaraAvx2(_mm256_loadu_si256((const __m256i *)(chaves + i)), alvo);
+        if (mascara != 0) {
+            return i + __builtin_ctz(mascara);
+        }
+    }
+    return procurarEscalar(chaves, i, fim, chave);
+}
+
+/**
+ * Compara quatro vetores AVX-512 de chaves por iteração, com máscaras de comparação.
+ */
+__attribute__((target("avx512f")))
+static long procurarAvx512(const Chave *chaves, long inicio, long fim, Chave chave) {
+    __m512i alvo = repetirAvx512(chave);
+    long i = inicio;
+
+    for (; i + 4 * CHAVES_AVX512 <= fim; i += 4 * CHAVES_AVX512) {
+        uint64_t a = mascaraAvx512(_mm512_loadu_si512(chaves + i), alvo);
+        uint64_t b = mascaraAvx512(_mm512_loadu_si512(chaves + i + CHAVES_AVX512), alvo);
+        uint64_t c = mascaraAvx512(_mm512_loadu_si512(chaves + i + 2 * CHAVES_AVX512), alvo);
+        uint64_t d = mascaraAvx512(_mm512_loadu_si512(chaves + i + 3 * CHAVES_AVX512), alvo);
+        uint64_t mascara = a | (b << CHAVES_AVX512) | (c << 2 * CHAVES_AVX512) | (d << 3 * CHAVES_AVX512);
+        if (mascara != 0) {
+            return i + __builtin_ctzll(mascara);
+        }
+    }
+    for (; i + CHAVES_AVX512 <= fim; i += CHAVES_AVX512) {
+        uint64_t mascara = mascaraAvx512(_mm512_loadu_si512(chaves + i), alvo);
+        if (mascara != 0) {
+            return i + __builtin_ctzll(mascara);
+        }
+    }
+    return procurarEscalar(chaves, i, fim, chave);
+}
+
+static ProcurarChave procurar = NULL;
+static const char *nomeInstrucoes = "escalar";
+
+/**
+ * Escolhe, uma única vez, a versão da procura adequada ao processador.
+ */
+static void escolherProcura(void) {
+    if (procurar != NULL) {
+        return;
+    }
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        procurar = procurarAvx512;
+        nomeInstrucoes = "avx512";
+    } else if (__builtin_cpu_supports("avx2")) {
+        procurar = procurarAvx2;
+        nomeInstrucoes = "avx2";
+    } else {
+        procurar = procurarEscalar;
+        nomeInstrucoes = "escalar";
+    }
+}
+
+/**
+ * Retorna o nome do conjunto de instruções usado pela varredura (avx512, avx2 ou escalar).
+ */
+const char *instrucoesVarredura(void) {
+    escolherProcura();
+    return nomeInstrucoes;
+}
+
+typedef struct {
+    const Registro *registros; // Arquivo mapeado em memória
+    const ColunaChaves *coluna;
+    long inicio; // Trecho da coluna tratado pela thread
+    long fim;
+    const Chave *consultas; // Chaves procuradas
+    int quantidade;
+    long *posicoes; // Primeira posição de cada consulta no trecho, ou -1
+    atomic_long *menores; // Menor posição de cada consulta já encontrada por alguma thread
+    uint64_t comparacoes;
+} TarefaVarredura;
+
+/**
+ * Executa uma função sobre cada tarefa de um vetor, uma thread por tarefa, como na construção
+ * paralela. Uma tarefa cuja thread não pôde ser criada é executada pela thread chamadora.
+ */
+static void executarTarefas(void *(*funcao)(void *), TarefaVarredura *tarefas, int quantidade) {
+    pthread_t threads[MAXIMO_THREADS_VARREDURA];
+    bool criada[MAXIMO_THREADS_VARREDURA];
+
+    for (int i = 1; i < quantidade; i++) {
+        criada[i] = pthread_create(&threads[i], NULL, funcao, &tarefas[i]) == 0;
+        if (!criada[i]) {
+            funcao(&tarefas[i]);
+        }
+    }
+    funcao(&tarefas[0]);
+
+    for (int i = 1; i < quantidade; i++) {
+        if (criada[i]) {
+            pthread_join(threads[i], NULL);
+        }
+    }
+}
+
+/**
+ * Divide a coluna em trechos contíguos, um por thread.
+ *
+ * @return Número de tarefas preenchidas.
+ */
+static int dividirTarefas(const ColunaChaves *coluna, int numThreads, TarefaVarredura *tarefas) {
+    if (numThreads < 1) {
+        numThreads = 1;
+    }
+    if (numThreads > MAXIMO_THREADS_VARREDURA) {
+        numThreads = MAXIMO_THREADS_VARREDURA;
+    }
+    if (numThreads > coluna->total / BLOCO_VARREDURA) {
+        numThreads = coluna->total / BLOCO_VARREDURA > 0 ? (int)(coluna->total / BLOCO_VARREDURA) : 1;
+    }
+
+    memset(tarefas, 0, numThreads * sizeof(TarefaVarredura));
+    for (int i = 0; i < numThreads; i++) {
+        tarefas[i].coluna = coluna;
+        tarefas[i].inicio = coluna->total * i / numThreads;
+        tarefas[i].fim = coluna->total * (i + 1) / numThreads;
+    }
+    return numThreads;
+}
+
+static void *copiarChaves(void *argumento) {
+    TarefaVarredura *tarefa = argumento;
+    for (long i = tarefa->inicio; i < tarefa->fim; i++) {
+        tarefa->coluna->chaves[i] = tarefa->registros[i].chave;
+    }
+    return NULL;
+}
+
+/**
+ * Copia as chaves de um arquivo de registros para uma coluna contígua em memória. O arquivo
+ * é mapeado em memória e cada thread copia um trecho.
+ *
+ * @param nomeArquivo Caminho do arquivo de registros.
+ * @param numThreads Número de threads da cópia.
+ * @param coluna Onde a coluna será armazenada.
+ * @param metricas Ponteiro para as métricas da construção.
+ * @return Retorna true se a coluna foi extraída.
+ */
+bool extrairColunaChaves(const char *nomeArquivo, int numThreads, ColunaChaves *coluna, Metricas *metricas) {
+    coluna->chaves = NULL;
+    coluna->total = 0;
+
+    int descritor = open(nomeArquivo, O_RDONLY);
+    if (descritor < 0) {
+        perror("Erro ao abrir o arquivo");
+        return false;
+    }
+    struct stat estado;
+    if (fstat(descritor, &estado) != 0) {
+        perror("Erro ao consultar o arquivo");
+        close(descritor);
+        return false;
+    }
+
+    long total = estado.st_size / sizeof(Registro);
+    const Registro *registros = NULL;
+    if (total > 0) {
+        registros = mmap(NULL, total * sizeof(Registro), PROT_READ, MAP_PRIVATE, descritor, 0);
+        metricas->chamadasSistema++;
+        if (registros == MAP_FAILED) {
+            perror("Erro ao mapear o arquivo");
+            close(descritor);
+            return false;
+        }
+        madvise((void *)registros, total * sizeof(Registro), MADV_SEQUENTIAL);
+    }
+    close(descritor);
+
+    // Folga de um vetor AVX-512 no fim, para que as leituras vetoriais nunca passem do bloco
+    coluna->chaves = aligned_alloc(64, ((total + 16) * sizeof(Chave) + 63) / 64 * 64);
+    if (!coluna->chaves) {
+        perror("Erro ao alocar a coluna de chaves");
+        if (registros != NULL) {
+            munmap((void *)registros, total * sizeof(Registro));
+        }
+        return false;
+    }
+    coluna->total = total;
+
+    TarefaVarredura tarefas[MAXIMO_THREADS_VARREDURA];
+    int numTarefas = dividirTarefas(coluna, numThreads, tarefas);
+    for (int i = 0; i < numTarefas; i++) {
+        tarefas[i].registros = registros;
+    }
+    executarTarefas(copiarChaves, tarefas, numTarefas);
+
+    if (registros != NULL) {
+        munmap((void *)registros, total * sizeof(Registro));
+    }
+
+    metricas->transferencias += total;
+    metricas->bytesLidos += total * sizeof(Registro);
+    metricas->numNos = 1;
+    metricas->altura = 1;
+    return true;
+}
+
+static void *procurarLoteTrecho(void *argumento) {
+    TarefaVarredura *tarefa = argumento;
+    const Chave *chaves = tarefa->coluna->chaves;
+    int pendentes = 0;
+
+    for (int q = 0; q < tarefa->quantidade; q++) {
+        tarefa->posicoes[q] = tarefa->consultas[q] == CHAVE_REMOVIDA ? -2 : -1;
+        pendentes += tarefa->posicoes[q] == -1;
+    }
+
+    // Cada bloco é percorrido por todas as consultas pendentes enquanto está na cache. Uma
+    // consulta já encontrada por uma thread de um trecho anterior deixa de ser procurada.
+    for (long inicio = tarefa->inicio; inicio < tarefa->fim && pendentes > 0; inicio += BLOCO_VARREDURA) {
+        long fim = inicio + BLOCO_VARREDURA < tarefa->fim ? inicio + BLOCO_VARREDURA : tarefa->fim;
+        for (int q = 0; q < tarefa->quantidade; q++) {
+            if (tarefa->posicoes[q] != -1) {
+                continue;
+            }
+            if (atomic_load_explicit(&tarefa->menores[q], memory_order_relaxed) < tarefa->inicio) {
+                tarefa->posicoes[q] = -2;
+                pendentes--;
+                continue;
+            }
+            long posicao = procurar(chaves, inicio, fim, tarefa->consultas[q]);
+            if (posicao >= 0) {
+                tarefa->comparacoes += posicao - inicio + 1;
+                tarefa->posicoes[q] = posicao;
+                pendentes--;
+                long menor = atomic_load_explicit(&tarefa->menores[q], memory_order_relaxed);
+                while (posicao < menor &&
+                       !atomic_compare_exchange_weak_explicit(&tarefa->menores[q], &menor, posicao, memory_order_relaxed, memory_order_relaxed)) {
+                }
+            } else {
+                tarefa->comparacoes += fim - inicio;
+            }
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Busca um lote de chaves na coluna, retornando a primeira ocorrência de cada uma. Cada
+ * thread percorre o próprio trecho uma vez, em blocos de BLOCO_VARREDURA chaves comparados
+ * com todas as consultas ainda pendentes.
+ *
+ * @param coluna Coluna de chaves do arquivo.
+ * @param chaves Chaves buscadas.
+ * @param quantidade Número de chaves buscadas.
+ * @param posicoes Onde a posição de cada chave será armazenada (-1 se não existe).
+ * @param numThreads Número de threads que dividem a coluna.
+ * @param metricas Ponteiro para as métricas da pesquisa.
+ */
+void buscarLoteColunaChaves(const ColunaChaves *coluna, const Chave *chaves, int quantidade, long *posicoes, int numThreads, Metricas *metricas) {
+    escolherProcura();
+    for (int q = 0; q < quantidade; q++) {
+        posicoes[q] = -1;
+    }
+    if (coluna->total == 0) {
+        return;
+    }
+
+    TarefaVarredura tarefas[MAXIMO_THREADS_VARREDURA];
+    int numTarefas = dividirTarefas(coluna, numThreads, tarefas);
+    long *parciais = malloc((size_t)numTarefas * quantidade * sizeof(long));
+    atomic_long *menores = malloc(quantidade * sizeof(atomic_long));
+    if (!parciais || !menores) {
+        perror("Erro ao alocar os resultados da varredura");
+        free(parciais);
+        free(menores);
+        return;
+    }
+    for (int q = 0; q < quantidade; q++) {
+        atomic_init(&menores[q], coluna->total);
+    }
+    for (int i = 0; i < numTarefas; i++) {
+        tarefas[i].consultas = chaves;
+        tarefas[i].quantidade = quantidade;
+        tarefas[i].posicoes = parciais + (size_t)i * quantidade;
+        tarefas[i].menores = menores;
+    }
+    executarTarefas(procurarLoteTrecho, tarefas, numTarefas);
+
+    // Os trechos estão em ordem, então o primeiro que encontrou a chave tem a primeira ocorrência
+    for (int i = 0; i < numTarefas; i++) {
+        metricas->comparacoes += tarefas[i].comparacoes;
+        for (int q = 0; q < quantidade; q++) {
+            if (posicoes[q] < 0 && tarefas[i].posicoes[q] >= 0) {
+                posicoes[q] = tarefas[i].posicoes[q];
+            }
+        }
+    }
+    free(menores);
+    free(parciais);
+}
+
+/**
+ * Busca a primeira ocorrência de uma chave comparando-a com as chaves da coluna.
+ *
+ * @param coluna Coluna de chaves do arquivo.
+ * @param chave Chave buscada.
+ * @param numThreads Número de threads que dividem a coluna.
+ * @param metricas Ponteiro para as métricas da pesquisa.
+ * @return Posição do registro no arquivo ou -1 se a chave não existe.
+ */
+long buscarColunaChaves(const ColunaChaves *coluna, Chave chave, int numThreads, Metricas *metricas) {
+    long posicao;
+    buscarLoteColunaChaves(coluna, &chave, 1, &posicao, numThreads, metricas);
+    return posicao;
+}
+
+/**
+ * Busca todas as ocorrências de uma chave em uma única passada pela coluna: cada procura
+ * vetorial recomeça logo depois da ocorrência anterior.
+ *
+ * @param coluna Coluna de chaves do arquivo.
+ * @param chave Chave buscada.
+ * @param posicoes Vetor onde as posições das ocorrências serão armazenadas, até o limite.
+ * @param limite Tamanho do vetor de posições.
+ * @param metricas Ponteiro para as métricas da pesquisa.
+ * @return Número de ocorrências da chave, que pode passar do limite.
+ */
+int buscarTodasColunaChaves(const ColunaChaves *coluna, Chave chave, long *posicoes, int limite, Metricas *metricas) {
+    escolherProcura();
+    int encontradas = 0;
+    long inicio = 0;
+    while (inicio < coluna->total) {
+        long posicao = procurar(coluna->chaves, inicio, coluna->total, chave);
+        if (posicao < 0) {
+            metricas->comparacoes += coluna->total - inicio;
+            break;
+        }
+        metricas->comparacoes += posicao - inicio + 1;
+        if (encontradas < limite) {
+            posicoes[encontradas] = posicao;
+        }
+        encontradas++;
+        inicio = posicao + 1;
+    }
+    return encontradas;
+}
+
+/**
+ * Libera a memória da coluna de chaves.
+ */
+void liberarColunaChaves(ColunaChaves *coluna) {
+    free(coluna->chaves);
+    coluna->chaves = NULL;
+    coluna->total = 0;
+}
@@ -0,0 +1,29 @@
+#ifndef VARREDURA_H
+#define VARREDURA_H
+
+#include "../registro/registro.h"
+#include "../metricas/metricas.h"
+#include <stdbool.h>
+
+#define MAXIMO_THREADS_VARREDURA 64 // Limite de threads da varredura
+#define BLOCO_VARREDURA 4096 // Chaves percorridas por todas as consultas de um lote antes do bloco seguinte
+
+/*
+ * Coluna com as chaves de um arquivo de registros, na ordem do arquivo, para a pesquisa por
+ * força bruta: sem estrutura de índice, cada consulta compara a chave com todas as chaves
+ * da coluna até encontrá-la. As comparações usam instruções vetoriais (AVX-512 ou AVX2,
+ * escolhidas em tempo de execução) e podem ser divididas entre threads por trechos.
+ */
+typedef struct {
+    Chave *chaves; // Chave de cada registro, incluindo as lápides
+    long total; // Número de registros
+} ColunaChaves;
+
+bool extrairColunaChaves(const char *nomeArquivo, int numThreads, ColunaChaves *coluna, Metricas *metricas);
+long buscarColunaChaves(const ColunaChaves *coluna, Chave chave, int numThreads, Metricas *metricas);
+int buscarTodasColunaChaves(const ColunaChaves *coluna, Chave chave, long *posicoes, int limite, Metricas *metricas);
+void buscarLoteColunaChaves(const ColunaChaves *coluna, const Chave *chaves, int quantidade, long *posicoes, int numThreads, Metricas *metricas);
+const char *instrucoesVarredura(void);
+void liberarColunaChaves(ColunaChaves *coluna);
+
+#endif // VARREDURA_H
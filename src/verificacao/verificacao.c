@@ -0,0 +1,322 @@
+#include "verificacao.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+/**
+ * Sorteia um número em [0, limite) com xorshift64*, reproduzível a partir da semente.
+ */
+static uint64_t sortear(uint64_t *estado, uint64_t limite) {
+    *estado ^= *estado >> 12;
+    *estado ^= *estado << 25;
+    *estado ^= *estado >> 27;
+    return (*estado * 2685821657736338717ULL) % limite;
+}
+
+/**
+ * Confere uma posição devolvida por uma árvore: ela deve estar presente e ter a chave buscada.
+ */
+static bool posicaoValida(const OraculoDuplicatas *oraculo, Chave chave, long posicao) {
+    return posicao >= 0 && posicao < OPERACOES_DUPLICATAS && oraculo->presente[posicao] && oraculo->chaveDe[posicao] == chave;
+}
+
+/**
+ * Confere, para cada chave, a busca simples, a busca de todas as ocorrências e a busca em lote
+ * das duas árvores contra os seus oráculos.
+ *
+ * @return Número de divergências encontradas.
+ */
+static int conferirChaves(NoArvoreB *arvoreB, NoArvoreBStar *arvoreBStar, const OraculoDuplicatas *oraculoB, const OraculoDuplicatas *oraculoBStar, int rodada, int operacao) {
+    Metricas metricas = {0};
+    long posicoes[OPERACOES_DUPLICATAS];
+    Registro *registros[OPERACOES_DUPLICATAS];
+    Chave chaves[CHAVES_DUPLICATAS];
+    Entrada *entradasLote[CHAVES_DUPLICATAS];
+    Registro *registrosLote[CHAVES_DUPLICATAS];
+    long posicoesLote[CHAVES_DUPLICATAS];
+    int divergencias = 0;
+
+    for (int c = 0; c < CHAVES_DUPLICATAS; c++) {
+        chaves[c] = c;
+    }
+    buscarLoteArvoreB(arvoreB, chaves, CHAVES_DUPLICATAS, entradasLote, &metricas);
+    buscarLoteArvoreBStar(arvoreBStar, chaves, CHAVES_DUPLICATAS, registrosLote, posicoesLote, &metricas);
+
+    for (int c = 0; c < CHAVES_DUPLICATAS; c++) {
+        int esperadas = oraculoB->ocorrencias[c];
+        bool ok = true;
+
+        Entrada *entrada = buscarNoArvoreB(arvoreB, c, &metricas);
+        ok &= esperadas > 0 ? entrada != NULL && posicaoValida(oraculoB, c, entrada->posicao) : entrada == NULL;
+        ok &= esperadas > 0 ? entradasLote[c] != NULL && posicaoValida(oraculoB, c, entradasLote[c]->posicao) : entradasLote[c] == NULL;
+        int encontradas = buscarTodosArvoreB(arvoreB, c, posicoes, OPERACOES_DUPLICATAS, &metricas);
+        ok &= encontradas == esperadas;
+        for (int i = 0; ok && i < encontradas; i++) {
+            ok &= posicaoValida(oraculoB, c, posicoes[i]);
+        }
+        if (!ok) {
+            fprintf(stderr, "Árvore B (ordem %d), rodada %d, operação %d: chave %d com %d ocorrências divergentes.\n", ORDEM_ARVORE_B, rodada, operacao, c, esperadas);
+            divergencias++;
+        }
+
+        esperadas = oraculoBStar->ocorrencias[c];
+        ok = true;
+        long posicao = -1;
+        Registro *registro = buscarArvoreBStar(arvoreBStar, c, &posicao, &metricas);
+        ok &= esperadas > 0 ? registro != NULL && posicaoValida(oraculoBStar, c, posicao) : registro == NULL;
+        ok &= esperadas > 0 ? registrosLote[c] != NULL && posicaoValida(oraculoBStar, c, posicoesLote[c]) : registrosLote[c] == NULL;
+        encontradas = buscarTodosArvoreBStar(arvoreBStar, c, registros, posicoes, OPERACOES_DUPLICATAS, &metricas);
+        ok &= encontradas == esperadas;
+        for (int i = 0; ok && i < encontradas; i++) {
+            ok &= posicaoValida(oraculoBStar, c, posicoes[i]) && registros[i]->chave == c;
+        }
+        if (!ok) {
+            fprintf(stderr, "Árvore B* (ordem %d), rodada %d, operação %d: chave %d com %d ocorrências divergentes.\n", ORDEM_ARVORE_BSTAR, rodada, operacao, c, esperadas);
+            divergencias++;
+        }
+    }
+    return divergencias;
+}
+
+/**
+ * Aplica inclusões, remoções e buscas sorteadas sobre poucas chaves, muito repetidas, às
+ * árvores B e B* e aos seus oráculos, conferindo cada remoção e, periodicamente, todas as chaves.
+ *
+ * @return Número de divergências encontradas.
+ */
+static int verificarDuplicatas(int rodada) {
+    // As duas árvores podem tirar ocorrências diferentes de uma chave, então cada uma tem o seu
+    OraculoDuplicatas oraculos[2]; // Árvore B e árvore B*
+    bool alocados = true;
+    for (int a = 0; a < 2; a++) {
+        memset(oraculos[a].ocorrencias, 0, sizeof(oraculos[a].ocorrencias));
+        oraculos[a].chaveDe = calloc(OPERACOES_DUPLICATAS, sizeof(int));
+        oraculos[a].presente = calloc(OPERACOES_DUPLICATAS, sizeof(bool));
+        alocados &= oraculos[a].chaveDe != NULL && oraculos[a].presente != NULL;
+    }
+    OraculoDuplicatas *oraculoB = &oraculos[0], *oraculoBStar = &oraculos[1];
+    int divergencias = 0;
+    if (!alocados) {
+        perror("Erro ao alocar o oráculo");
+        divergencias = 1;
+    }
+
+    uint64_t estado = 0x9E3779B97F4A7C15ULL * (uint64_t)(rodada + 1);
+    NoArvoreB *arvoreB = NULL;
+    NoArvoreBStar *arvoreBStar = NULL;
+    Metricas metricas = {0};
+    Registro reg = {0};
+
+    for (long posicao = 0; posicao < OPERACOES_DUPLICATAS && divergencias == 0; posicao++) {
+        Chave chave = (Chave)sortear(&estado, CHAVES_DUPLICATAS);
+        if (sortear(&estado, 5) < 3) {
+            // Inclusão: a posição da operação identifica a ocorrência
+            reg.chave = chave;
+            arvoreB = inserirNoArvoreB(arvoreB, chave, posicao, &metricas);
+            arvoreBStar = inserirArvoreBStar(arvoreBStar, reg, posicao, &metricas);
+            for (int a = 0; a < 2; a++) {
+                oraculos[a].chaveDe[posicao] = chave;
+                oraculos[a].presente[posicao] = true;
+                oraculos[a].ocorrencias[chave]++;
+            }
+        } else {
+            // Remoção: cada árvore tira uma ocorrência qualquer da chave, se houver
+            long removidas[2];
+            int esperadas = oraculoB->ocorrencias[chave];
+            arvoreB = removerDaArvoreB(arvoreB, chave, &removidas[0], &metricas);
+            arvoreBStar = removerArvoreBStar(arvoreBStar, chave, &removidas[1], &metricas);
+            for (int a = 0; a < 2; a++) {
+                bool ok = esperadas > 0 ? posicaoValida(&oraculos[a], chave, removidas[a]) : removidas[a] == -1;
+                if (!ok) {
+                    fprintf(
+                        stderr,
+                        "%s, rodada %d, operação %ld: remoção da chave %" FORMATO_CHAVE " com %d ocorrências devolveu %ld.\n",
+                        a == 0 ? "Árvore B" : "Árvore B*", rodada, posicao, chave, esperadas, removidas[a]
+                    );
+                    divergencias++;
+                } else if (esperadas > 0) {
+                    oraculos[a].presente[removidas[a]] = false;
+                    oraculos[a].ocorrencias[chave]--;
+                }
+            }
+        }
+
+        if (divergencias == 0 && posicao % 500 == 499) {
+            divergencias += conferirChaves(arvoreB, arvoreBStar, oraculoB, oraculoBStar, rodada, (int)posicao);
+        }
+    }
+    if (divergencias == 0) {
+        divergencias += conferirChaves(arvoreB, arvoreBStar, oraculoB, oraculoBStar, rodada, OPERACOES_DUPLICATAS);
+    }
+
+    destruirArvoreB(arvoreB);
+    destruirArvoreBStar(arvoreBStar);
+    for (int a = 0; a < 2; a++) {
+        free(oraculos[a].chaveDe);
+        free(oraculos[a].presente);
+    }
+    return divergencias;
+}
+
+/**
+ * Confere uma busca na árvore concorrente: a chave 2 * i deve estar na posição i se
+ * "presente", pode estar se "talvez" e uma chave ímpar nunca deve ser encontrada.
+ */
+static bool buscaConcorrenteValida(ArvoreBConcorrente *arvore, Chave chave, bool presente, bool talvez, Metricas *metricas) {
+    long posicao = -1;
+    bool encontrada = buscarArvoreBConcorrente(arvore, chave, &posicao, metricas);
+    if (chave % 2 != 0) {
+        return !encontrada;
+    }
+    if (!encontrada) {
+        return !presente;
+    }
+    return (presente || talvez) && posicao == chave / 2;
+}
+
+/**
+ * Insere as chaves atribuídas a um escritor, conferindo cada uma logo depois de inseri-la.
+ */
+static void* escreverVerificacao(void *argumento) {
+    TarefaVerificacaoConcorrente *tarefa = argumento;
+    Metricas metricas = {0};
+    for (long i = tarefa->inicio; i < CHAVES_CONCORRENTES; i += tarefa->passo) {
+        Chave chave = (Chave)(2 * tarefa->ordem[i]);
+        inserirArvoreBConcorrente(tarefa->arvore, chave, tarefa->ordem[i], &metricas);
+        tarefa->divergencias += !buscaConcorrenteValida(tarefa->arvore, chave, true, false, &metricas);
+        tarefa->operacoes++;
+    }
+    atomic_fetch_sub(tarefa->escritoresAtivos, 1);
+    return NULL;
+}
+
+/**
+ * Busca, enquanto houver escritores, chaves inseridas antes da rodada (que devem ser
+ * encontradas), chaves da rodada (que podem ainda não estar lá) e chaves ímpares (que nunca
+ * devem ser encontradas).
+ */
+static void* lerVerificacao(void *argumento) {
+    TarefaVerificacaoConcorrente *tarefa = argumento;
+    Metricas metricas = {0};
+    while (atomic_load(tarefa->escritoresAtivos) > 0) {
+        long i = (long)sortear(&tarefa->estado, CHAVES_CONCORRENTES);
+        bool preenchida = i < tarefa->numPreenchidas;
+        Chave chave = (Chave)(2 * tarefa->ordem[i]);
+        tarefa->divergencias += !buscaConcorrenteValida(tarefa->arvore, chave, preenchida, !preenchida, &metricas);
+        tarefa->divergencias += !buscaConcorrenteValida(tarefa->arvore, chave + 1, false, false, &metricas);
+        tarefa->operacoes += 2;
+    }
+    return NULL;
+}
+
+/**
+ * Executa uma rodada de inserções e buscas simultâneas na Árvore B concorrente e confere,
+ * durante e depois dela, cada resultado contra o oráculo.
+ *
+ * @return Número de divergências encontradas.
+ */
+static int verificarConcorrente(int rodada) {
+    long *ordem = malloc(CHAVES_CONCORRENTES * sizeof(long));
+    if (!ordem) {
+        perror("Erro ao alocar as chaves");
+        return 1;
+    }
+    uint64_t estado = 0x9E3779B97F4A7C15ULL * (uint64_t)(rodada + 1);
+    for (long i = 0; i < CHAVES_CONCORRENTES; i++) {
+        ordem[i] = i;
+    }
+    for (long i = CHAVES_CONCORRENTES - 1; i > 0; i--) {
+        long j = (long)sortear(&estado, (uint64_t)i + 1);
+        long troca = ordem[i];
+        ordem[i] = ordem[j];
+        ordem[j] = troca;
+    }
+
+    // A primeira metade entra antes da rodada; os escritores inserem a segunda
+    ArvoreBConcorrente arvore;
+    Metricas metricas = {0};
+    iniciarArvoreBConcorrente(&arvore);
+    long numPreenchidas = CHAVES_CONCORRENTES / 2;
+    for (long i = 0; i < numPreenchidas; i++) {
+        inserirArvoreBConcorrente(&arvore, (Chave)(2 * ordem[i]), ordem[i], &metricas);
+    }
+
+    int escritores = 1 << (rodada % 3);
+    int numThreads = escritores + LEITORES_CONCORRENTES;
+    TarefaVerificacaoConcorrente tarefas[MAXIMO_THREADS_CONCORRENTES] = {0};
+    pthread_t threads[MAXIMO_THREADS_CONCORRENTES];
+    bool criada[MAXIMO_THREADS_CONCORRENTES];
+    atomic_int escritoresAtivos;
+    atomic_init(&escritoresAtivos, escritores);
+
+    for (int t = 0; t < numThreads; t++) {
+        TarefaVerificacaoConcorrente *tarefa = &tarefas[t];
+        tarefa->arvore = &arvore;
+        tarefa->ordem = ordem;
+        tarefa->inicio = numPreenchidas + t;
+        tarefa->passo = escritores;
+        tarefa->numPreenchidas = numPreenchidas;
+        tarefa->escritoresAtivos = &escritoresAtivos;
+        tarefa->estado = estado ^ (0xD1B54A32D192ED03ULL * (uint64_t)(t + 1));
+
+        void *(*funcao)(void *) = t < escritores ? escreverVerificacao : lerVerificacao;
+        criada[t] = pthread_create(&threads[t], NULL, funcao, tarefa) == 0;
+        if (!criada[t] && t < escritores) {
+            funcao(tarefa); // Um escritor precisa terminar seu trabalho mesmo sem thread
+        }
+    }
+
+    uint64_t divergencias = 0, buscas = 0;
+    for (int t = 0; t < numThreads; t++) {
+        if (criada[t]) {
+            pthread_join(threads[t], NULL);
+        }
+        divergencias += tarefas[t].divergencias;
+        buscas += t < escritores ? 0 : tarefas[t].operacoes;
+    }
+
+    // Conferência final: todas as chaves pares na sua posição e nenhuma ímpar
+    for (long i = 0; i < CHAVES_CONCORRENTES; i++) {
+        divergencias += !buscaConcorrenteValida(&arvore, (Chave)(2 * i), true, false, &metricas);
+        divergencias += !buscaConcorrenteValida(&arvore, (Chave)(2 * i + 1), false, false, &metricas);
+    }
+    if (divergencias > 0) {
+        fprintf(stderr, "Árvore B concorrente (ordem %d), rodada %d com %d escritor(es): %llu divergências.\n", ORDEM_ARVORE_B, rodada, escritores, (unsigned long long)divergencias);
+    } else if (buscas == 0) {
+        fprintf(stderr, "Árvore B concorrente (ordem %d), rodada %d: os leitores não chegaram a buscar durante as inserções.\n", ORDEM_ARVORE_B, rodada);
+    }
+
+    destruirArvoreBConcorrente(&arvore);
+    free(ordem);
+    return divergencias > 0 ? 1 : 0;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc == 2 && strcmp(argv[1], "duplicatas") == 0) {
+        int divergencias = 0;
+        for (int rodada = 0; rodada < RODADAS_DUPLICATAS && divergencias == 0; rodada++) {
+            divergencias += verificarDuplicatas(rodada);
+        }
+        printf(
+            "Duplicatas (ordens %d e %d): %d rodadas de %d operações, %d divergências.\n",
+            ORDEM_ARVORE_B, ORDEM_ARVORE_BSTAR, RODADAS_DUPLICATAS, OPERACOES_DUPLICATAS, divergencias
+        );
+        return divergencias == 0 ? 0 : 1;
+    }
+
+    if (argc == 2 && strcmp(argv[1], "concorrente") == 0) {
+        int divergencias = 0;
+        for (int rodada = 0; rodada < RODADAS_CONCORRENTES && divergencias == 0; rodada++) {
+            divergencias += verificarConcorrente(rodada);
+        }
+        printf(
+            "Concorrente (ordem %d): %d rodadas de %d chaves com %d leitores, %d rodada(s) divergente(s).\n",
+            ORDEM_ARVORE_B, RODADAS_CONCORRENTES, CHAVES_CONCORRENTES, LEITORES_CONCORRENTES, divergencias
+        );
+        return divergencias == 0 ? 0 : 1;
+    }
+
+    fprintf(stderr, "Uso: %s duplicatas|concorrente\n", argv[0]);
+    return 1;
+}
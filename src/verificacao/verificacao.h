@@ -0,0 +1,45 @@
+#ifndef VERIFICACAO_H
+#define VERIFICACAO_H
+
+#include "../registro/registro.h"
+#include "../arvoreb/arvoreb.h"
+#include "../arvorebstar/arvorebstar.h"
+#include "../arvorebconcorrente/arvorebconcorrente.h"
+#include <stdatomic.h>
+
+#define OPERACOES_DUPLICATAS 20000 // Operações sorteadas em cada rodada da verificação de duplicatas
+#define CHAVES_DUPLICATAS 64 // Chaves distintas sorteadas; poucas, para que cada uma se repita muito
+#define RODADAS_DUPLICATAS 8 // Rodadas, cada uma com uma semente diferente
+#define CHAVES_CONCORRENTES 100000 // Chaves inseridas em cada rodada da verificação concorrente
+#define RODADAS_CONCORRENTES 6 // Rodadas, com 1, 2 e 4 escritores, cada uma com uma semente diferente
+#define LEITORES_CONCORRENTES 4 // Leitores de cada rodada da verificação concorrente
+
+/*
+ * Verificações das árvores contra um oráculo simples, sem E/S. A ordem das árvores é fixada na
+ * compilação, como nos microbenchmarks, então cada ordem é um executável (make verificar
+ * compila um para cada valor de ORDENS_VERIFICACAO). O executável termina com erro na primeira
+ * divergência entre uma árvore e o oráculo.
+ */
+typedef struct {
+    int *chaveDe; // Chave de cada posição inserida
+    bool *presente; // Indica se a posição ainda está na árvore
+    int ocorrencias[CHAVES_DUPLICATAS]; // Ocorrências de cada chave presentes na árvore
+} OraculoDuplicatas;
+
+/*
+ * Tarefa de uma thread da verificação concorrente. O oráculo é a própria numeração: a chave
+ * 2 * i fica na posição i, e as chaves ímpares nunca são inseridas.
+ */
+typedef struct {
+    ArvoreBConcorrente *arvore;
+    const long *ordem; // Índices das chaves na ordem de inserção
+    long inicio; // Primeiro índice de ordem inserido pelo escritor
+    long passo; // Distância entre os índices inseridos pelo mesmo escritor
+    long numPreenchidas; // Chaves inseridas antes da rodada
+    atomic_int *escritoresAtivos;
+    uint64_t estado; // Estado do sorteio da thread
+    uint64_t operacoes;
+    uint64_t divergencias;
+} TarefaVerificacaoConcorrente;
+
+#endif // VERIFICACAO_H
@@ -0,0 +1,242 @@
+#include "zonas.h"
+#include "../util/util.h"
+#include "../es/es.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Monta o caminho do arquivo auxiliar com o mapa de zonas de um arquivo de registros.
+ */
+static void caminhoMapaZonas(const char *nomeArquivo, char *caminho, size_t tamanho) {
+    snprintf(caminho, tamanho, "%s.zonas", nomeArquivo);
+}
+
+/**
+ * Lê um bloco de registros consecutivos com um único posicionamento e uma única leitura.
+ *
+ * @return Número de registros lidos.
+ */
+static long lerBlocoZona(FILE *arquivo, long zona, Registro *bloco, Metricas *metricas) {
+    registrarPosicionamento(metricas);
+    if (fseeko(arquivo, DESLOCAMENTO_REGISTRO(zona * REGISTROS_POR_ZONA), SEEK_SET) != 0) {
+        return 0;
+    }
+    long lidos = (long)fread(bloco, sizeof(Registro), REGISTROS_POR_ZONA, arquivo);
+    metricas->transferencias += lidos;
+    metricas->bytesLidos += lidos * sizeof(Registro);
+    metricas->chamadasSistema++;
+    return lidos;
+}
+
+/**
+ * Tenta carregar o mapa do arquivo auxiliar. O mapa só é aceito se foi gravado depois da
+ * última alteração do arquivo de registros e para o mesmo número de registros.
+ */
+static bool lerMapaZonas(const char *nomeArquivo, long totalRegistros, MapaZonas *mapa) {
+    char caminho[300];
+    caminhoMapaZonas(nomeArquivo, caminho, sizeof(caminho));
+
+    if (!auxiliarAtualizado(nomeArquivo, caminho)) {
+        return false;
+    }
+
+    FILE *arquivo = abrirArquivoDados(caminho, "rb");
+    if (!arquivo) {
+        return false;
+    }
+
+    CabecalhoZonas cabecalho;
+    long numZonas = (totalRegistros + REGISTROS_POR_ZONA - 1) / REGISTROS_POR_ZONA;
+    bool valido = fread(&cabecalho, sizeof(cabecalho), 1, arquivo) == 1 &&
+                  cabecalho.totalRegistros == totalRegistros &&
+                  cabecalho.registrosPorZona == REGISTROS_POR_ZONA;
+    if (valido) {
+        mapa->zonas = malloc((numZonas > 0 ? numZonas : 1) * sizeof(Zona));
+        valido = mapa->zonas != NULL && (long)fread(mapa->zonas, sizeof(Zona), numZonas, arquivo) == numZonas;
+        if (!valido) {
+            free(mapa->zonas);
+            mapa->zonas = NULL;
+        }
+    }
+    fclose(arquivo);
+
+    if (valido) {
+        mapa->numZonas = numZonas;
+        mapa->totalRegistros = totalRegistros;
+    }
+    return valido;
+}
+
+/**
+ * Grava o mapa no arquivo auxiliar. Uma falha aqui não impede o uso do mapa em memória.
+ */
+static void gravarMapaZonas(const char *nomeArquivo, const MapaZonas *mapa) {
+    char caminho[300];
+    caminhoMapaZonas(nomeArquivo, caminho, sizeof(caminho));
+
+    FILE *arquivo = abrirArquivoDados(caminho, "wb");
+    if (!arquivo) {
+        perror("Erro ao gravar o mapa de zonas");
+        return;
+    }
+    CabecalhoZonas cabecalho = {mapa->totalRegistros, REGISTROS_POR_ZONA};
+    fwrite(&cabecalho, sizeof(cabecalho), 1, arquivo);
+    fwrite(mapa->zonas, sizeof(Zona), mapa->numZonas, arquivo);
+    fclose(arquivo);
+}
+
+/**
+ * Carrega o mapa de zonas de um arquivo de registros, extraindo-o com uma leitura
+ * sequencial do arquivo quando o arquivo auxiliar falta ou está desatualizado. O arquivo
+ * auxiliar é lido e gravado com abrirArquivoDados, como o de registros, para que -D valha
+ * para todas as leituras da pesquisa.
+ *
+ * @param nomeArquivo Caminho do arquivo de registros.
+ * @param arquivo Ponteiro para o arquivo de registros aberto com abrirArquivoDados.
+ * @param mapa Estrutura onde o mapa será carregado.
+ * @param metricas Ponteiro para as métricas da construção; só a extração lê o arquivo.
+ * @return Retorna true se o mapa foi carregado.
+ */
+bool carregarMapaZonas(const char *nomeArquivo, FILE *arquivo, MapaZonas *mapa, Metricas *metricas) {
+    memset(mapa, 0, sizeof(MapaZonas));
+    fseeko(arquivo, 0, SEEK_END);
+    long totalRegistros = ftello(arquivo) / sizeof(Registro);
+
+    if (lerMapaZonas(nomeArquivo, totalRegistros, mapa)) {
+        metricas->numNos = mapa->numZonas;
+        metricas->altura = 1;
+        return true;
+    }
+
+    long numZonas = (totalRegistros + REGISTROS_POR_ZONA - 1) / REGISTROS_POR_ZONA;
+    Registro *bloco = malloc(REGISTROS_POR_ZONA * sizeof(Registro));
+    mapa->zonas = malloc((numZonas > 0 ? numZonas : 1) * sizeof(Zona));
+    if (!bloco || !mapa->zonas) {
+        perror("Erro ao alocar o mapa de zonas");
+        free(bloco);
+        free(mapa->zonas);
+        mapa->zonas = NULL;
+        return false;
+    }
+
+    for (long zona = 0; zona < numZonas; zona++) {
+        Zona *atual = &mapa->zonas[zona];
+        atual->menor = CHAVE_MAXIMA;
+        atual->maior = CHAVE_MINIMA;
+        long lidos = lerBlocoZona(arquivo, zona, bloco, metricas);
+        for (long i = 0; i < lidos; i++) {
+            if (!registroValido(&bloco[i])) {
+                continue;
+            }
+            if (bloco[i].chave < atual->menor) {
+                atual->menor = bloco[i].chave;
+            }
+            if (bloco[i].chave > atual->maior) {
+                atual->maior = bloco[i].chave;
+            }
+        }
+    }
+    free(bloco);
+
+    mapa->numZonas = numZonas;
+    mapa->totalRegistros = totalRegistros;
+    gravarMapaZonas(nomeArquivo, mapa);
+
+    metricas->numNos = numZonas;
+    metricas->altura = 1;
+    return true;
+}
+
+/**
+ * Busca uma chave lendo apenas os blocos cujas zonas podem contê-la.
+ *
+ * @param arquivo Ponteiro para o arquivo de registros.
+ * @param mapa Mapa de zonas do arquivo.
+ * @param chave Chave buscada.
+ * @param reg Onde o registro encontrado será copiado.
+ * @param posicao Onde a posição do registro será armazenada (pode ser NULL).
+ * @param metricas Ponteiro para as métricas da pesquisa.
+ * @return Retorna true se a chave foi encontrada.
+ */
+bool buscarMapaZonas(FILE *arquivo, const MapaZonas *mapa, Chave chave, Registro *reg, long *posicao, Metricas *metricas) {
+    Registro *bloco = malloc(REGISTROS_POR_ZONA * sizeof(Registro));
+    bool encontrado = false;
+    if (!bloco) {
+        perror("Erro ao alocar o bloco do mapa de zonas");
+        return false;
+    }
+
+    for (long zona = 0; zona < mapa->numZonas && !encontrado; zona++) {
+        metricas->comparacoes += 2;
+        if (chave < mapa->zonas[zona].menor || chave > mapa->zonas[zona].maior) {
+            continue;
+        }
+
+        long lidos = lerBlocoZona(arquivo, zona, bloco, metricas);
+        for (long i = 0; i < lidos; i++) {
+            metricas->comparacoes++;
+            if (bloco[i].chave == chave) {
+                *reg = bloco[i];
+                if (posicao != NULL) {
+                    *posicao = zona * REGISTROS_POR_ZONA + i;
+                }
+                encontrado = true;
+                break;
+            }
+        }
+    }
+
+    free(bloco);
+    return encontrado;
+}
+
+/**
+ * Conta os registros válidos com chave no intervalo, lendo apenas os blocos cujas zonas
+ * o intersectam.
+ *
+ * @param arquivo Ponteiro para o arquivo de registros.
+ * @param mapa Mapa de zonas do arquivo.
+ * @param minimo Menor chave do intervalo.
+ * @param maximo Maior chave do intervalo.
+ * @param zonasLidas Onde o número de blocos lidos será acumulado (pode ser NULL).
+ * @param metricas Ponteiro para as métricas da pesquisa.
+ * @return Número de registros no intervalo, ou -1 se o bloco não pôde ser alocado.
+ */
+long contarIntervaloMapaZonas(FILE *arquivo, const MapaZonas *mapa, Chave minimo, Chave maximo, long *zonasLidas, Metricas *metricas) {
+    Registro *bloco = malloc(REGISTROS_POR_ZONA * sizeof(Registro));
+    long total = 0;
+    if (!bloco) {
+        perror("Erro ao alocar o bloco do mapa de zonas");
+        return -1;
+    }
+
+    for (long zona = 0; zona < mapa->numZonas; zona++) {
+        metricas->comparacoes += 2;
+        if (maximo < mapa->zonas[zona].menor || minimo > mapa->zonas[zona].maior) {
+            continue;
+        }
+
+        long lidos = lerBlocoZona(arquivo, zona, bloco, metricas);
+        if (zonasLidas != NULL) {
+            (*zonasLidas)++;
+        }
+        for (long i = 0; i < lidos; i++) {
+            metricas->comparacoes += 2;
+            if (registroValido(&bloco[i]) && bloco[i].chave >= minimo && bloco[i].chave <= maximo) {
+                total++;
+            }
+        }
+    }
+
+    free(bloco);
+    return total;
+}
+
+/**
+ * Libera a memória do mapa de zonas.
+ */
+void liberarMapaZonas(MapaZonas *mapa) {
+    free(mapa->zonas);
+    mapa->zonas = NULL;
+    mapa->numZonas = 0;
+}
@@ -0,0 +1,38 @@
+#ifndef ZONAS_H
+#define ZONAS_H
+
+#include "../registro/registro.h"
+#include "../metricas/metricas.h"
+#include <stdbool.h>
+#include <stdio.h>
+
+#define REGISTROS_POR_ZONA 256 // Registros consecutivos resumidos por uma zona
+
+/*
+ * Mapa de zonas de um arquivo de registros: a menor e a maior chave válida de cada bloco
+ * de REGISTROS_POR_ZONA registros. Uma busca só precisa ler os blocos cujo intervalo
+ * contém a chave, mesmo em arquivos fora de ordem. O mapa fica em um arquivo auxiliar com a
+ * extensão ".zonas" e é extraído de novo quando o arquivo de registros muda.
+ */
+typedef struct {
+    Chave menor; // Menor chave válida do bloco (maior que "maior" se o bloco não tem registros válidos)
+    Chave maior; // Maior chave válida do bloco
+} Zona;
+
+typedef struct {
+    long totalRegistros; // Registros do arquivo quando o mapa foi extraído
+    long registrosPorZona;
+} CabecalhoZonas;
+
+typedef struct {
+    Zona *zonas;
+    long numZonas;
+    long totalRegistros;
+} MapaZonas;
+
+bool carregarMapaZonas(const char *nomeArquivo, FILE *arquivo, MapaZonas *mapa, Metricas *metricas);
+bool buscarMapaZonas(FILE *arquivo, const MapaZonas *mapa, Chave chave, Registro *reg, long *posicao, Metricas *metricas);
+long contarIntervaloMapaZonas(FILE *arquivo, const MapaZonas *mapa, Chave minimo, Chave maximo, long *zonasLidas, Metricas *metricas);
+void liberarMapaZonas(MapaZonas *mapa);
+
+#endif // ZONAS_H